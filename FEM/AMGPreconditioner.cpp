@@ -0,0 +1,587 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file AMGPreconditioner.cpp
+ * Smoothed aggregation algebraic multigrid for the sparse matrix of the
+ * built-in linear solvers (NEW_EQS).
+ */
+
+#include "AMGPreconditioner.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "matrix_class.h"
+
+namespace Math_Group
+{
+namespace
+{
+/// Largest coarsest system that is factorized densely. Larger ones, e.g.
+/// if the maximum number of levels is reached, are only smoothed.
+const long max_dense_size = 2000;
+/// Number of symmetric smoothing sweeps on a coarsest level that is not
+/// factorized
+const int coarse_smoothing_sweeps = 10;
+}  // namespace
+
+bool AMGPreconditioner::Setup(const CSparseMatrix& A, const CNumerics* num)
+{
+    const bool new_pattern = (dim != A.Dim() || dof != A.Dof() ||
+                              owner != num || levels.empty());
+    if (new_pattern)
+    {
+        dim = A.Dim();
+        dof = A.Dof();
+        owner = num;
+        levels.assign(1, Level());
+        CRSMatrix& A0 = levels[0].A;
+        A.GetScalarCRSPattern(A0.ptr, A0.col, a_entry_index);
+        A0.n = dim;
+        A0.n_cols = dim;
+        A0.val.resize(A0.col.size());
+    }
+
+    CRSMatrix& A0 = levels[0].A;
+    const double* entry = A.Entries();
+    const long nnz = static_cast<long>(A0.val.size());
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long k = 0; k < nnz; k++)
+        A0.val[k] = entry[a_entry_index[k]];
+
+    if (new_pattern)
+        BuildHierarchy();
+    else
+        ComputeCoarseOperators();
+    FactorizeCoarse();
+    return new_pattern;
+}
+
+double AMGPreconditioner::OperatorComplexity() const
+{
+    if (levels.empty() || levels[0].A.val.empty())
+        return 0.;
+    double nnz = 0.;
+    for (std::size_t l = 0; l < levels.size(); l++)
+        nnz += static_cast<double>(levels[l].A.val.size());
+    return nnz / static_cast<double>(levels[0].A.val.size());
+}
+
+/*!
+   Coarsening until the coarse size or the maximum number of levels is
+   reached, or until the aggregation does not reduce the size any more.
+ */
+void AMGPreconditioner::BuildHierarchy()
+{
+    levels.resize(1);
+    while (static_cast<int>(levels.size()) < param.max_levels &&
+           levels.back().A.n > param.coarse_size)
+    {
+        const std::size_t l = levels.size() - 1;
+        PrepareLevel(levels[l]);
+
+        std::vector<long> aggregate;
+        long n_aggregates = 0;
+        Aggregate(levels[l].A, aggregate, n_aggregates);
+        if (n_aggregates == 0 || n_aggregates >= levels[l].A.n)
+            break;
+
+        SmoothedProlongation(levels[l], aggregate, n_aggregates, levels[l].P);
+        Transpose(levels[l].P, levels[l].R);
+
+        levels.push_back(Level());
+        CRSMatrix AP;
+        Multiply(levels[l].A, levels[l].P, AP);
+        Multiply(levels[l].R, AP, levels[l + 1].A);
+    }
+    // The coarsest level has no prolongation
+    levels.back().P = CRSMatrix();
+    levels.back().R = CRSMatrix();
+    for (std::size_t l = 0; l < levels.size(); l++)
+        PrepareLevel(levels[l]);
+}
+
+/// Galerkin products with the kept prolongations
+void AMGPreconditioner::ComputeCoarseOperators()
+{
+    for (std::size_t l = 0; l + 1 < levels.size(); l++)
+    {
+        CRSMatrix AP;
+        Multiply(levels[l].A, levels[l].P, AP);
+        Multiply(levels[l].R, AP, levels[l + 1].A);
+    }
+    for (std::size_t l = 0; l < levels.size(); l++)
+        PrepareLevel(levels[l]);
+}
+
+/*!
+   Inverse diagonal and weight of the Jacobi smoothing,
+   omega = 4/(3 rho(D^{-1}A)). rho is bounded by the Gershgorin estimate.
+ */
+void AMGPreconditioner::PrepareLevel(Level& level)
+{
+    const CRSMatrix& A = level.A;
+    const long n = A.n;
+    level.inv_diag.assign(n, 1.0);
+    double rho = 0.;
+    for (long i = 0; i < n; i++)
+    {
+        double diag = 0.;
+        double row_sum = 0.;
+        for (long k = A.ptr[i]; k < A.ptr[i + 1]; k++)
+        {
+            if (A.col[k] == i)
+                diag += A.val[k];
+            row_sum += std::fabs(A.val[k]);
+        }
+        if (std::fabs(diag) < DBL_MIN)
+            diag = 1.0;
+        level.inv_diag[i] = 1.0 / diag;
+        rho = std::max(rho, row_sum * std::fabs(level.inv_diag[i]));
+    }
+    level.jacobi_weight = (rho > 0.) ? 4.0 / (3.0 * rho) : 2.0 / 3.0;
+
+    level.b.assign(n, 0.);
+    level.x.assign(n, 0.);
+    level.r.assign(n, 0.);
+}
+
+/*!
+   Aggregation of the strongly connected unknowns in three passes:
+   1. Unknowns whose strong neighbours are all free start an aggregate
+      with these neighbours.
+   2. Remaining unknowns join the aggregate of their strongest neighbour
+      aggregated in pass 1.
+   3. Still remaining unknowns form aggregates with their free neighbours.
+   Unknowns without strong connections, e.g. Dirichlet rows, are not
+   aggregated.
+ */
+void AMGPreconditioner::Aggregate(const CRSMatrix& A,
+                                  std::vector<long>& aggregate,
+                                  long& n_aggregates) const
+{
+    const long n = A.n;
+    const long free_node = -1;
+    const long isolated = -2;
+
+    std::vector<double> diag(n, 0.);
+    for (long i = 0; i < n; i++)
+        for (long k = A.ptr[i]; k < A.ptr[i + 1]; k++)
+            if (A.col[k] == i)
+                diag[i] += A.val[k];
+
+    // Strong connections
+    const double theta = param.strength_threshold;
+    std::vector<long> s_ptr(n + 1, 0);
+    std::vector<long> s_col;
+    std::vector<double> s_val;
+    s_col.reserve(A.col.size());
+    s_val.reserve(A.col.size());
+    for (long i = 0; i < n; i++)
+    {
+        for (long k = A.ptr[i]; k < A.ptr[i + 1]; k++)
+        {
+            const long j = A.col[k];
+            const double a_ij = std::fabs(A.val[k]);
+            if (j == i || a_ij == 0.)
+                continue;
+            if (a_ij >= theta * std::sqrt(std::fabs(diag[i] * diag[j])))
+            {
+                s_col.push_back(j);
+                s_val.push_back(a_ij);
+            }
+        }
+        s_ptr[i + 1] = static_cast<long>(s_col.size());
+    }
+
+    aggregate.assign(n, free_node);
+    for (long i = 0; i < n; i++)
+        if (s_ptr[i] == s_ptr[i + 1])
+            aggregate[i] = isolated;
+    n_aggregates = 0;
+
+    // Pass 1
+    for (long i = 0; i < n; i++)
+    {
+        if (aggregate[i] != free_node)
+            continue;
+        bool all_free = true;
+        for (long k = s_ptr[i]; k < s_ptr[i + 1]; k++)
+            if (aggregate[s_col[k]] >= 0)
+            {
+                all_free = false;
+                break;
+            }
+        if (!all_free)
+            continue;
+        aggregate[i] = n_aggregates;
+        for (long k = s_ptr[i]; k < s_ptr[i + 1]; k++)
+            if (aggregate[s_col[k]] == free_node)
+                aggregate[s_col[k]] = n_aggregates;
+        n_aggregates++;
+    }
+
+    // Pass 2
+    const std::vector<long> aggregate_pass1(aggregate);
+    for (long i = 0; i < n; i++)
+    {
+        if (aggregate[i] != free_node)
+            continue;
+        double strongest = 0.;
+        for (long k = s_ptr[i]; k < s_ptr[i + 1]; k++)
+        {
+            const long agg_j = aggregate_pass1[s_col[k]];
+            if (agg_j >= 0 && s_val[k] > strongest)
+            {
+                strongest = s_val[k];
+                aggregate[i] = agg_j;
+            }
+        }
+    }
+
+    // Pass 3
+    for (long i = 0; i < n; i++)
+    {
+        if (aggregate[i] != free_node)
+            continue;
+        aggregate[i] = n_aggregates;
+        for (long k = s_ptr[i]; k < s_ptr[i + 1]; k++)
+            if (aggregate[s_col[k]] == free_node)
+                aggregate[s_col[k]] = n_aggregates;
+        n_aggregates++;
+    }
+
+    for (long i = 0; i < n; i++)
+        if (aggregate[i] == isolated)
+            aggregate[i] = -1;
+}
+
+/*!
+   P = (I - omega D^{-1} A) P_0, with the piecewise constant tentative
+   prolongation P_0 of the aggregates.
+ */
+void AMGPreconditioner::SmoothedProlongation(const Level& level,
+                                             const std::vector<long>& aggregate,
+                                             const long n_aggregates,
+                                             CRSMatrix& P) const
+{
+    const CRSMatrix& A = level.A;
+    P.n = A.n;
+    P.n_cols = n_aggregates;
+    P.ptr.assign(A.n + 1, 0);
+    P.col.clear();
+    P.val.clear();
+    P.col.reserve(A.col.size());
+    P.val.reserve(A.col.size());
+
+    // Position of the columns in the current row
+    std::vector<long> marker(n_aggregates, -1);
+    for (long i = 0; i < A.n; i++)
+    {
+        const long row_start = static_cast<long>(P.col.size());
+        if (aggregate[i] >= 0)
+        {
+            marker[aggregate[i]] = row_start;
+            P.col.push_back(aggregate[i]);
+            P.val.push_back(1.0);
+        }
+        const double scale = level.jacobi_weight * level.inv_diag[i];
+        for (long k = A.ptr[i]; k < A.ptr[i + 1]; k++)
+        {
+            const long agg = aggregate[A.col[k]];
+            if (agg < 0)
+                continue;
+            if (marker[agg] < row_start)
+            {
+                marker[agg] = static_cast<long>(P.col.size());
+                P.col.push_back(agg);
+                P.val.push_back(0.);
+            }
+            P.val[marker[agg]] -= scale * A.val[k];
+        }
+        P.ptr[i + 1] = static_cast<long>(P.col.size());
+    }
+}
+
+/// C = A B, row by row (Gustavson).
+void AMGPreconditioner::Multiply(const CRSMatrix& A, const CRSMatrix& B,
+                                 CRSMatrix& C)
+{
+    C.n = A.n;
+    C.n_cols = B.n_cols;
+    C.ptr.assign(A.n + 1, 0);
+    C.col.clear();
+    C.val.clear();
+
+    std::vector<long> marker(B.n_cols, -1);
+    for (long i = 0; i < A.n; i++)
+    {
+        const long row_start = static_cast<long>(C.col.size());
+        for (long ka = A.ptr[i]; ka < A.ptr[i + 1]; ka++)
+        {
+            const long j = A.col[ka];
+            const double a_ij = A.val[ka];
+            for (long kb = B.ptr[j]; kb < B.ptr[j + 1]; kb++)
+            {
+                const long c = B.col[kb];
+                if (marker[c] < row_start)
+                {
+                    marker[c] = static_cast<long>(C.col.size());
+                    C.col.push_back(c);
+                    C.val.push_back(a_ij * B.val[kb]);
+                }
+                else
+                    C.val[marker[c]] += a_ij * B.val[kb];
+            }
+        }
+        C.ptr[i + 1] = static_cast<long>(C.col.size());
+    }
+}
+
+void AMGPreconditioner::Transpose(const CRSMatrix& A, CRSMatrix& T)
+{
+    T.n = A.n_cols;
+    T.n_cols = A.n;
+    T.ptr.assign(T.n + 1, 0);
+    for (std::size_t k = 0; k < A.col.size(); k++)
+        T.ptr[A.col[k] + 1]++;
+    for (long i = 0; i < T.n; i++)
+        T.ptr[i + 1] += T.ptr[i];
+    T.col.resize(A.col.size());
+    T.val.resize(A.val.size());
+    std::vector<long> pos(T.ptr.begin(), T.ptr.end() - 1);
+    for (long i = 0; i < A.n; i++)
+        for (long k = A.ptr[i]; k < A.ptr[i + 1]; k++)
+        {
+            const long m = pos[A.col[k]]++;
+            T.col[m] = i;
+            T.val[m] = A.val[k];
+        }
+}
+
+/// r = b - A x
+void AMGPreconditioner::Residual(const CRSMatrix& A, const double* x,
+                                 const double* b, double* r)
+{
+    const long n = A.n;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < n; i++)
+    {
+        double val = b[i];
+        for (long k = A.ptr[i]; k < A.ptr[i + 1]; k++)
+            val -= A.val[k] * x[A.col[k]];
+        r[i] = val;
+    }
+}
+
+/*!
+   Dense LU factorization of the coarsest matrix with row pivoting.
+   A vanishing pivot, e.g. of a singular pure Neumann problem, is set to
+   zero, and the corresponding unknown is set to zero in the solution.
+ */
+void AMGPreconditioner::FactorizeCoarse()
+{
+    const Level& level = levels.back();
+    const long n = level.A.n;
+    coarse_lu.clear();
+    coarse_pivot.clear();
+    if (n > std::max(param.coarse_size, max_dense_size))
+        return;
+
+    coarse_lu.assign(n * n, 0.);
+    coarse_pivot.resize(n);
+    double max_entry = 0.;
+    for (long i = 0; i < n; i++)
+        for (long k = level.A.ptr[i]; k < level.A.ptr[i + 1]; k++)
+        {
+            coarse_lu[i * n + level.A.col[k]] += level.A.val[k];
+            max_entry = std::max(max_entry, std::fabs(level.A.val[k]));
+        }
+    const double tiny = DBL_EPSILON * max_entry * static_cast<double>(n);
+
+    double* lu = &coarse_lu[0];
+    for (long k = 0; k < n; k++)
+    {
+        long p = k;
+        for (long i = k + 1; i < n; i++)
+            if (std::fabs(lu[i * n + k]) > std::fabs(lu[p * n + k]))
+                p = i;
+        coarse_pivot[k] = p;
+        if (p != k)
+            for (long j = 0; j < n; j++)
+                std::swap(lu[k * n + j], lu[p * n + j]);
+        if (std::fabs(lu[k * n + k]) <= tiny)
+        {
+            lu[k * n + k] = 0.;
+            continue;
+        }
+        const double inv_pivot = 1.0 / lu[k * n + k];
+        for (long i = k + 1; i < n; i++)
+        {
+            const double l_ik = lu[i * n + k] * inv_pivot;
+            lu[i * n + k] = l_ik;
+            if (l_ik == 0.)
+                continue;
+            for (long j = k + 1; j < n; j++)
+                lu[i * n + j] -= l_ik * lu[k * n + j];
+        }
+    }
+}
+
+void AMGPreconditioner::SolveCoarse(Level& level) const
+{
+    if (coarse_lu.empty())
+    {
+        for (int s = 0; s < coarse_smoothing_sweeps; s++)
+        {
+            Smooth(level, true);
+            Smooth(level, false);
+        }
+        return;
+    }
+
+    const long n = level.A.n;
+    const double* lu = &coarse_lu[0];
+    double* x = &level.x[0];
+    for (long i = 0; i < n; i++)
+        x[i] = level.b[i];
+    for (long k = 0; k < n; k++)
+    {
+        std::swap(x[k], x[coarse_pivot[k]]);
+        for (long i = k + 1; i < n; i++)
+            x[i] -= lu[i * n + k] * x[k];
+    }
+    for (long i = n - 1; i >= 0; i--)
+    {
+        if (lu[i * n + i] == 0.)
+        {
+            x[i] = 0.;
+            continue;
+        }
+        double val = x[i];
+        for (long j = i + 1; j < n; j++)
+            val -= lu[i * n + j] * x[j];
+        x[i] = val / lu[i * n + i];
+    }
+}
+
+/*!
+   One smoothing step on level.x. The Gauss-Seidel sweep runs forward for
+   the pre- and backward for the post-smoothing, which keeps the cycle
+   symmetric for symmetric matrices.
+ */
+void AMGPreconditioner::Smooth(Level& level, const bool forward) const
+{
+    const CRSMatrix& A = level.A;
+    const long n = A.n;
+    double* x = &level.x[0];
+    const double* b = &level.b[0];
+
+    if (param.smoother == 0)
+    {
+        double* r = &level.r[0];
+        Residual(A, x, b, r);
+        const double omega = level.jacobi_weight;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (long i = 0; i < n; i++)
+            x[i] += omega * level.inv_diag[i] * r[i];
+        return;
+    }
+
+    for (long m = 0; m < n; m++)
+    {
+        const long i = forward ? m : n - 1 - m;
+        double val = b[i];
+        for (long k = A.ptr[i]; k < A.ptr[i + 1]; k++)
+            val -= A.val[k] * x[A.col[k]];
+        x[i] += val * level.inv_diag[i];
+    }
+}
+
+/// Cycle on level l with the start vector levels[l].x.
+void AMGPreconditioner::Cycle(const std::size_t l)
+{
+    Level& level = levels[l];
+    if (l + 1 == levels.size())
+    {
+        SolveCoarse(level);
+        return;
+    }
+
+    for (int s = 0; s < param.smoothing_steps; s++)
+        Smooth(level, true);
+
+    // Restriction of the residual
+    Residual(level.A, &level.x[0], &level.b[0], &level.r[0]);
+    Level& coarse = levels[l + 1];
+    const CRSMatrix& R = level.R;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < R.n; i++)
+    {
+        double val = 0.;
+        for (long k = R.ptr[i]; k < R.ptr[i + 1]; k++)
+            val += R.val[k] * level.r[R.col[k]];
+        coarse.b[i] = val;
+        coarse.x[i] = 0.;
+    }
+
+    for (int g = 0; g < param.cycle; g++)
+        Cycle(l + 1);
+
+    // Coarse grid correction
+    const CRSMatrix& P = level.P;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < P.n; i++)
+    {
+        double val = 0.;
+        for (long k = P.ptr[i]; k < P.ptr[i + 1]; k++)
+            val += P.val[k] * coarse.x[P.col[k]];
+        level.x[i] += val;
+    }
+
+    for (int s = 0; s < param.smoothing_steps; s++)
+        Smooth(level, false);
+}
+
+void AMGPreconditioner::Solve(const double* vec_s, double* vec_r)
+{
+    Level& fine = levels[0];
+    const long n = fine.A.n;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < n; i++)
+    {
+        fine.b[i] = vec_s[i];
+        fine.x[i] = 0.;
+    }
+    Cycle(0);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < n; i++)
+        vec_r[i] = fine.x[i];
+}
+}  // namespace Math_Group
@@ -0,0 +1,150 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file AMGPreconditioner.h
+ * Smoothed aggregation algebraic multigrid for the sparse matrix of the
+ * built-in linear solvers (NEW_EQS).
+ */
+
+#ifndef OGS_AMGPRECONDITIONER_H
+#define OGS_AMGPRECONDITIONER_H
+
+#include <cstddef>
+#include <vector>
+
+class CNumerics;
+
+namespace Math_Group
+{
+class CSparseMatrix;
+
+/// Parameters of the AMG hierarchy and of its cycle.
+struct AMGParameters
+{
+    AMGParameters()
+        : cycle(1),
+          strength_threshold(0.08),
+          smoother(1),
+          smoothing_steps(1),
+          max_levels(10),
+          coarse_size(200)
+    {
+    }
+    /// 1: V cycle, 2: W cycle
+    int cycle;
+    /// Threshold of the strength of connection, |a_ij| >= theta
+    /// sqrt(|a_ii a_jj|)
+    double strength_threshold;
+    /// 0: damped Jacobi (OpenMP), 1: symmetric Gauss-Seidel
+    int smoother;
+    /// Number of pre- and of post-smoothing steps
+    int smoothing_steps;
+    int max_levels;
+    /// Size below which the coarsest system is solved directly
+    long coarse_size;
+};
+
+/*!
+   \brief Smoothed aggregation AMG of a CSparseMatrix.
+
+   The setup works on the point-wise compressed row pattern of the whole
+   matrix. Aggregates are built from the strong connections after Vanek
+   et al., and the tentative, piecewise constant prolongation is smoothed
+   with one damped Jacobi step. The coarse operators are the Galerkin
+   products R A P with R = P^T.
+
+   The aggregates and the prolongations are kept as long as the pattern of
+   the matrix and the numerics the hierarchy was built for are the same,
+   i.e. a new setup only recomputes the coarse operators and the smoother
+   data from the current matrix values.
+ */
+class AMGPreconditioner
+{
+public:
+    AMGPreconditioner() : dim(0), dof(0), owner(NULL) {}
+    void Configure(const AMGParameters& parameters) { param = parameters; }
+    /*!
+       Setup of the hierarchy.
+       \param num Numerics of the equation the matrix belongs to. The
+              aggregates of another equation sharing the matrix are not
+              reused.
+       \return true if the aggregates and prolongations were (re)built.
+     */
+    bool Setup(const CSparseMatrix& A, const CNumerics* num);
+
+    /// vec_r = M^{-1} vec_s with one multigrid cycle and zero start vector.
+    void Solve(const double* vec_s, double* vec_r);
+
+    int NumberOfLevels() const { return static_cast<int>(levels.size()); }
+    long LevelSize(const int l) const { return levels[l].A.n; }
+    /// Sum of the nonzeros of all levels over the nonzeros of the matrix
+    double OperatorComplexity() const;
+
+private:
+    /// Compressed row matrix of a level
+    struct CRSMatrix
+    {
+        CRSMatrix() : n(0), n_cols(0) {}
+        long n;
+        long n_cols;
+        std::vector<long> ptr;
+        std::vector<long> col;
+        std::vector<double> val;
+    };
+    struct Level
+    {
+        CRSMatrix A;
+        /// Prolongation to this level from the next coarser one, and its
+        /// transpose
+        CRSMatrix P;
+        CRSMatrix R;
+        std::vector<double> inv_diag;
+        double jacobi_weight;
+        /// Right hand side, solution and residual of this level
+        std::vector<double> b;
+        std::vector<double> x;
+        std::vector<double> r;
+    };
+
+    AMGParameters param;
+
+    /// Pattern of the finest matrix. Dimension and DOF identify it.
+    long dim;
+    int dof;
+    /// Numerics the aggregates were built for
+    const CNumerics* owner;
+    std::vector<long> a_entry_index;
+
+    std::vector<Level> levels;
+    /// LU factors of the coarsest matrix, dense, with row pivoting
+    std::vector<double> coarse_lu;
+    std::vector<long> coarse_pivot;
+
+    void BuildHierarchy();
+    void ComputeCoarseOperators();
+    void PrepareLevel(Level& level);
+    void Aggregate(const CRSMatrix& A, std::vector<long>& aggregate,
+                   long& n_aggregates) const;
+    void SmoothedProlongation(const Level& level,
+                              const std::vector<long>& aggregate,
+                              const long n_aggregates, CRSMatrix& P) const;
+    void FactorizeCoarse();
+    void SolveCoarse(Level& level) const;
+    void Smooth(Level& level, const bool forward) const;
+    void Cycle(const std::size_t l);
+
+    static void Multiply(const CRSMatrix& A, const CRSMatrix& B,
+                         CRSMatrix& C);
+    static void Transpose(const CRSMatrix& A, CRSMatrix& T);
+    static void Residual(const CRSMatrix& A, const double* x, const double* b,
+                         double* r);
+};
+}  // namespace Math_Group
+#endif
@@ -0,0 +1,205 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file AndersonAcceleration.cpp
+ * Anderson acceleration of fixed point iterations, e.g. of the Picard
+ * iterations of a process and of the coupling iterations between processes.
+ */
+
+#include "AndersonAcceleration.h"
+
+#include <cmath>
+
+namespace Math_Group
+{
+/// Largest ratio of the diagonal entries of R before the oldest
+/// difference is dropped
+static const double ANDERSON_MAX_CONDITION = 1.0e10;
+
+AndersonAcceleration::AndersonAcceleration(const int depth)
+    : max_columns(depth > 0 ? depth : 1),
+      size(0),
+      n_columns(0),
+      first_column(0),
+      f_prev_norm(0.0),
+      dF(max_columns),
+      dG(max_columns),
+      R(max_columns * max_columns),
+      gamma(max_columns),
+      n_iterations(0),
+      n_accelerated(0),
+      n_restarts(0)
+{
+}
+
+void AndersonAcceleration::reset()
+{
+    n_columns = 0;
+    first_column = 0;
+    n_iterations = 0;
+    n_accelerated = 0;
+    n_restarts = 0;
+}
+
+void AndersonAcceleration::dropOldestColumn()
+{
+    first_column = (first_column + 1) % max_columns;
+    n_columns--;
+}
+
+double AndersonAcceleration::factorize()
+{
+    const std::size_t n = size;
+    double r_max = 0.0, r_min = 0.0;
+    for (int j = 0; j < n_columns; j++)
+    {
+        double* q_j = &Q[j * n];
+        const double* df = &dF[getColumn(j)][0];
+        for (std::size_t l = 0; l < n; l++)
+            q_j[l] = df[l];
+        for (int i = 0; i < j; i++)
+        {
+            const double* q_i = &Q[i * n];
+            double r = 0.0;
+            for (std::size_t l = 0; l < n; l++)
+                r += q_i[l] * q_j[l];
+            R[i * max_columns + j] = r;
+            for (std::size_t l = 0; l < n; l++)
+                q_j[l] -= r * q_i[l];
+        }
+        double norm = 0.0;
+        for (std::size_t l = 0; l < n; l++)
+            norm += q_j[l] * q_j[l];
+        norm = std::sqrt(norm);
+        R[j * max_columns + j] = norm;
+        if (norm > 0.0)
+            for (std::size_t l = 0; l < n; l++)
+                q_j[l] /= norm;
+        if (j == 0 || norm > r_max)
+            r_max = norm;
+        if (j == 0 || norm < r_min)
+            r_min = norm;
+    }
+    if (r_min <= 0.0)
+        return HUGE_VAL;
+    return r_max / r_min;
+}
+
+bool AndersonAcceleration::update(double* x, const double* g,
+                                  const std::size_t n, const double beta)
+{
+    if (n != size)
+    {
+        // New system size: no history
+        size = n;
+        n_columns = 0;
+        first_column = 0;
+        f_prev.resize(n);
+        g_prev.resize(n);
+        for (int j = 0; j < max_columns; j++)
+        {
+            dF[j].resize(n);
+            dG[j].resize(n);
+        }
+        Q.resize(static_cast<std::size_t>(max_columns) * n);
+    }
+    n_iterations++;
+
+    // Residual and the differences to the previous iteration
+    double f_norm = 0.0;
+    for (std::size_t l = 0; l < n; l++)
+    {
+        const double f = g[l] - x[l];
+        f_norm += f * f;
+    }
+    f_norm = std::sqrt(f_norm);
+
+    if (n_iterations > 1)
+    {
+        if (n_columns > 0 && f_norm >= f_prev_norm)
+        {
+            // The accelerated iterate does not decrease the residual: it is
+            // rejected, and the next iterate is the fixed point step of the
+            // previous one. The residual of the previous iterate is kept as
+            // the reference of the next difference.
+            n_columns = 0;
+            first_column = 0;
+            n_restarts++;
+            for (std::size_t l = 0; l < n; l++)
+                x[l] = g_prev[l] - (1.0 - beta) * f_prev[l];
+            return false;
+        }
+        if (n_columns == max_columns)
+            dropOldestColumn();
+        const int c = getColumn(n_columns);
+        double* df = &dF[c][0];
+        double* dg = &dG[c][0];
+        for (std::size_t l = 0; l < n; l++)
+        {
+            df[l] = (g[l] - x[l]) - f_prev[l];
+            dg[l] = g[l] - g_prev[l];
+        }
+        n_columns++;
+    }
+    for (std::size_t l = 0; l < n; l++)
+    {
+        f_prev[l] = g[l] - x[l];
+        g_prev[l] = g[l];
+    }
+    f_prev_norm = f_norm;
+
+    // Least squares problem
+    while (n_columns > 0 && factorize() > ANDERSON_MAX_CONDITION)
+        dropOldestColumn();
+    bool accelerated = n_columns > 0;
+    if (accelerated)
+    {
+        // gamma = R^-1 Q^T f
+        for (int j = 0; j < n_columns; j++)
+        {
+            const double* q_j = &Q[j * n];
+            double s = 0.0;
+            for (std::size_t l = 0; l < n; l++)
+                s += q_j[l] * f_prev[l];
+            gamma[j] = s;
+        }
+        for (int j = n_columns - 1; j >= 0; j--)
+        {
+            for (int i = j + 1; i < n_columns; i++)
+                gamma[j] -= R[j * max_columns + i] * gamma[i];
+            gamma[j] /= R[j * max_columns + j];
+            if (!(std::fabs(gamma[j]) < HUGE_VAL))
+                accelerated = false;
+        }
+        if (!accelerated)
+        {
+            n_columns = 0;
+            first_column = 0;
+            n_restarts++;
+        }
+    }
+
+    for (std::size_t l = 0; l < n; l++)
+        x[l] += beta * f_prev[l];
+    if (!accelerated)
+        return false;
+
+    for (int j = 0; j < n_columns; j++)
+    {
+        const double* df = &dF[getColumn(j)][0];
+        const double* dg = &dG[getColumn(j)][0];
+        const double c = gamma[j];
+        for (std::size_t l = 0; l < n; l++)
+            x[l] -= c * (dg[l] - (1.0 - beta) * df[l]);
+    }
+    n_accelerated++;
+    return true;
+}
+}  // namespace Math_Group
@@ -0,0 +1,107 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file AndersonAcceleration.h
+ * Anderson acceleration of fixed point iterations, e.g. of the Picard
+ * iterations of a process and of the coupling iterations between processes.
+ */
+
+#ifndef OGS_ANDERSONACCELERATION_H
+#define OGS_ANDERSONACCELERATION_H
+
+#include <cstddef>
+#include <vector>
+
+namespace Math_Group
+{
+/*!
+   \brief Anderson acceleration with a window of the last iterations.
+
+   For the fixed point iteration x_{k+1} = G(x_k) with the residual
+   f_k = G(x_k) - x_k, the differences of the last m residuals and
+   values of G are kept (Walker & Ni, 2011). The next iterate is
+       x_{k+1} = x_k + beta f_k - sum_j gamma_j (dG_j - (1 - beta) dF_j)
+   with the coefficients gamma of the least squares problem
+       min || f_k - sum_j gamma_j dF_j ||_2,
+   which is solved by a QR decomposition of the differences dF. With an
+   empty window, the step is the plain fixed point step damped by beta.
+
+   Safeguards:
+   - The oldest differences are dropped while R is ill-conditioned.
+   - If the norm of the residual of an accelerated iterate does not
+     decrease, the iterate is rejected: the window is cleared and the next
+     iterate is the plain fixed point step of the previous iterate
+     (restart).
+ */
+class AndersonAcceleration
+{
+public:
+    /// depth: maximum number of differences that are kept
+    explicit AndersonAcceleration(const int depth);
+
+    /// Clear the window and the counters, e.g. for a new time step
+    void reset();
+
+    /*!
+       One iteration.
+       \param x     The present iterate x_k, overwritten with x_{k+1}
+       \param g     G(x_k)
+       \param n     Size of x and g
+       \param beta  Damping (relaxation) of the fixed point step
+       \return      Whether the step is accelerated
+     */
+    bool update(double* x, const double* g, const std::size_t n,
+                const double beta);
+
+    int getDepth() const { return max_columns; }
+    /// Number of iterations since reset()
+    int getNumberOfIterations() const { return n_iterations; }
+    /// Number of accelerated iterations since reset()
+    int getNumberOfAcceleratedIterations() const { return n_accelerated; }
+    /// Number of restarts since reset()
+    int getNumberOfRestarts() const { return n_restarts; }
+
+private:
+    int max_columns;
+    std::size_t size;
+    /// Number of columns in the window
+    int n_columns;
+    /// Position of the oldest column in the ring buffers
+    int first_column;
+
+    /// Residual and G of the previous iteration
+    std::vector<double> f_prev;
+    std::vector<double> g_prev;
+    double f_prev_norm;
+
+    /// Ring buffers of the differences dF and dG, one column each
+    std::vector<std::vector<double> > dF;
+    std::vector<std::vector<double> > dG;
+
+    /// Q (column wise) and R (row-major, upper) of the QR decomposition
+    std::vector<double> Q;
+    std::vector<double> R;
+    std::vector<double> gamma;
+
+    int n_iterations;
+    int n_accelerated;
+    int n_restarts;
+
+    int getColumn(const int j) const
+    {
+        return (first_column + j) % max_columns;
+    }
+    void dropOldestColumn();
+    /// QR decomposition of the columns of dF by modified Gram-Schmidt.
+    /// Returns the ratio of the largest to the smallest diagonal entry of R.
+    double factorize();
+};
+}  // namespace Math_Group
+#endif
@@ -2252,20 +2252,30 @@ bool CECLIPSEData::CorrespondingElements()
     for (long j = 0; j < this->elements; j++)
         CorrespondingGeosysElement[j] = -1;
 
-    for (unsigned long i = 0; i < m_msh->ele_vector.size(); i++)
-        for (long j = 0; j < this->elements; j++)
+    // Only the Geosys elements whose bounding box contains the barycentre of
+    // the Eclipse element are compared
+    const MeshLib::MeshElementGrid& element_grid(m_msh->getElementGrid());
+    std::vector<long> candidates;
+    for (long j = 0; j < this->elements; j++)
+    {
+        const double barycentre[3] = {this->eclgrid[j]->x_barycentre,
+                                      this->eclgrid[j]->y_barycentre,
+                                      -this->eclgrid[j]->z_barycentre};
+        element_grid.getElementsAtPoint(barycentre, candidates);
+        for (size_t l = 0; l < candidates.size(); l++)
         {
+            const long i = candidates[l];
             m_ele = m_msh->ele_vector[i];
             double const* grav_c(m_ele->GetGravityCenter());
             // check if coordinates of the gravity centre are equal
-            if ((grav_c[0] == this->eclgrid[j]->x_barycentre) &&
-                (grav_c[1] == this->eclgrid[j]->y_barycentre) &&
-                (grav_c[2] == -this->eclgrid[j]->z_barycentre))
+            if ((grav_c[0] == barycentre[0]) && (grav_c[1] == barycentre[1]) &&
+                (grav_c[2] == barycentre[2]))
             {
                 CorrespondingEclipseElement[i] = j;
                 CorrespondingGeosysElement[j] = i;
             }
         }
+    }
 
     // check if all values in the correspondingElementVector are larger than -1
     for (unsigned long i = 0; i < m_msh->ele_vector.size(); i++)
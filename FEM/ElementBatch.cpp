@@ -0,0 +1,336 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file ElementBatch.cpp
+ * Geometry and local matrices of a batch of elements of the same type, which
+ * are computed together in SIMD lanes.
+ */
+
+#include "ElementBatch.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "makros.h"
+#include "msh_elem.h"
+
+namespace FiniteElement
+{
+const int ElementBatch::WIDTH;
+
+ElementBatch::ElementBatch()
+    : elem_type(MshElemType::INVALID),
+      nnodes(0),
+      dim(0),
+      n_gp(0),
+      shapefct(NULL),
+      dshapefct_local(NULL),
+      n_elements(0),
+      with_mass_matrix(false)
+{
+}
+
+void ElementBatch::reset(const MshElemType::type type, const int n_nodes,
+                         const int dimension, const int n_gauss_points,
+                         const double* shape_fct,
+                         const double* grad_shape_fct)
+{
+    elem_type = type;
+    nnodes = n_nodes;
+    dim = dimension;
+    n_gp = n_gauss_points;
+    shapefct = shape_fct;
+    dshapefct_local = grad_shape_fct;
+    n_elements = 0;
+    with_mass_matrix = false;
+
+    const std::size_t dd = dim * dim;
+    coordinates.assign(dim * nnodes * WIDTH, 0.0);
+    determinants.assign(n_gp * WIDTH, 0.0);
+    inv_jacobians.assign(n_gp * dd * WIDTH, 0.0);
+    jacobians.assign(dd * WIDTH, 0.0);
+    dshapefct.assign(n_gp * dim * nnodes * WIDTH, 0.0);
+    mass_factors.assign(n_gp * WIDTH, 0.0);
+    laplace_factors.assign(n_gp * WIDTH, 0.0);
+    tensors.assign(n_gp * dd * WIDTH, 0.0);
+    mass.assign(nnodes * nnodes * WIDTH, 0.0);
+    laplace.assign(nnodes * nnodes * WIDTH, 0.0);
+    KdN.assign(dim * nnodes * WIDTH, 0.0);
+}
+
+void ElementBatch::addElement(MeshLib::CElem* elem)
+{
+    const int lane = n_elements++;
+    elements[lane] = elem;
+    for (int i = 0; i < nnodes; i++)
+    {
+        double const* const xyz = elem->GetNode(i)->getData();
+        for (int l = 0; l < dim; l++)
+            coordinates[(l * nnodes + i) * WIDTH + lane] = xyz[l];
+    }
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Jacobians, their determinants and inverses, and the gradients of
+         the shape functions of all elements at all integration points as
+         CElement::computeJacobian() and CElement::ComputeGradShapefct().
+         The unused lanes of a partial batch are filled with the first
+         element.
+**************************************************************************/
+int ElementBatch::computeGeometry()
+{
+    for (int lane = n_elements; lane < WIDTH; lane++)
+        for (int k = 0; k < dim * nnodes; k++)
+            coordinates[k * WIDTH + lane] = coordinates[k * WIDTH];
+
+    const int W = WIDTH;
+    const int dd = dim * dim;
+    const double* X = &coordinates[0];
+    const double* Y = (dim > 1) ? X + nnodes * W : NULL;
+    const double* Z = (dim > 2) ? X + 2 * nnodes * W : NULL;
+    double* J = &jacobians[0];
+    double det[WIDTH];
+
+    for (int gp = 0; gp < n_gp; gp++)
+    {
+        const double* dN = dshapefct_local + gp * dim * nnodes;
+        double* invJ = &inv_jacobians[gp * dd * W];
+        std::fill(J, J + dd * W, 0.0);
+        switch (dim)
+        {
+            case 1:
+                for (int w = 0; w < W; w++)
+                {
+                    J[w] = 0.5 * (X[W + w] - X[w]);
+                    invJ[w] = 2.0 / (X[W + w] - X[w]);
+                    det[w] = J[w];
+                }
+                break;
+            case 2:
+                for (int i = 0, j = nnodes; i < nnodes; i++, j++)
+                    for (int w = 0; w < W; w++)
+                    {
+                        J[w] += X[i * W + w] * dN[i];
+                        J[W + w] += Y[i * W + w] * dN[i];
+                        J[2 * W + w] += X[i * W + w] * dN[j];
+                        J[3 * W + w] += Y[i * W + w] * dN[j];
+                    }
+                for (int w = 0; w < W; w++)
+                {
+                    det[w] = J[w] * J[3 * W + w] - J[W + w] * J[2 * W + w];
+                    invJ[w] = J[3 * W + w] / det[w];
+                    invJ[W + w] = -J[W + w] / det[w];
+                    invJ[2 * W + w] = -J[2 * W + w] / det[w];
+                    invJ[3 * W + w] = J[w] / det[w];
+                }
+                break;
+            case 3:
+                for (int i = 0; i < nnodes; i++)
+                {
+                    const double dN0 = dN[i];
+                    const double dN1 = dN[i + nnodes];
+                    const double dN2 = dN[i + 2 * nnodes];
+                    for (int w = 0; w < W; w++)
+                    {
+                        const double x = X[i * W + w];
+                        const double y = Y[i * W + w];
+                        const double z = Z[i * W + w];
+                        J[w] += x * dN0;
+                        J[W + w] += y * dN0;
+                        J[2 * W + w] += z * dN0;
+                        J[3 * W + w] += x * dN1;
+                        J[4 * W + w] += y * dN1;
+                        J[5 * W + w] += z * dN1;
+                        J[6 * W + w] += x * dN2;
+                        J[7 * W + w] += y * dN2;
+                        J[8 * W + w] += z * dN2;
+                    }
+                }
+                for (int w = 0; w < W; w++)
+                {
+                    const double J0 = J[w], J1 = J[W + w], J2 = J[2 * W + w];
+                    const double J3 = J[3 * W + w], J4 = J[4 * W + w],
+                                 J5 = J[5 * W + w];
+                    const double J6 = J[6 * W + w], J7 = J[7 * W + w],
+                                 J8 = J[8 * W + w];
+                    det[w] = J0 * (J4 * J8 - J7 * J5) +
+                             J6 * (J1 * J5 - J4 * J2) +
+                             J3 * (J2 * J7 - J8 * J1);
+                    invJ[w] = (J4 * J8 - J7 * J5) / det[w];
+                    invJ[W + w] = (J2 * J7 - J1 * J8) / det[w];
+                    invJ[2 * W + w] = (J1 * J5 - J2 * J4) / det[w];
+                    invJ[3 * W + w] = (J5 * J6 - J8 * J3) / det[w];
+                    invJ[4 * W + w] = (J0 * J8 - J6 * J2) / det[w];
+                    invJ[5 * W + w] = (J2 * J3 - J5 * J0) / det[w];
+                    invJ[6 * W + w] = (J3 * J7 - J6 * J4) / det[w];
+                    invJ[7 * W + w] = (J1 * J6 - J7 * J0) / det[w];
+                    invJ[8 * W + w] = (J0 * J4 - J3 * J1) / det[w];
+                }
+                break;
+        }
+        for (int lane = 0; lane < n_elements; lane++)
+            if (dim > 1 && std::fabs(det[lane]) < MKleinsteZahl)
+                return lane;
+        for (int w = 0; w < W; w++)
+            determinants[gp * W + w] = std::fabs(det[w]);
+
+        // Gradients: dN_global(j, i) = sum_k invJ(j, k) dN_local(k, i)
+        double* dN_global = &dshapefct[gp * dim * nnodes * W];
+        for (int i = 0; i < nnodes; i++)
+            for (int j = 0; j < dim; j++)
+            {
+                double* dN_ji = dN_global + (j * nnodes + i) * W;
+                for (int w = 0; w < W; w++)
+                    dN_ji[w] = 0.0;
+                for (int k = 0; k < dim; k++)
+                {
+                    const double dN_ki = dN[k * nnodes + i];
+                    const double* invJ_jk = invJ + (j * dim + k) * W;
+                    for (int w = 0; w < W; w++)
+                        dN_ji[w] += invJ_jk[w] * dN_ki;
+                }
+            }
+    }
+    return -1;
+}
+
+void ElementBatch::getGeometry(const int lane, double* det,
+                               double* inv_jacobian, double* grad_shape_fct,
+                               double* jacobian) const
+{
+    const int dd = dim * dim;
+    for (int gp = 0; gp < n_gp; gp++)
+        det[gp] = determinants[gp * WIDTH + lane];
+    for (int k = 0; k < n_gp * dd; k++)
+        inv_jacobian[k] = inv_jacobians[k * WIDTH + lane];
+    for (int k = 0; k < n_gp * dim * nnodes; k++)
+        grad_shape_fct[k] = dshapefct[k * WIDTH + lane];
+    for (int k = 0; k < dd; k++)
+        jacobian[k] = jacobians[k * WIDTH + lane];
+}
+
+void ElementBatch::setCoefficients(const int lane, const int gp,
+                                   const double mass_fac,
+                                   const double laplace_fac,
+                                   const double* tensor)
+{
+    const int dd = dim * dim;
+    mass_factors[gp * WIDTH + lane] = mass_fac;
+    laplace_factors[gp * WIDTH + lane] = laplace_fac;
+    for (int k = 0; k < dd; k++)
+        tensors[(gp * dd + k) * WIDTH + lane] = tensor[k];
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Mass and Laplace matrices of all elements. The operations are
+         those of addShapeProduct() with the lower triangle only and of
+         addGradShapeProduct() in LocalAssemblyKernels.h.
+**************************************************************************/
+void ElementBatch::computeMatrices(const bool with_mass)
+{
+    const int W = WIDTH;
+    const int dd = dim * dim;
+    with_mass_matrix = with_mass;
+    // The coefficients of the unused lanes are zero
+    for (int lane = n_elements; lane < W; lane++)
+        for (int gp = 0; gp < n_gp; gp++)
+        {
+            mass_factors[gp * W + lane] = 0.0;
+            laplace_factors[gp * W + lane] = 0.0;
+        }
+    std::fill(mass.begin(), mass.end(), 0.0);
+    std::fill(laplace.begin(), laplace.end(), 0.0);
+
+    for (int gp = 0; gp < n_gp; gp++)
+    {
+        if (with_mass)
+        {
+            const double* N = shapefct + gp * nnodes;
+            const double* fac = &mass_factors[gp * W];
+            for (int i = 0; i < nnodes; i++)
+            {
+                double fac_i[WIDTH];
+                for (int w = 0; w < W; w++)
+                    fac_i[w] = fac[w] * N[i];
+                double* M_i = &mass[i * nnodes * W];
+                for (int j = 0; j <= i; j++)
+                    for (int w = 0; w < W; w++)
+                        M_i[j * W + w] += fac_i[w] * N[j];
+            }
+        }
+
+        const double* dN = &dshapefct[gp * dim * nnodes * W];
+        const double* K = &tensors[gp * dd * W];
+        const double* fac = &laplace_factors[gp * W];
+        for (int l = 0; l < dim; l++)
+            for (int i = 0; i < nnodes; i++)
+            {
+                double val[WIDTH] = {};
+                for (int k = 0; k < dim; k++)
+                {
+                    const double* dN_ki = dN + (k * nnodes + i) * W;
+                    const double* K_kl = K + (k * dim + l) * W;
+                    for (int w = 0; w < W; w++)
+                        val[w] += dN_ki[w] * K_kl[w];
+                }
+                double* KdN_li = &KdN[(l * nnodes + i) * W];
+                for (int w = 0; w < W; w++)
+                    KdN_li[w] = fac[w] * val[w];
+            }
+        for (int i = 0; i < nnodes; i++)
+            for (int j = 0; j < nnodes; j++)
+            {
+                double val[WIDTH] = {};
+                for (int l = 0; l < dim; l++)
+                {
+                    const double* KdN_li = &KdN[(l * nnodes + i) * W];
+                    const double* dN_lj = dN + (l * nnodes + j) * W;
+                    for (int w = 0; w < W; w++)
+                        val[w] += KdN_li[w] * dN_lj[w];
+                }
+                double* L_ij = &laplace[(i * nnodes + j) * W];
+                for (int w = 0; w < W; w++)
+                    L_ij[w] += val[w];
+            }
+    }
+
+    // Upper triangle of the mass matrices
+    if (with_mass)
+        for (int i = 0; i < nnodes; i++)
+            for (int j = 0; j < i; j++)
+                for (int w = 0; w < W; w++)
+                    mass[(j * nnodes + i) * W + w] =
+                        mass[(i * nnodes + j) * W + w];
+}
+
+void ElementBatch::getMatrix(const std::vector<double>& values,
+                             const int lane, double* M,
+                             const std::size_t ld) const
+{
+    for (int i = 0; i < nnodes; i++)
+        for (int j = 0; j < nnodes; j++)
+            M[i * ld + j] = values[(i * nnodes + j) * WIDTH + lane];
+}
+
+void ElementBatch::getMass(const int lane, double* M,
+                           const std::size_t ld) const
+{
+    getMatrix(mass, lane, M, ld);
+}
+
+void ElementBatch::getLaplace(const int lane, double* M,
+                              const std::size_t ld) const
+{
+    getMatrix(laplace, lane, M, ld);
+}
+}  // namespace FiniteElement
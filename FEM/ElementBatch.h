@@ -0,0 +1,157 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file ElementBatch.h
+ * Geometry and local matrices of a batch of elements of the same type, which
+ * are computed together in SIMD lanes.
+ */
+
+#ifndef OGS_ELEMENTBATCH_H
+#define OGS_ELEMENTBATCH_H
+
+#include <cstddef>
+#include <vector>
+
+#include "MSHEnums.h"
+
+namespace MeshLib
+{
+class CElem;
+}
+
+namespace FiniteElement
+{
+/// Number of elements of a batch, i.e. the doubles of a SIMD register
+#if defined(__AVX512F__)
+const int ELEMENT_BATCH_WIDTH = 8;
+#else
+const int ELEMENT_BATCH_WIDTH = 4;
+#endif
+
+/*!
+   \brief A batch of up to ELEMENT_BATCH_WIDTH linear elements of the same
+   type, whose element dimension is the space dimension.
+
+   The values are stored as structure of arrays: the values of one entry,
+   e.g. of a Jacobian or of a local matrix, of all elements of the batch
+   are contiguous. The loops over the elements of the batch are the
+   innermost ones with a compile time bound, so that the compiler
+   evaluates the elements in the lanes of SIMD registers.
+
+   The Jacobians, their inverses and the gradients of the shape functions
+   are computed for all integration points as in
+   CElement::ComputeGradShapefctInElement(). The coefficients of the mass
+   and Laplace matrices are set per element and integration point by
+   CFiniteElementStd, and the local matrices are summed up as by
+   LocalAssemblyKernels, with the same operations as the element by
+   element computation.
+ */
+class ElementBatch
+{
+public:
+    static const int WIDTH = ELEMENT_BATCH_WIDTH;
+
+    ElementBatch();
+
+    /*!
+       Start an empty batch.
+       \param shape_fct       Shape functions at all integration points
+                              (ShapeFunctionPool)
+       \param grad_shape_fct  Local gradients of the shape functions at all
+                              integration points (ShapeFunctionPool)
+     */
+    void reset(const MshElemType::type type, const int n_nodes,
+               const int dim, const int n_gauss_points,
+               const double* shape_fct, const double* grad_shape_fct);
+
+    MshElemType::type getElementType() const { return elem_type; }
+    int size() const { return n_elements; }
+    bool isFull() const { return n_elements == WIDTH; }
+    MeshLib::CElem* getElement(const int lane) const
+    {
+        return elements[lane];
+    }
+    /// Remove the elements, the type and the sizes are kept
+    void clear() { n_elements = 0; }
+
+    /// Add an element with its node coordinates
+    void addElement(MeshLib::CElem* elem);
+
+    /// Jacobians and gradients of the shape functions of all elements.
+    /// Returns the lane of an element with a singular Jacobian, or -1.
+    int computeGeometry();
+
+    /// Copy the values of an element in the layout of CElement: the
+    /// determinants, the inverse Jacobians and the gradients of the shape
+    /// functions of all integration points, and the Jacobian of the last
+    /// integration point
+    void getGeometry(const int lane, double* determinants,
+                     double* inv_jacobians, double* grad_shape_fct,
+                     double* jacobian) const;
+
+    /*!
+       Coefficients of an element at an integration point
+       \param mass_fac     Factor of N^T N including the integration weight
+       \param laplace_fac  Factor of dN^T K dN including the integration
+                           weight
+       \param tensor       K, a dim x dim row-major matrix
+     */
+    void setCoefficients(const int lane, const int gp, const double mass_fac,
+                         const double laplace_fac, const double* tensor);
+
+    /// Mass and Laplace matrices of all elements. The mass matrices only
+    /// if with_mass.
+    void computeMatrices(const bool with_mass);
+    bool hasMass() const { return with_mass_matrix; }
+
+    /// Copy the matrices of an element to row-major matrices with the
+    /// leading dimension ld
+    void getMass(const int lane, double* M, const std::size_t ld) const;
+    void getLaplace(const int lane, double* M, const std::size_t ld) const;
+
+private:
+    MshElemType::type elem_type;
+    int nnodes;
+    int dim;
+    int n_gp;
+    const double* shapefct;
+    const double* dshapefct_local;
+
+    int n_elements;
+    MeshLib::CElem* elements[WIDTH];
+    bool with_mass_matrix;
+
+    /// [(l * nnodes + i) * WIDTH + lane]: coordinate l of node i
+    std::vector<double> coordinates;
+    /// [gp * WIDTH + lane]
+    std::vector<double> determinants;
+    /// [(gp * dim * dim + kl) * WIDTH + lane]
+    std::vector<double> inv_jacobians;
+    /// [kl * WIDTH + lane], last integration point
+    std::vector<double> jacobians;
+    /// [((gp * dim + k) * nnodes + i) * WIDTH + lane]
+    std::vector<double> dshapefct;
+    /// [gp * WIDTH + lane]
+    std::vector<double> mass_factors;
+    /// [gp * WIDTH + lane]
+    std::vector<double> laplace_factors;
+    /// [(gp * dim * dim + kl) * WIDTH + lane]
+    std::vector<double> tensors;
+    /// [(i * nnodes + j) * WIDTH + lane]
+    std::vector<double> mass;
+    std::vector<double> laplace;
+    /// Buffer of K^T dN of an integration point
+    std::vector<double> KdN;
+
+    void getMatrix(const std::vector<double>& values, const int lane,
+                   double* M, const std::size_t ld) const;
+};
+}  // namespace FiniteElement
+#endif
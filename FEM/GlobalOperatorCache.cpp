@@ -0,0 +1,127 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file GlobalOperatorCache.cpp
+ * Global matrices of the terms of a linear process, which are assembled once
+ * and combined to the equation system of each time step.
+ */
+
+#include "GlobalOperatorCache.h"
+
+#include <cstring>
+
+#include "matrix_class.h"
+
+namespace Math_Group
+{
+GlobalOperatorCache::GlobalOperatorCache(const SparseTable& sparse_table,
+                                         const bool with_content)
+    : assembled_fingerprint(0),
+      valid(false),
+      assembling(false),
+      released(false),
+      n_assemblies(0)
+{
+    for (int k = 0; k < NUMBER_OF_TERMS; k++)
+        terms[k] = NULL;
+    terms[MASS] = new CSparseMatrix(sparse_table, 1);
+    terms[LAPLACE] = new CSparseMatrix(sparse_table, 1);
+    terms[ADVECTION] = new CSparseMatrix(sparse_table, 1);
+    if (with_content)
+        terms[CONTENT] = new CSparseMatrix(sparse_table, 1);
+}
+
+GlobalOperatorCache::~GlobalOperatorCache()
+{
+    for (int k = 0; k < NUMBER_OF_TERMS; k++)
+        delete terms[k];
+}
+
+void GlobalOperatorCache::reset(const unsigned long long fingerprint)
+{
+    for (int k = 0; k < NUMBER_OF_TERMS; k++)
+        if (terms[k])
+            (*terms[k]) = 0.;
+    assembled_fingerprint = fingerprint;
+    valid = false;
+    assembling = true;
+    n_assemblies++;
+}
+
+void GlobalOperatorCache::setAssembled()
+{
+    valid = assembling;
+    assembling = false;
+}
+
+void GlobalOperatorCache::release()
+{
+    for (int k = 0; k < NUMBER_OF_TERMS; k++)
+    {
+        delete terms[k];
+        terms[k] = NULL;
+    }
+    std::vector<double>().swap(work);
+    valid = assembling = false;
+    released = true;
+}
+
+void GlobalOperatorCache::combine(const double* fac, CSparseMatrix& A) const
+{
+    const CSparseMatrix* m[NUMBER_OF_TERMS];
+    double f[NUMBER_OF_TERMS];
+    int n = 0;
+    for (int k = 0; k < NUMBER_OF_TERMS; k++)
+    {
+        if (!terms[k] || fac[k] == 0.)
+            continue;
+        m[n] = terms[k];
+        f[n] = fac[k];
+        n++;
+    }
+    A.Combine(n, f, m);
+}
+
+void GlobalOperatorCache::apply(const double* lhs_fac, const double* rhs_fac,
+                                const double* u0, CSparseMatrix& A, double* b)
+{
+    const long dim = A.Dim();
+    work.resize(dim);
+    combine(rhs_fac, A);
+    A.multiVec(const_cast<double*>(u0), &work[0]);
+    for (long i = 0; i < dim; i++)
+        b[i] += work[i];
+    combine(lhs_fac, A);
+    n_assemblies = 0;
+}
+
+std::size_t GlobalOperatorCache::getMemory() const
+{
+    std::size_t memory = 0;
+    for (int k = 0; k < NUMBER_OF_TERMS; k++)
+        if (terms[k])
+            memory += terms[k]->NumberOfEntries() * sizeof(double);
+    return memory;
+}
+
+unsigned long long hashValues(const double* values, const std::size_t n,
+                              unsigned long long hash)
+{
+    const unsigned long long prime = 1099511628211ULL;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        unsigned long long word;
+        std::memcpy(&word, values + i, sizeof(word));
+        hash ^= word;
+        hash *= prime;
+    }
+    return hash;
+}
+}  // namespace Math_Group
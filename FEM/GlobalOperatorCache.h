@@ -0,0 +1,113 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file GlobalOperatorCache.h
+ * Global matrices of the terms of a linear process, which are assembled once
+ * and combined to the equation system of each time step.
+ */
+
+#ifndef OGS_GLOBALOPERATORCACHE_H
+#define OGS_GLOBALOPERATORCACHE_H
+
+#include <cstddef>
+#include <vector>
+
+namespace Math_Group
+{
+class CSparseMatrix;
+class SparseTable;
+
+/*!
+   \brief Global matrices of the terms of a linear process.
+
+   For the equation system
+      A = sum_k a_k T_k,   b = (sum_k c_k T_k) u^n
+   with the global mass, Laplace, advection and content matrices T_k, only
+   the factors a_k and c_k depend on the time step size and on theta. The
+   terms are assembled by one element loop, and in the following time
+   steps the system is formed from them without an element loop.
+
+   The terms are kept with a fingerprint of the coefficients that they
+   were assembled with. With another fingerprint they are invalid and
+   have to be assembled anew.
+ */
+class GlobalOperatorCache
+{
+public:
+    enum Term
+    {
+        MASS = 0,
+        LAPLACE,
+        /// Advection and first order terms, e.g. decay
+        ADVECTION,
+        /// Change of the content, right hand side only
+        CONTENT,
+        NUMBER_OF_TERMS
+    };
+
+    /// The content term is allocated only if with_content
+    GlobalOperatorCache(const SparseTable& sparse_table,
+                        const bool with_content);
+    ~GlobalOperatorCache();
+
+    /// Whether the terms were assembled with the coefficients of the
+    /// fingerprint
+    bool isValid(const unsigned long long fingerprint) const
+    {
+        return valid && fingerprint == assembled_fingerprint;
+    }
+    /// Whether the element loop adds to the terms
+    bool isAssembling() const { return assembling; }
+    /// Set the terms to zero for an element loop with the coefficients of
+    /// the fingerprint
+    void reset(const unsigned long long fingerprint);
+    /// The element loop is complete
+    void setAssembled();
+    /// Number of element loops since the terms were last used
+    int getNumberOfAssemblies() const { return n_assemblies; }
+    /// Free the terms for good, e.g. if the coefficients change in every
+    /// time step
+    void release();
+    bool isReleased() const { return released; }
+
+    /// Global matrix of a term, or NULL if it is not kept
+    CSparseMatrix* getTerm(const int term) const { return terms[term]; }
+
+    /*!
+       A = sum_k lhs_fac[k] T_k and b += (sum_k rhs_fac[k] T_k) u0. Each
+       sum is formed in one pass over the entries. The right hand side
+       operator is formed in A before the matrix, so that no further
+       matrix is needed.
+     */
+    void apply(const double* lhs_fac, const double* rhs_fac,
+               const double* u0, CSparseMatrix& A, double* b);
+
+    /// Memory of the terms in bytes
+    std::size_t getMemory() const;
+
+private:
+    CSparseMatrix* terms[NUMBER_OF_TERMS];
+    unsigned long long assembled_fingerprint;
+    bool valid;
+    bool assembling;
+    bool released;
+    int n_assemblies;
+    std::vector<double> work;
+
+    void combine(const double* fac, CSparseMatrix& A) const;
+};
+
+/// Hash of n values (FNV-1a over 64 bit words), continuing hash
+unsigned long long hashValues(const double* values, const std::size_t n,
+                              unsigned long long hash);
+/// Initial value of hashValues()
+const unsigned long long HASH_OFFSET_BASIS = 14695981039346656037ULL;
+}  // namespace Math_Group
+#endif
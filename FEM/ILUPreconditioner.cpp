@@ -0,0 +1,484 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file ILUPreconditioner.cpp
+ * Incomplete LU factorization, ILU(0) and ILUT, of the sparse matrix of the
+ * built-in linear solvers (NEW_EQS).
+ */
+
+#include "ILUPreconditioner.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <functional>
+#include <utility>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "matrix_class.h"
+
+namespace Math_Group
+{
+namespace
+{
+/// Order of the candidates for the ILUT dropping: largest magnitude first.
+struct LargerMagnitude
+{
+    bool operator()(const std::pair<double, long>& a,
+                    const std::pair<double, long>& b) const
+    {
+        return a.first > b.first;
+    }
+};
+
+/*!
+   Keep the entries of the list with a magnitude not smaller than tol, and
+   of them at most max_entries largest. The kept columns are sorted.
+ */
+void selectLargestEntries(const std::vector<long>& cols, const double* w,
+                          const double tol, const std::size_t max_entries,
+                          std::vector<long>& kept)
+{
+    std::vector<std::pair<double, long> > candidates;
+    candidates.reserve(cols.size());
+    for (std::size_t k = 0; k < cols.size(); k++)
+    {
+        const double val = std::fabs(w[cols[k]]);
+        if (val >= tol && val > 0.)
+            candidates.push_back(std::make_pair(val, cols[k]));
+    }
+    if (candidates.size() > max_entries)
+    {
+        std::nth_element(candidates.begin(),
+                         candidates.begin() + max_entries, candidates.end(),
+                         LargerMagnitude());
+        candidates.resize(max_entries);
+    }
+    kept.clear();
+    for (std::size_t k = 0; k < candidates.size(); k++)
+        kept.push_back(candidates[k].second);
+    std::sort(kept.begin(), kept.end());
+}
+
+/// Group the rows by level. level[i] must be known for all rows.
+void groupLevels(const std::vector<long>& level, const long n_levels,
+                 std::vector<long>& level_ptr, std::vector<long>& level_rows)
+{
+    const long n = static_cast<long>(level.size());
+    level_ptr.assign(n_levels + 1, 0);
+    for (long i = 0; i < n; i++)
+        level_ptr[level[i] + 1]++;
+    for (long l = 0; l < n_levels; l++)
+        level_ptr[l + 1] += level_ptr[l];
+    level_rows.resize(n);
+    std::vector<long> pos(level_ptr.begin(), level_ptr.end() - 1);
+    for (long i = 0; i < n; i++)
+        level_rows[pos[level[i]]++] = i;
+}
+}  // namespace
+
+ILUPreconditioner::ILUPreconditioner()
+    : drop_tolerance(0.), max_fill(-1), level_scheduling(false), dim(0),
+      dof(0), lu_has_fill(false)
+{
+}
+
+void ILUPreconditioner::Configure(const double drop_tol, const int n_fill,
+                                  const bool level_sched)
+{
+    drop_tolerance = drop_tol;
+    max_fill = n_fill;
+    level_scheduling = level_sched;
+}
+
+/*!
+   Point-wise pattern of the matrix. Only redone if the dimension or the
+   DOF of the matrix has changed, e.g. by a process with another number
+   of primary variables sharing the same equation system. A row without a
+   diagonal entry gets one with the value zero (a_entry_index -1), which
+   the factorization replaces like a vanishing pivot.
+ */
+void ILUPreconditioner::AnalysePattern(const CSparseMatrix& A)
+{
+    if (dim != A.Dim() || dof != A.Dof() || a_ptr.empty())
+    {
+        dim = A.Dim();
+        dof = A.Dof();
+        A.GetScalarCRSPattern(a_ptr, a_col, a_entry_index);
+
+        long n_missing = 0;
+        for (long i = 0; i < dim; i++)
+            if (!std::binary_search(a_col.begin() + a_ptr[i],
+                                    a_col.begin() + a_ptr[i + 1], i))
+                n_missing++;
+        if (n_missing > 0)
+        {
+            std::vector<long> ptr(dim + 1, 0), col, entry_index;
+            col.reserve(a_col.size() + n_missing);
+            entry_index.reserve(a_col.size() + n_missing);
+            for (long i = 0; i < dim; i++)
+            {
+                bool has_diag = false;
+                for (long k = a_ptr[i]; k < a_ptr[i + 1]; k++)
+                {
+                    if (!has_diag && a_col[k] >= i)
+                    {
+                        if (a_col[k] != i)
+                        {
+                            col.push_back(i);
+                            entry_index.push_back(-1);
+                        }
+                        has_diag = true;
+                    }
+                    col.push_back(a_col[k]);
+                    entry_index.push_back(a_entry_index[k]);
+                }
+                if (!has_diag)
+                {
+                    col.push_back(i);
+                    entry_index.push_back(-1);
+                }
+                ptr[i + 1] = static_cast<long>(col.size());
+            }
+            a_ptr.swap(ptr);
+            a_col.swap(col);
+            a_entry_index.swap(entry_index);
+        }
+        lu_has_fill = true;  // Force the factor pattern below
+    }
+    if (!lu_has_fill)
+        return;
+
+    // Without fill-in the factors have the pattern of the matrix. Also
+    // redone after an ILUT factorization, which has replaced it.
+    lu_ptr = a_ptr;
+    lu_col = a_col;
+    lu_diag.resize(dim);
+    for (long i = 0; i < dim; i++)
+        lu_diag[i] = std::lower_bound(a_col.begin() + a_ptr[i],
+                                      a_col.begin() + a_ptr[i + 1], i) -
+                     a_col.begin();
+    lu_has_fill = false;
+    lower_level_ptr.clear();
+    upper_level_ptr.clear();
+}
+
+void ILUPreconditioner::Factorize(const CSparseMatrix& A)
+{
+    const bool new_pattern =
+        (dim != A.Dim() || dof != A.Dof() || lu_has_fill);
+    AnalysePattern(A);
+    inv_diag.resize(dim);
+
+    if (isILUT())
+    {
+        FactorizeILUT(A.Entries());
+        // The pattern of the factors depends on the values
+        if (level_scheduling)
+            ComputeLevels();
+        return;
+    }
+
+    FactorizeILU0(A.Entries());
+    if (level_scheduling && (new_pattern || lower_level_ptr.empty()))
+        ComputeLevels();
+}
+
+/*!
+   Replace a (nearly) vanishing pivot. The same threshold as that of
+   the Jacobi preconditioner is used.
+ */
+void ILUPreconditioner::FixDiagonal(const long i, const double row_norm)
+{
+    double& diag = lu_val[lu_diag[i]];
+    if (std::fabs(diag) < DBL_MIN)
+        diag = (row_norm > DBL_MIN) ? row_norm : 1.0;
+    inv_diag[i] = 1.0 / diag;
+}
+
+/*!
+   ILU(0), IKJ variant, in place on a copy of the matrix values.
+ */
+void ILUPreconditioner::FactorizeILU0(const double* entry)
+{
+    const long nnz = static_cast<long>(a_col.size());
+    lu_val.resize(nnz);
+    for (long k = 0; k < nnz; k++)
+        lu_val[k] = (a_entry_index[k] < 0) ? 0. : entry[a_entry_index[k]];
+
+    // Position of the entries of the current row
+    std::vector<long> iw(dim, -1);
+    for (long i = 0; i < dim; i++)
+    {
+        const long row_begin = lu_ptr[i];
+        const long row_end = lu_ptr[i + 1];
+        double row_norm = 0.;
+        for (long k = row_begin; k < row_end; k++)
+        {
+            iw[lu_col[k]] = k;
+            row_norm = std::max(row_norm, std::fabs(lu_val[k]));
+        }
+
+        for (long k = row_begin; k < row_end; k++)
+        {
+            const long kc = lu_col[k];
+            if (kc >= i)
+                break;
+            // l_ik = a_ik / u_kk
+            const double l_ik = lu_val[k] * inv_diag[kc];
+            lu_val[k] = l_ik;
+            if (l_ik == 0.)
+                continue;
+            for (long m = lu_diag[kc] + 1; m < lu_ptr[kc + 1]; m++)
+            {
+                const long pos = iw[lu_col[m]];
+                if (pos != -1)
+                    lu_val[pos] -= l_ik * lu_val[m];
+            }
+        }
+        FixDiagonal(i, row_norm);
+
+        for (long k = row_begin; k < row_end; k++)
+            iw[lu_col[k]] = -1;
+    }
+}
+
+/*!
+   ILUT(tau, p) after Y. Saad, Iterative methods for sparse linear systems,
+   Algorithm 10.6.
+ */
+void ILUPreconditioner::FactorizeILUT(const double* entry)
+{
+    const std::size_t n_max =
+        static_cast<std::size_t>(std::max(max_fill, 0));
+    std::vector<double> w(dim, 0.);
+    std::vector<char> in_row(dim, 0);
+    std::vector<long> l_cols, u_cols, kept;
+
+    lu_has_fill = true;
+    lu_ptr.assign(dim + 1, 0);
+    lu_col.clear();
+    lu_val.clear();
+    lu_diag.assign(dim, -1);
+    lu_col.reserve(a_col.size() * 2);
+    lu_val.reserve(a_col.size() * 2);
+
+    for (long i = 0; i < dim; i++)
+    {
+        // Scatter row i of A
+        l_cols.clear();
+        u_cols.clear();
+        double row_norm = 0.;
+        for (long k = a_ptr[i]; k < a_ptr[i + 1]; k++)
+        {
+            const long j = a_col[k];
+            const double val =
+                (a_entry_index[k] < 0) ? 0. : entry[a_entry_index[k]];
+            w[j] = val;
+            in_row[j] = 1;
+            if (j < i)
+                l_cols.push_back(j);
+            else if (j > i)
+                u_cols.push_back(j);
+            row_norm += val * val;
+        }
+        if (!in_row[i])
+        {
+            w[i] = 0.;
+            in_row[i] = 1;
+        }
+        row_norm = std::sqrt(row_norm);
+        const double tol = drop_tolerance * row_norm;
+
+        // Eliminate the L part in ascending column order. Fill-in in the
+        // L part is appended to l_cols and found by the selection below.
+        for (std::size_t next = 0; next < l_cols.size(); next++)
+        {
+            std::size_t min_pos = next;
+            for (std::size_t m = next + 1; m < l_cols.size(); m++)
+                if (l_cols[m] < l_cols[min_pos])
+                    min_pos = m;
+            std::swap(l_cols[next], l_cols[min_pos]);
+            const long k = l_cols[next];
+
+            w[k] *= inv_diag[k];
+            if (std::fabs(w[k]) < tol)
+            {
+                w[k] = 0.;
+                continue;
+            }
+            const double l_ik = w[k];
+            for (long m = lu_diag[k] + 1; m < lu_ptr[k + 1]; m++)
+            {
+                const long j = lu_col[m];
+                if (!in_row[j])
+                {
+                    in_row[j] = 1;
+                    w[j] = 0.;
+                    if (j < i)
+                        l_cols.push_back(j);
+                    else
+                        u_cols.push_back(j);
+                }
+                w[j] -= l_ik * lu_val[m];
+            }
+        }
+
+        // Dropping and storage of row i
+        selectLargestEntries(l_cols, &w[0], tol, n_max, kept);
+        for (std::size_t k = 0; k < kept.size(); k++)
+        {
+            lu_col.push_back(kept[k]);
+            lu_val.push_back(w[kept[k]]);
+        }
+        lu_diag[i] = static_cast<long>(lu_col.size());
+        lu_col.push_back(i);
+        lu_val.push_back(w[i]);
+        selectLargestEntries(u_cols, &w[0], tol, n_max, kept);
+        for (std::size_t k = 0; k < kept.size(); k++)
+        {
+            lu_col.push_back(kept[k]);
+            lu_val.push_back(w[kept[k]]);
+        }
+        lu_ptr[i + 1] = static_cast<long>(lu_col.size());
+        FixDiagonal(i, row_norm);
+
+        // Reset the work arrays
+        for (std::size_t k = 0; k < l_cols.size(); k++)
+        {
+            w[l_cols[k]] = 0.;
+            in_row[l_cols[k]] = 0;
+        }
+        for (std::size_t k = 0; k < u_cols.size(); k++)
+        {
+            w[u_cols[k]] = 0.;
+            in_row[u_cols[k]] = 0;
+        }
+        w[i] = 0.;
+        in_row[i] = 0;
+    }
+}
+
+/*!
+   Level sets: a row of the forward (backward) substitution depends on
+   the rows of the columns of its L (U) part.
+ */
+void ILUPreconditioner::ComputeLevels()
+{
+    std::vector<long> level(dim, 0);
+    long n_levels = 0;
+    for (long i = 0; i < dim; i++)
+    {
+        long lev = 0;
+        for (long k = lu_ptr[i]; k < lu_diag[i]; k++)
+            lev = std::max(lev, level[lu_col[k]] + 1);
+        level[i] = lev;
+        n_levels = std::max(n_levels, lev + 1);
+    }
+    groupLevels(level, n_levels, lower_level_ptr, lower_level_rows);
+
+    n_levels = 0;
+    for (long i = dim - 1; i >= 0; i--)
+    {
+        long lev = 0;
+        for (long k = lu_diag[i] + 1; k < lu_ptr[i + 1]; k++)
+            lev = std::max(lev, level[lu_col[k]] + 1);
+        level[i] = lev;
+        n_levels = std::max(n_levels, lev + 1);
+    }
+    groupLevels(level, n_levels, upper_level_ptr, upper_level_rows);
+}
+
+/*!
+   Forward substitution with L (unit diagonal) and backward substitution
+   with U. The result of the level-scheduled variant is identical to that
+   of the sequential one.
+ */
+void ILUPreconditioner::Solve(const double* vec_s, double* vec_r) const
+{
+    if (!level_scheduling || lower_level_ptr.empty())
+    {
+        for (long i = 0; i < dim; i++)
+        {
+            double val = vec_s[i];
+            for (long k = lu_ptr[i]; k < lu_diag[i]; k++)
+                val -= lu_val[k] * vec_r[lu_col[k]];
+            vec_r[i] = val;
+        }
+        for (long i = dim - 1; i >= 0; i--)
+        {
+            double val = vec_r[i];
+            for (long k = lu_diag[i] + 1; k < lu_ptr[i + 1]; k++)
+                val -= lu_val[k] * vec_r[lu_col[k]];
+            vec_r[i] = val * inv_diag[i];
+        }
+        return;
+    }
+
+    const long n_lower = static_cast<long>(lower_level_ptr.size()) - 1;
+    for (long l = 0; l < n_lower; l++)
+    {
+        const long l_end = lower_level_ptr[l + 1];
+#ifdef _OPENMP
+#pragma omp parallel for if (l_end - lower_level_ptr[l] > 64)
+#endif
+        for (long m = lower_level_ptr[l]; m < l_end; m++)
+        {
+            const long i = lower_level_rows[m];
+            double val = vec_s[i];
+            for (long k = lu_ptr[i]; k < lu_diag[i]; k++)
+                val -= lu_val[k] * vec_r[lu_col[k]];
+            vec_r[i] = val;
+        }
+    }
+    const long n_upper = static_cast<long>(upper_level_ptr.size()) - 1;
+    for (long l = 0; l < n_upper; l++)
+    {
+        const long l_end = upper_level_ptr[l + 1];
+#ifdef _OPENMP
+#pragma omp parallel for if (l_end - upper_level_ptr[l] > 64)
+#endif
+        for (long m = upper_level_ptr[l]; m < l_end; m++)
+        {
+            const long i = upper_level_rows[m];
+            double val = vec_r[i];
+            for (long k = lu_diag[i] + 1; k < lu_ptr[i + 1]; k++)
+                val -= lu_val[k] * vec_r[lu_col[k]];
+            vec_r[i] = val * inv_diag[i];
+        }
+    }
+}
+
+/*!
+   (LU)^{-T}: U^T y = s by forward, and L^T r = y by backward
+   substitution, both column oriented.
+ */
+void ILUPreconditioner::TransSolve(const double* vec_s, double* vec_r) const
+{
+    for (long i = 0; i < dim; i++)
+        vec_r[i] = vec_s[i];
+    for (long i = 0; i < dim; i++)
+    {
+        vec_r[i] *= inv_diag[i];
+        const double val = vec_r[i];
+        for (long k = lu_diag[i] + 1; k < lu_ptr[i + 1]; k++)
+            vec_r[lu_col[k]] -= lu_val[k] * val;
+    }
+    for (long i = dim - 1; i >= 0; i--)
+    {
+        const double val = vec_r[i];
+        for (long k = lu_ptr[i]; k < lu_diag[i]; k++)
+            vec_r[lu_col[k]] -= lu_val[k] * val;
+    }
+}
+}  // namespace Math_Group
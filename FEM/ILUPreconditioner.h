@@ -0,0 +1,110 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file ILUPreconditioner.h
+ * Incomplete LU factorization, ILU(0) and ILUT, of the sparse matrix of the
+ * built-in linear solvers (NEW_EQS).
+ */
+
+#ifndef OGS_ILUPRECONDITIONER_H
+#define OGS_ILUPRECONDITIONER_H
+
+#include <vector>
+
+namespace Math_Group
+{
+class CSparseMatrix;
+
+/*!
+   \brief Incomplete LU factorization of a CSparseMatrix.
+
+   The factorization works on the point-wise compressed row pattern of
+   the whole matrix, i.e. on all DOF blocks, for both CRS and JDS storage.
+   The pattern analysis (row pattern, positions of the diagonal entries,
+   level sets) is done once for a matrix and a DOF, and it is reused by
+   all numerical factorizations until the DOF of the matrix changes.
+
+   - ILU(0): the factors keep the pattern of the matrix.
+   - ILUT(tau, p): the dual threshold variant of Saad. Entries smaller than
+     tau times the norm of the row are dropped, and at most p entries are
+     kept in each row of L and of U, respectively.
+
+   If level scheduling is switched on, the rows of both triangular factors
+   are grouped into levels of mutually independent rows, and the rows of
+   a level are solved in parallel (OpenMP).
+ */
+class ILUPreconditioner
+{
+public:
+    ILUPreconditioner();
+
+    /*!
+       \param drop_tolerance  Relative drop tolerance tau of ILUT.
+       \param max_fill        Maximum number of entries per row in L and U
+                              each. If max_fill < 0, ILU(0) is used.
+       \param level_scheduling Use level-scheduled triangular solves.
+     */
+    void Configure(const double drop_tolerance, const int max_fill,
+                   const bool level_scheduling);
+
+    /// Compute the factorization. The pattern analysis is reused if
+    /// possible.
+    void Factorize(const CSparseMatrix& A);
+
+    /// vec_r = (LU)^{-1} vec_s
+    void Solve(const double* vec_s, double* vec_r) const;
+    /// vec_r = (LU)^{-T} vec_s
+    void TransSolve(const double* vec_s, double* vec_r) const;
+
+    bool isILUT() const { return max_fill >= 0; }
+    long NumberOfEntries() const { return static_cast<long>(lu_col.size()); }
+    long NumberOfLevels() const
+    {
+        return static_cast<long>(lower_level_ptr.size()) - 1;
+    }
+
+private:
+    /// Configuration
+    double drop_tolerance;
+    int max_fill;
+    bool level_scheduling;
+
+    /// Analysed pattern of the matrix. Dimension and DOF identify it.
+    long dim;
+    int dof;
+    std::vector<long> a_ptr;
+    std::vector<long> a_col;
+    std::vector<long> a_entry_index;
+
+    /// The factors L (unit lower, without diagonal) and U in one compressed
+    /// row array. Each row holds its L part, the diagonal entry and its
+    /// U part with ascending columns.
+    std::vector<long> lu_ptr;
+    std::vector<long> lu_col;
+    std::vector<double> lu_val;
+    std::vector<long> lu_diag;
+    std::vector<double> inv_diag;
+    /// The factor pattern is that of ILUT, not the one of the matrix
+    bool lu_has_fill;
+
+    /// Level sets of the forward and backward substitutions.
+    std::vector<long> lower_level_ptr;
+    std::vector<long> lower_level_rows;
+    std::vector<long> upper_level_ptr;
+    std::vector<long> upper_level_rows;
+
+    void AnalysePattern(const CSparseMatrix& A);
+    void FactorizeILU0(const double* entry);
+    void FactorizeILUT(const double* entry);
+    void ComputeLevels();
+    void FixDiagonal(const long i, const double row_norm);
+};
+}  // namespace Math_Group
+#endif
@@ -0,0 +1,70 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file LocalAssemblyKernels.cpp
+ * Integration point kernels of the local matrices of CFiniteElementStd with
+ * the number of element nodes and the space dimension as template
+ * parameters.
+ */
+
+#include "LocalAssemblyKernels.h"
+
+#define OGS_LOCAL_KERNELS(N, D)                                     \
+    {                                                               \
+        &addShapeProduct<N>, &addGradShapeProduct<N, D>,            \
+            &addShapeGradProduct<N, D>                              \
+    }
+
+namespace FiniteElement
+{
+namespace
+{
+template <int NNODES>
+const LocalAssemblyKernels& getKernelsOfNodes(const int dim)
+{
+    static const LocalAssemblyKernels kernels[3] = {
+        OGS_LOCAL_KERNELS(NNODES, 1), OGS_LOCAL_KERNELS(NNODES, 2),
+        OGS_LOCAL_KERNELS(NNODES, 3)};
+    return kernels[dim - 1];
+}
+}  // namespace
+
+const LocalAssemblyKernels& getLocalAssemblyKernels(const int n,
+                                                    const int dim)
+{
+    static const LocalAssemblyKernels generic = OGS_LOCAL_KERNELS(0, 0);
+    if (dim < 1 || dim > 3)
+        return generic;
+
+    switch (n)
+    {
+        case 2:  // Line
+            return getKernelsOfNodes<2>(dim);
+        case 3:  // Triangle, quadratic line
+            return getKernelsOfNodes<3>(dim);
+        case 4:  // Quadrilateral, tetrahedron
+            return getKernelsOfNodes<4>(dim);
+        case 6:  // Prism, quadratic triangle
+            return getKernelsOfNodes<6>(dim);
+        case 8:  // Hexahedron, 8 node quadrilateral
+            return getKernelsOfNodes<8>(dim);
+        case 9:  // Quadratic quadrilateral
+            return getKernelsOfNodes<9>(dim);
+        case 10:  // Quadratic tetrahedron
+            return getKernelsOfNodes<10>(dim);
+        case 15:  // Quadratic prism
+            return getKernelsOfNodes<15>(dim);
+        case 20:  // Quadratic hexahedron
+            return getKernelsOfNodes<20>(dim);
+        default:
+            return generic;
+    }
+}
+}  // namespace FiniteElement
@@ -0,0 +1,154 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file LocalAssemblyKernels.h
+ * Integration point kernels of the local matrices of CFiniteElementStd with
+ * the number of element nodes and the space dimension as template
+ * parameters.
+ */
+
+#ifndef OGS_LOCALASSEMBLYKERNELS_H
+#define OGS_LOCALASSEMBLYKERNELS_H
+
+#include <cassert>
+#include <cstddef>
+
+namespace FiniteElement
+{
+/// Largest number of element nodes of the kernels, i.e. of a 20 node
+/// hexahedron.
+const int LOCAL_KERNEL_MAX_NODES = 20;
+
+/*!
+   Contribution of an integration point to a matrix of the type N^T N,
+   e.g. a mass matrix: M(i, j) += fac N_i N_j. Only j <= i if lower_only.
+
+   For NNODES > 0, the loops have compile time bounds and n is ignored.
+   NNODES = 0 is the generic kernel with n nodes. M is row-major with the
+   leading dimension ld.
+ */
+template <int NNODES>
+void addShapeProduct(const double fac, const double* N, const int n,
+                     double* M, const std::size_t ld, const bool lower_only)
+{
+    const int nn = (NNODES > 0) ? NNODES : n;
+    for (int i = 0; i < nn; i++)
+    {
+        const double fac_i = fac * N[i];
+        double* M_i = M + i * ld;
+        const int n_j = lower_only ? i + 1 : nn;
+        for (int j = 0; j < n_j; j++)
+            M_i[j] += fac_i * N[j];
+    }
+}
+
+/*!
+   Contribution of an integration point to a matrix of the type
+   dN^T K dN, e.g. a Laplace matrix:
+   M(i, j) += fac sum_kl dN(k, i) K(k, l) dN(l, j).
+
+   dN is the gradient of the shape functions with the rows of the
+   dimensions, K a DIM x DIM row-major matrix. fac K^T dN is formed once,
+   which saves the innermost loop of the direct summation.
+ */
+template <int NNODES, int DIM>
+void addGradShapeProduct(const double fac, const double* dN,
+                         const double* K, const int n, const int dim,
+                         double* M, const std::size_t ld)
+{
+    const int nn = (NNODES > 0) ? NNODES : n;
+    const int dd = (DIM > 0) ? DIM : dim;
+    assert(nn <= LOCAL_KERNEL_MAX_NODES && dd <= 3);
+
+    double KdN[3 * LOCAL_KERNEL_MAX_NODES];
+    for (int l = 0; l < dd; l++)
+        for (int i = 0; i < nn; i++)
+        {
+            double val = 0.0;
+            for (int k = 0; k < dd; k++)
+                val += dN[k * nn + i] * K[k * dd + l];
+            KdN[l * nn + i] = fac * val;
+        }
+
+    for (int i = 0; i < nn; i++)
+    {
+        double* M_i = M + i * ld;
+        for (int j = 0; j < nn; j++)
+        {
+            double val = 0.0;
+            for (int l = 0; l < dd; l++)
+                val += KdN[l * nn + i] * dN[l * nn + j];
+            M_i[j] += val;
+        }
+    }
+}
+
+/*!
+   Contribution of an integration point to a matrix of the type
+   N^T v dN, e.g. an advection matrix:
+   M(i, j) += fac N_i sum_k v_k dN(k, j).
+ */
+template <int NNODES, int DIM>
+void addShapeGradProduct(const double fac, const double* N, const double* v,
+                         const double* dN, const int n, const int dim,
+                         double* M, const std::size_t ld)
+{
+    const int nn = (NNODES > 0) ? NNODES : n;
+    const int dd = (DIM > 0) ? DIM : dim;
+    assert(nn <= LOCAL_KERNEL_MAX_NODES && dd <= 3);
+
+    double vdN[LOCAL_KERNEL_MAX_NODES];
+    for (int j = 0; j < nn; j++)
+    {
+        double val = 0.0;
+        for (int k = 0; k < dd; k++)
+            val += v[k] * dN[k * nn + j];
+        vdN[j] = val;
+    }
+
+    for (int i = 0; i < nn; i++)
+    {
+        const double fac_i = fac * N[i];
+        double* M_i = M + i * ld;
+        for (int j = 0; j < nn; j++)
+            M_i[j] += fac_i * vdN[j];
+    }
+}
+
+/*!
+   \brief The kernels for one number of element nodes and space dimension.
+
+   The kernels are selected once per element by getLocalAssemblyKernels()
+   and called at each integration point.
+ */
+struct LocalAssemblyKernels
+{
+    typedef void (*ShapeProduct)(const double, const double*, const int,
+                                 double*, const std::size_t, const bool);
+    typedef void (*GradShapeProduct)(const double, const double*,
+                                     const double*, const int, const int,
+                                     double*, const std::size_t);
+    typedef void (*ShapeGradProduct)(const double, const double*,
+                                     const double*, const double*, const int,
+                                     const int, double*, const std::size_t);
+
+    ShapeProduct shape_product;
+    GradShapeProduct grad_shape_product;
+    ShapeGradProduct shape_grad_product;
+};
+
+/// Kernels for elements with n nodes in a space of dimension dim. These
+/// are specialized for the node numbers of the linear and quadratic
+/// lines, triangles, quadrilaterals, tetrahedra, prisms and hexahedra,
+/// and generic otherwise.
+const LocalAssemblyKernels& getLocalAssemblyKernels(const int n,
+                                                    const int dim);
+}  // namespace FiniteElement
+#endif
@@ -0,0 +1,190 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file NodalVectorKernels.cpp
+ * Kernels over the node values of a primary variable and the solution vector
+ * of a process: norms of the increments of an iteration and the update of
+ * the node values.
+ */
+
+#include "NodalVectorKernels.h"
+
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace Math_Group
+{
+/// Number of independent partial sums of a block
+static const int NODAL_KERNEL_LANES = 4;
+
+/// Kinds of the increment norms
+enum IncrementKind
+{
+    /// d = x, without u
+    INCREMENT_ONLY,
+    /// d = x, with u
+    INCREMENT_AND_VALUES,
+    /// d = u - x
+    DIFFERENCE_TO_VALUES
+};
+
+template <int Kind>
+static inline double getIncrement(const double* u, const long* index,
+                                  const double* x, const long i, double& v)
+{
+    if (Kind == INCREMENT_ONLY)
+    {
+        v = 0.0;
+        return x[i];
+    }
+    v = u[index[i]];
+    if (Kind == INCREMENT_AND_VALUES)
+        return x[i];
+    return v - x[i];
+}
+
+template <int Kind>
+static void accumulateIncrementNorms(const double* u, const long* index,
+                                     const double* x, const long begin,
+                                     const long end, IncrementNorms& norms)
+{
+    double d_sq[NODAL_KERNEL_LANES], u_sq[NODAL_KERNEL_LANES],
+        d_max[NODAL_KERNEL_LANES];
+    for (int l = 0; l < NODAL_KERNEL_LANES; l++)
+        d_sq[l] = u_sq[l] = d_max[l] = 0.0;
+
+    long i = begin;
+    for (; i + NODAL_KERNEL_LANES <= end; i += NODAL_KERNEL_LANES)
+    {
+        for (int l = 0; l < NODAL_KERNEL_LANES; l++)
+        {
+            double v;
+            const double d = getIncrement<Kind>(u, index, x, i + l, v);
+            d_sq[l] += d * d;
+            u_sq[l] += v * v;
+            const double a = std::fabs(d);
+            d_max[l] = a > d_max[l] ? a : d_max[l];
+        }
+    }
+    for (; i < end; i++)
+    {
+        double v;
+        const double d = getIncrement<Kind>(u, index, x, i, v);
+        d_sq[0] += d * d;
+        u_sq[0] += v * v;
+        const double a = std::fabs(d);
+        d_max[0] = a > d_max[0] ? a : d_max[0];
+    }
+
+    norms.increment_sq = norms.value_sq = norms.increment_max = 0.0;
+    for (int l = 0; l < NODAL_KERNEL_LANES; l++)
+    {
+        norms.increment_sq += d_sq[l];
+        norms.value_sq += u_sq[l];
+        if (d_max[l] > norms.increment_max)
+            norms.increment_max = d_max[l];
+    }
+}
+
+template <int Kind>
+static IncrementNorms calcIncrementNorms(const double* u, const long* index,
+                                         const double* x, const long n)
+{
+    IncrementNorms norms;
+#ifdef _OPENMP
+    const int n_threads = omp_get_max_threads();
+    std::vector<IncrementNorms> partial(n_threads);
+#pragma omp parallel num_threads(n_threads)
+    {
+        const int t = omp_get_thread_num();
+        const int nt = omp_get_num_threads();
+        accumulateIncrementNorms<Kind>(u, index, x, n * t / nt,
+                                       n * (t + 1) / nt, partial[t]);
+    }
+    norms.increment_sq = norms.value_sq = norms.increment_max = 0.0;
+    for (int t = 0; t < n_threads; t++)
+    {
+        norms.increment_sq += partial[t].increment_sq;
+        norms.value_sq += partial[t].value_sq;
+        if (partial[t].increment_max > norms.increment_max)
+            norms.increment_max = partial[t].increment_max;
+    }
+#else
+    accumulateIncrementNorms<Kind>(u, index, x, 0, n, norms);
+#endif
+    return norms;
+}
+
+IncrementNorms CalcIncrementNorms(const double* u, const long* index,
+                                  const double* x, const long n,
+                                  const bool x_is_increment)
+{
+    if (u == NULL)
+        return calcIncrementNorms<INCREMENT_ONLY>(u, index, x, n);
+    if (x_is_increment)
+        return calcIncrementNorms<INCREMENT_AND_VALUES>(u, index, x, n);
+    return calcIncrementNorms<DIFFERENCE_TO_VALUES>(u, index, x, n);
+}
+
+void UpdateNodeValues(double* u, const long* index, double* x,
+                      const long n, const double theta,
+                      const bool x_is_increment)
+{
+    // The equations have distinct nodes, so that the threads write to
+    // distinct entries of u.
+    if (x_is_increment)
+    {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (long i = 0; i < n; i++)
+            u[index[i]] += theta * x[i];
+    }
+    else if (theta > 1.0 - DBL_EPSILON)
+    {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (long i = 0; i < n; i++)
+        {
+            const double u_k = u[index[i]];
+            u[index[i]] = x[i];
+            x[i] = u_k;
+        }
+    }
+    else
+    {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (long i = 0; i < n; i++)
+        {
+            const double u_k = u[index[i]];
+            u[index[i]] = (1.0 - theta) * u_k + theta * x[i];
+            x[i] = u_k;
+        }
+    }
+}
+
+void GatherNodeValues(const double* u, const long* index, double* x,
+                      const long n)
+{
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < n; i++)
+        x[i] = u[index[i]];
+}
+}  // namespace Math_Group
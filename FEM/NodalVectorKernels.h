@@ -0,0 +1,73 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file NodalVectorKernels.h
+ * Kernels over the node values of a primary variable and the solution vector
+ * of a process: norms of the increments of an iteration and the update of
+ * the node values.
+ */
+
+#ifndef OGS_NODALVECTORKERNELS_H
+#define OGS_NODALVECTORKERNELS_H
+
+namespace Math_Group
+{
+/*!
+   The kernels work on the array of the node values of a primary variable,
+   u (CRFProcess::nod_val_vector), and on the part of the solution vector x
+   of this variable. The value of the equation i is u[index[i]], with the
+   node index of the equation index (CFEMesh::Eqs2Global_NodeIndex).
+
+   The loops are split in blocks of the threads (OpenMP), and the sums of a
+   block are accumulated in several independent lanes, which the compiler
+   keeps in SIMD registers. The partial sums are added in a fixed order, so
+   that the results are reproducible for a given number of threads.
+ */
+
+/// Sums of the squares and the maximum of the absolute values
+struct IncrementNorms
+{
+    /// Sum of d_i^2 of the increments d
+    double increment_sq;
+    /// Sum of u_i^2 of the node values
+    double value_sq;
+    /// max |d_i|
+    double increment_max;
+};
+
+/*!
+   Norms of the increments of an iteration in one pass.
+   \param u               Node values, or NULL if only the norms of the
+                          increments x are needed
+   \param index           Node index of the equation index
+   \param x               Solution vector of the variable
+   \param n               Number of equations
+   \param x_is_increment  If true (Newton), the increment is x, otherwise
+                          it is u - x.
+ */
+IncrementNorms CalcIncrementNorms(const double* u, const long* index,
+                                  const double* x, const long n,
+                                  const bool x_is_increment);
+
+/*!
+   Update of the node values with the solution in one pass.
+   - x_is_increment (Newton): u += theta x.
+   - Otherwise (Picard): u = (1 - theta) u + theta x, and x gets the
+     previous values of u, e.g. for the time step control.
+ */
+void UpdateNodeValues(double* u, const long* index, double* x,
+                      const long n, const double theta,
+                      const bool x_is_increment);
+
+/// Copy the node values to the solution vector: x[i] = u[index[i]]
+void GatherNodeValues(const double* u, const long* index, double* x,
+                      const long n);
+}  // namespace Math_Group
+#endif
@@ -3493,6 +3493,7 @@ void COutput::ELEWritePLY_TECData(fstream& tec_file)
     std::vector<size_t> ele_vector_at_geo;
     m_msh->GetELEOnPLY(static_cast<const GEOLIB::Polyline*>(getGeoObj()),
                        ele_vector_at_geo, false);
+    m_msh->ConstructEdges();
 
     // helper variables
     Math_Group::vec<MeshLib::CEdge*> ele_edges_vector(15);
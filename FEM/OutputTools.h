@@ -126,7 +126,7 @@ inline double getElementMMP(int mmp_id, MeshLib::CElem* ele, CRFProcess* m_pcs)
 inline double getNodeMMP(int mmp_id, MeshLib::CFEMesh* m_msh,
                          MeshLib::CNode* node, CRFProcess* m_pcs)
 {
-    const std::vector<size_t>& connected_ele_ids =
+    MeshLib::NodeAdjacency const& connected_ele_ids =
         node->getConnectedElementIDs();
     double ele_avg = .0;
     for (long i_e = 0; i_e < (long)connected_ele_ids.size(); i_e++)
@@ -141,7 +141,7 @@ inline double getNodeMMP(int mmp_id, MeshLib::CFEMesh* m_msh,
 inline double getNodeElementValue(int ele_value_id, MeshLib::CFEMesh* m_msh,
                                   MeshLib::CNode* node, CRFProcess* m_pcs)
 {
-    const std::vector<size_t>& connected_ele_ids =
+    MeshLib::NodeAdjacency const& connected_ele_ids =
         node->getConnectedElementIDs();
     double ele_avg = .0;
     for (long i_e = 0; i_e < (long)connected_ele_ids.size(); i_e++)
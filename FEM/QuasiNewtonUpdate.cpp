@@ -0,0 +1,191 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file QuasiNewtonUpdate.cpp
+ * Low-rank quasi-Newton (BFGS and Broyden) updates of the inverse of a kept
+ * tangent matrix.
+ */
+
+#include "QuasiNewtonUpdate.h"
+
+#include <cmath>
+
+namespace Math_Group
+{
+/// Smallest relative value of y^T s (BFGS) or of s^T H y (Broyden) of an
+/// update
+static const double QUASI_NEWTON_MIN_DENOMINATOR = 1.0e-10;
+
+QuasiNewtonUpdate::QuasiNewtonUpdate(const int qn_method, const int updates)
+    : method(qn_method == BROYDEN ? BROYDEN : BFGS),
+      max_updates(updates > 0 ? updates : 1),
+      size(0),
+      n_updates(0),
+      S(max_updates),
+      Y(max_updates),
+      rho(max_updates),
+      alpha(max_updates),
+      step_damping(1.0),
+      has_step(false),
+      update_failed(false)
+{
+}
+
+void QuasiNewtonUpdate::reset()
+{
+    n_updates = 0;
+    has_step = false;
+    update_failed = false;
+}
+
+void QuasiNewtonUpdate::prepareRHS(double* b, const std::size_t n)
+{
+    if (n != size)
+    {
+        // New system size: no updates
+        size = n;
+        n_updates = 0;
+        has_step = false;
+        for (int i = 0; i < max_updates; i++)
+        {
+            S[i].resize(n);
+            Y[i].resize(n);
+        }
+        step.resize(n);
+        b_prev.resize(n);
+    }
+    update_failed = false;
+    b_present.assign(b, b + n);
+    if (method != BFGS)
+        return;
+
+    if (has_step)
+    {
+        // y = b_prev - b: change of the residual by the last step
+        if (n_updates < max_updates)
+        {
+            double* y = &Y[n_updates][0];
+            double ys = 0.0, yy = 0.0, ss = 0.0;
+            for (std::size_t l = 0; l < n; l++)
+            {
+                y[l] = b_prev[l] - b[l];
+                ys += y[l] * step[l];
+                yy += y[l] * y[l];
+                ss += step[l] * step[l];
+            }
+            if (ys > QUASI_NEWTON_MIN_DENOMINATOR * std::sqrt(yy * ss))
+            {
+                S[n_updates].swap(step);
+                step.resize(n);
+                rho[n_updates] = 1.0 / ys;
+                n_updates++;
+            }
+            else
+                update_failed = true;
+        }
+        else
+            update_failed = true;
+        has_step = false;
+    }
+
+    // First loop of the recursion
+    for (int i = n_updates - 1; i >= 0; i--)
+    {
+        const double* s_i = &S[i][0];
+        const double* y_i = &Y[i][0];
+        double a = 0.0;
+        for (std::size_t l = 0; l < n; l++)
+            a += s_i[l] * b[l];
+        a *= rho[i];
+        for (std::size_t l = 0; l < n; l++)
+            b[l] -= a * y_i[l];
+        alpha[i] = a;
+    }
+}
+
+bool QuasiNewtonUpdate::correctSolution(double* x, double* b)
+{
+    const std::size_t n = size;
+    for (std::size_t l = 0; l < n; l++)
+        b[l] = b_present[l];
+
+    if (method == BFGS)
+    {
+        // Second loop of the recursion
+        for (int i = 0; i < n_updates; i++)
+        {
+            const double* s_i = &S[i][0];
+            const double* y_i = &Y[i][0];
+            double beta = 0.0;
+            for (std::size_t l = 0; l < n; l++)
+                beta += y_i[l] * x[l];
+            beta *= rho[i];
+            const double c = alpha[i] - beta;
+            for (std::size_t l = 0; l < n; l++)
+                x[l] += c * s_i[l];
+        }
+    }
+    else
+    {
+        // z = H_k b
+        for (int i = 0; i < n_updates; i++)
+        {
+            const double* s_i = &S[i][0];
+            const double* a_i = &Y[i][0];
+            double sx = 0.0;
+            for (std::size_t l = 0; l < n; l++)
+                sx += s_i[l] * x[l];
+            for (std::size_t l = 0; l < n; l++)
+                x[l] += sx * a_i[l];
+        }
+        if (has_step)
+        {
+            // With the last step s = damping * H_k b_prev, H_k y is
+            // s / damping - z, and the update of the step is
+            //     a = (s - H_k y) / (s^T H_k y).
+            double ss = 0.0, sz = 0.0;
+            for (std::size_t l = 0; l < n; l++)
+            {
+                ss += step[l] * step[l];
+                sz += step[l] * x[l];
+            }
+            const double sHy = ss / step_damping - sz;
+            if (n_updates < max_updates &&
+                std::fabs(sHy) > QUASI_NEWTON_MIN_DENOMINATOR * ss /
+                                     step_damping)
+            {
+                double* a = &Y[n_updates][0];
+                const double c = 1.0 - 1.0 / step_damping;
+                for (std::size_t l = 0; l < n; l++)
+                    a[l] = (c * step[l] + x[l]) / sHy;
+                S[n_updates].swap(step);
+                step.resize(n);
+                n_updates++;
+                for (std::size_t l = 0; l < n; l++)
+                    x[l] += sz * a[l];
+            }
+            else
+                update_failed = true;
+            has_step = false;
+        }
+    }
+    b_prev.swap(b_present);
+    return !update_failed;
+}
+
+void QuasiNewtonUpdate::setStep(const double* x, const double damping)
+{
+    step.resize(size);
+    for (std::size_t l = 0; l < size; l++)
+        step[l] = damping * x[l];
+    step_damping = damping;
+    has_step = true;
+}
+}  // namespace Math_Group
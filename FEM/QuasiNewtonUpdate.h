@@ -0,0 +1,112 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file QuasiNewtonUpdate.h
+ * Low-rank quasi-Newton (BFGS and Broyden) updates of the inverse of a kept
+ * tangent matrix.
+ */
+
+#ifndef OGS_QUASINEWTONUPDATE_H
+#define OGS_QUASINEWTONUPDATE_H
+
+#include <cstddef>
+#include <vector>
+
+namespace Math_Group
+{
+/*!
+   \brief Quasi-Newton increments with the inverse H0 of a kept tangent.
+
+   The Newton system K dx = b with the residual -b is solved with the kept
+   tangent K0, i.e. by the kept factorization or preconditioner of the
+   linear solver. The inverse H0 = K0^-1 is updated by the steps s_i and
+   the differences y_i = b_i - b_{i+1} of the right hand sides:
+   - BFGS, for symmetric tangents, in the two-loop recursion of the last
+     updates (Matthies & Strang, 1979). The right hand side of the linear
+     solution is modified before it, and the solution after it. An update
+     with y_i^T s_i <= 0 is skipped.
+   - Broyden (good Broyden) for non-symmetric tangents in the product form
+     H_k = (I + a_{k-1} s_{k-1}^T) ... (I + a_0 s_0^T) H0, where a_i is
+     computed from the increment of the next iteration without a further
+     linear solution (Kelley, 1995).
+
+   One iteration:
+   - prepareRHS(b) before the linear solution,
+   - correctSolution(x, b) after it,
+   - setStep(x, damping) with the applied step.
+
+   A restart, reset(), is due after the number of updates has reached the
+   limit, after an ill-defined update, or if the residual grows. Then the
+   tangent is to be assembled and factorized again.
+ */
+class QuasiNewtonUpdate
+{
+public:
+    enum Method
+    {
+        BFGS = 1,
+        BROYDEN = 2
+    };
+
+    /// updates: maximum number of updates of H0
+    QuasiNewtonUpdate(const int qn_method, const int updates);
+
+    /// Clear the updates and the previous step, for a new tangent
+    void reset();
+
+    /*!
+       Called before the linear solution with the kept tangent.
+       \param b  Right hand side of the present iterate, overwritten with
+                 the right hand side of the solution (BFGS)
+       \param n  Size of b
+     */
+    void prepareRHS(double* b, const std::size_t n);
+
+    /*!
+       Called after the linear solution with the kept tangent.
+       \param x  Solution with the kept tangent, overwritten with the
+                 quasi-Newton increment
+       \param b  Gets the right hand side of prepareRHS() back
+       \return   False if the update of the last step is ill-defined
+     */
+    bool correctSolution(double* x, double* b);
+
+    /// The step applied to the iterate is damping * x
+    void setStep(const double* x, const double damping);
+
+    int getMethod() const { return method; }
+    int getMaxUpdates() const { return max_updates; }
+    /// Number of updates since reset()
+    int getNumberOfUpdates() const { return n_updates; }
+
+private:
+    int method;
+    int max_updates;
+    std::size_t size;
+    int n_updates;
+
+    /// Steps s_i, and y_i (BFGS) or a_i (Broyden)
+    std::vector<std::vector<double> > S;
+    std::vector<std::vector<double> > Y;
+    /// BFGS: 1 / (y_i^T s_i) and the coefficients of the first loop
+    std::vector<double> rho;
+    std::vector<double> alpha;
+
+    /// Last step and its damping, right hand sides of the previous and the
+    /// present iterate
+    std::vector<double> step;
+    double step_damping;
+    bool has_step;
+    std::vector<double> b_prev;
+    std::vector<double> b_present;
+    bool update_failed;
+};
+}  // namespace Math_Group
+#endif
@@ -14,14 +14,17 @@
 
 #include "ShapeFunctionPool.h"
 
+#include <algorithm>
 #include <cassert> /* assert */
 #include "fem_ele.h"
+#include "msh_elem.h"
 
 namespace FiniteElement
 {
 ShapeFunctionPool::ShapeFunctionPool(
     const std::vector<MshElemType::type>& elem_types, CElement& quadrature,
     const int num_sample_gs_pnts)
+    : _geometry_cache(NULL)
 {
     int num_elem_nodes[2][MshElemType::NUM_ELEM_TYPES];
     int dim_elem[MshElemType::NUM_ELEM_TYPES];
@@ -106,6 +109,17 @@ ShapeFunctionPool::ShapeFunctionPool(
                        num_sample_gs_pnts);
 }
 
+ShapeFunctionPool::~ShapeFunctionPool()
+{
+    delete _geometry_cache;
+}
+
+void ShapeFunctionPool::enableGeometryCache(const std::size_t memory_limit)
+{
+    delete _geometry_cache;
+    _geometry_cache = new ElementGeometryCache(memory_limit);
+}
+
 void ShapeFunctionPool::computeQuadratures(
     const std::vector<MshElemType::type>& elem_types,
     const int num_elem_nodes[2][MshElemType::NUM_ELEM_TYPES],
@@ -185,4 +199,78 @@ const double* ShapeFunctionPool::getGradShapeFunctionCenterValues(
     return _grad_shape_function_center[static_cast<int>(elem_type) - 1].data();
 }
 
+void ElementGeometryCache::clear()
+{
+    _order = 0;
+    _n_filled = 0;
+    _size = 0;
+    std::vector<Entry>().swap(_entries);
+    std::vector<double>().swap(_values);
+}
+
+bool ElementGeometryCache::reserve(const MeshLib::CElem* elem,
+                                   const int order, const int n_gauss_points,
+                                   const int global_dim,
+                                   const std::size_t size)
+{
+    const std::size_t index = static_cast<std::size_t>(elem->GetIndex());
+    const std::size_t n_entries = std::max(index + 1, _entries.size());
+    if (sizeof(Entry) * n_entries + sizeof(double) * (_size + size) >
+        _memory_limit)
+        return false;
+
+    if (_entries.size() < n_entries)
+    {
+        const Entry empty = {NULL, 0, 0, 0, false};
+        _entries.resize(n_entries, empty);
+    }
+    Entry& entry = _entries[index];
+    entry.element = elem;
+    entry.offset = _size;
+    entry.n_gauss_points = n_gauss_points;
+    entry.global_dim = global_dim;
+    entry.filled = false;
+    _order = order;
+    _size += size;
+    return true;
+}
+
+void ElementGeometryCache::allocate()
+{
+    _values.resize(_size);
+}
+
+double* ElementGeometryCache::getStorage(const MeshLib::CElem* elem)
+{
+    const std::size_t index = static_cast<std::size_t>(elem->GetIndex());
+    if (index >= _entries.size() || _entries[index].element != elem)
+        return NULL;
+    Entry& entry = _entries[index];
+    if (!entry.filled)
+        _n_filled++;
+    entry.filled = true;
+    return &_values[entry.offset];
+}
+
+const double* ElementGeometryCache::find(const MeshLib::CElem* elem,
+                                         const int order,
+                                         const int n_gauss_points,
+                                         const int global_dim) const
+{
+    const std::size_t index = static_cast<std::size_t>(elem->GetIndex());
+    if (order != _order || index >= _entries.size())
+        return NULL;
+    const Entry& entry = _entries[index];
+    if (!entry.filled || entry.element != elem ||
+        entry.n_gauss_points != n_gauss_points ||
+        entry.global_dim != global_dim)
+        return NULL;
+    return &_values[entry.offset];
+}
+
+std::size_t ElementGeometryCache::getMemory() const
+{
+    return sizeof(Entry) * _entries.size() + sizeof(double) * _values.size();
+}
+
 }  // namespace FiniteElement
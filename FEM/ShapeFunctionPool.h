@@ -14,14 +14,81 @@
 #ifndef OGS_SHAPEFUNCTIONPOOL_H
 #define OGS_SHAPEFUNCTIONPOOL_H
 
+#include <cstddef>
 #include <vector>
 
 #include "MSHEnums.h"
 
+namespace MeshLib
+{
+class CElem;
+}
+
 namespace FiniteElement
 {
 class CElement;
 
+/*!
+   \brief Determinants and inverses of the Jacobians and gradients of the
+   shape functions with respect to the global coordinates at the
+   integration points of the elements of a mesh, for one order of the
+   shape functions.
+
+   The values of all elements are in one contiguous array, found by the
+   element index. They are computed in a serial loop over the elements,
+   see CElement::cacheElementGeometry(), and only read afterwards, also
+   by the assemblers of the threads of a parallel assembly. Elements that
+   exceed the memory limit are not cached and computed as before.
+ */
+class ElementGeometryCache
+{
+public:
+    /// \param memory_limit  Memory limit in bytes.
+    explicit ElementGeometryCache(const std::size_t memory_limit)
+        : _memory_limit(memory_limit), _order(0), _n_filled(0), _size(0)
+    {
+    }
+
+    /// Remove all elements, e.g. after nodes were moved.
+    void clear();
+
+    /// Reserve \a size values for an element. False if the memory limit
+    /// is reached.
+    bool reserve(const MeshLib::CElem* elem, const int order,
+                 const int n_gauss_points, const int global_dim,
+                 const std::size_t size);
+    /// Allocate the values of all reserved elements.
+    void allocate();
+    /// Values of a reserved element to be filled. NULL if not reserved.
+    double* getStorage(const MeshLib::CElem* elem);
+
+    /// Values of a filled element, or NULL if the element is not cached
+    /// for this order and number of integration points.
+    const double* find(const MeshLib::CElem* elem, const int order,
+                       const int n_gauss_points, const int global_dim) const;
+
+    std::size_t getNumberOfElements() const { return _n_filled; }
+    std::size_t getMemory() const;
+
+private:
+    struct Entry
+    {
+        const MeshLib::CElem* element;
+        std::size_t offset;
+        int n_gauss_points;
+        int global_dim;
+        bool filled;
+    };
+
+    std::size_t _memory_limit;
+    int _order;
+    std::size_t _n_filled;
+    std::size_t _size;
+    /// Indexed by the element index.
+    std::vector<Entry> _entries;
+    std::vector<double> _values;
+};
+
 class ShapeFunctionPool
 {
 public:
@@ -32,7 +99,7 @@ public:
     */
     ShapeFunctionPool(const std::vector<MshElemType::type>& elem_types,
                       CElement& quadrature, const int num_sample_gs_pnts);
-    ~ShapeFunctionPool() {}
+    ~ShapeFunctionPool();
 
     /// Get shape function values of an element type
     const double* getShapeFunctionValues(
@@ -53,6 +120,12 @@ public:
     const double* getGradShapeFunctionCenterValues(
         const MshElemType::type elem_type) const;
 
+    /// Keep the geometry of the elements of the assembly in a cache.
+    /// \param memory_limit  Memory limit of the cache in bytes.
+    void enableGeometryCache(const std::size_t memory_limit);
+    /// The geometry cache, or NULL if it is not enabled.
+    ElementGeometryCache* getGeometryCache() const { return _geometry_cache; }
+
 private:
     /// Results of shape functions of all integration points.
     std::vector<std::vector<double> > _shape_function;
@@ -69,6 +142,8 @@ private:
     /// element centroid.
     std::vector<std::vector<double> > _grad_shape_function_center;
 
+    ElementGeometryCache* _geometry_cache;
+
     void computeQuadratures(
         const std::vector<MshElemType::type>& elem_types,
         const int num_elem_nodes[2][MshElemType::NUM_ELEM_TYPES],
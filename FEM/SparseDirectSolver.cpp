@@ -0,0 +1,163 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file SparseDirectSolver.cpp
+ * Sparse direct solution of the linear equations of the built-in solvers
+ * (NEW_EQS) with the bundled Eigen.
+ */
+
+#include "SparseDirectSolver.h"
+
+#include <algorithm>
+
+#include "matrix_class.h"
+
+namespace Math_Group
+{
+/*!
+   Compressed column copy of the point-wise pattern of A. The rows of each
+   column are ascending, as the rows of the compressed row pattern are
+   visited in ascending order.
+ */
+void SparseDirectSolver::BuildPattern(const CSparseMatrix& A)
+{
+    std::vector<long> ptr, col, entry_index;
+    A.GetScalarCRSPattern(ptr, col, entry_index);
+    dim = A.Dim();
+    dof = A.Dof();
+    const long nnz = static_cast<long>(col.size());
+
+    matrix.resize(dim, dim);
+    matrix.resizeNonZeros(nnz);
+    int* const outer = matrix.outerIndexPtr();
+    int* const inner = matrix.innerIndexPtr();
+    std::vector<long> next(dim + 1, 0);
+    for (long k = 0; k < nnz; k++)
+        next[col[k] + 1]++;
+    for (long j = 0; j < dim; j++)
+        next[j + 1] += next[j];
+    for (long j = 0; j <= dim; j++)
+        outer[j] = static_cast<int>(next[j]);
+
+    value_index.resize(nnz);
+    if (method == LDLT)
+        values.resize(nnz);
+    for (long i = 0; i < dim; i++)
+        for (long k = ptr[i]; k < ptr[i + 1]; k++)
+        {
+            const long pos = next[col[k]]++;
+            inner[pos] = static_cast<int>(i);
+            value_index[pos] = entry_index[k];
+        }
+    analyzed = false;
+    factorized = false;
+}
+
+/*!
+   Copy of values to the matrix without the columns of the unknowns whose
+   rows only have a diagonal entry.
+ */
+void SparseDirectSolver::RemoveKnownColumns()
+{
+    const int* const outer = matrix.outerIndexPtr();
+    const int* const inner = matrix.innerIndexPtr();
+    double* const value = matrix.valuePtr();
+    std::copy(values.begin(), values.end(), value);
+
+    std::vector<char> known(dim, 1);
+    std::vector<double> diagonal(dim, 0.);
+    for (long j = 0; j < dim; j++)
+        for (long k = outer[j]; k < outer[j + 1]; k++)
+        {
+            if (inner[k] == j)
+                diagonal[j] = value[k];
+            else if (value[k] != 0.)
+                known[inner[k]] = 0;
+        }
+
+    removed_row.clear();
+    removed_column.clear();
+    removed_factor.clear();
+    for (long j = 0; j < dim; j++)
+    {
+        if (!known[j] || diagonal[j] == 0.)
+            continue;
+        for (long k = outer[j]; k < outer[j + 1]; k++)
+        {
+            if (inner[k] == j || value[k] == 0.)
+                continue;
+            removed_row.push_back(inner[k]);
+            removed_column.push_back(j);
+            removed_factor.push_back(value[k] / diagonal[j]);
+            value[k] = 0.;
+        }
+    }
+}
+
+SparseDirectSolver::Status SparseDirectSolver::Factorize(
+    const CSparseMatrix& A)
+{
+    const bool new_pattern = (dim != A.Dim() || dof != A.Dof() || !analyzed);
+    if (new_pattern)
+        BuildPattern(A);
+
+    const double* entry = A.Entries();
+    double* const value = (method == LU) ? matrix.valuePtr() : &values[0];
+    const long nnz = static_cast<long>(value_index.size());
+    if (factorized)
+    {
+        long k = 0;
+        while (k < nnz && value[k] == entry[value_index[k]])
+            k++;
+        if (k == nnz)
+            return REUSED;
+    }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long k = 0; k < nnz; k++)
+        value[k] = entry[value_index[k]];
+    if (method == LDLT)
+        RemoveKnownColumns();
+
+    if (method == LU)
+    {
+        if (new_pattern)
+            lu.analyzePattern(matrix);
+        lu.factorize(matrix);
+        factorized = (lu.info() == Eigen::Success);
+    }
+    else
+    {
+        if (new_pattern)
+            ldlt.analyzePattern(matrix);
+        ldlt.factorize(matrix);
+        factorized = (ldlt.info() == Eigen::Success);
+    }
+    analyzed = true;
+    if (!factorized)
+        return FAILED;
+    return new_pattern ? ANALYZED_AND_FACTORIZED : FACTORIZED;
+}
+
+void SparseDirectSolver::Solve(const double* b, double* x)
+{
+    VectorMap solution(x, dim);
+    if (method == LU)
+    {
+        solution = lu.solve(ConstVectorMap(b, dim));
+        return;
+    }
+    Eigen::VectorXd rhs = ConstVectorMap(b, dim);
+    for (std::size_t k = 0; k < removed_row.size(); k++)
+        rhs[removed_row[k]] -= removed_factor[k] * b[removed_column[k]];
+    solution = ldlt.solve(rhs);
+}
+}  // namespace Math_Group
@@ -0,0 +1,102 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file SparseDirectSolver.h
+ * Sparse direct solution of the linear equations of the built-in solvers
+ * (NEW_EQS) with the bundled Eigen.
+ */
+
+#ifndef OGS_SPARSEDIRECTSOLVER_H
+#define OGS_SPARSEDIRECTSOLVER_H
+
+#include <vector>
+
+#include "Eigen/Sparse"
+
+namespace Math_Group
+{
+class CSparseMatrix;
+
+/*!
+   \brief Sparse LU (COLAMD ordering) or LDLT (AMD ordering) factorization of
+   a CSparseMatrix.
+
+   The compressed column copy of the matrix and the symbolic analysis are
+   built once for the pattern of the matrix, i.e. of its SparseTable and
+   DOF. A factorization only copies the current values. It is skipped if the
+   values are those of the last factorization, e.g. for linear problems with
+   a constant time step.
+
+   Dirichlet conditions only clear the row of a known unknown, see
+   CSparseMatrix::Diagonize(). For LDLT, the column of such an unknown is
+   therefore moved to the right hand side, which keeps the matrix
+   symmetric.
+ */
+class SparseDirectSolver
+{
+public:
+    enum Method
+    {
+        LU,
+        /// Only for symmetric matrices
+        LDLT
+    };
+    /// What the last Factorize() has done
+    enum Status
+    {
+        ANALYZED_AND_FACTORIZED,
+        FACTORIZED,
+        REUSED,
+        FAILED
+    };
+
+    explicit SparseDirectSolver(const Method m)
+        : method(m), dim(0), dof(0), analyzed(false), factorized(false)
+    {
+    }
+    Method GetMethod() const { return method; }
+
+    Status Factorize(const CSparseMatrix& A);
+    /// x = A^{-1} b with the last factorization
+    void Solve(const double* b, double* x);
+
+private:
+    typedef Eigen::SparseMatrix<double, Eigen::ColMajor, int> EigenMatrix;
+    typedef Eigen::Map<const Eigen::VectorXd> ConstVectorMap;
+    typedef Eigen::Map<Eigen::VectorXd> VectorMap;
+
+    Method method;
+
+    /// Pattern of the matrix. Dimension and DOF identify it.
+    long dim;
+    int dof;
+    bool analyzed;
+    bool factorized;
+    EigenMatrix matrix;
+    /// Index in CSparseMatrix::Entries() of each value of matrix
+    std::vector<long> value_index;
+    /// Values of the last factorization before the columns of the known
+    /// unknowns were removed (LDLT only)
+    std::vector<double> values;
+    /// Removed entries a_ij / a_jj of the columns j of the known unknowns
+    /// (LDLT only)
+    std::vector<long> removed_row;
+    std::vector<long> removed_column;
+    std::vector<double> removed_factor;
+
+    Eigen::SparseLU<EigenMatrix, Eigen::COLAMDOrdering<int> > lu;
+    Eigen::SimplicialLDLT<EigenMatrix, Eigen::Lower, Eigen::AMDOrdering<int> >
+        ldlt;
+
+    void BuildPattern(const CSparseMatrix& A);
+    void RemoveKnownColumns();
+};
+}  // namespace Math_Group
+#endif
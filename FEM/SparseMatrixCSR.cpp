@@ -0,0 +1,119 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file SparseMatrixCSR.cpp
+ * Sparse matrix with the node connectivity pattern of a mesh in compressed
+ * row storage, e.g. for the flux-corrected transport.
+ */
+
+#include "SparseMatrixCSR.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "matrix_class.h"
+#include "msh_mesh.h"
+
+namespace Math_Group
+{
+SparseMatrixCSR::SparseMatrixCSR(const MeshLib::CFEMesh& mesh)
+    : dummy_zero(0.)
+{
+    const long n = static_cast<long>(mesh.GetNodesNumber(false));
+    row_ptr.assign(n + 1, 0);
+    for (long i = 0; i < n; i++)
+    {
+        MeshLib::NodeAdjacency const& connected =
+            mesh.nod_vector[i]->getConnectedNodes();
+        for (std::size_t k = 0; k < connected.size(); k++)
+            if (static_cast<long>(connected[k]) < n)
+                col_idx.push_back(static_cast<long>(connected[k]));
+        std::sort(col_idx.begin() + row_ptr[i], col_idx.end());
+        col_idx.erase(std::unique(col_idx.begin() + row_ptr[i], col_idx.end()),
+                      col_idx.end());
+        row_ptr[i + 1] = static_cast<long>(col_idx.size());
+    }
+    SetupTransposed();
+}
+
+SparseMatrixCSR::SparseMatrixCSR(const CSparseMatrix& A,
+                                 const std::vector<long>& eqs_index)
+    : dummy_zero(0.)
+{
+    std::vector<long> ptr, col, entry;
+    A.GetScalarCRSPattern(ptr, col, entry);
+    // Node of each equation of the first DOF
+    const long n_eqs = A.Size();
+    const long n = static_cast<long>(eqs_index.size());
+    std::vector<long> node(n_eqs, -1);
+    for (long i = 0; i < n; i++)
+        node[eqs_index[i]] = i;
+
+    row_ptr.assign(n + 1, 0);
+    // (column, position in the matrix) of a row
+    std::vector<std::pair<long, long> > row;
+    for (long i = 0; i < n; i++)
+    {
+        const long r = eqs_index[i];
+        row.clear();
+        for (long k = ptr[r]; k < ptr[r + 1]; k++)
+            if (col[k] < n_eqs && node[col[k]] >= 0)
+                row.push_back(std::make_pair(node[col[k]], entry[k]));
+        std::sort(row.begin(), row.end());
+        for (std::size_t k = 0; k < row.size(); k++)
+        {
+            col_idx.push_back(row[k].first);
+            matrix_entry.push_back(row[k].second);
+        }
+        row_ptr[i + 1] = static_cast<long>(col_idx.size());
+    }
+    SetupTransposed();
+}
+
+void SparseMatrixCSR::SetupTransposed()
+{
+    const long n = Rows();
+    transposed.resize(col_idx.size());
+    for (long i = 0; i < n; i++)
+        for (long k = row_ptr[i]; k < row_ptr[i + 1]; k++)
+            transposed[k] = Find(col_idx[k], i);
+    values.assign(col_idx.size(), 0.);
+}
+
+long SparseMatrixCSR::Find(const long i, const long j) const
+{
+    const std::vector<long>::const_iterator begin =
+        col_idx.begin() + row_ptr[i];
+    const std::vector<long>::const_iterator end =
+        col_idx.begin() + row_ptr[i + 1];
+    const std::vector<long>::const_iterator it =
+        std::lower_bound(begin, end, j);
+    if (it == end || *it != j)
+        return -1;
+    return static_cast<long>(it - col_idx.begin());
+}
+
+double& SparseMatrixCSR::operator()(const long i, const long j)
+{
+    const long k = Find(i, j);
+    if (k < 0)
+    {
+        dummy_zero = 0.;
+        return dummy_zero;
+    }
+    return values[k];
+}
+
+SparseMatrixCSR& SparseMatrixCSR::operator=(const double a)
+{
+    std::fill(values.begin(), values.end(), a);
+    return *this;
+}
+}  // namespace Math_Group
@@ -0,0 +1,80 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file SparseMatrixCSR.h
+ * Sparse matrix with the node connectivity pattern of a mesh in compressed
+ * row storage, e.g. for the flux-corrected transport.
+ */
+
+#ifndef OGS_SPARSEMATRIXCSR_H
+#define OGS_SPARSEMATRIXCSR_H
+
+#include <vector>
+
+namespace MeshLib
+{
+class CFEMesh;
+}
+
+namespace Math_Group
+{
+class CSparseMatrix;
+
+/*!
+   \brief Matrix over the nodes of the linear elements of a mesh, with an
+   entry for each pair of connected nodes. These are the entries of the
+   sparse table of the linear equations, but in node numbering.
+
+   The pattern is fixed. The columns of each row are ascending, and the
+   position of the transposed entry is stored with each entry, so that
+   the symmetric pair (i, j), (j, i) is updated without a search.
+ */
+class SparseMatrixCSR
+{
+public:
+    /// Pattern of the nodes connected to the nodes of the mesh
+    explicit SparseMatrixCSR(const MeshLib::CFEMesh& mesh);
+    /// Pattern of the sparse table of a matrix of the linear equations,
+    /// with the equation eqs_index[i] of node i as row i. The positions of
+    /// the entries in the value array of the matrix are kept.
+    SparseMatrixCSR(const CSparseMatrix& A, const std::vector<long>& eqs_index);
+
+    long Rows() const { return static_cast<long>(row_ptr.size()) - 1; }
+    /// Entries of row i are [RowBegin(i), RowEnd(i))
+    long RowBegin(const long i) const { return row_ptr[i]; }
+    long RowEnd(const long i) const { return row_ptr[i + 1]; }
+    long Column(const long k) const { return col_idx[k]; }
+    /// Position of the entry (j, i) of the entry k = (i, j)
+    long Transposed(const long k) const { return transposed[k]; }
+    /// Position of the entry k in the values of the matrix of the linear
+    /// equations, if the pattern was built from it
+    long MatrixEntry(const long k) const { return matrix_entry[k]; }
+    double& Value(const long k) { return values[k]; }
+    double Value(const long k) const { return values[k]; }
+
+    /// Position of the entry (i, j), or -1 if it is not in the pattern
+    long Find(const long i, const long j) const;
+    /// Entry (i, j). Entries outside the pattern are a dummy zero.
+    double& operator()(const long i, const long j);
+
+    SparseMatrixCSR& operator=(const double a);
+
+private:
+    void SetupTransposed();
+
+    std::vector<long> row_ptr;
+    std::vector<long> col_idx;
+    std::vector<long> transposed;
+    std::vector<long> matrix_entry;
+    std::vector<double> values;
+    double dummy_zero;
+};
+}  // namespace Math_Group
+#endif
@@ -0,0 +1,92 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file ThreadPrivate.h
+ * A value with one copy for each OpenMP thread.
+ */
+
+#ifndef OGS_THREADPRIVATE_H
+#define OGS_THREADPRIVATE_H
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/// Maximum number of threads that may access a ThreadPrivate value.
+#ifdef _OPENMP
+#define OGS_MAX_THREADS 64
+#else
+#define OGS_MAX_THREADS 1
+#endif
+
+/// Index of the calling thread in a ThreadPrivate value.
+inline int ThreadPrivateIndex()
+{
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+/*!
+   \brief Member of a shared object that is used as scratch by the thread
+   calling a method of the object, e.g. the pointer to the current element of
+   a material property.
+
+   Each thread reads and writes its own copy. Outside of a parallel region
+   this is the copy of the master thread, so that serial code uses the
+   member as before.
+ */
+template <typename T>
+class ThreadPrivate
+{
+public:
+    ThreadPrivate() { setAll(T()); }
+    explicit ThreadPrivate(const T& value) { *this = value; }
+    ThreadPrivate& operator=(const T& value)
+    {
+        values[ThreadPrivateIndex()] = value;
+        return *this;
+    }
+    /// Assign the value to the copies of all threads.
+    void setAll(const T& value)
+    {
+        for (int i = 0; i < OGS_MAX_THREADS; i++)
+            values[i] = value;
+    }
+
+    operator T&() { return values[ThreadPrivateIndex()]; }
+    operator const T&() const { return values[ThreadPrivateIndex()]; }
+    T operator->() const { return values[ThreadPrivateIndex()]; }
+
+private:
+    T values[OGS_MAX_THREADS];
+};
+
+/// Array member with one copy for each thread, see ThreadPrivate.
+template <typename T, int N>
+class ThreadPrivateArray
+{
+public:
+    ThreadPrivateArray()
+    {
+        for (int i = 0; i < OGS_MAX_THREADS; i++)
+            for (int j = 0; j < N; j++)
+                values[i][j] = T();
+    }
+    operator T*() { return values[ThreadPrivateIndex()]; }
+    operator const T*() const { return values[ThreadPrivateIndex()]; }
+
+private:
+    T values[OGS_MAX_THREADS][N];
+};
+
+#endif
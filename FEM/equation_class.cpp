@@ -66,6 +66,7 @@ extern int PARDISO(int*, int*, int*, int*, int*, int*, double*, int*, int*,
 
 #include "equation_class.h"
 #include "matrix_class.h"
+#include "SparseDirectSolver.h"
 #include "rf_num_new.h"
 #ifdef JFNK_H2M
 #include "rf_pcs.h"
@@ -112,6 +113,16 @@ Linear_EQS::Linear_EQS(const SparseTable& sparse_table,
 #endif
 
     prec_M = NULL;
+    ilut_drop_tolerance = 0.;
+    ilut_max_fill = -1;
+    ilu_level_scheduling = false;
+    precond_num = NULL;
+    precond_reuse_num = NULL;
+    precond_operator = NULL;
+    precond_operator_version = 0;
+    kept_operator = NULL;
+    kept_operator_version = 0;
+    config_num = NULL;
 
 #if defined(USE_MPI)
     x = NULL;
@@ -152,6 +163,13 @@ Linear_EQS::Linear_EQS(const long size)
     A = NULL;
     b = NULL;
     size_global = size;
+    precond_num = NULL;
+    precond_reuse_num = NULL;
+    precond_operator = NULL;
+    precond_operator_version = 0;
+    kept_operator = NULL;
+    kept_operator_version = 0;
+    config_num = NULL;
     x = new double[size];
     //
     for (long i = 0; i < size; i++)
@@ -194,10 +212,18 @@ void Linear_EQS::ConfigNumerics(CNumerics* m_num, const long n)
     int nbuffer = 0;  // Number of temperary float arrays
     precond_type = m_num->ls_precond;
     solver_type = m_num->ls_method;
+    config_num = m_num;
+    precond_reuse_num = NULL;
+    if (m_num->shared_transport_operator > 0 ||
+        m_num->newton_jacobian_reuse > 0 || m_num->quasi_newton_method > 0)
+        precond_reuse_num = m_num;
     switch (solver_type)
     {
         case 1:
-            solver_name = "Gauss";
+            // Sparse direct solvers
+            solver_name = "Gauss (sparse LU)";
+            nbuffer = 1;
+            precond_type = -1;
             break;
         case 2:
             solver_name = "BiCGSTab";
@@ -231,10 +257,15 @@ void Linear_EQS::ConfigNumerics(CNumerics* m_num, const long n)
             solver_name = "SOR";
             break;
         case 11:
-            solver_name = "AMG1R5";
+            // Smoothed aggregation AMG as stand-alone solver
+            solver_name = "AMG";
+            nbuffer = 2;
+            precond_type = 102;
             break;
         case 12:
-            solver_name = "UMF";
+            solver_name = "UMF (sparse LU)";
+            nbuffer = 1;
+            precond_type = -1;
             break;
         case 13:  // 06.2010. WW
             solver_name = "GMRES";
@@ -247,6 +278,11 @@ void Linear_EQS::ConfigNumerics(CNumerics* m_num, const long n)
             H.resize(m_gmres + 1, m_gmres + 1);
             nbuffer = m_gmres + 4;
             break;
+        case 14:
+            solver_name = "Sparse LDLT";
+            nbuffer = 1;
+            precond_type = -1;
+            break;
     }
     // Buffer
     /*
@@ -292,20 +328,71 @@ void Linear_EQS::ConfigNumerics(CNumerics* m_num, const long n)
 #endif
 #endif
             break;
-        case 100:
-            // precond_name = "ILU"; break;
-            // If ILU is ready, remove follows
-            // ----------------------------------------------
+        case 100:  // ILU(0)
+        case 101:  // ILUT
+            ilut_drop_tolerance = m_num->ls_ilut_drop_tolerance;
+            ilut_max_fill =
+                (precond_type == 101) ? m_num->ls_ilut_max_fill : -1;
+            ilu_level_scheduling = m_num->ls_ilu_level_scheduling;
+            precond_name = (precond_type == 101) ? "ILUT" : "ILU(0)";
+#if defined(USE_MPI)
+            // Only the Jacobi preconditioner handles the subdomain borders
             precond_name = "ILU not available. Use Jacobi";
             precond_type = 1;
-#ifndef JFNK_H2M
+            prec_M = new double[size_A];
+#else
+#ifdef JFNK_H2M
+            // No matrix is assembled for JFNK
             if (m_num->nls_method == 2)
+            {
+                precond_name = "ILU not available. Use Jacobi";
+                precond_type = 1;
                 prec_M = new double[size_A];
+            }
+#endif
 #endif
+            break;
+        case 102:  // AMG
+            amg_parameters.cycle = m_num->ls_amg_cycle;
+            amg_parameters.strength_threshold =
+                m_num->ls_amg_strength_threshold;
+            amg_parameters.smoother = m_num->ls_amg_smoother;
+            amg_parameters.smoothing_steps = m_num->ls_amg_smoothing_steps;
+            amg_parameters.max_levels = m_num->ls_amg_max_levels;
+            amg_parameters.coarse_size = m_num->ls_amg_coarse_size;
+            precond_name =
+                (amg_parameters.cycle == 2) ? "AMG W-cycle" : "AMG V-cycle";
 #if defined(USE_MPI)
+            precond_name = "AMG not available. Use Jacobi";
+            precond_type = 1;
             prec_M = new double[size_A];
+#else
+#ifdef JFNK_H2M
+            if (m_num->nls_method == 2)
+            {
+                precond_name = "AMG not available. Use Jacobi";
+                precond_type = 1;
+                prec_M = new double[size_A];
+            }
+#endif
+#endif
+            break;
+        case 103:  // Block Jacobi
+            precond_name = "Block Jacobi";
+#if defined(USE_MPI)
+            precond_name = "Block Jacobi not available. Use Jacobi";
+            precond_type = 1;
+            prec_M = new double[size_A];
+#else
+#ifdef JFNK_H2M
+            if (m_num->nls_method == 2)
+            {
+                precond_name = "Block Jacobi not available. Use Jacobi";
+                precond_type = 1;
+                prec_M = new double[size_A];
+            }
+#endif
 #endif
-            // ----------------------------------------------
             break;
         default:
             precond_name = "No preconditioner";
@@ -883,12 +970,14 @@ int Linear_EQS::Solver()
         case 10:
             return SOR();
         case 11:
-            return AMG1R5();
+            return AMG();
         case 12:
             return UMF();
         case 13:
             return GMRES();
             break;
+        case 14:
+            return Direct(true);
     }
     return -1;
 }
@@ -910,11 +999,71 @@ void Linear_EQS::ComputePreconditioner()
 #endif
             return;
         case 100:
-            ComputePreconditioner_ILU();
-            return;
+        case 101:
+            if (!IsPreconditionerCurrent())
+                ComputePreconditioner_ILU();
+            break;
+        case 102:
+            if (!IsPreconditionerCurrent())
+                ComputePreconditioner_AMG();
+            break;
+        case 103:
+            if (!IsPreconditionerCurrent())
+                A->ComputeBlockJacobi();
+            break;
         default:
-            return;
+            break;
+    }
+    // The kept operator is stated for each solve
+    kept_operator = NULL;
+}
+/**************************************************************************
+   Task: Check whether the preconditioner was computed with the same
+      numerics from the same kept operator (SetKeptOperator()), e.g. for
+      the transport components that share their operator. The boundary
+      conditions of the processes may differ, so that the reused
+      preconditioner is the one of a nearby matrix then. A matrix that is
+      not a kept operator is always new.
+**************************************************************************/
+bool Linear_EQS::IsPreconditionerCurrent()
+{
+    if (precond_reuse_num && kept_operator &&
+        precond_num == precond_reuse_num &&
+        precond_operator == kept_operator &&
+        precond_operator_version == kept_operator_version)
+    {
+        if (message)
+            cout << "      Preconditioner of the previous solution reused\n";
+        return true;
     }
+    precond_num = precond_reuse_num;
+    precond_operator = precond_reuse_num ? kept_operator : NULL;
+    precond_operator_version = kept_operator_version;
+    return false;
+}
+/**************************************************************************
+   Task: Incomplete LU factorization of the matrix, ILU(0) or ILUT.
+      The pattern analysis is kept by the matrix and reused as long as
+      the DOF is the same.
+**************************************************************************/
+void Linear_EQS::ComputePreconditioner_ILU()
+{
+    A->ComputeILU(ilut_drop_tolerance, ilut_max_fill, ilu_level_scheduling);
+}
+/**************************************************************************
+   Task: Setup of the AMG hierarchy. The aggregates and prolongations are
+      kept by the matrix, and only the coarse operators are updated as
+      long as the DOF and the numerics are the same.
+**************************************************************************/
+void Linear_EQS::ComputePreconditioner_AMG()
+{
+    if (!A->ComputeAMG(amg_parameters, config_num) || !message)
+        return;
+    const AMGPreconditioner* amg = A->GetAMG();
+    cout << "      AMG hierarchy: " << amg->NumberOfLevels() << " levels, size";
+    for (int l = 0; l < amg->NumberOfLevels(); l++)
+        cout << " " << amg->LevelSize(l);
+    cout << ", operator complexity " << amg->OperatorComplexity() << "\n";
 }
 /**************************************************************************
    Task: Linear equation::SetKnownXi
@@ -951,15 +1100,27 @@ void Linear_EQS::Precond(double* vec_s, double* vec_r)
 #endif
             break;
         case 100:
-            pre = false;  // A->Precond_ILU(vec_s, vec_r);
+        case 101:
+            A->Precond_ILU(vec_s, vec_r);
+            break;
+        case 102:
+            A->Precond_AMG(vec_s, vec_r);
+            break;
+        case 103:
+            A->Precond_BlockJacobi(vec_s, vec_r);
             break;
         default:
             pre = false;  // A->Precond_ILU(vec_s, vec_r);
             break;
     }
     if (!pre)
+    {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long i = 0; i < size_A; i++)
             vec_r[i] = vec_s[i];
+    }
 }
 /**************************************************************************
    Task: Linear equation:: M^T x
@@ -969,6 +1130,16 @@ void Linear_EQS::Precond(double* vec_s, double* vec_r)
 **************************************************************************/
 void Linear_EQS::TransPrecond(double* vec_s, double* vec_r)
 {
+    if (precond_type == 100 || precond_type == 101)
+    {
+        A->TransPrecond_ILU(vec_s, vec_r);
+        return;
+    }
+    if (precond_type == 103)
+    {
+        A->Precond_BlockJacobi(vec_s, vec_r, true);
+        return;
+    }
     Precond(vec_s, vec_r);
 }
 /*\!
@@ -986,6 +1157,25 @@ double Linear_EQS::dot(const double* xx, const double* yy)
     val_i += dom->Dot_Border_Vec(xx, yy);
     //
     MPI_Allreduce(&val_i, &val, 1, MPI_DOUBLE, MPI_SUM, comm_DDC);
+#elif defined(_OPENMP)
+    // The partial sums of the threads are added in the order of the threads
+    // rather than by a reduction clause, so that the result is reproducible
+    // for a given number of threads.
+    const int n_threads = omp_get_max_threads();
+    std::vector<double> partial(n_threads, 0.);
+#pragma omp parallel num_threads(n_threads)
+    {
+        const int t = omp_get_thread_num();
+        const int nt = omp_get_num_threads();
+        const long begin = size_A * t / nt;
+        const long end = size_A * (t + 1) / nt;
+        double sum = 0.;
+        for (long i = begin; i < end; i++)
+            sum += xx[i] * yy[i];
+        partial[t] = sum;
+    }
+    for (int t = 0; t < n_threads; t++)
+        val += partial[t];
 #else
     for (long i = 0; i < size_A; i++)
         val += xx[i] * yy[i];
@@ -1141,11 +1331,17 @@ int Linear_EQS::CG()
     //
     // r0 = b-Ax
     A->multiVec(x, s);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (long i = 0; i < size; i++)
         r[i] = b[i] - s[i];
     //
     // Preconditioning: M^{-1}r
     Precond(r, s);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (long i = 0; i < size; i++)
         p[i] = s[i];
     // Check the convergence
@@ -1162,6 +1358,9 @@ int Linear_EQS::CG()
         A->multiVec(p, s);
         const double alpha = rr / dot(p, s);
         // Update
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long i = 0; i < size; i++)
         {
             x[i] += alpha * p[i];
@@ -1178,6 +1377,9 @@ int Linear_EQS::CG()
         const double rrM1 = rr;
         rr = dot(s, r);
         const double beta = rr / rrM1;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long i = 0; i < size; i++)
             p[i] = s[i] + beta * p[i];
     }
@@ -1185,6 +1387,114 @@ int Linear_EQS::CG()
     Message();
     return iter <= max_iter;
 }
+/**************************************************************************
+   Task: Linear equation::AMG
+      Stationary iteration with the AMG cycle, x += M^{-1}(b-Ax)
+**************************************************************************/
+int Linear_EQS::AMG()
+{
+    //
+    const long size = A->Dim();
+    double* r = f_buffer[0];
+    double* s = f_buffer[1];
+    //
+    double bNorm_new = Norm(b);
+    // Check if the norm of b is samll enough for convengence
+    if (CheckNormRHS(bNorm_new))
+        return 0;
+    //
+    // r0 = b-Ax
+    A->multiVec(x, s);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < size; i++)
+        r[i] = b[i] - s[i];
+    // Check the convergence
+    if ((error = Norm(r) / bNorm) < tol)
+    {
+        Message();
+        return 1;
+    }
+    //
+    for (iter = 1; iter <= max_iter; ++iter)
+    {
+        Precond(r, s);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (long i = 0; i < size; i++)
+            x[i] += s[i];
+        A->multiVec(x, s);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (long i = 0; i < size; i++)
+            r[i] = b[i] - s[i];
+        if ((error = Norm(r) / bNorm) < tol)
+        {
+            Message();
+            return iter <= max_iter;
+        }
+    }
+    //
+    Message();
+    return iter <= max_iter;
+}
+/**************************************************************************
+   Task: Linear equation::Direct
+      Sparse direct solution. The factorization is kept by the matrix and
+      reused as long as the matrix does not change, and its symbolic part
+      as long as the pattern is the same. The error is the relative
+      residual of the solution. Returns 0 if the factorization fails or
+      the residual is not below the tolerance.
+**************************************************************************/
+int Linear_EQS::Direct(const bool symmetric)
+{
+    const long size = A->Dim();
+    double* r = f_buffer[0];
+    //
+    double bNorm_new = Norm(b);
+    if (CheckNormRHS(bNorm_new))
+        return 0;
+    //
+    SparseDirectSolver* direct = A->GetDirectSolver(symmetric);
+    switch (direct->Factorize(*A))
+    {
+        case SparseDirectSolver::ANALYZED_AND_FACTORIZED:
+            if (message)
+                cout << "      Symbolic analysis and factorization\n";
+            break;
+        case SparseDirectSolver::REUSED:
+            if (message)
+                cout << "      Factorization of the previous solution "
+                        "reused\n";
+            break;
+        case SparseDirectSolver::FAILED:
+            cout << "      ERROR: sparse direct factorization failed, the "
+                    "matrix is singular"
+                 << (symmetric ? " or not symmetric" : "") << "\n";
+            error = 1.;
+            Message();
+            return 0;
+        default:
+            break;
+    }
+    direct->Solve(b, x);
+    iter = 1;
+    //
+    A->multiVec(x, r);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < size; i++)
+        r[i] = b[i] - r[i];
+    error = Norm(r) / bNorm;
+    Message();
+    // As for the iterative solvers, failure if the residual is above the
+    // tolerance, e.g. for a nearly singular matrix
+    return error < tol;
+}
 /**************************************************************************
    Task: Linear equation::BiCG
    Programing:
@@ -1212,6 +1522,9 @@ int Linear_EQS::BiCG()
     //
     // r0 = b-Ax
     A->multiVec(x, rt);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (long i = 0; i < size; i++)
     {
         r[i] = b[i] - rt[i];
@@ -1239,14 +1552,22 @@ int Linear_EQS::BiCG()
         }
         //
         if (iter == 1)
+        {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
             for (long i = 0; i < size; i++)
             {
                 p[i] = z[i];
                 pt[i] = zt[i];
             }
+        }
         else
         {
             const double beta = rho1 / rho2;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
             for (long i = 0; i < size; i++)
             {
                 p[i] = z[i] + beta * p[i];
@@ -1258,6 +1579,9 @@ int Linear_EQS::BiCG()
         A->Trans_MultiVec(pt, qt);
         const double alpha = rho1 / dot(pt, q);
         //
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long i = 0; i < size; i++)
         {
             x[i] += alpha * p[i];
@@ -1309,22 +1633,37 @@ int Linear_EQS::BiCGStab()
 #ifdef JFNK_H2M
     if (a_pcs)  /// JFNK. 24.11.2010
     {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long i = 0; i < size; i++)
             r0[i] = b[i];  // r = b-Ax
         a_pcs->Jacobian_Multi_Vector_JFNK(x, s);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long i = 0; i < size; i++)
             r0[i] -= s[i];  // r = b-Ax
     }
     else
     {
         A->multiVec(x, s);  // s as buffer
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long i = 0; i < size; i++)
             r0[i] = b[i] - s[i];  // r = b-Ax
     }
 #else  // ifdef JFNK_H2M
     A->multiVec(x, s);  // s as buffer
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (long i = 0; i < size; i++)
         r0[i] = b[i] - s[i];                    // r = b-Ax
+#endif
+#ifdef _OPENMP
+#pragma omp parallel for
 #endif
     for (long i = 0; i < size; i++)
     {
@@ -1347,11 +1686,19 @@ int Linear_EQS::BiCGStab()
             return 0;
         }
         if (iter == 1)
+        {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
             for (long i = 0; i < size; i++)
                 p[i] = r[i];
+        }
         else
         {
             beta = (rho_1 / rho_0) * (alpha / omega);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
             for (long i = 0; i < size; i++)
                 p[i] = r[i] + beta * (p[i] - omega * v[i]);
         }
@@ -1367,10 +1714,16 @@ int Linear_EQS::BiCGStab()
         //
         alpha = rho_1 / dot(r0, v);
         //
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long i = 0; i < size; i++)
             s[i] = r[i] - alpha * v[i];
         if ((error = Norm(s) / bNorm) < tol)
         {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
             for (long i = 0; i < size; i++)
                 x[i] += alpha * p_h[i];
             Message();
@@ -1392,6 +1745,9 @@ int Linear_EQS::BiCGStab()
         else
             omega = 1.0;
         // Update solution
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long i = 0; i < size; i++)
         {
             x[i] += alpha * p_h[i] + omega * s_h[i];
@@ -1447,6 +1803,9 @@ int Linear_EQS::CGS()
         return 0;
     //
     A->multiVec(x, v);  // v as buffer
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (long i = 0; i < size; i++)
     {
         r0[i] = b[i] - v[i];  // r = b-Ax
@@ -1468,11 +1827,19 @@ int Linear_EQS::CGS()
             return 0;
         }
         if (iter == 1)
+        {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
             for (long i = 0; i < size; i++)
                 p[i] = u[i] = r[i];
+        }
         else
         {
             beta = rho_1 / rho_2;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
             for (long i = 0; i < size; i++)
             {
                 u[i] = r[i] + beta * q[i];
@@ -1486,6 +1853,9 @@ int Linear_EQS::CGS()
         //
         alpha = rho_1 / dot(r0, v);
         //
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long i = 0; i < size; i++)
         {
             q[i] = u[i] - alpha * v[i];
@@ -1493,11 +1863,17 @@ int Linear_EQS::CGS()
         }
         // Preconditioner
         Precond(q_h, u_h);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long i = 0; i < size; i++)
             x[i] += alpha * u_h[i];
         //
         A->multiVec(u_h, q_h);
         //
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long i = 0; i < size; i++)
             r[i] -= alpha * q_h[i];
         rho_2 = rho_1;
@@ -1585,6 +1961,9 @@ inline void Linear_EQS::Update(double* x, int k, Matrix& h, double* s)
     for (long j = 0; j <= k; j++)
     {
         v_j = f_buffer[v_idx0 + j];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long i = 0; i < size; i++)
             x[i] += v_j[i] * y[j];
     }
@@ -1622,20 +2001,32 @@ int Linear_EQS::GMRES()
 #ifdef JFNK_H2M
     if (a_pcs)  /// JFNK. 20.10.2010
     {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long l = 0; l < size_A; l++)
             r[l] = b[l];
         a_pcs->Jacobian_Multi_Vector_JFNK(x, w);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long l = 0; l < size_A; l++)
             r[l] -= w[l];  // r = b-Ax.
     }
     else
     {
         A->multiVec(x, w);  // Ax-->w
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long l = 0; l < size_A; l++)
             r[l] = b[l] - w[l];  // r = b-Ax.
     }
 #else  // ifdef JFNK_H2M
     A->multiVec(x, w);  // Ax-->w
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
     for (long l = 0; l < size_A; l++)
         r[l] = b[l] - w[l];  // r = b-Ax.
 #endif
@@ -1657,6 +2048,9 @@ int Linear_EQS::GMRES()
     while (iter <= max_iter)
     {
         v = f_buffer[v_idx0];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long l = 0; l < size_A; l++)
             v[l] = r[l] / beta;  //  r/beta
         for (long l = 0; l < m + 1; l++)
@@ -1679,11 +2073,17 @@ int Linear_EQS::GMRES()
                 v_k = f_buffer[v_idx0 + k];
                 H(k, i) = dot(w, v_k);
 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
                 for (long l = 0; l < size_A; l++)
                     w[l] -= H(k, i) * v_k[l];
             }
             H(i + 1, i) = Norm(w);
             v_k = f_buffer[v_idx0 + i + 1];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
             for (long l = 0; l < size_A; l++)
                 v_k[l] = w[l] / H(i + 1, i);
 
@@ -1718,6 +2118,9 @@ int Linear_EQS::GMRES()
 #endif
             A->multiVec(x, t);
 
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
         for (long l = 0; l < size_A; l++)
             w[l] = b[l] - t[l];  // r = b-Ax.
         Precond(w, r);           // M*r
@@ -26,6 +26,7 @@
 #ifdef LIS
 #include "lis.h"
 #endif
+#include "AMGPreconditioner.h"
 #include "matrix_class.h"
 class CNumerics;
 class CRFProcess;
@@ -78,7 +79,18 @@ public:
 #endif
     void ComputePreconditioner();
     void ComputePreconditioner_Jacobi();
-    void ComputePreconditioner_ILU() {}
+    void ComputePreconditioner_ILU();
+    void ComputePreconditioner_AMG();
+    /// Whether the matrix is the one of the last preconditioner setup
+    bool IsPreconditionerCurrent();
+    /// The matrix of the next solve is the operator kept by owner (a shared
+    /// transport operator or a lagged Jacobian) in the given version, with
+    /// the boundary conditions of the current process
+    void SetKeptOperator(const void* owner, const unsigned long version)
+    {
+        kept_operator = owner;
+        kept_operator_version = version;
+    }
 //
 // Solver
 #if defined(USE_MPI)
@@ -97,15 +109,17 @@ public:
     int CG();
     int BiCG();  // 02.2010. WW
     int BiCGStab();
-    int Gauss() { return -1; }
+    int Gauss() { return Direct(false); }
     int QMRCGStab() { return -1; }
     int CGNR() { return -1; }
     int CGS();
     int Richardson() { return -1; }
     int JOR() { return -1; }
     int SOR() { return -1; }
-    int AMG1R5() { return -1; }
-    int UMF() { return -1; }
+    int AMG();
+    int UMF() { return Direct(false); }
+    /// Sparse direct solution, LDLT if symmetric, otherwise LU.
+    int Direct(const bool symmetric);
     int GMRES();
 #endif
     //
@@ -166,6 +180,24 @@ private:  // Dot not remove this!
     // Controls
     int precond_type;
     int solver_type;
+    // ILU: max_fill < 0 for ILU(0)
+    double ilut_drop_tolerance;
+    int ilut_max_fill;
+    bool ilu_level_scheduling;
+    AMGParameters amg_parameters;
+    /// Numerics and kept operator of the last preconditioner setup, if
+    /// several equations share their operator ($SHARED_TRANSPORT_OPERATOR)
+    /// or Newton iterations share their Jacobian ($NEWTON_JACOBIAN_LAGGING,
+    /// $QUASI_NEWTON)
+    const CNumerics* precond_num;
+    const CNumerics* precond_reuse_num;
+    const void* precond_operator;
+    unsigned long precond_operator_version;
+    /// Kept operator of the next solve, see SetKeptOperator()
+    const void* kept_operator;
+    unsigned long kept_operator_version;
+    /// Numerics of the last ConfigNumerics(), owner of the AMG hierarchy
+    const CNumerics* config_num;
     bool message;
     int iter, max_iter;
     double tol, bNorm, error;
@@ -14,9 +14,12 @@
 
 #include "fem_ele.h"
 
+#include <algorithm>
 #include <cfloat>
 #include <cassert>
+#include <iostream>
 
+#include "display.h"
 #include "msh_elem.h"
 #include "rf_pcs.h"
 #include "femlib.h"
@@ -27,6 +30,7 @@
 #endif
 
 #include "ShapeFunctionPool.h"
+#include "ElementBatch.h"
 
 namespace FiniteElement
 {
@@ -51,6 +55,8 @@ CElement::CElement(int CoordFlag, const int order)
       GradShapeFunction(NULL),
       GradShapeFunctionHQ(NULL),
       _is_mixed_order(false),
+      element_batch(NULL),
+      batch_lane(-1),
       T_Flag(false),
       C_Flag(false),
       F_Flag(false),
@@ -325,7 +331,175 @@ void CElement::ConfigElement(CElem* MElement, const bool FaceIntegration)
     {
         Order = 1;
     }
-    ComputeGradShapefctInElement(FaceIntegration);
+    if (FaceIntegration ||
+        !(getBatchElementGeometry() || getCachedElementGeometry()))
+        ComputeGradShapefctInElement(FaceIntegration);
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Fill the geometry cache of the shape function pool of the present
+         order with the determinants and inverses of the Jacobians and the
+         gradients of the shape functions of the elements. The values of
+         both orders are removed first, e.g. after nodes were moved.
+         Elements beyond the memory limit of the cache are not cached.
+**************************************************************************/
+void CElement::cacheElementGeometry(const std::vector<CElem*>& elements)
+{
+    for (int i = 0; i < 2; i++)
+        if (_shape_function_pool_ptr[i] &&
+            _shape_function_pool_ptr[i]->getGeometryCache())
+            _shape_function_pool_ptr[i]->getGeometryCache()->clear();
+
+    const ShapeFunctionPool* pool = _shape_function_pool_ptr[Order - 1];
+    ElementGeometryCache* cache = pool ? pool->getGeometryCache() : NULL;
+    if (!cache || _is_mixed_order)
+        return;
+
+    std::size_t n_reserved = 0;
+    for (; n_reserved < elements.size(); n_reserved++)
+    {
+        CElem* elem = elements[n_reserved];
+        SetIntegrationPointNumber(elem->GetElementType());
+        const std::size_t e_dim = elem->GetDimension();
+        const int global_dim = static_cast<int>((dim != e_dim) ? dim : e_dim);
+        if (!cache->reserve(elem, Order, nGaussPoints, global_dim,
+                            getGeometryCacheSize(elem)))
+            break;
+    }
+    cache->allocate();
+
+    for (std::size_t i = 0; i < n_reserved; i++)
+    {
+        CElem* elem = elements[i];
+        const bool quadratic = elem->GetOrder();
+        elem->SetOrder(Order == 2);
+        ConfigElement(elem);
+        elem->SetOrder(quadratic);
+
+        const std::size_t n_jacobian = ele_dim * ele_dim;
+        const double* dshp_fct_all =
+            (Order == 2) ? _dshapefctHQ_all : _dshapefct_all;
+        double* values = cache->getStorage(elem);
+        values = std::copy(_determinants_all,
+                           _determinants_all + nGaussPoints, values);
+        values = std::copy(_inv_jacobian_all,
+                           _inv_jacobian_all + nGaussPoints * n_jacobian,
+                           values);
+        values = std::copy(
+            dshp_fct_all,
+            dshp_fct_all + nNodes * _ele_global_dim * nGaussPoints, values);
+        std::copy(_Jacobian, _Jacobian + n_jacobian, values);
+    }
+
+    Display::ScreenMessage(
+        "-> Geometry cache of order %d: %ld of %ld elements, %g MB\n", Order,
+        (long)n_reserved, (long)elements.size(),
+        cache->getMemory() / 1048576.);
+}
+
+std::size_t CElement::getGeometryCacheSize(const CElem* elem)
+{
+    const std::size_t e_dim = elem->GetDimension();
+    const std::size_t global_dim = (dim != e_dim) ? dim : e_dim;
+    const std::size_t n_nodes = (Order == 2) ? elem->nnodesHQ : elem->nnodes;
+    // Determinants, inverse Jacobians and gradients of the shape functions
+    // of all integration points, and the Jacobian of the last one
+    return nGaussPoints * (1 + e_dim * e_dim + n_nodes * global_dim) +
+           e_dim * e_dim;
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Copy the values of ComputeGradShapefctInElement() of the present
+         element from the geometry cache. Leaves the same pointers to the
+         last integration point as ComputeGradShapefctInElement().
+         Return false if the element is not cached.
+**************************************************************************/
+bool CElement::getCachedElementGeometry()
+{
+    const ShapeFunctionPool* pool = _shape_function_pool_ptr[Order - 1];
+    const ElementGeometryCache* cache = pool ? pool->getGeometryCache() : NULL;
+    if (!cache)
+        return false;
+    const double* values = cache->find(MeshElement, Order, nGaussPoints,
+                                       static_cast<int>(_ele_global_dim));
+    if (!values)
+        return false;
+
+    setOrder(Order);
+    const std::size_t n_jacobian = ele_dim * ele_dim;
+    double* dshp_fct_all = (Order == 2) ? _dshapefctHQ_all : _dshapefct_all;
+    const std::size_t n_dshp_fct = nNodes * _ele_global_dim * nGaussPoints;
+    std::copy(values, values + nGaussPoints, _determinants_all);
+    values += nGaussPoints;
+    std::copy(values, values + nGaussPoints * n_jacobian, _inv_jacobian_all);
+    values += nGaussPoints * n_jacobian;
+    std::copy(values, values + n_dshp_fct, dshp_fct_all);
+    values += n_dshp_fct;
+    std::copy(values, values + n_jacobian, _Jacobian);
+
+    invJacobian = &_inv_jacobian_all[(nGaussPoints - 1) * n_jacobian];
+    getLocalGradShapefunctValues(nGaussPoints - 1, Order);
+    if (axisymmetry && ele_dim < 3)
+        calculateRadius(nGaussPoints - 1);
+    return true;
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Whether an element can be assembled in an element batch. The
+         batch computes the geometry of linear elements with the node
+         coordinates in the global axes, i.e. of elements whose dimension
+         is the space dimension, and without axisymmetry.
+**************************************************************************/
+bool CElement::isBatchElement(const CElem* elem) const
+{
+    const MshElemType::type elem_type = elem->GetElementType();
+    if (!_shape_function_pool_ptr[0] || _is_mixed_order || axisymmetry ||
+        Order != 1 || elem_type == MshElemType::INVALID ||
+        elem_type == MshElemType::QUAD8)
+        return false;
+    if (static_cast<std::size_t>(elem->GetDimension()) != dim)
+        return false;
+    // Axes swapped by ConfigElement()
+    if ((dim == 1 && coordinate_system % 10 != 0) ||
+        (dim == 2 && coordinate_system % 10 == 2))
+        return false;
+    return true;
+}
+
+void CElement::resetElementBatch(ElementBatch& batch, const CElem* elem)
+{
+    const MshElemType::type elem_type = elem->GetElementType();
+    SetIntegrationPointNumber(elem_type);
+    batch.reset(
+        elem_type, elem->GetVertexNumber(), static_cast<int>(dim),
+        nGaussPoints,
+        _shape_function_pool_ptr[0]->getShapeFunctionValues(elem_type),
+        _shape_function_pool_ptr[0]->getGradShapeFunctionValues(elem_type));
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Copy the values of ComputeGradShapefctInElement() of the present
+         element from its lane of the element batch. Leaves the same
+         pointers to the last integration point as
+         ComputeGradShapefctInElement(). Return false if the element is
+         not the one of the lane.
+**************************************************************************/
+bool CElement::getBatchElementGeometry()
+{
+    if (!element_batch || Order != 1 ||
+        element_batch->getElement(batch_lane) != MeshElement)
+        return false;
+
+    setOrder(Order);
+    element_batch->getGeometry(batch_lane, _determinants_all,
+                               _inv_jacobian_all, _dshapefct_all, _Jacobian);
+    invJacobian = &_inv_jacobian_all[(nGaussPoints - 1) * ele_dim * ele_dim];
+    getLocalGradShapefunctValues(nGaussPoints - 1, Order);
+    return true;
 }
 
 /**************************************************************************
@@ -17,6 +17,8 @@
 
 #define fem_INC
 
+#include <vector>
+
 #include "prototyp.h"
 
 #ifndef USE_PETSC
@@ -65,6 +67,7 @@ using MeshLib::CElem;
 using MeshLib::CNode;
 
 class ShapeFunctionPool;
+class ElementBatch;
 
 class CElement
 {
@@ -73,9 +76,25 @@ public:
     virtual ~CElement();
     //
     void ConfigElement(CElem* MElement, const bool FaceIntegration = false);
+    // Fill the geometry cache of the shape function pool of the present
+    // order with the elements, if the pool has a cache.
+    void cacheElementGeometry(const std::vector<CElem*>& elements);
 
     void setElement(CElem* MElement) { MeshElement = MElement; }
 
+    // Whether the element can be assembled in an element batch: a linear
+    // element whose dimension is the space dimension
+    bool isBatchElement(const CElem* elem) const;
+    // Start an element batch for elements of the type of elem
+    void resetElementBatch(ElementBatch& batch, const CElem* elem);
+    // ConfigElement() takes the geometry of the element from a lane of the
+    // batch instead of computing it. NULL: compute it again.
+    void setElementBatch(ElementBatch* batch, const int lane)
+    {
+        element_batch = batch;
+        batch_lane = lane;
+    }
+
     void setOrder(const int order);
     int getOrder() const { return Order; }
     // Set Gauss point
@@ -287,12 +306,26 @@ protected:
 
     void getGradShapeFunctionPtr(const MshElemType::type elem_type);
 
+    // Copy the Jacobians and the gradients of the shape functions of the
+    // present element from the geometry cache. False if not cached.
+    bool getCachedElementGeometry();
+    // Number of values of an element in the geometry cache
+    std::size_t getGeometryCacheSize(const CElem* elem);
+    // Copy the Jacobians and the gradients of the shape functions of the
+    // present element from the element batch. False if not in the batch.
+    bool getBatchElementGeometry();
+
     // Get the values of the local gradient of shape functions at integral point
     // gp
     void getLocalGradShapefunctValues(const int gp, const int order);
 
     bool _is_mixed_order;
 
+    // Batch of elements, which are assembled together, and the lane of
+    // the present element in it
+    ElementBatch* element_batch;
+    int batch_lane;
+
     // Coupling
     int NodeShift[5];
     // Displacement column indeces in the node value table
@@ -25,6 +25,8 @@
 #include "mathlib.h"
 // Problems
 //#include "rf_mfp_new.h"
+#include "ElementBatch.h"
+#include "LocalAssemblyKernels.h"
 #include "SparseMatrixDOK.h"
 #include "eos.h"
 #include "rf_mmp_new.h"
@@ -50,7 +52,9 @@
 // Solver
 #ifdef NEW_EQS
 #include "equation_class.h"
+#include "GlobalOperatorCache.h"
 using Math_Group::CSparseMatrix;
+using Math_Group::GlobalOperatorCache;
 #endif
 
 #ifndef USE_PETSC
@@ -2206,7 +2210,7 @@ void CFiniteElementStd::CalCoefLaplace(bool Gravity, int ip)
     double rhow = 0.0;
     double* tensor = NULL;
     double Hav, manning, chezy, expp, chezy4, Ss, arg;
-    static double Hn[9], z[9];
+    double Hn[9], z[9];
     double GradH[3], Gradz[3], w[3], v1[3], v2[3];
     int nidx1;
     int Index = MeshElement->GetIndex();
@@ -3758,6 +3762,9 @@ void CFiniteElementStd::CalcMass()
     //  int indice = MeshElement->GetIndex();
     //  int phase = pcs->pcs_type_number;
     int upwind_method = pcs->m_num->ele_upwind_method;
+#if !defined(USE_PETSC)
+    const LocalAssemblyKernels& kernels = getLocalAssemblyKernels(nnodes, dim);
+#endif
 
     if (PcsType == EPT_TWOPHASE_FLOW)
     {
@@ -3840,15 +3847,10 @@ void CFiniteElementStd::CalcMass()
                 }
             }
 #else
-            for (i = 0; i < nnodes; i++)
-                for (j = 0; j < nnodes; j++)
-                {
-                    // NW
-                    if (pcs->m_num->ele_supg_method == 0)
-                        if (j > i)
-                            continue;
-                    (*Mass)(i, j) += mat_fac * shapefct[i] * shapefct[j];
-                }
+            // NW: lower triangle only without SUPG
+            kernels.shape_product(mat_fac, shapefct, nnodes,
+                                  Mass->getEntryArray(), Mass->Cols(),
+                                  pcs->m_num->ele_supg_method == 0);
 #endif
             if (pcs->m_num->ele_supg_method > 0)  // NW
             {
@@ -4834,12 +4836,14 @@ void CFiniteElementStd::CalcLumpedMassPSGLOBAL()
  **************************************************************************/
 void CFiniteElementStd::CalcStorage()
 {
-    int i, j;
     // ---- Gauss integral
     int gp_r = 0, gp_s = 0, gp_t = 0;
     double fkt, mat_fac;
     // Material
     mat_fac = 1.0;
+#if !defined(USE_PETSC)
+    const LocalAssemblyKernels& kernels = getLocalAssemblyKernels(nnodes, dim);
+#endif
     //----------------------------------------------------------------------
     //======================================================================
     // Loop over Gauss points
@@ -4858,18 +4862,17 @@ void CFiniteElementStd::CalcStorage()
         fkt *= mat_fac;
 // Calculate mass matrix
 #if defined(USE_PETSC)  // || defined(other parallel libs)//03~04.3012. WW
-        for (i = 0; i < act_nodes; i++)
+        for (int i = 0; i < act_nodes; i++)
         {
             const int ia = local_idx[i];
-            for (j = 0; j < nnodes; j++)
+            for (int j = 0; j < nnodes; j++)
             {
                 (*Storage)(ia, j) += fkt * shapefct[ia] * shapefct[j];
             }
         }
 #else
-        for (i = 0; i < nnodes; i++)
-            for (j = 0; j < nnodes; j++)
-                (*Storage)(i, j) += fkt * shapefct[i] * shapefct[j];
+        kernels.shape_product(fkt, shapefct, nnodes, Storage->getEntryArray(),
+                              Storage->Cols(), false);
 #endif
     }
     // TEST OUTPUT
@@ -4888,12 +4891,14 @@ void CFiniteElementStd::CalcStorage()
  **************************************************************************/
 void CFiniteElementStd::CalcContent()
 {
-    int i, j;
     // ---- Gauss integral
     int gp_r = 0, gp_s = 0, gp_t = 0;
     double fkt, mat_fac;
     // Material
     mat_fac = 1.0;
+#if !defined(USE_PETSC)
+    const LocalAssemblyKernels& kernels = getLocalAssemblyKernels(nnodes, dim);
+#endif
     //----------------------------------------------------------------------
     //======================================================================
     // Loop over Gauss points
@@ -4912,18 +4917,17 @@ void CFiniteElementStd::CalcContent()
         fkt *= mat_fac;
 // Calculate mass matrix
 #if defined(USE_PETSC)  // || defined(other parallel libs)//03~04.3012. WW
-        for (i = 0; i < act_nodes; i++)
+        for (int i = 0; i < act_nodes; i++)
         {
             const int ia = local_idx[i];
-            for (j = 0; j < nnodes; j++)
+            for (int j = 0; j < nnodes; j++)
             {
                 (*Content)(ia, j) += fkt * shapefct[ia] * shapefct[j];
             }
         }
 #else
-        for (i = 0; i < nnodes; i++)
-            for (j = 0; j < nnodes; j++)
-                (*Content)(i, j) += fkt * shapefct[i] * shapefct[j];
+        kernels.shape_product(fkt, shapefct, nnodes, Content->getEntryArray(),
+                              Content->Cols(), false);
 #endif
     }
 }
@@ -4960,6 +4964,9 @@ void CFiniteElementStd::CalcLaplace()
     {
         dof_n = 3;
     }
+#if !defined(USE_PETSC)
+    const LocalAssemblyKernels& kernels = getLocalAssemblyKernels(nnodes, dim);
+#endif
 
     //----------------------------------------------------------------------
     // Loop over Gauss points
@@ -4976,17 +4983,7 @@ void CFiniteElementStd::CalcLaplace()
         getShapefunctValues(
             gp, 1);  // For thoese used in the material parameter caculation
         // Calculate mass matrix
-        // The following "if" is done by WW
-        if (PcsType == EPT_GROUNDWATER_FLOW &&
-            MediaProp->unconfined_flow_group == 1 &&
-            MeshElement->ele_dim == 2 && !pcs->m_msh->hasCrossSection())
-        {
-            double water_depth = 0.0;
-            for (int i = 0; i < nnodes; i++)
-                water_depth +=
-                    (pcs->GetNodeValue(nodes[i], idx1) - Z[i]) * shapefct[i];
-            fkt *= water_depth;
-        }
+        fkt *= CalcWaterDepthFactor();
         //---------------------------------------------------------
 
         for (size_t in = 0; in < dof_n; in++)
@@ -5035,32 +5032,36 @@ void CFiniteElementStd::CalcLaplace()
                 }      // i: nodes
 #else
                 //---------------------------------------------------------
-                for (int i = 0; i < nnodes; i++)
-                {
-                    const int iish = i + ish;
-                    for (int j = 0; j < nnodes; j++)
-                    {
-                        const int jjsh = j + jsh;
-                        //  if(j>i) continue;
-                        for (size_t k = 0; k < dim; k++)
-                        {
-                            const int ksh = k * nnodes + i;
-                            const int km = dim * k;
-                            for (size_t l = 0; l < dim; l++)
-                            {
-                                (*Laplace)(iish, jjsh) +=
-                                    fkt * dshapefct[ksh] * mat[km + l] *
-                                    dshapefct[l * nnodes + j];
-                            }
-                        }
-                    }  // j: nodes
-                }      // i: nodes
+                kernels.grad_shape_product(
+                    fkt, dshapefct, mat, nnodes, dim,
+                    Laplace->getEntryArray() + ish * Laplace->Cols() + jsh,
+                    Laplace->Cols());
 #endif
             }
         }
     }  //	//TEST OUTPUT
        // Laplace->Write();
 }
+/**************************************************************************
+   FEMLib-Method:
+   Task: Water depth at the present Gauss point, which is a factor of the
+         Laplace matrix of 2D unconfined groundwater flow. 1 otherwise.
+**************************************************************************/
+double CFiniteElementStd::CalcWaterDepthFactor()
+{
+    if (PcsType == EPT_GROUNDWATER_FLOW &&
+        MediaProp->unconfined_flow_group == 1 && MeshElement->ele_dim == 2 &&
+        !pcs->m_msh->hasCrossSection())
+    {
+        double water_depth = 0.0;
+        for (int i = 0; i < nnodes; i++)
+            water_depth +=
+                (pcs->GetNodeValue(nodes[i], idx1) - Z[i]) * shapefct[i];
+        return water_depth;
+    }
+    return 1.0;
+}
+
 /***************************************************************************
    FEMLib-Method:
    Task: Assembly of LaplaceMatrix for
@@ -5373,6 +5374,9 @@ void CFiniteElementStd::CalcAdvection()
     // Initial values
     gp_t = 0;
     (*Advection) = 0.0;
+#if !defined(USE_PETSC)
+    const LocalAssemblyKernels& kernels = getLocalAssemblyKernels(nnodes, dim);
+#endif
 
     //----------------------------------------------------------------------
     // Loop over Gauss points
@@ -5452,11 +5456,9 @@ void CFiniteElementStd::CalcAdvection()
             }
         }
 #else
-        for (i = 0; i < nnodes; i++)
-            for (j = 0; j < nnodes; j++)
-                for (size_t k = 0; k < dim; k++)
-                    (*Advection)(i, j) +=
-                        fkt * shapefct[i] * vel[k] * dshapefct[k * nnodes + j];
+        kernels.shape_grad_product(fkt, shapefct, vel, dshapefct, nnodes, dim,
+                                   Advection->getEntryArray(),
+                                   Advection->Cols());
 #endif
         if (pcs->m_num->ele_supg_method > 0)  // NW
         {
@@ -7788,6 +7790,9 @@ void CFiniteElementStd::AssembleParabolicEquation()
         else
             CalcMassTES();
     }
+    else if (element_batch && element_batch->hasMass())
+        element_batch->getMass(batch_lane, Mass->getEntryArray(),
+                               Mass->Cols());
     else
     {
         if (pcs->m_num->ele_mass_lumping)
@@ -7799,6 +7804,9 @@ void CFiniteElementStd::AssembleParabolicEquation()
     // Laplace matrix.......................................................
     if (PcsType == EPT_MULTI_COMPONENTIAL_FLOW)
         CalcLaplaceMCF();  // AKS
+    else if (element_batch)
+        element_batch->getLaplace(batch_lane, Laplace->getEntryArray(),
+                                  Laplace->Cols());
     else
         CalcLaplace();
     if (PcsType == EPT_MULTI_COMPONENTIAL_FLOW)
@@ -8116,6 +8124,14 @@ void CFiniteElementStd::AssembleParabolicEquation()
             (*RHS)[i + LocalShift] += NodalVal[i];
         }
     }
+#ifdef NEW_EQS
+    // Terms of the kept global matrices of a linear process
+    if (isGlobalOperatorAssembly())
+    {
+        add2GlobalOperatorCache(GlobalOperatorCache::MASS, *Mass);
+        add2GlobalOperatorCache(GlobalOperatorCache::LAPLACE, *Laplace);
+    }
+#endif
     //
     // RHS->Write();
 }
@@ -8281,6 +8297,9 @@ void CFiniteElementStd::add2GlobalMatrixII(const int block_cols)
         A = m_dom->eqs->A;
     else
         A = pcs->eqs_new->A;
+    // Positions of the element matrix entries, if mapped
+    const long* ele_entries =
+        A->ElementEntries(static_cast<long>(MeshElement->GetIndex()), nnodes);
 #endif
     // For DOF>1:
     if (PcsType == EPT_MULTIPHASE_FLOW || PcsType == EPT_PSGLOBAL ||
@@ -8304,6 +8323,18 @@ void CFiniteElementStd::add2GlobalMatrixII(const int block_cols)
             {
                 j_sh = NodeShift[jj + dm_shift];
                 jj_sh = jj * nnodes;
+#ifdef NEW_EQS
+                if (ele_entries && A->IsBlockShift(i_sh) &&
+                    A->IsBlockShift(j_sh))
+                {
+                    A->AddElementBlock(
+                        ele_entries, nnodes, i_sh, j_sh,
+                        StiffMatrix->getEntryArray() +
+                            ii_sh * StiffMatrix->Cols() + jj_sh,
+                        static_cast<int>(StiffMatrix->Cols()));
+                    continue;
+                }
+#endif
                 for (i = 0; i < nnodes; i++)
                 {
                     kk = i_sh + eqs_number[i];  // 02.2011. WW
@@ -8324,6 +8355,15 @@ void CFiniteElementStd::add2GlobalMatrixII(const int block_cols)
     else
     {
         cshift += NodeShift[dm_shift];  // WW 05.01.07
+#ifdef NEW_EQS
+        if (ele_entries && A->IsBlockShift(cshift))
+        {
+            A->AddElementBlock(ele_entries, nnodes, cshift, cshift,
+                               StiffMatrix->getEntryArray(),
+                               static_cast<int>(StiffMatrix->Cols()));
+            return;
+        }
+#endif
         for (i = 0; i < nnodes; i++)
         {
             kk = cshift + eqs_number[i];  // 02.2011. WW
@@ -8346,6 +8386,47 @@ void CFiniteElementStd::add2GlobalMatrixII(const int block_cols)
     }*/
 }
 #endif
+
+#ifdef NEW_EQS
+/**************************************************************************
+   FEMLib-Method:
+   Task: Whether the element matrices are added to the global matrices
+         of the terms, which are kept for linear processes
+         (see CRFProcess::isGlobalOperatorCached())
+**************************************************************************/
+bool CFiniteElementStd::isGlobalOperatorAssembly() const
+{
+    return pcs->global_operator_cache &&
+           pcs->global_operator_cache->isAssembling() && !m_dom;
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Add an element matrix to a term of the kept global matrices.
+         Terms that are not kept are skipped.
+**************************************************************************/
+void CFiniteElementStd::add2GlobalOperatorCache(const int term,
+                                                const Matrix& local)
+{
+    CSparseMatrix* T = pcs->global_operator_cache->getTerm(term);
+    if (!T)
+        return;
+    const long shift = NodeShift[problem_dimension_dm];
+    const long* ele_entries =
+        T->ElementEntries(static_cast<long>(MeshElement->GetIndex()), nnodes);
+    if (ele_entries && T->IsBlockShift(shift))
+    {
+        T->AddElementBlock(ele_entries, nnodes, shift, shift,
+                           local.getEntryArray(),
+                           static_cast<int>(local.Cols()));
+        return;
+    }
+    for (int i = 0; i < nnodes; i++)
+        for (int j = 0; j < nnodes; j++)
+            (*T)(shift + eqs_number[i], shift + eqs_number[j]) +=
+                local(i, j);
+}
+#endif
 /**************************************************************************
    FEMLib-Method:
    Task:
@@ -8386,7 +8467,7 @@ void CFiniteElementStd::CalcFEM_FCT()
     //----------------------------------------------------------------------
     // Initialize FCT flux with consistent mass matrix: f_ij = m_ij
     //----------------------------------------------------------------------
-    Math_Group::SparseMatrixDOK* FCT_Flux = this->pcs->FCT_AFlux;
+    Math_Group::SparseMatrixCSR* FCT_Flux = this->pcs->FCT_AFlux;
     for (int i = 0; i < nnodes; i++)
     {
         long node_i_id = this->MeshElement->nodes_index[i];
@@ -8669,6 +8750,28 @@ void CFiniteElementStd::AssembleMixedHyperbolicParabolicEquation()
         *AuxMatrix = *Content;
         (*AuxMatrix) *= fac_content;
         *AuxMatrix1 += *AuxMatrix;
+#ifdef NEW_EQS
+        // Terms of the kept global matrices of a linear process
+        if (isGlobalOperatorAssembly())
+        {
+            add2GlobalOperatorCache(GlobalOperatorCache::MASS, *Mass);
+            add2GlobalOperatorCache(GlobalOperatorCache::LAPLACE, *Laplace);
+            add2GlobalOperatorCache(GlobalOperatorCache::ADVECTION,
+                                    *Advection);
+            add2GlobalOperatorCache(GlobalOperatorCache::ADVECTION, *Storage);
+            add2GlobalOperatorCache(GlobalOperatorCache::CONTENT, *Content);
+        }
+        // Keep the RHS operator for the components that share it
+        if (pcs->shared_rhs && !m_dom)
+        {
+            for (int i = 0; i < nnodes; i++)
+                for (int j = 0; j < nnodes; j++)
+                    (*pcs->shared_rhs)(
+                        NodeShift[problem_dimension_dm] + eqs_number[i],
+                        NodeShift[problem_dimension_dm] + eqs_number[j]) +=
+                        (*AuxMatrix1)(i, j);
+        }
+#endif
 
         for (int i = 0; i < nnodes; i++)
         {
@@ -9341,6 +9444,78 @@ void CFiniteElementStd::Config()
         }
     }
 }
+/**************************************************************************
+   FEMLib-Method:
+   Task: Assemble the elements of a batch of elements of the same type.
+         The Jacobians and the gradients of the shape functions of all
+         elements, and after the coefficients of each element, the mass and
+         Laplace matrices of all elements are computed together in SIMD
+         lanes. Then each element is assembled by Assembly() with its
+         values from the batch. The batch is empty afterwards.
+**************************************************************************/
+void CFiniteElementStd::AssembleElementBatch(ElementBatch& batch)
+{
+    const int lane = batch.computeGeometry();
+    if (lane >= 0)
+    {
+        std::cout << "\n*** Jacobian: Det == 0 in element "
+                  << batch.getElement(lane)->GetIndex() << "\n";
+        abort();
+    }
+
+    for (int i = 0; i < batch.size(); i++)
+    {
+        setElementBatch(&batch, i);
+        ConfigElement(batch.getElement(i));
+        Config();
+        CalcElementBatchCoefficients();
+    }
+    // The mass matrices of lumping and SUPG are computed element by element
+    batch.computeMatrices(pcs->m_num->ele_mass_lumping == 0 &&
+                          pcs->m_num->ele_supg_method == 0);
+
+    for (int i = 0; i < batch.size(); i++)
+    {
+        setElementBatch(&batch, i);
+        ConfigElement(batch.getElement(i));
+        Assembly();
+    }
+    setElementBatch(NULL, -1);
+    batch.clear();
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Coefficients of the mass and Laplace matrices of the present
+         element at all Gauss points for its lane of the element batch,
+         i.e. the factors of CalcMass() and CalcLaplace() including the
+         integration weights.
+**************************************************************************/
+void CFiniteElementStd::CalcElementBatchCoefficients()
+{
+    int gp_r = 0, gp_s = 0, gp_t = 0;
+    const bool with_mass =
+        pcs->m_num->ele_mass_lumping == 0 && pcs->m_num->ele_supg_method == 0;
+    for (gp = 0; gp < nGaussPoints; gp++)
+    {
+        const double fkt = GetGaussData(gp, gp_r, gp_s, gp_t);
+        getGradShapefunctValues(gp, 1);
+        getShapefunctValues(gp, 1);
+
+        double mass_fac = 0.0;
+        if (with_mass)
+        {
+            mass_fac = CalCoefMass();
+            mass_fac *= fkt;
+            mass_fac *= MediaProp->ElementVolumeMultiplyer;
+        }
+        const double laplace_fac = fkt * CalcWaterDepthFactor();
+        CalCoefLaplace(false, gp);
+        element_batch->setCoefficients(batch_lane, gp, mass_fac,
+                                       laplace_fac, mat);
+    }
+}
+
 /**************************************************************************
    FEMLib-Method:
    Task: Assemble local matrices to the global system
@@ -9471,7 +9646,8 @@ void CFiniteElementStd::Assembly()
             if (dm_pcs)
                 Assemble_strainCPL();
 
-            if (pcs->m_num->nls_method == 1)  // Newton-Raphson. 07.2011. WW
+            // Newton-Raphson. 07.2011. WW. Not if the Jacobian is kept.
+            if (pcs->m_num->nls_method == 1 && !pcs->isJacobianLagged())
                 ComputeAdditionalJacobi_Richards();
             add2GlobalMatrixII();
             break;
@@ -122,6 +122,9 @@ public:
     // 3. Laplace matrix
     void CalcLaplace();
     void CalcLaplaceMCF();  // AKS
+    // Water depth as factor of the Laplace matrix of 2D unconfined
+    // groundwater flow at the present Gauss point, otherwise 1
+    double CalcWaterDepthFactor();
     // 4. Gravity term
     void CalcGravity();
     // 5. Strain coupling matrix
@@ -427,6 +430,12 @@ protected:
     // Local Assembly
     // Assembly of parabolic equation
     void AssembleParabolicEquation();  // OK4104
+    // Assembly of the elements of a batch of elements of the same type,
+    // whose mass and Laplace matrices are computed together
+    void AssembleElementBatch(ElementBatch& batch);
+    // Coefficients of the mass and Laplace matrices of the present element
+    // at all Gauss points for the element batch
+    void CalcElementBatchCoefficients();
     void AssembleMixedHyperbolicParabolicEquation();
     void AssembleParabolicEquationNewton();
     // JOD
@@ -472,6 +481,13 @@ protected:
     void add2GlobalMatrixII();
 #else
     void add2GlobalMatrixII(const int block_cols = 2);  // WW. 06.2011
+#endif
+#ifdef NEW_EQS
+    /// Whether the element matrices are added to the kept global matrices
+    /// of the process (CRFProcess::global_operator_cache)
+    bool isGlobalOperatorAssembly() const;
+    /// Add an element matrix to a term of the kept global matrices
+    void add2GlobalOperatorCache(const int term, const Matrix& local);
 #endif
     void PrintTheSetOfElementMatrices(std::string mark);
     // Friend classes, 01/07, WW
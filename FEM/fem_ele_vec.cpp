@@ -858,6 +858,9 @@ void CFiniteElementVec::ComputeMatrix_RHS(const double fkt, const Matrix* p_D)
             continue;
         if (excavation)
             continue;  // WX:08.2011
+        // Modified Newton: the Jacobian of a previous iteration is kept
+        if (pcs->isJacobianLagged())
+            continue;
 // Local assembly of stiffness matrix, B^T C B
 #ifdef JFNK_H2M
         /// If JFNK. 18.10.2010. WW
@@ -1329,6 +1332,9 @@ bool CFiniteElementVec::GlobalAssembly()
         return false;
     }
 
+    // Modified Newton: the Jacobian of a previous iteration is kept
+    if (pcs->isJacobianLagged())
+        return true;
     GlobalAssembly_Stiffness();
 
     return true;
@@ -1450,58 +1456,96 @@ void CFiniteElementVec::GlobalAssembly_Stiffness()
         A = m_dom->eqsH->A;
     else
         A = pcs->eqs_new->A;
+    // Positions of the element matrix entries, if mapped
+    const long* ele_entries = A->ElementEntries(
+        static_cast<long>(MeshElement->GetIndex()), nnodesHQ);
 #endif
 
     double f1 = 1.0;
     double f2 = -1.0;
+#ifdef NEW_EQS
+    // The map is only used if the shifts start DOF blocks of the matrix
+    for (size_t k = 0; k < ele_dim && ele_entries; k++)
+        if (!A->IsBlockShift(NodeShift[k]))
+            ele_entries = NULL;
+#endif
     if (dynamic)
     {
         f1 = 0.5 * beta2 * dt * dt;
         f2 = -0.5 * bbeta1 * dt;
         // Assemble stiffness matrix
-        for (int i = 0; i < nnodesHQ; i++)
+#ifdef NEW_EQS
+        if (ele_entries)
         {
-            for (int j = 0; j < nnodesHQ; j++)
+            for (size_t k = 0; k < ele_dim; k++)
+                A->AddElementBlock(ele_entries, nnodesHQ, NodeShift[k],
+                                   NodeShift[k], Mass->getEntryArray(),
+                                   static_cast<int>(Mass->Cols()));
+        }
+        else
+#endif
+        {
+            for (int i = 0; i < nnodesHQ; i++)
             {
-                // Local assembly of stiffness matrix
-                for (size_t k = 0; k < ele_dim; k++)
+                for (int j = 0; j < nnodesHQ; j++)
                 {
+                    // Local assembly of stiffness matrix
+                    for (size_t k = 0; k < ele_dim; k++)
+                    {
 #ifdef NEW_EQS
-                    (*A)(eqs_number[i] + NodeShift[k],
-                         eqs_number[j] + NodeShift[k]) += (*Mass)(i, j);
+                        (*A)(eqs_number[i] + NodeShift[k],
+                             eqs_number[j] + NodeShift[k]) += (*Mass)(i, j);
 #else
-                    MXInc(eqs_number[i] + NodeShift[k],
-                          eqs_number[j] + NodeShift[k], (*Mass)(i, j));
+                        MXInc(eqs_number[i] + NodeShift[k],
+                              eqs_number[j] + NodeShift[k], (*Mass)(i, j));
 #endif
-                }
-            }  // loop j
-        }      // loop i
+                    }
+                }  // loop j
+            }      // loop i
+        }
     }
 
     // Assemble stiffness matrix
-    for (int i = 0; i < nnodesHQ; i++)
+#ifdef NEW_EQS
+    if (ele_entries)
     {
-        for (int j = 0; j < nnodesHQ; j++)
+        const int ld = static_cast<int>(Stiffness->Cols());
+        for (size_t k = 0; k < ele_dim; k++)
+            for (size_t l = 0; l < ele_dim; l++)
+                A->AddElementBlock(
+                    ele_entries, nnodesHQ, NodeShift[k], NodeShift[l],
+                    Stiffness->getEntryArray() + k * nnodesHQ * ld +
+                        l * nnodesHQ,
+                    ld, f1);
+    }
+    else
+#endif
+    {
+        for (int i = 0; i < nnodesHQ; i++)
         {
-            // Local assembly of stiffness matrix
-            for (size_t k = 0; k < ele_dim; k++)
+            for (int j = 0; j < nnodesHQ; j++)
             {
-                for (size_t l = 0; l < ele_dim; l++)
+                // Local assembly of stiffness matrix
+                for (size_t k = 0; k < ele_dim; k++)
                 {
+                    for (size_t l = 0; l < ele_dim; l++)
+                    {
 #ifdef NEW_EQS
-                    (*A)(eqs_number[i] + NodeShift[k],
-                         eqs_number[j] + NodeShift[l]) +=
-                        f1 * (*Stiffness)(i + k * nnodesHQ, j + l * nnodesHQ);
+                        (*A)(eqs_number[i] + NodeShift[k],
+                             eqs_number[j] + NodeShift[l]) +=
+                            f1 *
+                            (*Stiffness)(i + k * nnodesHQ, j + l * nnodesHQ);
 #else
-                    MXInc(
-                        eqs_number[i] + NodeShift[k],
-                        eqs_number[j] + NodeShift[l],
-                        f1 * (*Stiffness)(i + k * nnodesHQ, j + l * nnodesHQ));
+                        MXInc(eqs_number[i] + NodeShift[k],
+                              eqs_number[j] + NodeShift[l],
+                              f1 * (*Stiffness)(i + k * nnodesHQ,
+                                                j + l * nnodesHQ));
 #endif
+                    }
                 }
-            }
-        }  // loop j
-    }      // loop i
+            }  // loop j
+        }      // loop i
+    }
 
     // TEST OUT
     // Stiffness->Write();
@@ -2090,10 +2134,11 @@ void CFiniteElementVec::LocalAssembly_continuum(const int update)
 #ifdef JFNK_H2M
                     if (smat->StressIntegrationDP(gp, eleV_DM, dstress, dPhi,
                                                   update) &&
-                        !JFNK)
+                        !JFNK && !pcs->isJacobianLagged())
 #else
                     if (smat->StressIntegrationDP(gp, eleV_DM, dstress, dPhi,
-                                                  update))
+                                                  update) &&
+                        !pcs->isJacobianLagged())
 #endif
 
                         // WW DevStress = smat->devS;
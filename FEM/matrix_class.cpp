@@ -18,12 +18,24 @@
    ==========================================================================*/
 
 /// Matrix
+#include <algorithm>
 #include <cfloat>
 #include <cmath>
 #include <iomanip>
+#include <new>
+#include <string>
 //
 #include "mathlib.h"
 #include "matrix_class.h"
+#ifdef NEW_EQS
+#include "AMGPreconditioner.h"
+#include "ILUPreconditioner.h"
+#include "SparseDirectSolver.h"
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #if !defined(USE_PETSC)  // && !defined(other parallel libs)//03.3012. WW
 #ifdef NEW_EQS
@@ -694,8 +706,6 @@ SparseTable::SparseTable(MeshLib::CFEMesh* a_mesh, bool quadratic, bool symm,
 {
     long i = 0, j = 0, ii = 0, jj = 0;
     long lbuff0 = 0, lbuff1 = 0;
-    long** larraybuffer;
-    larraybuffer = NULL;
     //
     // In sparse table, = number of nodes
     rows = a_mesh->GetNodesNumber(quadratic);
@@ -707,73 +717,56 @@ SparseTable::SparseTable(MeshLib::CFEMesh* a_mesh, bool quadratic, bool symm,
         row_index_mapping_n2o = new long[rows];
         row_index_mapping_o2n = new long[rows];
     }
-    else if (storage_type == CRS)
+    else  // CRS, BCSR
     {
         row_index_mapping_n2o = NULL;
         row_index_mapping_o2n = NULL;
     }
 
-    if (symmetry)
+    // Columns of the rows in the equation numbering of the nodes
+    // (CFEMesh::RenumberEquations), ascending. Only the upper triangle for
+    // the symmetric storage.
+    std::vector<long> row_ptr(rows + 1, 0);
+    std::vector<long> row_columns;
+    for (i = 0; i < rows; i++)
     {
-        larraybuffer = new long*[rows];
-        for (i = 0; i < rows; i++)
+        const MeshLib::CNode* node =
+            a_mesh->nod_vector[a_mesh->Eqs2Global_NodeIndex[i]];
+        MeshLib::NodeAdjacency const& connected_nodes =
+            node->getConnectedNodes();
+        for (j = 0; j < (long)connected_nodes.size(); j++)
         {
-            if (storage_type == JDS)
-                row_index_mapping_n2o[i] = i;
-            // 'diag_entry' used as a temporary array
-            // to store the number of nodes connected to this node
-            lbuff1 = (long)a_mesh->nod_vector[i]->getConnectedNodes().size();
-            larraybuffer[i] = new long[lbuff1 + 1];
-            //
-            larraybuffer[i][0] = lbuff1;
-            for (j = 0; j < lbuff1; j++)
-                larraybuffer[i][j + 1] =
-                    a_mesh->nod_vector[i]->getConnectedNodes()[j];
-            a_mesh->nod_vector[i]->getConnectedNodes().clear();
-            for (j = 0; j < lbuff1; j++)
-            {
-                jj = larraybuffer[i][j + 1];
-                if (i <= jj)
-                    a_mesh->nod_vector[i]->getConnectedNodes().push_back(jj);
-            }
+            jj = a_mesh->nod_vector[connected_nodes[j]]->GetEquationIndex();
+            /// If linear element is used
+            if ((!quadratic) && (jj >= rows))
+                continue;
+            if (symmetry && jj < i)
+                continue;
+            row_columns.push_back(jj);
         }
+        row_ptr[i + 1] = (long)row_columns.size();
+        std::sort(row_columns.begin() + row_ptr[i], row_columns.end());
     }
 
-    /// CRS storage
-    if (storage_type == CRS)
+    /// CRS storage, also the table of BCSR
+    if (storage_type != JDS)
     {
         /// num_column_entries saves vector ptr of CRS
         num_column_entries = new long[rows + 1];
-
-        std::vector<long> A_index;
-        long col_index;
-
         for (i = 0; i < rows; i++)
         {
-            num_column_entries[i] = (long)A_index.size();
-
-            for (j = 0;
-                 j < (long)a_mesh->nod_vector[i]->getConnectedNodes().size();
-                 j++)
-            {
-                col_index = a_mesh->nod_vector[i]->getConnectedNodes()[j];
-
-                /// If linear element is used
-                if ((!quadratic) && (col_index >= rows))
-                    continue;
-
-                if (i == col_index)
-                    diag_entry[i] = (long)A_index.size();
-                A_index.push_back(col_index);
-            }
+            num_column_entries[i] = row_ptr[i];
+            for (j = row_ptr[i]; j < row_ptr[i + 1]; j++)
+                if (row_columns[j] == i)
+                    diag_entry[i] = j;
         }
 
-        size_entry_column = (long)A_index.size();
+        size_entry_column = (long)row_columns.size();
         num_column_entries[rows] = size_entry_column;
 
         entry_column = new long[size_entry_column];
         for (i = 0; i < size_entry_column; i++)
-            entry_column[i] = A_index[i];
+            entry_column[i] = row_columns[i];
     }
     else if (storage_type == JDS)
     {
@@ -786,17 +779,7 @@ SparseTable::SparseTable(MeshLib::CFEMesh* a_mesh, bool quadratic, bool symm,
             row_index_mapping_n2o[i] = i;
             // 'diag_entry' used as a temporary array
             // to store the number of nodes connected to this node
-            diag_entry[i] =
-                (long)a_mesh->nod_vector[i]->getConnectedNodes().size();
-            if (!quadratic)
-            {
-                lbuff0 = 0;
-                for (j = 0; j < diag_entry[i]; j++)
-                    if (a_mesh->nod_vector[i]->getConnectedNodes()[j] <
-                        static_cast<size_t>(rows))
-                        lbuff0++;
-                diag_entry[i] = lbuff0;
-            }
+            diag_entry[i] = row_ptr[i + 1] - row_ptr[i];
             size_entry_column += diag_entry[i];
         }
 
@@ -847,7 +830,7 @@ SparseTable::SparseTable(MeshLib::CFEMesh* a_mesh, bool quadratic, bool symm,
                 // ii is the real row index of this entry in matrix
                 ii = row_index_mapping_n2o[j];
                 // jj is the real column index of this entry in matrix
-                jj = a_mesh->nod_vector[ii]->getConnectedNodes()[i];
+                jj = row_columns[row_ptr[ii] + i];
                 entry_column[lbuff0] = jj;
 
                 // Till to this stage, 'diag_entry' is really used to store
@@ -859,27 +842,6 @@ SparseTable::SparseTable(MeshLib::CFEMesh* a_mesh, bool quadratic, bool symm,
                 lbuff0++;
             }
     }
-
-    // For the case of symmetry matrix
-    if (symmetry)
-    {
-        for (i = 0; i < rows; i++)
-        {
-            lbuff0 = larraybuffer[i][0];
-            a_mesh->nod_vector[i]->getConnectedNodes().resize(lbuff0);
-            //
-            for (j = 0; j < lbuff0; j++)
-                a_mesh->nod_vector[i]->getConnectedNodes()[j] =
-                    larraybuffer[i][j + 1];
-        }
-        for (i = 0; i < rows; i++)
-        {
-            delete[] larraybuffer[i];
-            larraybuffer[i] = 0;
-        }
-        delete[] larraybuffer;
-        larraybuffer = 0;
-    }
 }
 /*\!
  ********************************************************************
@@ -1018,7 +980,7 @@ void SparseTable::Write(std::ostream& os)
     os << "\n*** Row index  "
        << "\n";
 
-    if (storage_type == CRS)
+    if (storage_type != JDS)
     {
         os << "\n*** Sparse entry  "
            << "\n";
@@ -1049,6 +1011,123 @@ void SparseTable::Write(std::ostream& os)
     }
 }
 
+/*\!
+ ********************************************************************
+   Position of entry (row, col) in entry_column, or -1 if the entry
+   does not exist. Same search as that of CSparseMatrix::operator().
+ ********************************************************************/
+long SparseTable::EntryPosition(const long row, const long col) const
+{
+    if (storage_type != JDS)
+        return binarySearch(entry_column, col, num_column_entries[row],
+                            num_column_entries[row + 1]);
+
+    const long row_in_sparse_table = row_index_mapping_o2n[row];
+    long counter = row_in_sparse_table;
+    for (long k = 0; k < max_columns; k++)
+    {
+        if (row_in_sparse_table >= num_column_entries[k])
+            return -1;
+        if (entry_column[counter] == col)
+            return counter;
+        counter += num_column_entries[k];
+    }
+    return -1;
+}
+
+/*\!
+ ********************************************************************
+   Element-to-matrix scatter map. For each element, the positions of
+   the entries of its element matrix are stored once, and the assembly
+   adds the local entries without searching them in the sparse table.
+   The symmetric storage is not mapped.
+   Arguments:
+      quadratic: nodes of quadratic elements, as for the table itself
+      max_memory_MB: upper limit of the memory of the map
+ ********************************************************************/
+bool SparseTable::BuildElementEntryMap(MeshLib::CFEMesh* a_mesh,
+                                       bool quadratic,
+                                       const double max_memory_MB)
+{
+    element_entry_ptr.clear();
+    element_entry.clear();
+    if (symmetry || max_memory_MB <= 0.)
+        return false;
+
+    const std::size_t n_elements = a_mesh->ele_vector.size();
+    double n_entries = 0.;
+    for (std::size_t e = 0; e < n_elements; e++)
+    {
+        const double nn = static_cast<double>(
+            a_mesh->ele_vector[e]->GetNodesNumber(quadratic));
+        n_entries += nn * nn;
+    }
+    const double memory_MB = (n_entries + n_elements + 1.) *
+                             static_cast<double>(sizeof(long)) / 1048576.;
+    const std::string table_name = quadratic ? "quadratic" : "linear";
+    if (memory_MB > max_memory_MB)
+    {
+        std::cout << "-> Element-to-matrix map (" << table_name
+                  << " elements) needs " << memory_MB
+                  << " MB, more than the limit of " << max_memory_MB
+                  << " MB. Matrix entries are searched in assembly."
+                  << "\n";
+        return false;
+    }
+
+    try
+    {
+        element_entry_ptr.resize(n_elements + 1);
+        element_entry.reserve(static_cast<std::size_t>(n_entries));
+    }
+    catch (std::bad_alloc&)
+    {
+        element_entry_ptr.clear();
+        std::vector<long>().swap(element_entry);
+        std::cout << "-> Not enough memory for the element-to-matrix map."
+                  << " Matrix entries are searched in assembly."
+                  << "\n";
+        return false;
+    }
+
+    element_entry_ptr[0] = 0;
+    std::vector<long> eqs_index;
+    for (std::size_t e = 0; e < n_elements; e++)
+    {
+        MeshLib::CElem const* elem = a_mesh->ele_vector[e];
+        const long nn = static_cast<long>(elem->GetNodesNumber(quadratic));
+        eqs_index.resize(nn);
+        bool mapped = true;
+        for (long i = 0; i < nn; i++)
+        {
+            eqs_index[i] = elem->GetNode(i)->GetEquationIndex();
+            if (eqs_index[i] < 0 || eqs_index[i] >= rows)
+                mapped = false;
+        }
+        const std::size_t first = element_entry.size();
+        for (long i = 0; i < nn && mapped; i++)
+            for (long j = 0; j < nn; j++)
+            {
+                const long k = EntryPosition(eqs_index[i], eqs_index[j]);
+                if (k < 0)
+                {
+                    mapped = false;
+                    break;
+                }
+                element_entry.push_back(k);
+            }
+        // Elements with entries outside the table keep the search
+        if (!mapped)
+            element_entry.resize(first);
+        element_entry_ptr[e + 1] = static_cast<long>(element_entry.size());
+    }
+
+    std::cout << "-> Element-to-matrix map (" << table_name
+              << " elements): " << memory_MB << " MB"
+              << "\n";
+    return true;
+}
+
 /*\!
  ********************************************************************
    Create sparse matrix table
@@ -1085,7 +1164,7 @@ SparseTable::~SparseTable()
    02/2008 PCH Compressed Row Storage
  ********************************************************************/
 CSparseMatrix::CSparseMatrix(const SparseTable& sparse_table, const int dof)
-    : DOF(dof)
+    : DOF(dof), ilu(NULL), amg(NULL), direct_solver(NULL)
 {
     symmetry = sparse_table.symmetry;
     size_entry_column = sparse_table.size_entry_column;
@@ -1099,10 +1178,28 @@ CSparseMatrix::CSparseMatrix(const SparseTable& sparse_table, const int dof)
     row_index_mapping_n2o = sparse_table.row_index_mapping_n2o;
     row_index_mapping_o2n = sparse_table.row_index_mapping_o2n;
     diag_entry = sparse_table.diag_entry;
+    element_entry_ptr = NULL;
+    element_entry = NULL;
+    if (!sparse_table.element_entry_ptr.empty())
+    {
+        element_entry_ptr = &sparse_table.element_entry_ptr[0];
+        element_entry = sparse_table.element_entry.empty()
+                            ? NULL
+                            : &sparse_table.element_entry[0];
+    }
     // Values of all sparse entries
     entry = new double[dof * dof * size_entry_column + 1];
     entry[dof * dof * size_entry_column] = 0.;
     zero_e = 0.;
+    // Start of each jagged diagonal, which allows row-wise traversal
+    if (storage_type == JDS)
+    {
+        jds_column_offset.resize(max_columns + 1);
+        jds_column_offset[0] = 0;
+        for (long k = 0; k < max_columns; k++)
+            jds_column_offset[k + 1] =
+                jds_column_offset[k] + num_column_entries[k];
+    }
 //
 #if defined(LIS) || defined(MKL)  // PCH
     int counter_ptr = 0, counter_col_idx = 0;
@@ -1129,8 +1226,7 @@ CSparseMatrix::CSparseMatrix(const SparseTable& sparse_table, const int dof)
                         // I = ii * rows + i; // row in global matrix
                         // column in global matrix
                         const int J = jj * rows + entry_column[counter];
-                        const int K = (ii * DOF + jj) *
-                                          size_entry_column + counter;
+                        const int K = EntryIndex(counter, ii, jj);
 
                         // Store column index for CRS
                         col_idx[counter_col_idx] = J;
@@ -1158,6 +1254,12 @@ CSparseMatrix::~CSparseMatrix()
 {
     delete[] entry;
     entry = NULL;
+    delete ilu;
+    ilu = NULL;
+    delete amg;
+    amg = NULL;
+    delete direct_solver;
+    direct_solver = NULL;
 
 #if defined(LIS) || defined(MKL)  // PCH
     delete[] ptr;
@@ -1217,9 +1319,9 @@ double& CSparseMatrix::operator()(const long i, const long j) const
         if (counter >= size_entry_column)
             return zero_e;
         //  Zero entry;
-        k = (ii * DOF + jj) * size_entry_column + counter;
+        k = EntryIndex(counter, ii, jj);
     }
-    else if (storage_type == CRS)
+    else
     {
         /// Left boundary of this row: num_column_entries[ir]
         /// Right boundary of this row: num_column_entries[ir+1]
@@ -1229,7 +1331,7 @@ double& CSparseMatrix::operator()(const long i, const long j) const
         if (k == -1)
             return zero_e;
 
-        k = (ii * DOF + jj) * size_entry_column + k;
+        k = EntryIndex(k, ii, jj);
     }
 
     return entry[k];  //
@@ -1330,6 +1432,41 @@ void CSparseMatrix::operator-=(const CSparseMatrix& m)
     for (long i = 0; i < size; i++)
         entry[i] -= m.entry[i];
 }
+/*\!
+ ********************************************************************
+   Linear combination of matrices with the same sparse table:
+   this = fac[0]*m[0] + ... + fac[n-1]*m[n-1]
+   The factors are applied entry by entry in one pass, so no
+   intermediate matrix is formed.
+ ********************************************************************/
+void CSparseMatrix::Combine(const int n, const double* fac,
+                            const CSparseMatrix* const* m)
+{
+    const long size = DOF * DOF * size_entry_column;
+    std::vector<const double*> m_entry(n);
+    for (int k = 0; k < n; k++)
+    {
+#ifdef gDEBUG
+        if (size != m[k]->DOF * m[k]->DOF * m[k]->size_entry_column)
+        {
+            std::cout << "\n Dimensions of two matrices do not match"
+                      << "\n";
+            abort();
+        }
+#endif
+        m_entry[k] = m[k]->entry;
+    }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < size; i++)
+    {
+        double val = 0.;
+        for (int k = 0; k < n; k++)
+            val += fac[k] * m_entry[k][i];
+        entry[i] = val;
+    }
+}
 /*\!
  ********************************************************************
    Output sparse matrix
@@ -1346,7 +1483,7 @@ void CSparseMatrix::Write(std::ostream& os)
     os.width(14);
     os.precision(8);
     //
-    if (storage_type == CRS)
+    if (storage_type != JDS)
         for (ii = 0; ii < DOF; ii++)
             for (i = 0; i < rows; i++)
                 for (jj = 0; jj < DOF; jj++)
@@ -1359,7 +1496,7 @@ void CSparseMatrix::Write(std::ostream& os)
                         os << std::setw(10) << ii * rows + i << " "
                            << std::setw(10) << jj * rows + entry_column[k]
                            << " " << std::setw(15)
-                           << entry[(ii * DOF + jj) * size_entry_column + k]
+                           << entry[EntryIndex(k, ii, jj)]
                            << "\n";
 
     else if (storage_type == JDS)
@@ -1382,8 +1519,7 @@ void CSparseMatrix::Write(std::ostream& os)
                                << std::setw(10)
                                << jj * rows + entry_column[counter] << " "
                                << std::setw(15)
-                               << entry[(ii * DOF + jj) * size_entry_column +
-                                        counter]
+                               << entry[EntryIndex(counter, ii, jj)]
                                << "\n";
                             counter += num_column_entries[k];
                         }
@@ -1437,7 +1573,7 @@ void CSparseMatrix::Write_BIN(std::ostream& os)
                     {
                         A_index[counter] = jj * rows + entry_column[k];
                         A_value[counter] =
-                            entry[(ii * DOF + jj) * size_entry_column + k];
+                            entry[EntryIndex(k, ii, jj)];
                         counter++;
                     }
             }
@@ -1463,192 +1599,372 @@ void CSparseMatrix::Write_BIN(std::ostream& os)
    08/2007 WW
    10/2007 WW
    03/2011 WW      CRS storage
+   OpenMP: rows are distributed over the threads. The symmetric part
+   is scattered into thread private buffers to avoid write conflicts.
 ********************************************************************/
 void CSparseMatrix::multiVec(double* vec_s, double* vec_r)
 {
-    long i, j, k, ii, jj, kk, ll, idof, jdof, counter;
-    for (i = 0; i < rows * DOF; i++)
+    const long dim = rows * DOF;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < dim; i++)
         vec_r[i] = 0.0;
-    //
-    counter = 0;
-    if (DOF > 1)
+
+    RowProduct(vec_s, vec_r, false);
+    if (symmetry)
+        ColumnProduct(vec_s, vec_r, true);
+}
+
+/*\!
+ ********************************************************************
+   Perform A^T*x
+   Arguments:
+      vec_sr: M^T*vec_s-->vec_r
+   10/2010 WW
+   03/2011 WW      CRS storage
+ ********************************************************************/
+void CSparseMatrix::Trans_MultiVec(double* vec_s, double* vec_r)
+{
+    const long dim = rows * DOF;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < dim; i++)
+        vec_r[i] = 0.0;
+
+    ColumnProduct(vec_s, vec_r, false);
+    if (symmetry)
+        RowProduct(vec_s, vec_r, true);
+}
+
+/*\!
+ ********************************************************************
+   vec_r += A*vec_s over the stored entries.
+   Each row of the result is written by only one thread, and the
+   summation order within a row is that of the serial code.
+   Arguments:
+      skip_diag: skip the diagonal entries (symmetric storage)
+ ********************************************************************/
+void CSparseMatrix::RowProduct(const double* vec_s, double* vec_r,
+                               const bool skip_diag) const
+{
+    if (storage_type == BCSR)
+        switch (DOF)
+        {
+            case 2:
+                BlockRowProduct<2>(vec_s, vec_r, skip_diag);
+                return;
+            case 3:
+                BlockRowProduct<3>(vec_s, vec_r, skip_diag);
+                return;
+            case 4:
+                BlockRowProduct<4>(vec_s, vec_r, skip_diag);
+                return;
+            default:
+                break;
+        }
+    if (storage_type != JDS)
     {
-        // Although this piece of code can deal with the case
-        // of DOF = 1, we also prepare a special piece of code for
-        // the case of DOF = 1 just for efficiency
-        if (storage_type == CRS)
+        if (DOF == 1)
         {
-            /// ptr is num_column_entries
-            for (ii = 0; ii < rows; ii++)
-                for (j = num_column_entries[ii]; j < num_column_entries[ii + 1];
-                     j++)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (long ii = 0; ii < rows; ii++)
+            {
+                double val = 0.;
+                const long row_end = num_column_entries[ii + 1];
+                for (long j = num_column_entries[ii]; j < row_end; j++)
                 {
-                    jj = entry_column[j];
-                    for (idof = 0; idof < DOF; idof++)
-                    {
-                        kk = idof * rows + ii;
-                        for (jdof = 0; jdof < DOF; jdof++)
-                        {
-                            ll = jdof * rows + jj;
-                            k = (idof * DOF + jdof) * size_entry_column + j;
-                            vec_r[kk] += entry[k] * vec_s[ll];
-                            if (symmetry & (kk != ll))
-                                vec_r[ll] += entry[k] * vec_s[kk];
-                        }
-                    }
+                    const long jj = entry_column[j];
+                    if (skip_diag && ii == jj)
+                        continue;
+                    val += entry[j] * vec_s[jj];
                 }
+                vec_r[ii] += val;
+            }
+            return;
         }
-        else if (storage_type == JDS)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (long ii = 0; ii < rows; ii++)
         {
-            for (k = 0; k < max_columns; k++)
-                for (i = 0; i < num_column_entries[k]; i++)
+            const long row_end = num_column_entries[ii + 1];
+            for (long idof = 0; idof < DOF; idof++)
+            {
+                const long kk = idof * rows + ii;
+                double val = 0.;
+                for (long j = num_column_entries[ii]; j < row_end; j++)
                 {
-                    ii = row_index_mapping_n2o[i];
-                    jj = entry_column[counter];
-                    for (idof = 0; idof < DOF; idof++)
+                    const long jj = entry_column[j];
+                    for (long jdof = 0; jdof < DOF; jdof++)
                     {
-                        kk = idof * rows + ii;
-                        for (jdof = 0; jdof < DOF; jdof++)
-                        {
-                            ll = jdof * rows + jj;
-                            j = (idof * DOF + jdof) * size_entry_column +
-                                counter;
-                            vec_r[kk] += entry[j] * vec_s[ll];
-                            if (symmetry & (kk != ll))
-                                vec_r[ll] += entry[j] * vec_s[kk];
-                        }
+                        const long ll = jdof * rows + jj;
+                        if (skip_diag && kk == ll)
+                            continue;
+                        val += entry[EntryIndex(j, idof, jdof)] *
+                               vec_s[ll];
                     }
-                    counter++;
                 }
+                vec_r[kk] += val;
+            }
         }
     }
-    else  // DOF = 1
+    else if (storage_type == JDS)
     {
-        if (storage_type == CRS)
+        const long* offset = &jds_column_offset[0];
+        if (DOF == 1)
         {
-            /// ptr is num_column_entries
-            for (ii = 0; ii < rows; ii++)
-                for (j = num_column_entries[ii]; j < num_column_entries[ii + 1];
-                     j++)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (long i = 0; i < rows; i++)
+            {
+                const long ii = row_index_mapping_n2o[i];
+                double val = 0.;
+                for (long k = 0; k < max_columns; k++)
                 {
-                    jj = entry_column[j];
-                    vec_r[ii] += entry[j] * vec_s[jj];
-                    if (symmetry & (ii != jj))
-                        vec_r[jj] += entry[j] * vec_s[ii];
+                    if (i >= num_column_entries[k])
+                        break;
+                    const long counter = offset[k] + i;
+                    const long jj = entry_column[counter];
+                    if (skip_diag && ii == jj)
+                        continue;
+                    val += entry[counter] * vec_s[jj];
                 }
+                vec_r[ii] += val;
+            }
+            return;
         }
-        else if (storage_type == JDS)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (long i = 0; i < rows; i++)
         {
-            for (k = 0; k < max_columns; k++)
-                for (i = 0; i < num_column_entries[k]; i++)
+            const long ii = row_index_mapping_n2o[i];
+            for (long idof = 0; idof < DOF; idof++)
+            {
+                const long kk = idof * rows + ii;
+                double val = 0.;
+                for (long k = 0; k < max_columns; k++)
                 {
-                    ii = row_index_mapping_n2o[i];
-                    jj = entry_column[counter];
-                    vec_r[ii] += entry[counter] * vec_s[jj];
-                    if (symmetry & (ii != jj))
-                        vec_r[jj] += entry[counter] * vec_s[ii];
-                    counter++;
+                    if (i >= num_column_entries[k])
+                        break;
+                    const long counter = offset[k] + i;
+                    const long jj = entry_column[counter];
+                    for (long jdof = 0; jdof < DOF; jdof++)
+                    {
+                        const long ll = jdof * rows + jj;
+                        if (skip_diag && kk == ll)
+                            continue;
+                        val += entry[EntryIndex(counter, idof, jdof)] *
+                               vec_s[ll];
+                    }
                 }
+                vec_r[kk] += val;
+            }
         }
     }
 }
 
 /*\!
  ********************************************************************
-   Perform A^T*x
-   Arguments:
-      vec_sr: M^T*vec_s-->vec_r
-   10/2010 WW
-   03/2011 WW      CRS storage
+   vec_r += A*vec_s for BCSR storage with the DOF N known at compile
+   time. The N x N block of an entry is contiguous, and the N values of
+   a row of the sparse table are summed up together.
  ********************************************************************/
-void CSparseMatrix::Trans_MultiVec(double* vec_s, double* vec_r)
+template <int N>
+void CSparseMatrix::BlockRowProduct(const double* vec_s, double* vec_r,
+                                    const bool skip_diag) const
 {
-    long i, j, k, ii, jj, kk, ll, idof, jdof, counter;
-    for (i = 0; i < rows * DOF; i++)
-        vec_r[i] = 0.0;
-    //
-    counter = 0;
-    if (DOF > 1)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long ii = 0; ii < rows; ii++)
     {
-        // Although this piece of code can deal with the case
-        // of DOF = 1, we also prepare a special piece of code for
-        // the case of DOF = 1 just for efficiency
-        if (storage_type == CRS)
+        double val[N];
+        for (int idof = 0; idof < N; idof++)
+            val[idof] = 0.;
+        const long row_end = num_column_entries[ii + 1];
+        for (long j = num_column_entries[ii]; j < row_end; j++)
         {
-            /// ptr is num_column_entries
-            for (ii = 0; ii < rows; ii++)
-                for (j = num_column_entries[ii]; j < num_column_entries[ii + 1];
-                     j++)
-                {
-                    jj = entry_column[j];
-                    for (idof = 0; idof < DOF; idof++)
-                    {
-                        kk = idof * rows + ii;
-                        for (jdof = 0; jdof < DOF; jdof++)
-                        {
-                            ll = jdof * rows + jj;
-                            k = (idof * DOF + jdof) * size_entry_column + j;
-                            vec_r[ll] += entry[k] * vec_s[kk];
-                            if (symmetry & (kk != ll))
-                                vec_r[kk] += entry[k] * vec_s[ll];
-                        }
-                    }
-                }
+            const long jj = entry_column[j];
+            const double* block = entry + j * N * N;
+            double s[N];
+            for (int jdof = 0; jdof < N; jdof++)
+                s[jdof] = vec_s[jdof * rows + jj];
+            if (skip_diag && ii == jj)
+            {
+                for (int idof = 0; idof < N; idof++)
+                    for (int jdof = 0; jdof < N; jdof++)
+                        if (idof != jdof)
+                            val[idof] += block[idof * N + jdof] * s[jdof];
+                continue;
+            }
+            for (int idof = 0; idof < N; idof++)
+                for (int jdof = 0; jdof < N; jdof++)
+                    val[idof] += block[idof * N + jdof] * s[jdof];
         }
-        else if (storage_type == JDS)
+        for (int idof = 0; idof < N; idof++)
+            vec_r[idof * rows + ii] += val[idof];
+    }
+}
+
+/*\!
+ ********************************************************************
+   Row ii of the matrix and the range [j_begin, j_end) of the entries of
+   row i of the sparse table, i.e. of the permuted rows in the case of
+   JDS. The index of entry j in entry_column is
+   jds_column_offset[j] + i for JDS and j otherwise.
+ ********************************************************************/
+void CSparseMatrix::GetRowRange(const long i, long& ii, long& j_begin,
+                                long& j_end) const
+{
+    if (storage_type != JDS)
+    {
+        ii = i;
+        j_begin = num_column_entries[i];
+        j_end = num_column_entries[i + 1];
+        return;
+    }
+    ii = row_index_mapping_n2o[i];
+    j_begin = 0;
+    j_end = 0;
+    while (j_end < max_columns && i < num_column_entries[j_end])
+        j_end++;
+}
+
+/*\!
+ ********************************************************************
+   vec_r += A^T*vec_s over the stored entries, row by row in the order
+   of the sparse table.
+ ********************************************************************/
+void CSparseMatrix::ScatterRows(const double* vec_s, double* vec_r,
+                                const bool skip_diag) const
+{
+    const long* offset =
+        (storage_type == JDS) ? &jds_column_offset[0] : NULL;
+    for (long i = 0; i < rows; i++)
+    {
+        long ii, j_begin, j_end;
+        GetRowRange(i, ii, j_begin, j_end);
+        for (long j = j_begin; j < j_end; j++)
         {
-            for (k = 0; k < max_columns; k++)
-                for (i = 0; i < num_column_entries[k]; i++)
+            // Index of the entry in entry_column
+            const long counter = (offset) ? offset[j] + i : j;
+            const long jj = entry_column[counter];
+            if (DOF == 1)
+            {
+                if (skip_diag && ii == jj)
+                    continue;
+                vec_r[jj] += entry[counter] * vec_s[ii];
+                continue;
+            }
+            for (long idof = 0; idof < DOF; idof++)
+            {
+                const long kk = idof * rows + ii;
+                for (long jdof = 0; jdof < DOF; jdof++)
                 {
-                    ii = row_index_mapping_n2o[i];
-                    jj = entry_column[counter];
-                    for (idof = 0; idof < DOF; idof++)
-                    {
-                        kk = idof * rows + ii;
-                        for (jdof = 0; jdof < DOF; jdof++)
-                        {
-                            ll = jdof * rows + jj;
-                            j = (idof * DOF + jdof) * size_entry_column +
-                                counter;
-                            vec_r[ll] += entry[j] * vec_s[kk];
-                            if (symmetry & (kk != ll))
-                                vec_r[kk] += entry[j] * vec_s[ll];
-                        }
-                    }
-                    counter++;
+                    const long ll = jdof * rows + jj;
+                    if (skip_diag && kk == ll)
+                        continue;
+                    vec_r[ll] += entry[EntryIndex(counter, idof, jdof)] *
+                                 vec_s[kk];
                 }
+            }
         }
     }
-    else  // DOF = 1
+}
+
+/*\!
+ ********************************************************************
+   Transposed pattern of the sparse table for the column products: the
+   entries of each column with their rows, in the order of the rows of
+   the sparse table. It is built once, as the pattern does not change.
+ ********************************************************************/
+void CSparseMatrix::SetupColumnPattern()
+{
+    const long* offset =
+        (storage_type == JDS) ? &jds_column_offset[0] : NULL;
+    column_entry_ptr.assign(rows + 1, 0);
+    for (long i = 0; i < rows; i++)
     {
-        if (storage_type == CRS)
+        long ii, j_begin, j_end;
+        GetRowRange(i, ii, j_begin, j_end);
+        for (long j = j_begin; j < j_end; j++)
         {
-            /// ptr is num_column_entries
-            for (ii = 0; ii < rows; ii++)
-                for (j = num_column_entries[ii]; j < num_column_entries[ii + 1];
-                     j++)
-                {
-                    jj = entry_column[j];
-                    vec_r[jj] += entry[j] * vec_s[ii];
-                    if (symmetry & (ii != jj))
-                        vec_r[ii] += entry[j] * vec_s[jj];
-                }
+            const long counter = (offset) ? offset[j] + i : j;
+            column_entry_ptr[entry_column[counter] + 1]++;
         }
-        else if (storage_type == JDS)
+    }
+    for (long jj = 0; jj < rows; jj++)
+        column_entry_ptr[jj + 1] += column_entry_ptr[jj];
+
+    column_entry_row.resize(column_entry_ptr[rows]);
+    column_entry.resize(column_entry_ptr[rows]);
+    std::vector<long> pos(column_entry_ptr.begin(), column_entry_ptr.end() - 1);
+    for (long i = 0; i < rows; i++)
+    {
+        long ii, j_begin, j_end;
+        GetRowRange(i, ii, j_begin, j_end);
+        for (long j = j_begin; j < j_end; j++)
         {
-            for (k = 0; k < max_columns; k++)
-                for (i = 0; i < num_column_entries[k]; i++)
+            const long counter = (offset) ? offset[j] + i : j;
+            const long k = pos[entry_column[counter]]++;
+            column_entry_row[k] = ii;
+            column_entry[k] = counter;
+        }
+    }
+}
+
+/*\!
+ ********************************************************************
+   vec_r += A^T*vec_s over the stored entries.
+   Several rows scatter into the same entry of vec_r. With more than
+   one thread, the columns are distributed over the threads instead,
+   using the transposed pattern. Each entry of the result is written by
+   only one thread, and its summation order is that of the serial code.
+ ********************************************************************/
+void CSparseMatrix::ColumnProduct(const double* vec_s, double* vec_r,
+                                  const bool skip_diag)
+{
+#ifdef _OPENMP
+    if (omp_get_max_threads() > 1 && size_entry_column > 0)
+    {
+        if (column_entry_ptr.empty())
+            SetupColumnPattern();
+        const long* ptr = &column_entry_ptr[0];
+        const long* row = &column_entry_row[0];
+        const long* counter = &column_entry[0];
+#pragma omp parallel for
+        for (long jj = 0; jj < rows; jj++)
+        {
+            for (long jdof = 0; jdof < DOF; jdof++)
+            {
+                const long ll = jdof * rows + jj;
+                double val = vec_r[ll];
+                for (long k = ptr[jj]; k < ptr[jj + 1]; k++)
                 {
-                    ii = row_index_mapping_n2o[i];
-                    jj = entry_column[counter];
-                    vec_r[jj] += entry[counter] * vec_s[ii];
-                    if (symmetry & (ii != jj))
-                        vec_r[ii] += entry[counter] * vec_s[jj];
-                    counter++;
+                    for (long idof = 0; idof < DOF; idof++)
+                    {
+                        const long kk = idof * rows + row[k];
+                        if (skip_diag && kk == ll)
+                            continue;
+                        val += entry[EntryIndex(counter[k], idof, jdof)] *
+                               vec_s[kk];
+                    }
                 }
+                vec_r[ll] = val;
+            }
         }
+        return;
     }
+#endif
+    ScatterRows(vec_s, vec_r, skip_diag);
 }
+
 /*\!
  ********************************************************************
    Set
@@ -1669,23 +1985,22 @@ void CSparseMatrix::Diagonize(const long idiag, const double b_given, double* b)
 
     ii = idiag / rows;
 
-    if (storage_type == CRS)
+    if (storage_type != JDS)
     {
         const long row_end = num_column_entries[id + 1];
         /// Diagonal entry and the row where the diagonal entry exists
         j = diag_entry[id];
-        vdiag = entry[(ii * DOF + ii) * size_entry_column + j];
+        vdiag = entry[EntryIndex(j, ii, ii)];
 
         /// Row where the diagonal entry exists
         for (jj = 0; jj < DOF; jj++)
         {
-            const long ij = (ii * DOF + jj) * size_entry_column;
             for (k = num_column_entries[id]; k < row_end; k++)
             {
                 j0 = entry_column[k];
                 if (id == j0 && jj == ii)  // Diagonal entry
                     continue;
-                entry[ij + k] = 0.;
+                entry[EntryIndex(k, ii, jj)] = 0.;
             }
         }
 #ifdef colDEBUG
@@ -1702,7 +2017,7 @@ void CSparseMatrix::Diagonize(const long idiag, const double b_given, double* b)
             {
                 if (i == j0 && ii == jj)
                     continue;
-                k = (jj * DOF + ii) * size_entry_column + j;
+                k = EntryIndex(j, jj, ii);
                 b[jj * rows + i] -= entry[k] * b_given;
                 entry[k] = 0.;
                 // Room for symmetry case
@@ -1759,7 +2074,7 @@ void CSparseMatrix::Diagonize(const long idiag, const double b_given, double* b)
                     {
                         if (i0 == j0 && ii == jj)
                             continue;
-                        j = (jj * DOF + ii) * size_entry_column + counter;
+                        j = EntryIndex(counter, jj, ii);
                         b[jj * rows + i0] -= entry[j] * b_given;
                         entry[j] = 0.;
                         // Room for symmetry case
@@ -1793,11 +2108,13 @@ void CSparseMatrix::Precond_Jacobi(double* vec_s, double* vec_r)
         // Although this piece of code can deal with the case
         // of DOF = 1, we also prepare a special piece of code for
         // the case of DOF = 1 just for efficiency
+#ifdef _OPENMP
+#pragma omp parallel for private(idof, diag)
+#endif
         for (i = 0; i < rows; i++)
             for (idof = 0; idof < DOF; idof++)
             {
-                diag = entry[(idof * DOF + idof) * size_entry_column +
-                             diag_entry[i]];
+                diag = entry[EntryIndex(diag_entry[i], idof, idof)];
                 if (fabs(diag) < DBL_MIN)
                     //        if(fabs(diag)<DBL_EPSILON)
                     diag = 1.0;
@@ -1808,7 +2125,10 @@ void CSparseMatrix::Precond_Jacobi(double* vec_s, double* vec_r)
         //
     }
     else  // DOF = 1
-
+    {
+#ifdef _OPENMP
+#pragma omp parallel for private(diag)
+#endif
         for (i = 0; i < rows; i++)
         {
             diag = entry[diag_entry[i]];
@@ -1820,7 +2140,309 @@ void CSparseMatrix::Precond_Jacobi(double* vec_s, double* vec_r)
             //
             vec_r[i] = vec_s[i] / diag;
         }
+    }
 }
+
+/*\!
+ ********************************************************************
+   Inverse of the n x n matrix a (row-major) in place by Gauss-Jordan
+   elimination with partial pivoting. False if a is singular.
+ ********************************************************************/
+static bool InvertBlock(double* a, const int n)
+{
+    int pivot_row[8];
+    for (int k = 0; k < n; k++)
+    {
+        int p = k;
+        for (int i = k + 1; i < n; i++)
+            if (fabs(a[i * n + k]) > fabs(a[p * n + k]))
+                p = i;
+        if (fabs(a[p * n + k]) < DBL_MIN)
+            return false;
+        pivot_row[k] = p;
+        if (p != k)
+            for (int j = 0; j < n; j++)
+                std::swap(a[k * n + j], a[p * n + j]);
+        const double inv = 1.0 / a[k * n + k];
+        a[k * n + k] = 1.0;
+        for (int j = 0; j < n; j++)
+            a[k * n + j] *= inv;
+        for (int i = 0; i < n; i++)
+        {
+            if (i == k)
+                continue;
+            const double f = a[i * n + k];
+            a[i * n + k] = 0.;
+            for (int j = 0; j < n; j++)
+                a[i * n + j] -= f * a[k * n + j];
+        }
+    }
+    // Undo the row interchanges as column interchanges in reverse order
+    for (int k = n - 1; k >= 0; k--)
+        if (pivot_row[k] != k)
+            for (int i = 0; i < n; i++)
+                std::swap(a[i * n + k], a[i * n + pivot_row[k]]);
+    return true;
+}
+
+/*\!
+ ********************************************************************
+   Block Jacobi preconditioner: the DOF x DOF blocks of the diagonal
+   entries of the sparse table, i.e. the couplings of the unknowns of a
+   node, are inverted. A singular block is replaced by the inverse of
+   its diagonal, as for Precond_Jacobi.
+ ********************************************************************/
+void CSparseMatrix::ComputeBlockJacobi()
+{
+    const long n_block = static_cast<long>(DOF) * DOF;
+    block_jacobi.resize(rows * n_block);
+    if (DOF > 8)  // Larger blocks are not inverted
+    {
+        std::fill(block_jacobi.begin(), block_jacobi.end(), 0.);
+        for (long i = 0; i < rows; i++)
+            for (int idof = 0; idof < DOF; idof++)
+            {
+                const double diag =
+                    entry[EntryIndex(diag_entry[i], idof, idof)];
+                block_jacobi[i * n_block + idof * DOF + idof] =
+                    (fabs(diag) < DBL_MIN) ? 1.0 : 1.0 / diag;
+            }
+        return;
+    }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < rows; i++)
+    {
+        double* block = &block_jacobi[i * n_block];
+        for (int idof = 0; idof < DOF; idof++)
+            for (int jdof = 0; jdof < DOF; jdof++)
+                block[idof * DOF + jdof] =
+                    entry[EntryIndex(diag_entry[i], idof, jdof)];
+        if (InvertBlock(block, DOF))
+            continue;
+        for (int idof = 0; idof < DOF; idof++)
+            for (int jdof = 0; jdof < DOF; jdof++)
+            {
+                double& b = block[idof * DOF + jdof];
+                if (idof != jdof)
+                    b = 0.;
+                else
+                {
+                    b = entry[EntryIndex(diag_entry[i], idof, idof)];
+                    b = (fabs(b) < DBL_MIN) ? 1.0 : 1.0 / b;
+                }
+            }
+    }
+}
+
+void CSparseMatrix::Precond_BlockJacobi(const double* vec_s, double* vec_r,
+                                        const bool transpose) const
+{
+    const long n_block = static_cast<long>(DOF) * DOF;
+    const long row_stride = transpose ? 1 : DOF;
+    const long col_stride = transpose ? DOF : 1;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < rows; i++)
+    {
+        const double* block = &block_jacobi[i * n_block];
+        for (int idof = 0; idof < DOF; idof++)
+        {
+            double val = 0.;
+            for (int jdof = 0; jdof < DOF; jdof++)
+                val += block[idof * row_stride + jdof * col_stride] *
+                       vec_s[jdof * rows + i];
+            vec_r[idof * rows + i] = val;
+        }
+    }
+}
+
+/*\!
+ ********************************************************************
+   Incomplete LU factorization of the matrix.
+   The pattern analysis is kept and reused for the next factorization
+   as long as the DOF of the matrix is the same.
+   Arguments:
+      drop_tolerance: relative drop tolerance of ILUT
+      max_fill: maximum number of entries per row of L and U (ILUT).
+                If max_fill < 0, ILU(0) is used.
+      level_scheduling: level-scheduled triangular solves
+ ********************************************************************/
+void CSparseMatrix::ComputeILU(const double drop_tolerance, const int max_fill,
+                               const bool level_scheduling)
+{
+    if (!ilu)
+        ilu = new ILUPreconditioner();
+    ilu->Configure(drop_tolerance, max_fill, level_scheduling);
+    ilu->Factorize(*this);
+}
+
+/*\!
+ ********************************************************************
+   M^{-1}*A with M = LU
+ ********************************************************************/
+void CSparseMatrix::Precond_ILU(double* vec_s, double* vec_r)
+{
+    if (!ilu)
+    {
+        Precond_Jacobi(vec_s, vec_r);
+        return;
+    }
+    ilu->Solve(vec_s, vec_r);
+}
+
+/*\!
+ ********************************************************************
+   M^{-T}*A with M = LU
+ ********************************************************************/
+void CSparseMatrix::TransPrecond_ILU(double* vec_s, double* vec_r)
+{
+    if (!ilu)
+    {
+        Precond_Jacobi(vec_s, vec_r);
+        return;
+    }
+    ilu->TransSolve(vec_s, vec_r);
+}
+
+/*\!
+ ********************************************************************
+   Add a block of an element matrix to the DOF block of the global row
+   and column shifts through the element-to-matrix map.
+   Arguments:
+      ele_entries: map of the element, see ElementEntries()
+      nnodes: number of nodes of the element
+      row_shift, col_shift: shifts of the DOF block. Both must satisfy
+                            IsBlockShift().
+      local: first entry of the block in the row-major element matrix
+      ld: number of columns of the element matrix
+      fac: factor of the element matrix
+ ********************************************************************/
+void CSparseMatrix::AddElementBlock(const long* ele_entries, const int nnodes,
+                                    const long row_shift, const long col_shift,
+                                    const double* local, const int ld,
+                                    const double fac)
+{
+    double* a_block = entry + EntryIndex(0, row_shift / rows, col_shift / rows);
+    // Distance of the values of successive sparse table entries in a block
+    const long stride = (storage_type == BCSR) ? DOF * DOF : 1;
+    for (int i = 0; i < nnodes; i++)
+    {
+        const long* row_entries = ele_entries + i * nnodes;
+        const double* local_row = local + i * ld;
+        for (int j = 0; j < nnodes; j++)
+            a_block[row_entries[j] * stride] += fac * local_row[j];
+    }
+}
+
+/*\!
+ ********************************************************************
+   Setup of the smoothed aggregation AMG. The aggregates and the
+   prolongations are kept for the next setup as long as the DOF of the
+   matrix is the same, and only the coarse operators are recomputed.
+ ********************************************************************/
+bool CSparseMatrix::ComputeAMG(const AMGParameters& parameters,
+                               const CNumerics* num)
+{
+    if (!amg)
+        amg = new AMGPreconditioner();
+    amg->Configure(parameters);
+    return amg->Setup(*this, num);
+}
+
+/*\!
+ ********************************************************************
+   Sparse direct solver. A new one is only created if the factorization
+   type changes, e.g. for processes with different numerics that share
+   the matrix.
+ ********************************************************************/
+SparseDirectSolver* CSparseMatrix::GetDirectSolver(const bool symmetric)
+{
+    const SparseDirectSolver::Method method =
+        symmetric ? SparseDirectSolver::LDLT : SparseDirectSolver::LU;
+    if (direct_solver && direct_solver->GetMethod() != method)
+    {
+        delete direct_solver;
+        direct_solver = NULL;
+    }
+    if (!direct_solver)
+        direct_solver = new SparseDirectSolver(method);
+    return direct_solver;
+}
+
+/*\!
+ ********************************************************************
+   M^{-1}*A with one AMG cycle
+ ********************************************************************/
+void CSparseMatrix::Precond_AMG(double* vec_s, double* vec_r)
+{
+    if (!amg)
+    {
+        Precond_Jacobi(vec_s, vec_r);
+        return;
+    }
+    amg->Solve(vec_s, vec_r);
+}
+
+/*\!
+ ********************************************************************
+   Point-wise compressed row pattern of the whole matrix, i.e. row
+   idof*rows+i for node i and DOF idof. The entries of the lower triangle
+   of a symmetric storage are added to the pattern, too.
+ ********************************************************************/
+void CSparseMatrix::GetScalarCRSPattern(std::vector<long>& ptr,
+                                        std::vector<long>& col_idx,
+                                        std::vector<long>& entry_idx) const
+{
+    const long dim = rows * DOF;
+    // (column, index of the value) of each row
+    std::vector<std::vector<std::pair<long, long> > > row_entries(dim);
+    const long* offset =
+        (storage_type == JDS) ? &jds_column_offset[0] : NULL;
+    for (long i = 0; i < rows; i++)
+    {
+        long ii, j_begin, j_end;
+        GetRowRange(i, ii, j_begin, j_end);
+        for (long j = j_begin; j < j_end; j++)
+        {
+            const long counter = (offset) ? offset[j] + i : j;
+            const long jj = entry_column[counter];
+            for (long idof = 0; idof < DOF; idof++)
+            {
+                const long kk = idof * rows + ii;
+                for (long jdof = 0; jdof < DOF; jdof++)
+                {
+                    const long ll = jdof * rows + jj;
+                    const long k =
+                        EntryIndex(counter, idof, jdof);
+                    row_entries[kk].push_back(std::make_pair(ll, k));
+                    if (symmetry && kk != ll)
+                        row_entries[ll].push_back(std::make_pair(kk, k));
+                }
+            }
+        }
+    }
+
+    ptr.resize(dim + 1);
+    ptr[0] = 0;
+    for (long i = 0; i < dim; i++)
+        ptr[i + 1] = ptr[i] + static_cast<long>(row_entries[i].size());
+    col_idx.resize(ptr[dim]);
+    entry_idx.resize(ptr[dim]);
+    for (long i = 0; i < dim; i++)
+    {
+        std::vector<std::pair<long, long> >& row = row_entries[i];
+        std::sort(row.begin(), row.end());
+        for (std::size_t k = 0; k < row.size(); k++)
+        {
+            col_idx[ptr[i] + k] = row[k].first;
+            entry_idx[ptr[i] + k] = row[k].second;
+        }
+    }
+}
+
 #if defined(USE_MPI)
 /*\!
  ********************************************************************
@@ -1839,8 +2461,7 @@ void CSparseMatrix::DiagonalEntries(double* diag_e)
         for (i = 0; i < rows; i++)
             for (idof = 0; idof < DOF; idof++)
                 diag_e[idof * rows + i] =
-                    entry[(idof * DOF + idof) * size_entry_column +
-                          diag_entry[i]];
+                    entry[EntryIndex(diag_entry[i], idof, idof)];
     //
     else  // DOF = 1
 
@@ -31,6 +31,7 @@ class CFEMesh;
 }
 // 08.2007 WW
 class CPARDomain;
+class CNumerics;
 #endif
 //#define OverLoadNEW_DELETE
 
@@ -522,7 +523,10 @@ public:
 enum StorageType
 {
     CRS,
-    JDS
+    JDS,
+    /// Table of CRS, with the DOF x DOF values of each entry stored
+    /// together (row-major), i.e. node-block interleaved
+    BCSR
 };
 class SparseTable
 {
@@ -532,6 +536,11 @@ public:
     SparseTable(CPARDomain& m_dom, bool quadratic, bool symm = false);
     ~SparseTable();
     void Write(std::ostream& os = std::cout);
+    /// Build the positions of the entries of all element matrices in the
+    /// value array of the sparse matrix. The map is not built if it needs
+    /// more than max_memory_MB, and the assembly then searches the entries.
+    bool BuildElementEntryMap(MeshLib::CFEMesh* a_mesh, bool quadratic,
+                              const double max_memory_MB);
 
 private:
     bool symmetry;
@@ -547,8 +556,19 @@ private:
     long max_columns;
     long rows;
     StorageType storage_type;  // 04.2011. WW
+    /// Element-to-matrix scatter map: entries element_entry_ptr[e] to
+    /// element_entry_ptr[e+1] of element_entry hold the positions (in the
+    /// first DOF block) of the entries (i, j) of the nodes of element e,
+    /// row by row. An element without entries is not mapped.
+    std::vector<long> element_entry_ptr;
+    std::vector<long> element_entry;
+    long EntryPosition(const long row, const long col) const;
     friend class CSparseMatrix;
 };
+class ILUPreconditioner;
+class AMGPreconditioner;
+struct AMGParameters;
+class SparseDirectSolver;
 // 08.2007 WW
 // Jagged Diagonal Storage
 class CSparseMatrix
@@ -558,8 +578,48 @@ public:
     ~CSparseMatrix();
     // Preconditioner
     void Precond_Jacobi(double* vec_s, double* vec_r);
-    // TEMP
-    void Precond_ILU(double* /*vec_s*/, double* /*vec_r*/) {}
+    /// Inverses of the DOF x DOF diagonal blocks of the nodes
+    void ComputeBlockJacobi();
+    /// M^{-1}*A (M^{-T}*A if transpose) with the diagonal blocks M
+    void Precond_BlockJacobi(const double* vec_s, double* vec_r,
+                             const bool transpose = false) const;
+    /// Incomplete LU factorization. max_fill < 0: ILU(0), otherwise ILUT.
+    void ComputeILU(const double drop_tolerance, const int max_fill,
+                    const bool level_scheduling);
+    void Precond_ILU(double* vec_s, double* vec_r);
+    void TransPrecond_ILU(double* vec_s, double* vec_r);
+    /// Smoothed aggregation AMG for the equation with the numerics num.
+    /// Returns true if the hierarchy was built anew, false if only its
+    /// coarse operators were updated.
+    bool ComputeAMG(const AMGParameters& parameters, const CNumerics* num);
+    void Precond_AMG(double* vec_s, double* vec_r);
+    const AMGPreconditioner* GetAMG() const { return amg; }
+    /// Sparse direct solver of the matrix, allocated on demand, LDLT for
+    /// symmetric matrices and LU otherwise. It keeps the symbolic analysis
+    /// and the last factorization.
+    SparseDirectSolver* GetDirectSolver(const bool symmetric);
+    /*!
+       Positions of the entries of an element matrix with nnodes x nnodes
+       entries in the sparse table, i.e. in the value array of a DOF block
+       for CRS and JDS, row by row. NULL if the element is not mapped, e.g.
+       for another number of nodes.
+     */
+    const long* ElementEntries(const long element, const int nnodes) const
+    {
+        if (element_entry_ptr == NULL)
+            return NULL;
+        const long* ptr = element_entry_ptr + element;
+        if (ptr[1] - ptr[0] != static_cast<long>(nnodes) * nnodes)
+            return NULL;
+        return element_entry + ptr[0];
+    }
+    /// True if a global row (column) shift is the start of a DOF block
+    bool IsBlockShift(const long shift) const { return shift % rows == 0; }
+    /// Add a block of an element matrix through the element-to-matrix map.
+    void AddElementBlock(const long* ele_entries, const int nnodes,
+                         const long row_shift, const long col_shift,
+                         const double* local, const int ld,
+                         const double fac = 1.0);
     // Operator
     void operator=(const double a);
     void operator*=(const double a);
@@ -567,6 +627,10 @@ public:
     void operator=(const CSparseMatrix& m);
     void operator+=(const CSparseMatrix& m);
     void operator-=(const CSparseMatrix& m);
+    /// Linear combination sum_k fac[k] m[k] of n matrices with the same
+    /// sparse table, in one pass over the entries
+    void Combine(const int n, const double* fac,
+                 const CSparseMatrix* const* m);
     // Vector pass through augment and bring results back.
     void multiVec(double* vec_s, double* vec_r);
     void Trans_MultiVec(double* vec_s, double* vec_r);
@@ -583,6 +647,21 @@ public:
         DOF = dof_n;
     }
     long Size() const { return rows; }
+    const double* Entries() const { return entry; }
+    /// Copy NumberOfEntries() values to the value array
+    void SetEntries(const double* values)
+    {
+        const long n = NumberOfEntries();
+        for (long i = 0; i < n; i++)
+            entry[i] = values[i];
+    }
+    long NumberOfEntries() const { return DOF * DOF * size_entry_column; }
+    /// Point-wise compressed row pattern of the whole matrix (all DOF
+    /// blocks) with ascending columns. entry_idx gives the position of
+    /// each entry in the value array.
+    void GetScalarCRSPattern(std::vector<long>& ptr,
+                             std::vector<long>& col_idx,
+                             std::vector<long>& entry_idx) const;
 #if defined(LIS) || \
     defined(MKL)  // These two pointers are in need for Compressed Row Storage
     int nnz() const  // PCH
@@ -623,6 +702,53 @@ private:
     long rows;
     //
     int DOF;
+    /// Element-to-matrix scatter map of the sparse table, or NULL
+    const long* element_entry_ptr;
+    const long* element_entry;
+
+    /// Offsets of the jagged diagonals in entry_column (JDS only)
+    std::vector<long> jds_column_offset;
+    /// Transposed pattern for the column products with OpenMP: the rows
+    /// and the indices in entry_column of the entries of column j are at
+    /// column_entry_ptr[j] to column_entry_ptr[j+1]-1.
+    std::vector<long> column_entry_ptr;
+    std::vector<long> column_entry_row;
+    std::vector<long> column_entry;
+    /// Inverted diagonal blocks of the nodes, DOF x DOF (row-major) each
+    std::vector<double> block_jacobi;
+    /// Incomplete LU factors, allocated on demand
+    ILUPreconditioner* ilu;
+    /// AMG hierarchy, allocated on demand
+    AMGPreconditioner* amg;
+    /// Sparse direct factorization, allocated on demand
+    SparseDirectSolver* direct_solver;
+
+    /// Position in entry of the value of DOF block (idof, jdof) at the
+    /// position counter of the sparse table
+    long EntryIndex(const long counter, const long idof,
+                    const long jdof) const
+    {
+        if (storage_type == BCSR)
+            return (counter * DOF + idof) * DOF + jdof;
+        return (idof * DOF + jdof) * size_entry_column + counter;
+    }
+    /// vec_r += A*vec_s restricted to the stored entries, row by row.
+    void RowProduct(const double* vec_s, double* vec_r,
+                    const bool skip_diag) const;
+    /// RowProduct of BCSR storage for DOF = N
+    template <int N>
+    void BlockRowProduct(const double* vec_s, double* vec_r,
+                         const bool skip_diag) const;
+    /// Row and range of the entries of row i of the sparse table
+    void GetRowRange(const long i, long& ii, long& j_begin,
+                     long& j_end) const;
+    /// vec_r += A^T*vec_s, row by row of the sparse table.
+    void ScatterRows(const double* vec_s, double* vec_r,
+                     const bool skip_diag) const;
+    void SetupColumnPattern();
+    /// vec_r += A^T*vec_s restricted to the stored entries.
+    void ColumnProduct(const double* vec_s, double* vec_r,
+                       const bool skip_diag);
 };
 // Since the pointer to member funtions gives lower performance
 #endif
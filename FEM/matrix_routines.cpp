@@ -1470,7 +1470,7 @@ double M5Get(long i, long j)
 
     const size_t jj(mesh->Eqs2Global_NodeIndex[j]);
     CNode const* const nod_i(mesh->nod_vector[mesh->Eqs2Global_NodeIndex[i]]);
-    std::vector<size_t> const& connected_nodes(nod_i->getConnectedNodes());
+    MeshLib::NodeAdjacency const& connected_nodes(nod_i->getConnectedNodes());
     const size_t n_connected_nodes(connected_nodes.size());
 
     for (size_t k = 0; k < n_connected_nodes; k++)
@@ -1497,7 +1497,7 @@ int M5Set(long i, long j, double e_val)
 
     const size_t jj(mesh->Eqs2Global_NodeIndex[j]);
     CNode const* const nod_i(mesh->nod_vector[mesh->Eqs2Global_NodeIndex[i]]);
-    std::vector<size_t> const& connected_nodes(nod_i->getConnectedNodes());
+    MeshLib::NodeAdjacency const& connected_nodes(nod_i->getConnectedNodes());
     const size_t n_connected_nodes(connected_nodes.size());
 
     for (size_t k = 0; k < n_connected_nodes; k++)
@@ -1727,7 +1727,7 @@ int M5Inc(long i, long j, double aij_inc)
 
     const size_t jj(mesh->Eqs2Global_NodeIndex[j]);
     CNode const* const nod_i(mesh->nod_vector[mesh->Eqs2Global_NodeIndex[i]]);
-    std::vector<size_t> const& connected_nodes(nod_i->getConnectedNodes());
+    MeshLib::NodeAdjacency const& connected_nodes(nod_i->getConnectedNodes());
     const size_t n_connected_nodes(connected_nodes.size());
     for (size_t k = 0; k < n_connected_nodes; k++)
         if (connected_nodes[k] == jj)
@@ -2447,7 +2447,7 @@ void MXRandbed(long ir, double Ri, double* ReSei)
             CNode const* const nod_i(
                 mesh->nod_vector[mesh->Eqs2Global_NodeIndex
                                      [i]]);  // TODO check this. i could be 0.
-            std::vector<size_t> const& connected_nodes(
+            MeshLib::NodeAdjacency const& connected_nodes(
                 nod_i->getConnectedNodes());
             const size_t n_connected_nodes(connected_nodes.size());
 
@@ -708,7 +708,7 @@ void CPARDomain::NodeConnectedNodes()
     for (size_t i = 0; i < n_nodes; i++)
     {
         nodes2node.clear();
-        std::vector<size_t> const& connected_nodes(
+        MeshLib::NodeAdjacency const& connected_nodes(
             m_msh->nod_vector[nodes[i]]->getConnectedNodes());
         const size_t n_connected_nodes(connected_nodes.size());
         for (size_t k = 0; k < n_connected_nodes; k++)
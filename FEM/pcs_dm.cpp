@@ -51,6 +51,7 @@
 #include "rf_ic_new.h"
 
 #include "rf_node.h"
+#include "QuasiNewtonUpdate.h"
 
 #if defined(USE_PETSC)  // || defined(other parallel libs)//03.3012. WW
 #include "PETSC/PETScLinearSolver.h"
@@ -94,6 +95,7 @@ namespace process
 CRFProcessDeformation::CRFProcessDeformation()
     : CRFProcess(),
       fem_dm(NULL),
+      quasi_newton(NULL),
       ARRAY(NULL),
       counter(0),
       InitialNorm(0.0),
@@ -121,6 +123,7 @@ CRFProcessDeformation::~CRFProcessDeformation()
         delete[] ARRAY;
     if (fem_dm)
         delete fem_dm;
+    delete quasi_newton;
 
     fem_dm = NULL;
     ARRAY = NULL;
@@ -637,6 +640,19 @@ double CRFProcessDeformation::Execute(int loop_process_number)
             ScreenMessage("      Load factor: %g\n", LoadFactor);
         }
         ite_steps = 0;
+        ResetJacobianLagging();
+#if defined(NEW_EQS) && !defined(USE_MPI)
+        bool quasi_newton_valid = true;
+        if (m_num->quasi_newton_method > 0 && m_num->nls_method == 1 &&
+            elasticity != 1)
+        {
+            if (!quasi_newton)
+                quasi_newton = new Math_Group::QuasiNewtonUpdate(
+                    m_num->quasi_newton_method,
+                    m_num->quasi_newton_max_updates);
+            quasi_newton->reset();
+        }
+#endif
         while (ite_steps < MaxIteration)
         {
             ite_steps++;
@@ -712,11 +728,16 @@ double CRFProcessDeformation::Execute(int loop_process_number)
             // 21.12.2007
             dom->eqsH->Solver(eqs_new->x, global_eqs_dim);
 #else
+            if (quasi_newton)
+                quasi_newton->prepareRHS(eqs_new->b, eqs_new->size_A);
 #if defined(LIS) || defined(MKL)
             eqs_new->Solver(this->m_num);  // NW
 #else
             eqs_new->Solver();  // 27.11.2007
 #endif
+            if (quasi_newton)
+                quasi_newton_valid =
+                    quasi_newton->correctSolution(eqs_new->x, eqs_new->b);
 #endif
 #else  // ifdef NEW_EQS
             ExecuteLinearSolver();
@@ -761,12 +782,50 @@ double CRFProcessDeformation::Execute(int loop_process_number)
 
                 Error = Norm / InitialNorm;
                 ErrorU = NormU / InitialNormU0;
+                // Modified Newton: the increment of an iteration with a kept
+                // Jacobian that does not decrease is discarded, and the
+                // iteration is repeated with a new Jacobian.
+                if (ite_steps < MaxIteration && !UpdateJacobianLagging(ErrorU))
+                {
+                    Error = Error1;
+                    ErrorU = ErrorU1;
+                    continue;
+                }
 
                 // Compute damping for Newton-Raphson step
                 damping = 1.0;
                 if (Error / Error1 > m_num->newton_damping_tolerance ||
                     ErrorU / ErrorU1 > m_num->newton_damping_tolerance)
                     damping = m_num->newton_damping_factor;
+#if defined(NEW_EQS) && !defined(USE_MPI)
+                // Quasi-Newton: the next iteration uses the kept tangent
+                // with the update of this step, or the tangent is assembled
+                // again (restart) if the update is ill-defined, the residual
+                // grows, or the number of updates is reached.
+                if (quasi_newton)
+                {
+                    if (!quasi_newton_valid ||
+                        (ite_steps > 1 && Error > Error1) ||
+                        quasi_newton->getNumberOfUpdates() >=
+                            quasi_newton->getMaxUpdates())
+                    {
+                        ScreenMessage(
+                            "      Quasi-Newton restart after %d updates\n",
+                            quasi_newton->getNumberOfUpdates());
+                        quasi_newton->reset();
+                        jacobian_lagged = false;
+                    }
+                    else
+                    {
+                        // The step of the first iteration contains the
+                        // increments of the Dirichlet boundary conditions
+                        // and is not used for an update.
+                        if (ite_steps > 1)
+                            quasi_newton->setStep(eqs_new->x, damping);
+                        jacobian_lagged = true;
+                    }
+                }
+#endif
 
 #if defined(NEW_EQS) && defined(JFNK_H2M)
                 /// If JFNK, get w from the buffer
@@ -838,6 +897,7 @@ double CRFProcessDeformation::Execute(int loop_process_number)
             // w = w+dw for Newton-Raphson
             UpdateIterativeStep(damping, 0);  // w = w+dw
         }                                     // Newton-Raphson iteration
+        ResetJacobianLagging();
 
         // Update stresses
         UpdateStress();
@@ -1382,7 +1442,8 @@ void CRFProcessDeformation::SetInitialGuess_EQS_VEC()
         {
             v_idx--;
             for (j = 0; j < number_of_nodes; j++)
-                eqs_x[shift + j] = GetNodeValue(j, v_idx);
+                eqs_x[shift + m_msh->nod_vector[j]->GetEquationIndex()] =
+                    GetNodeValue(j, v_idx);
         }
         else
             for (j = 0; j < number_of_nodes; j++)
@@ -1459,7 +1520,8 @@ void CRFProcessDeformation::UpdateIterativeStep(const double damp,
 
                     const long eqs_row = eqs_r;
 #else
-                    const long eqs_row = j + shift;
+                    const long eqs_row =
+                        m_msh->nod_vector[j]->GetEquationIndex() + shift;
 #endif
                     SetNodeValue(
                         j,
@@ -1498,7 +1560,8 @@ void CRFProcessDeformation::UpdateIterativeStep(const double damp,
                 const long eqs_row =
                     problem_dimension_dm * m_msh->Eqs2Global_NodeIndex[j] + i;
 #else
-                const long eqs_row = j + shift;
+                const long eqs_row =
+                    m_msh->nod_vector[j]->GetEquationIndex() + shift;
 #endif
                 SetNodeValue(j,
                              ColIndex,
@@ -1536,10 +1599,11 @@ void CRFProcessDeformation::UpdateIterativeStep(const double damp,
 
             for (j = 0; j < number_of_nodes; j++)
             {
-                SetNodeValue(
-                    j,
-                    ColIndex,
-                    GetNodeValue(j, ColIndex) + eqs_x[j + shift] * damp);
+                const long eqs_row =
+                    m_msh->nod_vector[j]->GetEquationIndex() + shift;
+                SetNodeValue(j,
+                             ColIndex,
+                             GetNodeValue(j, ColIndex) + eqs_x[eqs_row] * damp);
             }
             shift += number_of_nodes;
         }
@@ -2126,75 +2190,73 @@ void CRFProcessDeformation::Extropolation_GaussValue()
             SetNodeValue(i, stressPrincipleIndices[k], 0.0);
     }
 
-    for (i = 0; i < (long)m_msh->ele_vector.size(); i++)
+    const std::vector<long>& elements = getActiveElements();
+    for (i = 0; i < (long)elements.size(); i++)
     {
-        elem = m_msh->ele_vector[i];
-        if (elem->GetMark())  // Marked for use
-        {
-            fem_dm->setElement(elem);
-            fem_dm->setOrder(2);
-            fem_dm->SetIntegrationPointNumber(elem->GetElementType());
+        elem = m_msh->ele_vector[elements[i]];
+        fem_dm->setElement(elem);
+        fem_dm->setOrder(2);
+        fem_dm->SetIntegrationPointNumber(elem->GetElementType());
 
-            fem_dm->SetMaterial();
-            //         eval_DM = ele_value_dm[i];
-            // TEST        (*eval_DM->Stress) += (*eval_DM->Stress0);
-            fem_dm->ExtropolateGuassStress();
-            // TEST        if(!update)
-            //           (*eval_DM->Stress) -= (*eval_DM->Stress0);
-            // calculation of principal stresses for postprocessing on nodes
-
-            for (int i = 0; i < fem_dm->nnodes; i++)
+        fem_dm->SetMaterial();
+        //         eval_DM = ele_value_dm[i];
+        // TEST        (*eval_DM->Stress) += (*eval_DM->Stress0);
+        fem_dm->ExtropolateGuassStress();
+        // TEST        if(!update)
+        //           (*eval_DM->Stress) -= (*eval_DM->Stress0);
+        // calculation of principal stresses for postprocessing on nodes
+
+        for (int i = 0; i < fem_dm->nnodes; i++)
+        {
+            // MeshLib::CNode *node;
+            int node_index = fem_dm->nodes[i];
+            // node = m_msh->nod_vector[node_index];
+            double stress[6];
+            stress[0] = fem_dm->pcs->GetNodeValue(
+                node_index, Idx_Stress[0]);  // sigma_xx
+            stress[1] = fem_dm->pcs->GetNodeValue(
+                node_index, Idx_Stress[1]);  // sigma_yy
+            stress[2] = fem_dm->pcs->GetNodeValue(
+                node_index, Idx_Stress[2]);  // sigma_zz
+            stress[3] = fem_dm->pcs->GetNodeValue(
+                node_index, Idx_Stress[3]);  // sigma_xy
+            if (problem_dimension_dm == 3)
             {
-                // MeshLib::CNode *node;
-                int node_index = fem_dm->nodes[i];
-                // node = m_msh->nod_vector[node_index];
-                double stress[6];
-                stress[0] = fem_dm->pcs->GetNodeValue(
-                    node_index, Idx_Stress[0]);  // sigma_xx
-                stress[1] = fem_dm->pcs->GetNodeValue(
-                    node_index, Idx_Stress[1]);  // sigma_yy
-                stress[2] = fem_dm->pcs->GetNodeValue(
-                    node_index, Idx_Stress[2]);  // sigma_zz
-                stress[3] = fem_dm->pcs->GetNodeValue(
-                    node_index, Idx_Stress[3]);  // sigma_xy
-                if (problem_dimension_dm == 3)
-                {
-                    stress[4] = fem_dm->pcs->GetNodeValue(
-                        node_index, Idx_Stress[4]);  // sigma_xz
-                    stress[5] = fem_dm->pcs->GetNodeValue(
-                        node_index, Idx_Stress[5]);  // sigma_yz
-                }
-                else
-                {
-                    stress[4] = 0;  // sigma_xz
-                    stress[5] = 0;  // sigma_yz
-                }
-                double prin_str[3];
-                double prin_dir[9];
-                fem_dm->smat->CalPrinStrDir(stress, prin_str, prin_dir, 3);
-                // transpose rotation tensor for principal directions
-                for (size_t i = 0; i < 3; i++)
-                    fem_dm->pcs->SetNodeValue(
-                        node_index, stressPrincipleIndices[i], prin_str[i]);
-                fem_dm->pcs->SetNodeValue(
-                    node_index, PrinStressDirectionIndices[0], prin_dir[0]);
-                fem_dm->pcs->SetNodeValue(
-                    node_index, PrinStressDirectionIndices[1], prin_dir[3]);
-                fem_dm->pcs->SetNodeValue(
-                    node_index, PrinStressDirectionIndices[2], prin_dir[6]);
-                fem_dm->pcs->SetNodeValue(
-                    node_index, PrinStressDirectionIndices[3], prin_dir[1]);
-                fem_dm->pcs->SetNodeValue(
-                    node_index, PrinStressDirectionIndices[4], prin_dir[4]);
-                fem_dm->pcs->SetNodeValue(
-                    node_index, PrinStressDirectionIndices[5], prin_dir[7]);
-                fem_dm->pcs->SetNodeValue(
-                    node_index, PrinStressDirectionIndices[6], prin_dir[2]);
-                fem_dm->pcs->SetNodeValue(
-                    node_index, PrinStressDirectionIndices[7], prin_dir[5]);
-                fem_dm->pcs->SetNodeValue(
-                    node_index, PrinStressDirectionIndices[8], prin_dir[8]);
+                stress[4] = fem_dm->pcs->GetNodeValue(
+                    node_index, Idx_Stress[4]);  // sigma_xz
+                stress[5] = fem_dm->pcs->GetNodeValue(
+                    node_index, Idx_Stress[5]);  // sigma_yz
+            }
+            else
+            {
+                stress[4] = 0;  // sigma_xz
+                stress[5] = 0;  // sigma_yz
             }
+            double prin_str[3];
+            double prin_dir[9];
+            fem_dm->smat->CalPrinStrDir(stress, prin_str, prin_dir, 3);
+            // transpose rotation tensor for principal directions
+            for (size_t i = 0; i < 3; i++)
+                fem_dm->pcs->SetNodeValue(
+                    node_index, stressPrincipleIndices[i], prin_str[i]);
+            fem_dm->pcs->SetNodeValue(
+                node_index, PrinStressDirectionIndices[0], prin_dir[0]);
+            fem_dm->pcs->SetNodeValue(
+                node_index, PrinStressDirectionIndices[1], prin_dir[3]);
+            fem_dm->pcs->SetNodeValue(
+                node_index, PrinStressDirectionIndices[2], prin_dir[6]);
+            fem_dm->pcs->SetNodeValue(
+                node_index, PrinStressDirectionIndices[3], prin_dir[1]);
+            fem_dm->pcs->SetNodeValue(
+                node_index, PrinStressDirectionIndices[4], prin_dir[4]);
+            fem_dm->pcs->SetNodeValue(
+                node_index, PrinStressDirectionIndices[5], prin_dir[7]);
+            fem_dm->pcs->SetNodeValue(
+                node_index, PrinStressDirectionIndices[6], prin_dir[2]);
+            fem_dm->pcs->SetNodeValue(
+                node_index, PrinStressDirectionIndices[7], prin_dir[5]);
+            fem_dm->pcs->SetNodeValue(
+                node_index, PrinStressDirectionIndices[8], prin_dir[8]);
         }
     }
 }
@@ -2719,6 +2781,7 @@ void CRFProcessDeformation::GlobalAssembly()
             GlobalAssembly_std(true);
         // if(!fem_dm->dynamic)
         //   RecoverSolution(2);  // p_i-->p_0
+        KeepOrRestoreJacobian();
 
         //----------------------------------------------------------------------
         //
@@ -2791,12 +2854,10 @@ void CRFProcessDeformation::GlobalAssembly_DM()
     //   if(m_num->nls_method==2&&ite_steps==1)
     //      IncorporateBoundaryConditions();
 
-    for (i = 0; i < (long)m_msh->ele_vector.size(); i++)
+    const std::vector<long>& elements = getActiveElements();
+    for (i = 0; i < (long)elements.size(); i++)
     {
-        elem = m_msh->ele_vector[i];
-        if (!elem->GetMark())  // Marked for use
-            continue;
-
+        elem = m_msh->ele_vector[elements[i]];
         elem->SetOrder(true);
         fem_dm->ConfigElement(elem);
         fem_dm->LocalAssembly(0);
@@ -2922,38 +2983,9 @@ void CRFProcessDeformation::PostExcavation()
                 elem->MarkingAll(true);
         }
 
-        size_t mesh_node_vector_size(m_msh->nod_vector.size());
-        for (size_t l = 0; l < mesh_node_vector_size; l++)
-        {
-            while (m_msh->nod_vector[l]->getConnectedElementIDs().size())
-                m_msh->nod_vector[l]->getConnectedElementIDs().pop_back();
-        }
-        // for (size_t l = 0; l < mesh_node_vector_size; l++)
-        size_t mesh_ele_vector_size(m_msh->ele_vector.size());
-        for (size_t l = 0; l < mesh_ele_vector_size; l++)  // WX: 07.2011
-        {
-            elem = m_msh->ele_vector[l];
-            if (!elem->GetMark())
-                continue;
-            // for(size_t i=0; i<elem->GetNodesNumber(m_msh->getOrder()); i++)
-            for (size_t i = 0; i < elem->GetNodesNumber(1);
-                 i++)  // WX:10.2011 change for one way coup. M->H
-            {
-                done = false;
-                node = elem->GetNode(i);
-                for (size_t j = 0; j < node->getConnectedElementIDs().size();
-                     j++)
-                {
-                    if (l == node->getConnectedElementIDs()[j])
-                    {
-                        done = true;
-                        break;
-                    }
-                }
-                if (!done)
-                    node->getConnectedElementIDs().push_back(l);
-            }
-        }
+        // WX: 07.2011. Quadratic nodes, WX:10.2011 change for one way coup.
+        // M->H
+        m_msh->ConnectedElements2Node(true);
         if (Neglect_H_ini == 1)  // WX:04.2013
             CalIniTotalStress();
     }
@@ -3049,18 +3081,16 @@ void CRFProcessDeformation::UpdateStress()
        else
        {
      */
-    for (i = 0; i < (long)m_msh->ele_vector.size(); i++)
+    const std::vector<long>& elements = getActiveElements();
+    for (i = 0; i < (long)elements.size(); i++)
     {
-        elem = m_msh->ele_vector[i];
-        if (elem->GetMark())  // Marked for use
-        {
-            elem->SetOrder(true);
+        elem = m_msh->ele_vector[elements[i]];
+        elem->SetOrder(true);
 #if !defined(USE_PETSC)  // && !defined(other parallel libs)//03.3012. WW
-            fem_dm->m_dom = NULL;
+        fem_dm->m_dom = NULL;
 #endif
-            fem_dm->ConfigElement(elem);
-            fem_dm->LocalAssembly(1);
-        }
+        fem_dm->ConfigElement(elem);
+        fem_dm->LocalAssembly(1);
     }
     //}
 }
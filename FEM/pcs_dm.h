@@ -38,6 +38,10 @@ namespace FiniteElement
 {
 class CFiniteElementVec;
 }
+namespace Math_Group
+{
+class QuasiNewtonUpdate;
+}
 using FiniteElement::CFiniteElementVec;
 #if !defined(USE_PETSC)  // && !defined(other parallel libs)//03.3012. WW
 class CPARDomain;
@@ -117,6 +121,8 @@ public:
 
 private:
     CFiniteElementVec* fem_dm;
+    /// Quasi-Newton updates of the kept tangent ($QUASI_NEWTON), or NULL
+    Math_Group::QuasiNewtonUpdate* quasi_newton;
     void InitialMBuffer();
     double* ARRAY;
 
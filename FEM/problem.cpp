@@ -24,6 +24,7 @@
 #include "SplitMPI_Communicator.h"
 #endif
 
+#include <algorithm>
 #include <cfloat>
 #include <iostream>
 #include <sstream>
@@ -72,6 +73,7 @@ extern int ReadData(const char*,
 #include "Output.h"
 #include "fem_ele_std.h"
 #include "fem_ele_vec.h"
+#include "AndersonAcceleration.h"
 #include "files0.h"  // GetLineFromFile1
 #include "rf_bc_new.h"
 #include "rf_node.h"
@@ -100,6 +102,9 @@ extern int ReadData(const char*,
 #if defined(USE_PETSC)  // || defined(other parallel libs)//03.3012. WW
 #include "PETSC/PETScLinearSolver.h"
 #endif
+#ifdef NEW_EQS
+#include "matrix_class.h"
+#endif
 
 using namespace Display;
 
@@ -119,6 +124,7 @@ using process::CRFProcessDeformation;
  ***************************************************************************/
 Problem::Problem(const char* filename)
     : dt0(0.),
+      cpl_acceleration(NULL),
       print_result(true),
       _linear_shapefunction_pool(NULL),
       _quadr_shapefunction_pool(NULL),
@@ -264,6 +270,9 @@ Problem::Problem(const char* filename)
         // set the id variable flow_pcs_type for Saturation and velocity
         // calculation in mass transport element matrices
         SetFlowProcessType();
+#ifdef NEW_EQS
+        SetSharedTransportOperators();
+#endif
         //----------------------------------------------------------------------
         KRConfig(*_geo_obj, _geo_name);
 
@@ -623,6 +632,7 @@ Problem::~Problem()
         delete[] buffer_array1;
     buffer_array = NULL;
     buffer_array1 = NULL;
+    delete cpl_acceleration;
     active_processes = NULL;
     exe_flag = NULL;
     //
@@ -1455,11 +1465,22 @@ bool Problem::CouplingLoop()
     // mean we don't want output for the others. if(acounter == num_processes)
     print_result = true;
     //
+    const int cpl_depth = GetCouplingAccelerationDepth();
+    if (cpl_depth > 0)
+    {
+        if (!cpl_acceleration)
+            cpl_acceleration =
+                new Math_Group::AndersonAcceleration(cpl_depth);
+        cpl_acceleration->reset();
+    }
+    //
     bool accept = true;
     max_outer_error = 0.0;
     for (outer_index = 0; outer_index < cpl_overall_max_iterations;
          outer_index++)
     {
+        if (cpl_depth > 0)
+            CopyCouplingIterate(cpl_iterate, false);
         // JT: All active processes must run on the overall loop. Strange this
         // wasn't the case before.
         for (i = 0; i < num_processes; i++)
@@ -1680,24 +1701,104 @@ if(has_constrained_bc > 0)
             accept = false;
             break;
         }
+
+        // Anderson acceleration of the next coupling iterate
+        if (cpl_depth > 0)
+        {
+            std::vector<double> g;
+            CopyCouplingIterate(g, false);
+            cpl_acceleration->update(&cpl_iterate[0], &g[0], g.size(), 1.0);
+            CopyCouplingIterate(cpl_iterate, true);
+        }
     }
+    if (cpl_depth > 0)
+        ScreenMessage(
+            "Anderson acceleration of the coupling: %d of %d updates "
+            "accelerated, %d restarts\n",
+            cpl_acceleration->getNumberOfAcceleratedIterations(),
+            cpl_acceleration->getNumberOfIterations(),
+            cpl_acceleration->getNumberOfRestarts());
     //
     return accept;
 }
 
+/*-----------------------------------------------------------------------
+   GeoSys - Function: GetCouplingAccelerationDepth
+   Task: Window of the Anderson acceleration of the overall coupling
+         iterations, the largest one of $COUPLING_ACCELERATION of the
+         processes. 0: no acceleration
+   Programming:
+-------------------------------------------------------------------------*/
+int Problem::GetCouplingAccelerationDepth() const
+{
+    int depth = 0;
+#if !defined(USE_PETSC)  // The node values are distributed
+    if (cpl_overall_max_iterations < 2)
+        return 0;
+    for (std::size_t i = 0; i < pcs_vector.size(); i++)
+    {
+        const CRFProcess* m_pcs = pcs_vector[i];
+        if (m_pcs->m_num)
+            depth = std::max(depth, m_pcs->m_num->cpl_anderson_depth);
+    }
+#endif
+    return depth;
+}
+
+/*-----------------------------------------------------------------------
+   GeoSys - Function: CopyCouplingIterate
+   Task: Copy the primary variables of the processes with
+         $COUPLING_ACCELERATION from (to_nodes == false) or to
+         (to_nodes == true) the values of the nodes
+   Programming:
+-------------------------------------------------------------------------*/
+void Problem::CopyCouplingIterate(std::vector<double>& values,
+                                  const bool to_nodes)
+{
+    if (!to_nodes)
+        values.clear();
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < pcs_vector.size(); i++)
+    {
+        CRFProcess* m_pcs = pcs_vector[i];
+        if (!m_pcs->m_num || m_pcs->m_num->cpl_anderson_depth < 1)
+            continue;
+        const bool quadratic = m_pcs->type == 4 || m_pcs->type == 41;
+        const std::size_t n_nodes = m_pcs->m_msh->GetNodesNumber(quadratic);
+        for (std::size_t j = 0; j < m_pcs->GetPrimaryVNumber(); j++)
+        {
+            const int nidx1 =
+                m_pcs->GetNodeValueIndex(m_pcs->GetPrimaryVName(j)) + 1;
+            // Scaled by the coupling tolerance, the variables have
+            // comparable magnitudes in the least squares problem
+            const double tolerance =
+                m_pcs->m_num->cpl_error_tolerance[std::min(
+                    j, static_cast<std::size_t>(DOF_NUMBER_MAX - 1))];
+            const double scale = tolerance > 0.0 ? tolerance : 1.0;
+            for (std::size_t l = 0; l < n_nodes; l++, n++)
+            {
+                if (to_nodes)
+                    m_pcs->SetNodeValue(l, nidx1, values[n] * scale);
+                else
+                    values.push_back(m_pcs->GetNodeValue(l, nidx1) / scale);
+            }
+        }
+    }
+}
+
 /*-----------------------------------------------------------------------
    GeoSys - Function: pre Coupling loop
    Task: Process solution is beginning. Perform any pre-loop configurations
    Programming:
    03/2012 JT
    Modification:
+   Initial guess of the time step by the solution predictor
 -------------------------------------------------------------------------*/
 void Problem::PreCouplingLoop(CRFProcess* m_pcs)
 {
-    if (!last_dt_accepted ||
-        force_post_node_copy)  // if last time step not accepted or values were
-                               // already copied.
-        return;
+    // Values are copied if the last time step was accepted and they were not
+    // already copied.
+    const bool copy_values = last_dt_accepted && !force_post_node_copy;
     //
     /*For mass transport this routine is only called once (for the overall
       transport process) and so we need to copy for all transport components*/
@@ -1709,15 +1810,23 @@ void Problem::PreCouplingLoop(CRFProcess* m_pcs)
             c_pcs = pcs_vector[i];
             if (c_pcs->getProcessType() == FiniteElement::MASS_TRANSPORT)
             {
-                c_pcs->CopyTimestepNODValues();
-                c_pcs->CopyTimestepELEValues();
+                if (copy_values)
+                {
+                    c_pcs->CopyTimestepNODValues();
+                    c_pcs->CopyTimestepELEValues();
+                }
+                c_pcs->PredictSolution();
             }
         }
     }
     else
     {  // Otherwise, just copy this process
-        m_pcs->CopyTimestepNODValues();
-        m_pcs->CopyTimestepELEValues();
+        if (copy_values)
+        {
+            m_pcs->CopyTimestepNODValues();
+            m_pcs->CopyTimestepELEValues();
+        }
+        m_pcs->PredictSolution();
     }
 }
 
@@ -3471,6 +3580,62 @@ inline double Problem::HeatTransport()
     return error;
 }
 
+#ifdef NEW_EQS
+/*-------------------------------------------------------------------------
+   GeoSys - Function: SetSharedTransportOperators
+   Task: Find the mobile components whose transport equation is the same
+      as that of a component solved before them ($SHARED_TRANSPORT_OPERATOR
+      in the NUM file). The first component of such a group keeps the
+      matrix and the RHS operator of its element loop, and the other ones
+      use them instead of their own element loop. As the matrices are the
+      same, the preconditioner of the first solve is reused, too.
+   -------------------------------------------------------------------------*/
+void Problem::SetSharedTransportOperators()
+{
+    if (!dom_vector.empty())
+        return;
+    for (std::size_t i = 1; i < transport_processes.size(); i++)
+    {
+        CRFProcess* m_pcs = transport_processes[i];
+        const CNumerics* m_num = m_pcs->m_num;
+        if (!m_num || m_num->shared_transport_operator < 1 ||
+            m_num->fct_method > 0 || m_pcs->continuum_vector.size() != 1 ||
+            m_pcs->NumDeactivated_SubDomains > 0)
+            continue;
+        const CompProperties* m_cp = cp_vec[m_pcs->pcs_component_number];
+        if (m_cp->mobil < 1)
+            continue;
+        for (std::size_t j = 0; j < i; j++)
+        {
+            CRFProcess* a_pcs = transport_processes[j];
+            if (a_pcs->shared_operator_pcs || a_pcs->m_num != m_num ||
+                a_pcs->m_msh != m_pcs->m_msh ||
+                a_pcs->eqs_new != m_pcs->eqs_new ||
+                a_pcs->continuum_vector.size() != 1 ||
+                a_pcs->NumDeactivated_SubDomains > 0)
+                continue;
+            const CompProperties* a_cp = cp_vec[a_pcs->pcs_component_number];
+            if (!m_cp->HasSameTransportOperator(*a_cp))
+                continue;
+            if (!a_pcs->shared_lhs)
+            {
+                const Math_Group::SparseTable& sparse_table =
+                    *a_pcs->m_msh->GetSparseTable();
+                a_pcs->shared_lhs =
+                    new Math_Group::CSparseMatrix(sparse_table, 1);
+                a_pcs->shared_rhs =
+                    new Math_Group::CSparseMatrix(sparse_table, 1);
+            }
+            m_pcs->shared_operator_pcs = a_pcs;
+            ScreenMessage(
+                "-> Component %s uses the transport operator of %s\n",
+                m_cp->compname.c_str(), a_cp->compname.c_str());
+            break;
+        }
+    }
+}
+#endif
+
 /*-------------------------------------------------------------------------
    GeoSys - Function: MassTrasport
    Task: Similate heat transport
@@ -4083,16 +4248,25 @@ inline void Problem::LOPExecuteRegionalRichardsFlow(CRFProcess* m_pcs_global,
         m_msh_local = fem_msh_vector[(int)fem_msh_vector.size() - 1];
         //....................................................................
         // Set local NODs
-        for (j = 0; j < no_local_nodes; j++)
+        std::vector<size_t> local_node_ptr(1, 0);
+        std::vector<size_t> local_node_elements;
+        for (j = 0; j < (int)m_msh_local->nod_vector.size(); j++)
         {
             g_node_number = j + (i * no_local_nodes);
             // TF not used			m_nod =
             // m_pcs_global->m_msh->nod_vector[g_node_number];
             m_nod_local = m_msh_local->nod_vector[j];
             // m_nod_local = m_nod;
-            m_nod_local->getConnectedElementIDs().push_back(i);
+            MeshLib::NodeAdjacency const& elements(
+                m_nod_local->getConnectedElementIDs());
+            local_node_elements.insert(local_node_elements.end(),
+                                       elements.begin(), elements.end());
+            if (j < no_local_nodes)
+                local_node_elements.push_back(i);
+            local_node_ptr.push_back(local_node_elements.size());
             // m_nod_local->ok_dummy = i;
         }
+        m_msh_local->setConnectedElements(local_node_ptr, local_node_elements);
         //....................................................................
         // Set local ELEs
         for (j = 0; j < no_local_elements; j++)
@@ -4573,10 +4747,12 @@ void Problem::createShapeFunctionPool()
 
     CFiniteElementStd* lin_fem_assembler = NULL;
     CFiniteElementVec* fem_assembler = NULL;
+    CRFProcess* lin_fem_pcs = NULL;
     if (pcs_0c_fem)
     {
         lin_fem_assembler = pcs_0c_fem->getLinearFEMAssembler();
         lin_fem_assembler->setOrder(1);
+        lin_fem_pcs = pcs_0c_fem;
     }
     if (pcs_1c_fem)
     {
@@ -4585,6 +4761,7 @@ void Problem::createShapeFunctionPool()
             lin_fem_assembler = pcs_1c_fem->getLinearFEMAssembler();
             if (lin_fem_assembler)
                 lin_fem_assembler->setOrder(1);
+            lin_fem_pcs = pcs_1c_fem;
         }
 
         CRFProcessDeformation* dm_pcs =
@@ -4722,6 +4899,32 @@ void Problem::createShapeFunctionPool()
                                             _quadr_shapefunction_pool);
         }
     }
+
+    // Cache of the element geometry with the largest memory limit given.
+    // The quadratic elements get what the linear ones leave.
+    double cache_memory_MB = 0.;
+    for (std::size_t i = 0; i < num_vector.size(); i++)
+        cache_memory_MB =
+            std::max(cache_memory_MB, num_vector[i]->ele_geometry_cache_memory);
+    if (cache_memory_MB > 0.)
+    {
+        std::size_t memory_limit =
+            static_cast<std::size_t>(cache_memory_MB * 1048576.);
+        if (lin_fem_assembler && _linear_shapefunction_pool)
+        {
+            _linear_shapefunction_pool->enableGeometryCache(memory_limit);
+            lin_fem_assembler->cacheElementGeometry(
+                lin_fem_pcs->m_msh->ele_vector);
+            memory_limit -=
+                _linear_shapefunction_pool->getGeometryCache()->getMemory();
+        }
+        if (fem_assembler &&
+            _quadr_shapefunction_pool != _linear_shapefunction_pool)
+        {
+            _quadr_shapefunction_pool->enableGeometryCache(memory_limit);
+            fem_assembler->cacheElementGeometry(pcs_1c_fem->m_msh->ele_vector);
+        }
+    }
 }
 
 #ifdef BRNS
@@ -24,6 +24,10 @@ namespace FiniteElement
 {
 class ShapeFunctionPool;
 }
+namespace Math_Group
+{
+class AndersonAcceleration;
+}
 namespace FiniteElement
 {
 class CFiniteElementStd;
@@ -51,6 +55,8 @@ public:
     bool CouplingLoop();
     void PostCouplingLoop();
     void PreCouplingLoop(CRFProcess* m_pcs = NULL);
+    int GetCouplingAccelerationDepth() const;
+    void CopyCouplingIterate(std::vector<double>& values, const bool to_nodes);
     // Copy u_n for auto time stepping
     double* GetBufferArray(const bool is_x_k = false)
     {
@@ -105,6 +111,12 @@ private:
     bool external_coupling_exists;
     int cpl_overall_max_iterations;
     int cpl_overall_min_iterations;
+    /// Anderson acceleration of the overall coupling iterations
+    /// ($COUPLING_ACCELERATION), or NULL
+    Math_Group::AndersonAcceleration* cpl_acceleration;
+    /// Primary variables of the accelerated processes before an overall
+    /// coupling iteration
+    std::vector<double> cpl_iterate;
     int loop_process_number;
     size_t max_time_steps;
     //
@@ -150,6 +162,10 @@ private:
     inline double FluidMomentum();
     inline double RandomWalker();
     inline double MassTrasport();
+#ifdef NEW_EQS
+    /// Components of the mass transport that use the operator of another one
+    void SetSharedTransportOperators();
+#endif
     inline double Deformation();
     // Accessory
     void LOPExecuteRegionalRichardsFlow(CRFProcess* m_pcs_global,
@@ -1122,6 +1122,9 @@ double CFluidProperties::Density(double* variables)
     double pressure;
     double Rho = 0.0;
     static double density;
+#ifdef _OPENMP
+#pragma omp threadprivate(density)
+#endif
     // static double air_gas_density,vapour_density,vapour_pressure;
 
     int gueltig;
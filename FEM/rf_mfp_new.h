@@ -21,6 +21,8 @@
 #include <string>
 #include <vector>
 
+#include "ThreadPrivate.h"
+
 class CompProperties;
 class CRFProcess;
 
@@ -143,8 +145,8 @@ private:
     std::string name;
     std::string cmpNm1, cmpNm2, cmpNm3, cmpNm4;  // component name
     int cmpN;                                    // components number
-    // FEM
-    FiniteElement::CFiniteElementStd* Fem_Ele_Std;
+    // FEM. Element of the calling thread
+    ThreadPrivate<FiniteElement::CFiniteElementStd*> Fem_Ele_Std;
     long node;  // OK4704
     // Density
     int density_model;
@@ -275,9 +277,9 @@ private:
     double K[14][56], KP[4];
 
     // State variables
-    double primary_variable[10];     // WW
-    double primary_variable_t0[10];  // CMCD
-    double primary_variable_t1[10];  // CMCD
+    ThreadPrivateArray<double, 10> primary_variable;     // WW
+    ThreadPrivateArray<double, 10> primary_variable_t0;  // CMCD
+    ThreadPrivateArray<double, 10> primary_variable_t1;  // CMCD
     bool cal_gravity;                // YD/WW
 
     double GasViscosity_Reichenberg_1971(double, double);
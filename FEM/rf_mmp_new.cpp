@@ -4515,6 +4515,9 @@ CMediumProperties::PorosityEffectiveConstrainedSwellingConstantIonicStrength(
 double* CMediumProperties::PermeabilityTensor(long index)
 {
     static double tensor[9];
+#ifdef _OPENMP
+#pragma omp threadprivate(tensor)
+#endif
     int perm_index = 0;
 
     int idx_k, idx_n;
@@ -29,6 +29,7 @@
 #include "makros.h"  // JT
 
 #include "PhysicalConstant.h"
+#include "ThreadPrivate.h"
 
 // PCSLib
 #include "rf_pcs.h"
@@ -41,7 +42,8 @@ using FiniteElement::CFiniteElementStd;
 class CMediumProperties
 {
 public:
-    CFiniteElementStd* Fem_Ele_Std;
+    // Element of the calling thread
+    ThreadPrivate<CFiniteElementStd*> Fem_Ele_Std;
 
 private:
     // WW
@@ -227,7 +229,8 @@ public:
     int porosity_model;  // porosity
     int porosity_curve;
     double porosity_model_values[15];
-    double porosity;
+    // Value of the calling thread, set by Porosity()
+    ThreadPrivate<double> porosity;
     double KC_porosity_initial;      // HS 11.2008
     double KC_permeability_initial;  // HS 11.2008
     std::string porosity_file;       // OK/MB
@@ -238,7 +241,8 @@ public:
     double flowlinearity_model_values[10];
     int storage_model;  // storativity
     double storage_model_values[10];
-    double storage;
+    // Value of the calling thread, set by StorageFunction()
+    ThreadPrivate<double> storage;
     int conductivity_model;
     double conductivity;
     int unconfined_flow_group;
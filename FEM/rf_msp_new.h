@@ -23,6 +23,7 @@ last modified:
 //#include <vector>
 
 #include "invariants.h"
+#include "ThreadPrivate.h"
 
 #define MSP_FILE_EXTENSION ".msp"
 
@@ -194,8 +195,8 @@ public:
     double getBiotsConstant() const { return biot_const; }
 
 private:
-    // CMCD
-    FiniteElement::CFiniteElementStd* Fem_Ele_Std;
+    // CMCD. Element of the calling thread
+    ThreadPrivate<FiniteElement::CFiniteElementStd*> Fem_Ele_Std;
     std::string name;
     // IO
     std::string file_base_name;
@@ -91,6 +91,17 @@ CNumerics::CNumerics(string name)
     ls_storage_method = 2;  // OK41
     m_cols = 5;             // 06.2010. WW
     ls_extra_arg = "";      // NW
+    ls_ilut_drop_tolerance = 1.e-4;
+    ls_ilut_max_fill = 20;
+    ls_ilu_level_scheduling = true;
+    ls_amg_cycle = 1;
+    ls_amg_strength_threshold = 0.08;
+    ls_amg_smoother = 1;
+    ls_amg_smoothing_steps = 1;
+    ls_amg_max_levels = 10;
+    ls_amg_coarse_size = 200;
+    ls_assembly_map_memory = 1024.;
+    ls_node_renumbering = 0;
     //
     // NLS - Nonlinear Solver
     nls_method_name = "PICARD";
@@ -98,6 +109,8 @@ CNumerics::CNumerics(string name)
     nls_error_method = 1;    // JT2012
     nls_max_iterations = 1;  // OK
     nls_relaxation = 0.0;
+    nls_anderson_depth = 0;
+    solution_predictor = 0;
     for (size_t i = 0; i < DOF_NUMBER_MAX; i++)  // JT2012
         nls_error_tolerance[i] = -1.0;  // JT2012: should not default this.
                                         // Should always be entered by user!
@@ -111,6 +124,7 @@ CNumerics::CNumerics(string name)
     cpl_variable_JOD = "FLUX";
     cpl_max_iterations = 1;  // OK
     cpl_min_iterations = 1;  // JT2012
+    cpl_anderson_depth = 0;
     // Local picard1                                //NW
     local_picard1_tolerance = 1.0e-3;
     local_picard1_max_iterations = 1;
@@ -128,11 +142,20 @@ CNumerics::CNumerics(string name)
     ele_supg_method = 0;              // NW
     ele_supg_method_length = 0;       // NW
     ele_supg_method_diffusivity = 0;  // NW
+    ele_parallel_assembly = 0;
+    ele_batch_assembly = 0;
+    ele_geometry_cache_memory = 0.;
+    shared_transport_operator = 0;
+    global_operator_cache = 0;
     fct_method = -1;                  // NW
     fct_prelimiter_type = 0;          // NW
     fct_const_alpha = -1.0;           // NW
     newton_damping_factor = 1.0;
     newton_damping_tolerance = 1.e3;
+    newton_jacobian_reuse = 0;
+    newton_jacobian_contraction = 0.5;
+    quasi_newton_method = 0;
+    quasi_newton_max_updates = 10;
     nls_abs_residual_tolerance = std::numeric_limits<double>::max();
     nls_abs_unknown_tolerance = std::numeric_limits<double>::max();
     nls_rel_unknown_tolerance = std::numeric_limits<double>::max();
@@ -661,6 +684,114 @@ ios::pos_type CNumerics::Read(ifstream* num_file)
             continue;
         }
         //....................................................................
+        // subkeyword found
+        if (line_string.find("$NON_LINEAR_ACCELERATION") != string::npos ||
+            line_string.find("$COUPLING_ACCELERATION") != string::npos)
+        {
+            // ANDERSON depth: Anderson acceleration of the Picard
+            // iterations of this process, or of the overall coupling
+            // iterations with the primary variables of this process
+            std::string acceleration_name;
+            int depth = 0;
+            line.str(GetLineFromFile1(num_file));
+            line >> acceleration_name >> depth;
+            if (acceleration_name.find("ANDERSON") == string::npos)
+            {
+                ScreenMessage(
+                    "WARNING. Unknown acceleration %s. Only ANDERSON is "
+                    "available.\n",
+                    acceleration_name.c_str());
+                depth = 0;
+            }
+            if (line_string.find("$NON_LINEAR_ACCELERATION") != string::npos)
+                nls_anderson_depth = depth;
+            else
+                cpl_anderson_depth = depth;
+            line.clear();
+            continue;
+        }
+        //....................................................................
+        // subkeyword found
+        if (line_string.find("$SOLUTION_PREDICTOR") != string::npos)
+        {
+            // LINEAR or QUADRATIC extrapolation of the initial guess of a
+            // time step from the last two or three accepted time steps
+            std::string predictor_name;
+            line.str(GetLineFromFile1(num_file));
+            line >> predictor_name;
+            if (predictor_name.find("LINEAR") != string::npos)
+                solution_predictor = 1;
+            else if (predictor_name.find("QUADRATIC") != string::npos)
+                solution_predictor = 2;
+            else
+                ScreenMessage(
+                    "WARNING. Unknown solution predictor %s. LINEAR or "
+                    "QUADRATIC is available.\n",
+                    predictor_name.c_str());
+            line.clear();
+            continue;
+        }
+        //....................................................................
+        // subkeyword found
+        if (line_string.find("$ILU_OPTIONS") != string::npos)
+        {
+            // drop tolerance, max. fill per row (ILUT), level scheduling
+            int level_scheduling = 1;
+            line.str(GetLineFromFile1(num_file));
+            line >> ls_ilut_drop_tolerance;
+            line >> ls_ilut_max_fill;
+            line >> level_scheduling;
+            ls_ilu_level_scheduling = (level_scheduling != 0);
+            line.clear();
+            continue;
+        }
+        //....................................................................
+        // subkeyword found
+        if (line_string.find("$AMG_OPTIONS") != string::npos)
+        {
+            // cycle (V or W), strength threshold, smoother (0: Jacobi,
+            // 1: Gauss-Seidel), smoothing steps, max. levels, coarse size
+            std::string cycle_name;
+            line.str(GetLineFromFile1(num_file));
+            line >> cycle_name;
+            ls_amg_cycle = (cycle_name.find('W') != string::npos) ? 2 : 1;
+            line >> ls_amg_strength_threshold;
+            line >> ls_amg_smoother;
+            line >> ls_amg_smoothing_steps;
+            line >> ls_amg_max_levels;
+            line >> ls_amg_coarse_size;
+            line.clear();
+            continue;
+        }
+        //....................................................................
+        // subkeyword found
+        if (line_string.find("$ASSEMBLY_MAP_MEMORY") != string::npos)
+        {
+            // Memory limit of the element-to-matrix map in MB. 0: no map
+            line.str(GetLineFromFile1(num_file));
+            line >> ls_assembly_map_memory;
+            line.clear();
+            continue;
+        }
+        //....................................................................
+        // subkeyword found
+        if (line_string.find("$NODE_RENUMBERING") != string::npos)
+        {
+            // Equation numbering of the nodes: NONE, RCM (reverse
+            // Cuthill-McKee) or HILBERT (space-filling curve)
+            std::string renumbering_name;
+            line.str(GetLineFromFile1(num_file));
+            line >> renumbering_name;
+            if (renumbering_name.find("RCM") != string::npos)
+                ls_node_renumbering = 1;
+            else if (renumbering_name.find("HILBERT") != string::npos)
+                ls_node_renumbering = 2;
+            else
+                ls_node_renumbering = 0;
+            line.clear();
+            continue;
+        }
+        //....................................................................
         if (line_string.find("$EXTERNAL_SOLVER_OPTION") !=
             string::npos)  // subkeyword found
         {
@@ -709,6 +840,54 @@ ios::pos_type CNumerics::Read(ifstream* num_file)
             continue;
         }
         // subkeyword found
+        if (line_string.find("$ELE_PARALLEL_ASSEMBLY") != string::npos)
+        {
+            // 1: element loop of the assembly in parallel (OpenMP)
+            line.str(GetLineFromFile1(num_file));
+            line >> ele_parallel_assembly;
+            line.clear();
+            continue;
+        }
+        // subkeyword found
+        if (line_string.find("$ELE_BATCH_ASSEMBLY") != string::npos)
+        {
+            // 1: elements of the same type are assembled in batches
+            line.str(GetLineFromFile1(num_file));
+            line >> ele_batch_assembly;
+            line.clear();
+            continue;
+        }
+        // subkeyword found
+        if (line_string.find("$ELE_GEOMETRY_CACHE") != string::npos)
+        {
+            // Memory limit in MB of the cache of the Jacobians and the
+            // gradients of the shape functions of the elements
+            line.str(GetLineFromFile1(num_file));
+            line >> ele_geometry_cache_memory;
+            line.clear();
+            continue;
+        }
+        // subkeyword found
+        if (line_string.find("$SHARED_TRANSPORT_OPERATOR") != string::npos)
+        {
+            // 1: mobile components with the same transport properties are
+            // solved with the operator of the first one
+            line.str(GetLineFromFile1(num_file));
+            line >> shared_transport_operator;
+            line.clear();
+            continue;
+        }
+        // subkeyword found
+        if (line_string.find("$GLOBAL_OPERATOR_CACHE") != string::npos)
+        {
+            // 1: the element loop is done once for linear processes, and
+            // the global system is combined from the kept global matrices
+            line.str(GetLineFromFile1(num_file));
+            line >> global_operator_cache;
+            line.clear();
+            continue;
+        }
+        // subkeyword found
         if (line_string.find("$GRAVITY_PROFILE") != string::npos)
         {
             line.str(GetLineFromFile1(num_file));  // WW
@@ -777,6 +956,39 @@ ios::pos_type CNumerics::Read(ifstream* num_file)
                 newton_damping_factor, newton_damping_tolerance);
             continue;
         }
+        // Modified Newton: Jacobian lagging
+        if (line_string.find("$NEWTON_JACOBIAN_LAGGING") != string::npos)
+        {
+            line.str(GetLineFromFile1(num_file));
+            line >> newton_jacobian_reuse;  // max. number of iterations that
+                                            // reuse the Jacobian of an
+                                            // iteration
+            line >> newton_jacobian_contraction;  // it is refreshed if the
+                                                  // error decreases by less
+                                                  // than this factor
+            line.clear();
+            continue;
+        }
+        // Quasi-Newton updates of the tangent of the deformation
+        if (line_string.find("$QUASI_NEWTON") != string::npos)
+        {
+            // BFGS or BROYDEN, max. number of updates before the tangent is
+            // assembled again
+            std::string qn_name;
+            line.str(GetLineFromFile1(num_file));
+            line >> qn_name >> quasi_newton_max_updates;
+            if (qn_name.find("BFGS") != string::npos)
+                quasi_newton_method = 1;
+            else if (qn_name.find("BROYDEN") != string::npos)
+                quasi_newton_method = 2;
+            else
+                ScreenMessage(
+                    "WARNING. Unknown quasi-Newton method %s. BFGS or "
+                    "BROYDEN is available.\n",
+                    qn_name.c_str());
+            line.clear();
+            continue;
+        }
         // Extended convergence test for Newton
         if (line_string.find("$ADDITIONAL_NEWTON_TOLERANCES") != string::npos)
         {
@@ -898,6 +1110,44 @@ void CNumerics::Write(fstream* num_file)
     *num_file << " " << nls_max_iterations;
     *num_file << " " << nls_relaxation;
     *num_file << "\n";
+    if (nls_anderson_depth > 0)
+    {
+        *num_file << " $NON_LINEAR_ACCELERATION"
+                  << "\n";
+        *num_file << "  ANDERSON " << nls_anderson_depth;
+        *num_file << "\n";
+    }
+    if (solution_predictor > 0)
+    {
+        *num_file << " $SOLUTION_PREDICTOR"
+                  << "\n";
+        *num_file << "  "
+                  << (solution_predictor == 1 ? "LINEAR" : "QUADRATIC");
+        *num_file << "\n";
+    }
+    if (newton_jacobian_reuse > 0)
+    {
+        *num_file << " $NEWTON_JACOBIAN_LAGGING"
+                  << "\n";
+        *num_file << "  " << newton_jacobian_reuse << " "
+                  << newton_jacobian_contraction;
+        *num_file << "\n";
+    }
+    if (quasi_newton_method > 0)
+    {
+        *num_file << " $QUASI_NEWTON"
+                  << "\n";
+        *num_file << "  " << (quasi_newton_method == 1 ? "BFGS" : "BROYDEN")
+                  << " " << quasi_newton_max_updates;
+        *num_file << "\n";
+    }
+    if (cpl_anderson_depth > 0)
+    {
+        *num_file << " $COUPLING_ACCELERATION"
+                  << "\n";
+        *num_file << "  ANDERSON " << cpl_anderson_depth;
+        *num_file << "\n";
+    }
     //--------------------------------------------------------------------
     *num_file << " $LINEAR_SOLVER"
               << "\n";
@@ -909,6 +1159,34 @@ void CNumerics::Write(fstream* num_file)
     *num_file << " " << ls_precond;
     *num_file << " " << ls_storage_method;
     *num_file << "\n";
+    if (ls_precond == 100 || ls_precond == 101)
+    {
+        *num_file << " $ILU_OPTIONS"
+                  << "\n";
+        *num_file << "  " << ls_ilut_drop_tolerance;
+        *num_file << " " << ls_ilut_max_fill;
+        *num_file << " " << ls_ilu_level_scheduling;
+        *num_file << "\n";
+    }
+    if (ls_method == 11 || ls_precond == 102)
+    {
+        *num_file << " $AMG_OPTIONS"
+                  << "\n";
+        *num_file << "  " << ((ls_amg_cycle == 2) ? "W" : "V");
+        *num_file << " " << ls_amg_strength_threshold;
+        *num_file << " " << ls_amg_smoother;
+        *num_file << " " << ls_amg_smoothing_steps;
+        *num_file << " " << ls_amg_max_levels;
+        *num_file << " " << ls_amg_coarse_size;
+        *num_file << "\n";
+    }
+    if (ls_node_renumbering > 0)
+    {
+        *num_file << " $NODE_RENUMBERING"
+                  << "\n";
+        *num_file << "  " << ((ls_node_renumbering == 1) ? "RCM" : "HILBERT");
+        *num_file << "\n";
+    }
     //--------------------------------------------------------------------
     *num_file << " $ELE_GAUSS_POINTS"
               << "\n";
@@ -925,6 +1203,42 @@ void CNumerics::Write(fstream* num_file)
     *num_file << "  " << ele_upwinding;
     *num_file << "\n";
     //--------------------------------------------------------------------
+    if (ele_parallel_assembly > 0)
+    {
+        *num_file << " $ELE_PARALLEL_ASSEMBLY"
+                  << "\n";
+        *num_file << "  " << ele_parallel_assembly;
+        *num_file << "\n";
+    }
+    if (ele_batch_assembly > 0)
+    {
+        *num_file << " $ELE_BATCH_ASSEMBLY"
+                  << "\n";
+        *num_file << "  " << ele_batch_assembly;
+        *num_file << "\n";
+    }
+    if (ele_geometry_cache_memory > 0.)
+    {
+        *num_file << " $ELE_GEOMETRY_CACHE"
+                  << "\n";
+        *num_file << "  " << ele_geometry_cache_memory;
+        *num_file << "\n";
+    }
+    if (shared_transport_operator > 0)
+    {
+        *num_file << " $SHARED_TRANSPORT_OPERATOR"
+                  << "\n";
+        *num_file << "  " << shared_transport_operator;
+        *num_file << "\n";
+    }
+    if (global_operator_cache > 0)
+    {
+        *num_file << " $GLOBAL_OPERATOR_CACHE"
+                  << "\n";
+        *num_file << "  " << global_operator_cache;
+        *num_file << "\n";
+    }
+    //--------------------------------------------------------------------
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -49,6 +49,22 @@ public:
     int ls_precond;
     int ls_storage_method;
     std::string ls_extra_arg;  // NW
+    // ILU preconditioner of NEW_EQS: ls_precond 100 ILU(0), 101 ILUT
+    double ls_ilut_drop_tolerance;
+    int ls_ilut_max_fill;
+    bool ls_ilu_level_scheduling;
+    // AMG of NEW_EQS: ls_method 11 solver, ls_precond 102 preconditioner
+    int ls_amg_cycle;  // 1: V cycle, 2: W cycle
+    double ls_amg_strength_threshold;
+    int ls_amg_smoother;  // 0: Jacobi, 1: Gauss-Seidel
+    int ls_amg_smoothing_steps;
+    int ls_amg_max_levels;
+    long ls_amg_coarse_size;
+    // Memory limit (MB) of the element-to-matrix map of NEW_EQS assembly
+    double ls_assembly_map_memory;
+    // Renumbering of the equations of the nodes, 0: none, 1: reverse
+    // Cuthill-McKee, 2: Hilbert curve
+    int ls_node_renumbering;
     //
     // NLS - Non-linear Solver
     std::string nls_method_name;
@@ -56,6 +72,11 @@ public:
     int nls_error_method;  // WW
     int nls_max_iterations;
     double nls_relaxation;
+    // Window of the Anderson acceleration of Picard iterations, 0: none
+    int nls_anderson_depth;
+    // Order of the extrapolation of the initial guess of a time step from
+    // the last accepted ones, 0: the previous solution
+    int solution_predictor;
     double
         nls_error_tolerance[DOF_NUMBER_MAX];  // JT2012: array function of dof
     double nls_plasticity_local_tolerance;
@@ -76,6 +97,9 @@ public:
                                    // cpl_variable must default to "NONE".
     int cpl_max_iterations;
     int cpl_min_iterations;  // JT2012
+    // Window of the Anderson acceleration of the overall coupling
+    // iterations, 0: none
+    int cpl_anderson_depth;
     double
         cpl_error_tolerance[DOF_NUMBER_MAX];  // JT2012: array function of dof
     bool cpl_error_specified;                 // JT2012
@@ -101,6 +125,20 @@ public:
     int ele_supg_method;              // NW
     int ele_supg_method_length;       // NW
     int ele_supg_method_diffusivity;  // NW
+    // Element loop of the assembly over colors of elements with OpenMP
+    int ele_parallel_assembly;
+    // Element loop of the assembly over batches of elements of the same
+    // type, whose geometry and local matrices are computed in SIMD lanes
+    int ele_batch_assembly;
+    // Memory limit (MB) of the cache of Jacobians and gradients of shape
+    // functions of the elements. 0: no cache
+    double ele_geometry_cache_memory;
+    // Mass transport: components with identical properties share the
+    // assembled operator
+    int shared_transport_operator;
+    // Linear processes: the global mass, Laplace and advection matrices
+    // are assembled once and combined in each time step
+    int global_operator_cache;
     // FEM-FCT
     int fct_method;                    // NW
     unsigned int fct_prelimiter_type;  // NW
@@ -117,6 +155,14 @@ public:
     int lag_vel_method;
     double newton_damping_factor;
     double newton_damping_tolerance;
+    // Modified Newton: number of further iterations with the Jacobian of an
+    // iteration, 0: none, and the error ratio above which it is refreshed
+    int newton_jacobian_reuse;
+    double newton_jacobian_contraction;
+    // Quasi-Newton updates of the kept tangent of the deformation, 0: none,
+    // 1: BFGS, 2: Broyden, and the number of updates before a restart
+    int quasi_newton_method;
+    int quasi_newton_max_updates;
     double nls_abs_residual_tolerance;
     double nls_abs_unknown_tolerance;
     double nls_rel_unknown_tolerance;
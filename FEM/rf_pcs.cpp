@@ -69,6 +69,9 @@ matrix solver
 //#include "rf_bc_new.h" // ST
 //#include "rf_mmp_new.h" // MAT
 #include "fem_ele_std.h"  // ELE
+#include "ElementBatch.h"
+#include "AndersonAcceleration.h"
+#include "NodalVectorKernels.h"
 #include "rf_ic_new.h"    // IC
 //#include "msh_lib.h" // ELE
 //#include "rf_tim_new.h"
@@ -111,6 +114,7 @@ REACT_BRNS* m_vec_BRNS;
 // New EQS
 #elif defined(NEW_EQS)
 #include "equation_class.h"
+#include "GlobalOperatorCache.h"
 #else
 #include "solver.h"  // ConfigRenumberProperties
 #include "matrix_routines.h"
@@ -386,6 +390,13 @@ CRFProcess::CRFProcess(void)
     reject_steps = 0;                  // 27.08.1008. WW
     ML_Cap = 0;                        // 23.01.2009 PCH
     PartialPS = 0;                     // 16.02 2009 PCH
+    nls_acceleration = NULL;
+    lagged_jacobian_uses = 0;
+    jacobian_lagged = false;
+    jacobian_lagging_error = -1.;
+    predictor_check = false;
+    active_elements_mark_changes = 0;
+    active_elements_mesh_size = -1;
 
 #if defined(USE_MPI) || defined(USE_PETSC)  // WW
     cpu_time_assembly = 0;
@@ -394,6 +405,15 @@ CRFProcess::CRFProcess(void)
 #ifdef NEW_EQS
     eqs_new = NULL;
     configured_in_nonlinearloop = false;
+    shared_lhs = NULL;
+    shared_rhs = NULL;
+    shared_operator_step = -1;
+    shared_operator_dt = 0.;
+    shared_operator_pcs = NULL;
+    global_operator_cache = NULL;
+    node_coordinates_hash = 0;
+    node_coordinates_changes = static_cast<unsigned long>(-1);
+    kept_operators = 0;
 #endif
     flag_couple_GEMS = 0;    // 11.2009 HS
     femFCTmode = false;      // NW
@@ -451,9 +471,21 @@ CRFProcess::~CRFProcess(void)
     long i;
     //----------------------------------------------------------------------
     // Finite element
+    for (std::size_t k = 1; k < thread_fem.size(); k++)
+        delete thread_fem[k];
+    thread_fem.clear();
+    for (std::size_t k = 0; k < element_batches.size(); k++)
+        delete element_batches[k];
+    element_batches.clear();
+    delete nls_acceleration;
     if (fem)
         delete fem;  // WW
     fem = NULL;
+#ifdef NEW_EQS
+    delete shared_lhs;
+    delete shared_rhs;
+    delete global_operator_cache;
+#endif
     //----------------------------------------------------------------------
     // ELE: Element matrices
     ElementMatrix* eleMatrix = NULL;
@@ -725,11 +757,15 @@ void CRFProcess::Create()
 #else
         long gl_size = m_msh->GetNodesNumber(false);
 #endif
-        this->FCT_AFlux = new SparseMatrixDOK(gl_size, gl_size);
+#if !defined(NEW_EQS)
+        this->FCT_AFlux = new SparseMatrixCSR(*m_msh);
+#endif
         this->Gl_ML = new Math_Group::Vec(gl_size);
         this->Gl_Vec = new Math_Group::Vec(gl_size);
         this->Gl_Vec1 = new Math_Group::Vec(gl_size);
     }
+    if (m_num->ele_supg_method > 0)  // SUPG element lengths from the edges
+        m_msh->ConstructEdges();
     //----------------------------------------------------------------------------
     // EQS - create equation system
     // WW CreateEQS();
@@ -770,6 +806,14 @@ void CRFProcess::Create()
         }
 #endif
     }  // WW 02.2013. Pardiso
+    if (m_num->fct_method > 0)
+    {
+        // Antidiffusive fluxes with the pattern of the equations
+        std::vector<long> eqs_index(m_msh->GetNodesNumber(false));
+        for (std::size_t i = 0; i < eqs_index.size(); i++)
+            eqs_index[i] = m_msh->nod_vector[i]->GetEquationIndex();
+        this->FCT_AFlux = new SparseMatrixCSR(*eqs_new->A, eqs_index);
+    }
 #else
     // WW  phase=1;
     // CRFProcess *m_pcs = NULL;                      //
@@ -2636,6 +2680,11 @@ void CRFProcess::Config(void)
         type = 55;  // WW
         ConfigRandomWalk();
     }
+    // Edge velocities and particle tracking on the edges of the flow meshes
+    if (this->getProcessType() == FiniteElement::FLUID_MOMENTUM ||
+        this->getProcessType() == FiniteElement::RANDOM_WALK)
+        for (size_t k = 0; k < fem_msh_vector.size(); k++)
+            fem_msh_vector[k]->ConstructEdges();
     //	if (_pcs_type_name.find("MULTI_PHASE_FLOW") != string::npos)
     //{//24.02.2007 WW
     if (this->getProcessType() ==
@@ -4559,10 +4608,9 @@ void CRFProcess::ConfigTES()
 **************************************************************************/
 void CRFProcess::CheckMarkedElement()
 {
-    size_t i, j;
+    size_t i;
     bool done;
     CElem* elem = NULL;
-    CNode* node = NULL;
 
     size_t ele_vector_size(m_msh->ele_vector.size());
 
@@ -4594,30 +4642,8 @@ void CRFProcess::CheckMarkedElement()
         else
             elem->MarkingAll(true);
     }
-    size_t node_vector_size = m_msh->nod_vector.size();
-    for (size_t l = 0; l < node_vector_size; l++)
-        while (m_msh->nod_vector[l]->getConnectedElementIDs().size())
-            m_msh->nod_vector[l]->getConnectedElementIDs().pop_back();
-
-    for (size_t l = 0; l < ele_vector_size; l++)
-    {
-        elem = m_msh->ele_vector[l];
-        if (!elem->GetMark())
-            continue;
-        for (i = 0; i < elem->GetNodesNumber(m_msh->getOrder()); i++)
-        {
-            done = false;
-            node = elem->GetNode(i);
-            for (j = 0; j < node->getConnectedElementIDs().size(); j++)
-                if (l == node->getConnectedElementIDs()[j])
-                {
-                    done = true;
-                    break;
-                }
-            if (!done)
-                node->getConnectedElementIDs().push_back(l);
-        }
-    }
+    m_msh->ConnectedElements2Node(m_msh->getOrder());
+    UpdateActiveElements();
 }
 
 bool CRFProcess::isPointInExcavatedDomain(double const* point,
@@ -4670,6 +4696,63 @@ void CRFProcess::CheckExcavedElement()
             }
         }
     }
+    UpdateActiveElements();
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task:  Collect the indices of the active elements grouped by element
+          type. The element loops run over them, so that deactivated
+          domains are skipped without a test of each element. If the
+          mesh is colored, the active elements of each color are
+          collected too for the parallel assembly.
+**************************************************************************/
+void CRFProcess::UpdateActiveElements()
+{
+    const long n_elements = static_cast<long>(m_msh->ele_vector.size());
+    active_element_ptr.assign(MshElemType::NUM_ELEM_TYPES + 1, 0);
+    for (long i = 0; i < n_elements; i++)
+    {
+        CElem* elem = m_msh->ele_vector[i];
+        if (elem->GetMark())
+            active_element_ptr[elem->GetElementType()]++;
+    }
+    for (int t = 0; t < MshElemType::NUM_ELEM_TYPES; t++)
+        active_element_ptr[t + 1] += active_element_ptr[t];
+
+    active_elements.resize(active_element_ptr[MshElemType::NUM_ELEM_TYPES]);
+    std::vector<long> position(active_element_ptr.begin(),
+                               active_element_ptr.end() - 1);
+    for (long i = 0; i < n_elements; i++)
+    {
+        CElem* elem = m_msh->ele_vector[i];
+        if (elem->GetMark())
+            active_elements[position[elem->GetElementType() - 1]++] = i;
+    }
+
+    active_color_elements.clear();
+    active_color_ptr.clear();
+    const std::vector<long>& color_ptr = m_msh->ele_color_ptr;
+    const std::vector<long>& color_elements = m_msh->ele_color_elements;
+    if (static_cast<long>(color_elements.size()) == n_elements)
+    {
+        position.assign(n_elements, -1);
+        for (std::size_t k = 0; k < active_elements.size(); k++)
+            position[active_elements[k]] = static_cast<long>(k);
+        active_color_elements.reserve(active_elements.size());
+        active_color_ptr.push_back(0);
+        for (std::size_t c = 0; c + 1 < color_ptr.size(); c++)
+        {
+            for (long k = color_ptr[c]; k < color_ptr[c + 1]; k++)
+                if (position[color_elements[k]] >= 0)
+                    active_color_elements.push_back(
+                        position[color_elements[k]]);
+            active_color_ptr.push_back(
+                static_cast<long>(active_color_elements.size()));
+        }
+    }
+    active_elements_mark_changes = CElem::getMarkChanges();
+    active_elements_mesh_size = n_elements;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -4800,10 +4883,9 @@ double CRFProcess::Execute()
         for (int ii = 0; ii < pcs_number_of_primary_nvals; ii++)
         {
             nidx1 = GetNodeValueIndex(pcs_primary_function_name[ii]) + 1;
-            long const ish = ii * g_nnodes;
-            for (j = 0; j < g_nnodes; j++)  // WW
-                eqs_x[j + ish] =
-                    GetNodeValue(m_msh->Eqs2Global_NodeIndex[j], nidx1);
+            Math_Group::GatherNodeValues(getNodeValue_per_Variable(nidx1),
+                                         &m_msh->Eqs2Global_NodeIndex[0],
+                                         eqs_x + ii * g_nnodes, g_nnodes);
         }
 #endif
     }
@@ -4818,6 +4900,15 @@ double CRFProcess::Execute()
     ScreenMessage("      Assembling equation system...\n");
 
     GlobalAssembly();
+#if defined(NEW_EQS) && !defined(USE_MPI)
+    // Assemble again with the previous solution if the predicted initial
+    // guess of the time step is rejected
+    if (RejectPredictedSolution())
+    {
+        eqs_new->Initialize();
+        GlobalAssembly();
+    }
+#endif
 #if defined(USE_MPI) || defined(USE_PETSC)  // WW
     cpu_time += clock();
     cpu_time_assembly += cpu_time;
@@ -4982,19 +5073,15 @@ double CRFProcess::Execute()
         for (int i = 0; i < pcs_number_of_primary_nvals; i++)
         {
             nidx1 = GetNodeValueIndex(pcs_primary_function_name[i]) + 1;
-#if !defined(USE_PETSC)  // && !defined(other parallel libs)
-            const long ish = i * g_nnodes;
-#endif
-            for (j = 0; j < g_nnodes; j++)
-            {
 #if defined(USE_PETSC)  // || defined(other parallel libs)
+            for (j = 0; j < g_nnodes; j++)
                 x_k[j * pcs_number_of_primary_nvals + i] =
                     GetNodeValue(j, nidx1);
 #else
-                x_k[j + ish] =
-                    GetNodeValue(m_msh->Eqs2Global_NodeIndex[j], nidx1);
+            Math_Group::GatherNodeValues(getNodeValue_per_Variable(nidx1),
+                                         &m_msh->Eqs2Global_NodeIndex[0],
+                                         x_k + i * g_nnodes, g_nnodes);
 #endif
-            }
         }
     }
 #if defined(USE_PETSC)  // || defined(other parallel libs)//03.3012. WW
@@ -5060,16 +5147,33 @@ double CRFProcess::Execute()
         eqs_x = eqs_new->GetGlobalSolution();
 #endif
         //
+#if !defined(USE_PETSC)
+        if (m_num->nls_anderson_depth > 0 && m_num->nls_method == 0 &&
+            pcs_error >= 1.0)
+            AccelerateNonLinearIteration(nl_theta);
+        else
+        {
+            // u = (1 - theta) u + theta x, and x gets the previous u, which
+            // is used for time stepping. 03.04.2009. WW
+            const double theta = (nl_theta > implicit_lim) ? 1.0 : nl_theta;
+            for (int ii = 0; ii < pcs_number_of_primary_nvals; ii++)
+            {
+                nidx1 = GetNodeValueIndex(pcs_primary_function_name[ii]) + 1;
+                Math_Group::UpdateNodeValues(
+                    getNodeValue_per_Variable(nidx1),
+                    &m_msh->Eqs2Global_NodeIndex[0], eqs_x + ii * g_nnodes,
+                    g_nnodes, theta, false);
+            }
+        }
+#else
         if (nl_theta > implicit_lim)  // This is most common. So go for the
                                       // lesser calculations.
         {
             for (int ii = 0; ii < pcs_number_of_primary_nvals; ii++)
             {
                 nidx1 = GetNodeValueIndex(pcs_primary_function_name[ii]) + 1;
-                const long nshift = ii * g_nnodes;
                 for (j = 0; j < g_nnodes; j++)
                 {
-#if defined(USE_PETSC)  // || defined(other parallel libs)//08.2014. WW
                     k = pcs_number_of_primary_nvals *
                             m_msh->Eqs2Global_NodeIndex[j] +
                         ii;
@@ -5077,14 +5181,6 @@ double CRFProcess::Execute()
                         GetNodeValue(j, nidx1);  // 03.04.2009. WW
                     SetNodeValue(j, nidx1, eqs_x[k]);
                     eqs_x[k] = val_n;  // Used for time stepping. 03.04.2009. WW
-#else
-                    k = m_msh->Eqs2Global_NodeIndex[j];
-                    const double val_n =
-                        GetNodeValue(k, nidx1);  // 03.04.2009. WW
-                    SetNodeValue(k, nidx1, eqs_x[j + nshift]);
-                    eqs_x[j + nshift] =
-                        val_n;  // Used for time stepping. 03.04.2009. WW
-#endif
                 }
             }
         }
@@ -5093,10 +5189,8 @@ double CRFProcess::Execute()
             for (int ii = 0; ii < pcs_number_of_primary_nvals; ii++)
             {
                 nidx1 = GetNodeValueIndex(pcs_primary_function_name[ii]) + 1;
-                const long nshift = ii * g_nnodes;
                 for (j = 0; j < g_nnodes; j++)
                 {
-#if defined(USE_PETSC)  // || defined(other parallel libs)//08.2014. WW
                     k = pcs_number_of_primary_nvals *
                             m_msh->Eqs2Global_NodeIndex[j] +
                         ii;
@@ -5105,19 +5199,10 @@ double CRFProcess::Execute()
                         j, nidx1,
                         (1.0 - nl_theta) * val_n + nl_theta * eqs_x[k]);
                     eqs_x[k] = val_n;  // Used for time stepping. 03.04.2009. WW
-#else
-                    k = m_msh->Eqs2Global_NodeIndex[j];
-                    const double val_n =
-                        GetNodeValue(k, nidx1);  // 03.04.2009. WW
-                    SetNodeValue(k, nidx1,
-                                 (1.0 - nl_theta) * val_n +
-                                     nl_theta * eqs_x[j + nshift]);
-                    eqs_x[j + nshift] =
-                        val_n;  // Used for time stepping. 03.04.2009. WW
-#endif
                 }
             }
         }
+#endif
 
         // maybe works also for other processes involving velocities
         // update nod velocity if constrained BC
@@ -5237,24 +5322,31 @@ void CRFProcess::CalculateElementMatrices(void)
    04/2010 NW Implementation
    last modified:
    05/2013 NW Support PETSc parallelization
+   The antidiffusive fluxes are kept in a matrix with the pattern of the
+   equations (SparseMatrixCSR), which also keeps the positions of K_ij in
+   the equation matrix (NEW_EQS). The loops over its rows are run in
+   parallel where each thread only writes to its own rows or node pairs.
  **************************************************************************/
 void CRFProcess::AddFCT_CorrectionVector()
 {
     int idx0 = 0;
     int idx1 = idx0 + 1;
     const double theta = this->m_num->ls_theta;
-    const size_t node_size = m_msh->GetNodesNumber(false);
-    SparseMatrixDOK::mat_t& fct_f = this->FCT_AFlux->GetRawData();
-    SparseMatrixDOK::col_t* col;
-    SparseMatrixDOK::mat_t::const_iterator ii;
-    SparseMatrixDOK::col_t::const_iterator jj;
+    const long node_size = static_cast<long>(m_msh->GetNodesNumber(false));
+    SparseMatrixCSR& fct_f = *this->FCT_AFlux;
     Math_Group::Vec* ML = this->Gl_ML;
 #if defined(NEW_EQS)
-    CSparseMatrix* A = NULL;  // WW
-    // if(m_dom)
-    //  A = m_dom->eqs->A;
-    // else
-    A = this->eqs_new->A;
+    CSparseMatrix* A = this->eqs_new->A;  // WW
+    // K at the positions kept by the flux matrix
+    const double* K = A->Entries();
+#endif
+    // Equation indices of the nodes
+    std::vector<long> eqs_index(node_size);
+    for (long i = 0; i < node_size; i++)
+#if defined(NEW_EQS)
+        eqs_index[i] = m_msh->nod_vector[i]->GetEquationIndex();
+#else
+        eqs_index[i] = i;
 #endif
 
 #ifdef USE_PETSC
@@ -5264,15 +5356,6 @@ void CRFProcess::AddFCT_CorrectionVector()
     FCT_MPI::computeD(m_msh, *FCT_K, *FCT_d);
 #endif
 
-    // List of Dirichlet nodes
-    std::set<long> list_bc_nodes;
-    for (size_t i = 0; i < bc_node_value.size(); i++)
-    {
-        CBoundaryConditionNode* bc_node = bc_node_value[i];
-        long nod_id = bc_node->geo_node_number;
-        list_bc_nodes.insert(nod_id);
-    }
-
     //----------------------------------------------------------------------
     // Construct global matrices: antidiffusive flux(f_ij), positivity matrix(L)
     // - f_ij =
@@ -5288,12 +5371,14 @@ void CRFProcess::AddFCT_CorrectionVector()
     //   -> f_ij = m_ij
     //----------------------------------------------------------------------
     // f_ij*=1/dt*(DeltaU_ij^H-DeltaU_ij^n)  for i!=j
-    for (size_t i = 0; i < node_size; i++)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < node_size; i++)
     {
-        col = &fct_f[i];
-        for (jj = col->begin(); jj != col->end(); jj++)
+        for (long k = fct_f.RowBegin(i); k < fct_f.RowEnd(i); k++)
         {
-            const size_t j = (*jj).first;
+            const long j = fct_f.Column(k);
             if (i > j)
                 continue;  // symmetric part, off-diagonal
             double diff_uH =
@@ -5301,25 +5386,26 @@ void CRFProcess::AddFCT_CorrectionVector()
             double diff_u0 =
                 this->GetNodeValue(i, idx0) - this->GetNodeValue(j, idx0);
             double v = 1.0 / dt * (diff_uH - diff_u0);
-            (*FCT_AFlux)(i, j) *=
-                v;  // MC is already done in local ele assembly
-            (*FCT_AFlux)(j, i) *=
-                -v;  // MC is already done in local ele assembly
+            // MC is already done in local ele assembly
+            fct_f.Value(k) *= v;
+            fct_f.Value(fct_f.Transposed(k)) *= -v;
         }
     }
 
     // Complete f, L
-    // Remark: Using iteration is only possible after the sparse table has been
-    // constructed.
-    for (size_t i = 0; i < node_size; i++)
+    // d_ij of the entries of the upper triangle
+    std::vector<double> d_upper(fct_f.RowBegin(node_size), 0.);
+#if defined(_OPENMP) && defined(NEW_EQS)
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < node_size; i++)
     {
 #ifdef USE_PETSC
         const size_t i_global = FCT_GLOB_ADDRESS(i);
 #endif
-        col = &fct_f[i];
-        for (jj = col->begin(); jj != col->end(); jj++)
+        for (long k = fct_f.RowBegin(i); k < fct_f.RowEnd(i); k++)
         {
-            const size_t j = (*jj).first;
+            const long j = fct_f.Column(k);
             if (i > j || i == j)
                 continue;  // do below only for upper triangle due to symmetric
 
@@ -5329,8 +5415,8 @@ void CRFProcess::AddFCT_CorrectionVector()
             double d1 = (*FCT_d)(i_global, j_global);
 #else
 #if defined(NEW_EQS)
-            double K_ij = (*A)(i, j);
-            double K_ji = (*A)(j, i);
+            double K_ij = K[fct_f.MatrixEntry(k)];
+            double K_ji = K[fct_f.MatrixEntry(fct_f.Transposed(k))];
 #else
             double K_ij = MXGet(i, j);
             double K_ji = MXGet(j, i);
@@ -5341,12 +5427,9 @@ void CRFProcess::AddFCT_CorrectionVector()
 #endif
             if (d1 == 0.0)
                 continue;
+            d_upper[k] = d1;
             double d0 =
                 d1;  // TODO should use AuxMatrix at the previous time step
-            // if (list_bc_nodes.find(i)!=list_bc_nodes.end() ||
-            // list_bc_nodes.find(j)!=list_bc_nodes.end()) {
-            //  d1 = d0 = 0.0;
-            //}
 
             // Complete antidiffusive flux: f_ij += -theta*d_ij^H*DeltaU_ij^H -
             // (1-theta)*d_ij^n*DeltaU_ij^n
@@ -5355,10 +5438,9 @@ void CRFProcess::AddFCT_CorrectionVector()
             double diff_u0 =
                 this->GetNodeValue(i, idx0) - this->GetNodeValue(j, idx0);
             double v = -(theta * d1 * diff_uH + (1.0 - theta) * d0 * diff_u0);
-            (*FCT_AFlux)(i, j) += v;
+            v += fct_f.Value(k);
 
             // prelimiting f
-            v = (*FCT_AFlux)(i, j);
             if (this->m_num->fct_prelimiter_type == 0)
             {
                 if (v * (-diff_uH) > 0.0)
@@ -5368,32 +5450,61 @@ void CRFProcess::AddFCT_CorrectionVector()
                 v = MinMod(v, -d1 * diff_uH);
             else if (this->m_num->fct_prelimiter_type == 2)
                 v = SuperBee(v, -d1 * diff_uH);
-            (*FCT_AFlux)(i, j) = v;
+            fct_f.Value(k) = v;
 #ifdef USE_PETSC
-            (*FCT_AFlux)(j, i) = -v;
+            fct_f.Value(fct_f.Transposed(k)) = -v;
 #else
-            (*FCT_AFlux)(j, i) = v;
+            fct_f.Value(fct_f.Transposed(k)) = v;
 #endif
+        }
+    }
 
+    // A += theta * D (PETSc), L = K + D
+#if defined(NEW_EQS)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < node_size; i++)
+    {
+        double d_ii = 0.;
+        for (long k = fct_f.RowBegin(i); k < fct_f.RowEnd(i); k++)
+        {
+            const long j = fct_f.Column(k);
+            if (i == j)
+                continue;
+            const double d1 =
+                (i < j) ? d_upper[k] : d_upper[fct_f.Transposed(k)];
+            if (d1 == 0.0)
+                continue;
+            (*A)(eqs_index[i], eqs_index[j]) += d1;
+            d_ii -= d1;
+        }
+        (*A)(eqs_index[i], eqs_index[i]) += d_ii;
+    }
+#else
+    for (long i = 0; i < node_size; i++)
+    {
 #ifdef USE_PETSC
-            // A += theta * D
-            if (i < (size_t)m_msh->getNumNodesLocal())
+        const size_t i_global = FCT_GLOB_ADDRESS(i);
+#endif
+        for (long k = fct_f.RowBegin(i); k < fct_f.RowEnd(i); k++)
+        {
+            const long j = fct_f.Column(k);
+            const double d1 = d_upper[k];
+            if (i >= j || d1 == 0.0)
+                continue;
+#ifdef USE_PETSC
+            const size_t j_global = FCT_GLOB_ADDRESS(j);
+            if (i < (long)m_msh->getNumNodesLocal())
             {
                 eqs_new->addMatrixEntry(i_global, i_global, -d1 * theta);
                 eqs_new->addMatrixEntry(i_global, j_global, d1 * theta);
             }
-            if (j < (size_t)m_msh->getNumNodesLocal())
+            if (j < (long)m_msh->getNumNodesLocal())
             {
                 eqs_new->addMatrixEntry(j_global, i_global, d1 * theta);
                 eqs_new->addMatrixEntry(j_global, j_global, -d1 * theta);
             }
-#else
-// L = K + D
-#if defined(NEW_EQS)
-            (*A)(i, i) += -d1;
-            (*A)(i, j) += d1;
-            (*A)(j, i) += d1;
-            (*A)(j, j) += -d1;
 #else
             // add off-diagonal term
             MXInc(i, j, d1);
@@ -5401,10 +5512,10 @@ void CRFProcess::AddFCT_CorrectionVector()
             // add diagonal term
             MXInc(i, i, -d1);
             MXInc(j, j, -d1);
-#endif
 #endif
         }
     }
+#endif
 
     //----------------------------------------------------------------------
     // Assemble RHS: b_i += [- (1-theta) * L_ij] u_j^n
@@ -5424,34 +5535,40 @@ void CRFProcess::AddFCT_CorrectionVector()
     // b = [-(1-theta) * L] u^n
     if (1.0 - theta > .0)
     {
+#ifdef NEW_EQS
+        // L*u^n in the equation numbering
+        std::vector<double> u_n(A->Dim(), 0.);
+        std::vector<double> L_u_n(A->Dim(), 0.);
+        for (long i = 0; i < node_size; i++)
+            u_n[eqs_index[i]] = this->GetNodeValue(i, idx0);
+        A->multiVec(&u_n[0], &L_u_n[0]);
+        for (long i = 0; i < node_size; i++)
+            eqs_rhs[eqs_index[i]] -= (1.0 - theta) * L_u_n[eqs_index[i]];
+#else
         // u^n
-        for (size_t i = 0; i < node_size; i++)
+        for (long i = 0; i < node_size; i++)
             (*V1)(i) = this->GetNodeValue(i, idx0);
         // L*u^n
-        for (size_t i = 0; i < node_size; i++)
+        for (long i = 0; i < node_size; i++)
         {
 #ifdef USE_PETSC
             const size_t i_global = FCT_GLOB_ADDRESS(i);
 #endif
-            for (size_t j = 0; j < node_size; j++)
+            for (long j = 0; j < node_size; j++)
             {
 #ifdef USE_PETSC
                 const size_t j_global = FCT_GLOB_ADDRESS(j);
                 // b+=-(1-theta)*D*u^n
                 (*V)(i) += (*FCT_d)(i_global, j_global) * (*V1)(j);
-#else
-#ifdef NEW_EQS
-                (*V)(i) += (*A)(i, j) * (*V1)(j);
 #else
                 (*V)(i) += MXGet(i, j) * (*V1)(j);
-#endif
 #endif
             }
         }
-        for (size_t i = 0; i < node_size; i++)
+        for (long i = 0; i < node_size; i++)
         {
 #if defined(USE_PETSC)
-            if (i < (size_t)m_msh->getNumNodesLocal())
+            if (i < (long)m_msh->getNumNodesLocal())
             {
                 const size_t i_global = FCT_GLOB_ADDRESS(i);
                 eqs_new->add_bVectorEntry(i_global, -(1.0 - theta) * (*V)(i),
@@ -5462,6 +5579,7 @@ void CRFProcess::AddFCT_CorrectionVector()
 //(*RHS)(i+LocalShift) +=  NodalVal[i];
 #endif
         }
+#endif
     }
 
 #ifndef USE_PETSC
@@ -5474,8 +5592,8 @@ void CRFProcess::AddFCT_CorrectionVector()
 #ifdef NEW_EQS
         (*A) = 0.0;
 #else
-        for (size_t i = 0; i < node_size; i++)
-            for (size_t j = 0; j < node_size; j++)
+        for (long i = 0; i < node_size; i++)
+            for (long j = 0; j < node_size; j++)
                 MXSet(i, j, 0.0);
 
 #endif
@@ -5489,18 +5607,18 @@ void CRFProcess::AddFCT_CorrectionVector()
 #ifdef NEW_EQS
         (*A) *= theta;
 #else
-        for (size_t i = 0; i < node_size; i++)
-            for (size_t j = 0; j < node_size; j++)
+        for (long i = 0; i < node_size; i++)
+            for (long j = 0; j < node_size; j++)
                 MXMul(i, j, theta);
 
 #endif
     }
     // A matrix: += 1/dt * ML
-    for (size_t i = 0; i < node_size; i++)
+    for (long i = 0; i < node_size; i++)
     {
         double v = 1.0 / dt * (*ML)(i);
 #ifdef NEW_EQS
-        (*A)(i, i) += v;
+        (*A)(eqs_index[i], eqs_index[i]) += v;
 #else
         MXInc(i, i, v);
 #endif
@@ -5515,20 +5633,22 @@ void CRFProcess::AddFCT_CorrectionVector()
     Math_Group::Vec* R_min = this->Gl_Vec;
     (*R_plus) = 0.0;
     (*R_min) = 0.0;
-    for (size_t i = 0; i < node_size; i++)
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < node_size; i++)
     {
         const size_t i_global = FCT_GLOB_ADDRESS(i);
         double P_plus, P_min;
         double Q_plus, Q_min;
         P_plus = P_min = 0.0;
         Q_plus = Q_min = 0.0;
-        col = &fct_f[i];
-        for (jj = col->begin(); jj != col->end(); jj++)
+        for (long k = fct_f.RowBegin(i); k < fct_f.RowEnd(i); k++)
         {
-            const size_t j = (*jj).first;
+            const long j = fct_f.Column(k);
             if (i == j)
                 continue;
-            double f = (*jj).second;  // double f = (*FCT_AFlux)(i,j);
+            double f = fct_f.Value(k);
 #ifndef USE_PETSC
             if (i > j)
                 f *= -1.0;
@@ -5568,18 +5688,21 @@ void CRFProcess::AddFCT_CorrectionVector()
     }
 
     // b_i += alpha_i * f_ij
-    for (size_t i = 0; i < node_size; i++)
+#if defined(_OPENMP) && !defined(USE_PETSC)
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < node_size; i++)
     {
         const size_t i_global = FCT_GLOB_ADDRESS(i);
-        col = &fct_f[i];
-        for (jj = col->begin(); jj != col->end(); jj++)
+        double b_i = 0.;
+        for (long k = fct_f.RowBegin(i); k < fct_f.RowEnd(i); k++)
         {
-            const size_t j = (*jj).first;
+            const long j = fct_f.Column(k);
             const size_t j_global = FCT_GLOB_ADDRESS(j);
             if (i == j)
                 continue;
 
-            double f = (*jj).second;  // double f = (*FCT_AFlux)(i,j);
+            double f = fct_f.Value(k);
 #ifndef USE_PETSC
             if (i > j)
                 f *= -1;  // symmetric
@@ -5597,15 +5720,18 @@ void CRFProcess::AddFCT_CorrectionVector()
                 val = this->m_num->fct_const_alpha * f;
 
 #ifdef USE_PETSC
-            if (i < (size_t)m_msh->getNumNodesLocal())
+            if (i < (long)m_msh->getNumNodesLocal())
                 eqs_new->add_bVectorEntry(i_global, val, ADD_VALUES);
 #else
-            eqs_rhs[i] += val;
+            b_i += val;
 #endif
 
             // Note: Galerkin FEM is recovered if alpha = 1 as below,
             // eqs_rhs[i] += 1.0*f;
         }
+#ifndef USE_PETSC
+        eqs_rhs[eqs_index[i]] += b_i;
+#endif
     }
 }
 
@@ -5735,14 +5861,45 @@ else
         // WW
 {       // STD
     // YDTEST. Changed to DOF 15.02.2007 WW
+    const bool parallel_assembly = isParallelAssembly();
+    const bool batch_assembly = !parallel_assembly && isBatchAssembly();
+#ifdef NEW_EQS
+    const bool shared_operator = isSharedTransportOperator();
+    if (shared_rhs && !femFCTmode)
+        (*shared_rhs) = 0.0;
+    const bool cached_operator = !shared_operator && isGlobalOperatorCached();
+#endif
     for (size_t ii = 0; ii < continuum_vector.size(); ii++)
     {
         continuum = ii;
-        for (size_t i = 0; i < m_msh->ele_vector.size(); i++)
+#ifdef NEW_EQS
+        if (shared_operator)
         {
-            elem = m_msh->ele_vector[i];
-            // Marked for use //WX: modified for coupled excavation
-            if (elem->GetMark() && elem->GetExcavState() == -1)
+            AssembleSharedTransportOperator();
+            continue;
+        }
+        if (cached_operator)
+        {
+            AssembleGlobalOperator();
+            continue;
+        }
+#endif
+        if (parallel_assembly)
+        {
+            GlobalAssembly_omp(false, Check2D3D, false);
+            continue;
+        }
+        if (batch_assembly)
+        {
+            GlobalAssembly_batch(Check2D3D);
+            continue;
+        }
+        const std::vector<long>& elements = getActiveElements();
+        for (size_t i = 0; i < elements.size(); i++)
+        {
+            elem = m_msh->ele_vector[elements[i]];
+            // WX: modified for coupled excavation
+            if (elem->GetExcavState() == -1)
             {
                 elem->SetOrder(false);
                 fem->ConfigElement(elem, Check2D3D);
@@ -5762,6 +5919,19 @@ else
         }
     }
 
+#ifdef NEW_EQS
+    if (global_operator_cache && global_operator_cache->isAssembling())
+        global_operator_cache->setAssembled();
+    if (shared_lhs && !shared_operator && !femFCTmode)
+    {
+        // Keep the operator for the components that share it
+        (*shared_lhs) = *eqs_new->A;
+        shared_operator_step = static_cast<long>(aktueller_zeitschritt);
+        shared_operator_dt = Tim->time_step_length;
+        eqs_new->SetKeptOperator(shared_lhs, ++kept_operators);
+    }
+    KeepOrRestoreJacobian();
+#endif
     if (femFCTmode)  // NW
         AddFCT_CorrectionVector();
 
@@ -5850,12 +6020,16 @@ void CRFProcess::GlobalAssembly_std(const bool is_mixed_order, bool Check2D3D)
     long i;
     CElem* elem = NULL;
 
-    for (i = 0; i < (long)m_msh->ele_vector.size(); i++)
+    if (isParallelAssembly())
     {
-        elem = m_msh->ele_vector[i];
-        if (!elem->GetMark())  // Marked for use
-            continue;          // For OpenMP. WW
+        GlobalAssembly_omp(is_mixed_order, Check2D3D, true);
+        return;
+    }
 
+    const std::vector<long>& elements = getActiveElements();
+    for (i = 0; i < (long)elements.size(); i++)
+    {
+        elem = m_msh->ele_vector[elements[i]];
         elem->SetOrder(m_msh->getOrder());
         fem->setMixedOrderFlag(is_mixed_order);
         fem->ConfigElement(elem, Check2D3D);
@@ -5863,138 +6037,644 @@ void CRFProcess::GlobalAssembly_std(const bool is_mixed_order, bool Check2D3D)
     }
 }
 
-/*************************************************************************
-   GeoSys-Function:
-   Task: Integration
-   Programming:
-   05/2009 WW Implementation
- **************************************************************************/
-void CRFProcess::Integration(vector<double>& node_velue)
+//--------------------------------------------------------------------
+/*! \brief Check whether the element loop of the assembly runs in parallel,
+     i.e. $ELE_PARALLEL_ASSEMBLY is given in the NUM file.
+
+     The local assembly of the single phase flow processes without
+     deformation coupling is thread safe: the material functions used by
+     them keep the data of the current element per thread (ThreadPrivate).
+     All other processes, the domain decomposition and the storage of the
+     element matrices use the serial element loop.
+ */
+bool CRFProcess::isParallelAssembly() const
 {
-    //----------------------------------------------------------------------
-    size_t k;
-    long i;
-    CElem* elem = NULL;
-    bool Check2D3D;
-    Check2D3D = false;
-    double n_val[8];
-
-    if (type == 66)  // Overland flow
-        Check2D3D = true;
-
-    vector<double> buffer((long)node_velue.size());
-    for (i = 0; i < (long)buffer.size(); i++)
-        buffer[i] = 0.;
-
-    for (i = 0; i < (long)m_msh->ele_vector.size(); i++)
+#if defined(_OPENMP) && !defined(USE_PETSC)
+    if (m_num->ele_parallel_assembly < 1 || omp_get_max_threads() < 2)
+        return false;
+    switch (getProcessType())
     {
-        elem = m_msh->ele_vector[i];
-        if (!elem->GetMark())
-            continue;
+        case FiniteElement::LIQUID_FLOW:
+        case FiniteElement::GROUNDWATER_FLOW:
+            break;
+        default:
+            return false;
+    }
+    return dom_vector.empty() && Memory_Type == 0 && !Write_Matrix &&
+           !femFCTmode && m_num->nls_method != 2 && fem &&
+           fem->isDeformationCoupling() == 0 &&
+           (!Tim || Tim->time_control_type != TimeControlType::NEUMANN);
+#else
+    return false;
+#endif
+}
 
-        for (k = 0; k < elem->GetNodesNumber(false); k++)
-            n_val[k] = node_velue[elem->GetNodeIndex(k)];
+//--------------------------------------------------------------------
+/*! \brief Element loop of the assembly with OpenMP.
+
+     Each thread uses its own CFiniteElementStd. The elements of one color
+     do not share nodes (CFEMesh::ColorElements), so that the threads add to
+     different rows of the global matrix and of the RHS vector. The colors
+     are assembled one after another. Thus, the contributions to a row are
+     always added in the same order, and the result does not depend on the
+     number of threads. Only the active elements of each color are visited
+     (UpdateActiveElements).
+
+     The porosity and the storage of the media properties are kept per
+     thread while the loop runs. Afterwards, each medium gets the values
+     of its element that the serial loop would assemble last.
+
+     \param mesh_order Element order of the mesh and mixed order flag as in
+                       GlobalAssembly_std, otherwise linear elements that
+                       are not excavated as in GlobalAssembly
+ */
+void CRFProcess::GlobalAssembly_omp(const bool is_mixed_order,
+                                    const bool Check2D3D,
+                                    const bool mesh_order)
+{
+#ifdef _OPENMP
+    if (m_msh->ele_color_elements.size() != m_msh->ele_vector.size())
+        m_msh->ColorElements();
+    const std::vector<long>& elements = getActiveElements();
+    if (active_color_elements.size() != elements.size())
+        UpdateActiveElements();
+
+    const int n_threads = std::min(omp_get_max_threads(), OGS_MAX_THREADS);
+    if (thread_fem.empty())
+        thread_fem.push_back(fem);
+    if (static_cast<int>(thread_fem.size()) < n_threads)
+    {
+        int Axisymm = 1;  // ani-axisymmetry
+        if (m_msh->isAxisymmetry())
+            Axisymm = -1;  // Axisymmetry is true
+        const bool Dyn = pcs_type_name_vector.size() &&
+                         pcs_type_name_vector[0].find("DYNAMIC") !=
+                             string::npos;
+        while (static_cast<int>(thread_fem.size()) < n_threads)
+        {
+            CFiniteElementStd* a_fem = new CFiniteElementStd(
+                this, Axisymm * m_msh->GetCoordinateFlag());
+            a_fem->setShapeFunctionPool(fem->getShapeFunctionPool(0),
+                                        fem->getShapeFunctionPool(1));
+            a_fem->SetGaussPointNumber(fem->GetNumGaussSamples());
+            a_fem->ConfigureCoupling(this, Shift, Dyn);
+            thread_fem.push_back(a_fem);
+        }
+    }
+
+    // Per thread and medium: the last position in elements that was
+    // assembled, and the porosity and storage after it
+    const std::size_t n_media = mmp_vector.size();
+    std::vector<long> last_position(n_threads * n_media, -1);
+    std::vector<double> last_porosity(n_threads * n_media);
+    std::vector<double> last_storage(n_threads * n_media);
+    for (std::size_t m = 0; m < n_media; m++)
+    {
+        CMediumProperties* mmp = mmp_vector[m];
+        mmp->porosity.setAll(mmp->porosity);
+        mmp->storage.setAll(mmp->storage);
+    }
+
+    const std::vector<long>& color_ptr = active_color_ptr;
+    const std::vector<long>& color_elements = active_color_elements;
+    for (std::size_t c = 0; c + 1 < color_ptr.size(); c++)
+    {
+#pragma omp parallel for num_threads(n_threads) schedule(static)
+        for (long k = color_ptr[c]; k < color_ptr[c + 1]; k++)
+        {
+            const long position = color_elements[k];
+            CElem* elem = m_msh->ele_vector[elements[position]];
+            const int thread = omp_get_thread_num();
+            CFiniteElementStd* a_fem = thread_fem[thread];
+            if (mesh_order)
+            {
+                elem->SetOrder(m_msh->getOrder());
+                a_fem->setMixedOrderFlag(is_mixed_order);
+            }
+            else
+            {
+                if (elem->GetExcavState() != -1)
+                    continue;
+                elem->SetOrder(false);
+            }
+            a_fem->ConfigElement(elem, Check2D3D);
+            a_fem->Assembly();
 
-        elem->SetOrder(false);
-        fem->ConfigElement(elem, Check2D3D);
-        fem->FaceIntegration(n_val);
+            const std::size_t m = elem->GetPatchIndex();
+            if (m >= n_media)
+                continue;
+            const std::size_t s = thread * n_media + m;
+            if (position > last_position[s])
+            {
+                last_position[s] = position;
+                last_porosity[s] = mmp_vector[m]->porosity;
+                last_storage[s] = mmp_vector[m]->storage;
+            }
+        }
+    }
 
-        for (k = 0; k < elem->GetNodesNumber(false); k++)
-            buffer[elem->GetNodeIndex(k)] += n_val[k];
+    for (std::size_t m = 0; m < n_media; m++)
+    {
+        long position = -1;
+        for (int thread = 0; thread < n_threads; thread++)
+        {
+            const std::size_t s = thread * n_media + m;
+            if (last_position[s] <= position)
+                continue;
+            position = last_position[s];
+            mmp_vector[m]->porosity = last_porosity[s];
+            mmp_vector[m]->storage = last_storage[s];
+        }
     }
-    //----------------------------------------------------------------------
+#else
+    (void)is_mixed_order;
+    (void)Check2D3D;
+    (void)mesh_order;
+#endif
 }
 
-/*************************************************************************
-   GeoSys-Function:
-   Task: Calculate integration point velocity
-   Programming:
-   08/2005 WW Implementation
-   last modified:
- **************************************************************************/
-void CRFProcess::CalIntegrationPointValue()
+//--------------------------------------------------------------------
+/*! \brief Check whether the element loop of the assembly uses element
+     batches, i.e. $ELE_BATCH_ASSEMBLY is given in the NUM file.
+
+     Batches are used for the flow processes whose local assembly is
+     AssembleParabolicEquation() with the mass and Laplace matrices of
+     CalcMass() and CalcLaplace(). The domain decomposition, the
+     deformation coupling, the dynamic and the Neumann time step control
+     use the element by element loop.
+ */
+bool CRFProcess::isBatchAssembly() const
 {
-    CElem* elem = NULL;
-    continuum = 0;  // 15.02.2007/
-    //  cal_integration_point_value = true;
-    // Currently, extropolation only valid for liquid and Richards flow.
-    //	if (_pcs_type_name.find("LIQUID") != string::npos ||
-    //_pcs_type_name.find( 			"RICHARD") != string::npos ||
-    //_pcs_type_name.find( 			"MULTI_PHASE_FLOW") != string::npos ||
-    //_pcs_type_name.find( 			"GROUNDWATER_FLOW") != string::npos ||
-    //_pcs_type_name.find( 			"TWO_PHASE_FLOW") != string::npos
-    //			|| _pcs_type_name.find("AIR_FLOW") != string::npos
-    //			|| _pcs_type_name.find("PS_GLOBAL") != string::npos) //WW/CB
-
+#if !defined(USE_PETSC)
+    if (m_num->ele_batch_assembly < 1 || !fem)
+        return false;
     switch (getProcessType())
     {
         case FiniteElement::LIQUID_FLOW:
-        case FiniteElement::RICHARDS_FLOW:
-        case FiniteElement::MULTI_PHASE_FLOW:
         case FiniteElement::GROUNDWATER_FLOW:
-        case FiniteElement::TWO_PHASE_FLOW:
-        case FiniteElement::DEFORMATION_H2:  // 07.2011. WW
-        case FiniteElement::AIR_FLOW:
-        case FiniteElement::PS_GLOBAL:
-        case FiniteElement::MULTI_COMPONENTIAL_FLOW:  // AKS/NB
-        case FiniteElement::DEFORMATION_FLOW:         // NW
-        case FiniteElement::TNEQ:                     // HS, TN
-        case FiniteElement::TES:                      // HS, TN
-        case FiniteElement::HEAT_TRANSPORT:           // JOD 2014-11-10
-        case FiniteElement::MASS_TRANSPORT:           // JOD 2014-11-10
-            cal_integration_point_value = true;
+        case FiniteElement::RICHARDS_FLOW:
             break;
         default:
-            cal_integration_point_value = false;
-            return;
+            return false;
     }
+    const bool dynamic = pcs_type_name_vector.size() &&
+                         pcs_type_name_vector[0].find("DYNAMIC") == 0;
+    return dom_vector.empty() && Memory_Type == 0 && !dynamic &&
+           m_num->nls_method != 2 && fem->isDeformationCoupling() == 0 &&
+           (!Tim || Tim->time_control_type != TimeControlType::NEUMANN);
+#else
+    return false;
+#endif
+}
 
-    ScreenMessage("->Calculate velocity\n");
+//--------------------------------------------------------------------
+/*! \brief Element loop of the assembly over batches of elements.
 
-    // check linear flow or not
-    bool isLinearFlow = true;
-    for (size_t i = 0; i < mmp_vector.size(); i++)
+     The elements are collected in one batch per element type. A full
+     batch is assembled by CFiniteElementStd::AssembleElementBatch(), the
+     partial batches after the loop. Elements that cannot be assembled in
+     a batch (CElement::isBatchElement()) are assembled one by one.
+ */
+void CRFProcess::GlobalAssembly_batch(const bool Check2D3D)
+{
+    if (element_batches.empty())
     {
-        if (mmp_vector[i]->flowlinearity_model > 1)
-        {
-            isLinearFlow = false;
-            break;
-        }
+        element_batches.resize(MshElemType::NUM_ELEM_TYPES);
+        for (std::size_t k = 0; k < element_batches.size(); k++)
+            element_batches[k] = new FiniteElement::ElementBatch();
     }
-    if (isLinearFlow)
+
+    const std::vector<long>& elements = getActiveElements();
+    for (std::size_t i = 0; i < elements.size(); i++)
     {
-        const size_t mesh_ele_vector_size(m_msh->ele_vector.size());
-        for (size_t i = 0; i < mesh_ele_vector_size; i++)
-        {
-            elem = m_msh->ele_vector[i];
-            if (elem->GetMark())  // Marked for use
-            {
-                if ((getProcessType() == FiniteElement::HEAT_TRANSPORT ||
-                     getProcessType() == FiniteElement::MASS_TRANSPORT) &&
-                    !elem->selected)
-                    continue;  // not selected for TOTAL_FLUX calculation JOD
-                               // 2014-11-10
-                fem->ConfigElement(elem);
-                fem->Config();  // OK4709
-                // fem->m_dom = NULL; // To be used for parallization
-                if (getProcessType() == FiniteElement::MULTI_COMPONENTIAL_FLOW)
-                    fem->Cal_VelocityMCF();
-                else
-                    fem->Cal_Velocity();
+        CElem* elem = m_msh->ele_vector[elements[i]];
+        if (elem->GetExcavState() != -1)
+            continue;
+        elem->SetOrder(false);
+        if (!fem->isBatchElement(elem))
+        {
+            fem->ConfigElement(elem, Check2D3D);
+            fem->Assembly();
+            continue;
+        }
+        FiniteElement::ElementBatch& batch =
+            *element_batches[elem->GetElementType() - 1];
+        if (batch.size() == 0)
+            fem->resetElementBatch(batch, elem);
+        batch.addElement(elem);
+        if (batch.isFull())
+            fem->AssembleElementBatch(batch);
+    }
+    for (std::size_t k = 0; k < element_batches.size(); k++)
+        if (element_batches[k]->size() > 0)
+            fem->AssembleElementBatch(*element_batches[k]);
+}
 
-                // moved here from additional lower loop
-                if (getProcessType() == FiniteElement::TNEQ ||
-                    getProcessType() == FiniteElement::TES)
-                {
-                    fem->CalcSolidDensityRate();  // HS, thermal storage
-                                                  // reactions
-                }
+#ifdef NEW_EQS
+//--------------------------------------------------------------------
+/*! \brief Check whether the element loop of the assembly is replaced by the
+     operator of another transport component.
+
+     Problem::SetSharedTransportOperators() assigns the component with the
+     same linear transport equation that is solved before this one. Its
+     operator is used if it was assembled in the current time step with the
+     same time step size.
+ */
+bool CRFProcess::isSharedTransportOperator() const
+{
+    const CRFProcess* m_pcs = shared_operator_pcs;
+    return m_pcs && !femFCTmode && dom_vector.empty() &&
+           m_pcs->shared_operator_step ==
+               static_cast<long>(aktueller_zeitschritt) &&
+           m_pcs->shared_operator_dt == Tim->time_step_length;
+}
+
+//--------------------------------------------------------------------
+/*! \brief Assembly of the element loop with the operator of another
+     transport component.
+
+     The matrix is the one of the other component. The RHS is its operator
+     applied to the concentrations of this component at the previous time
+     level. Source terms and boundary conditions are added afterwards as
+     for the element loop.
+ */
+void CRFProcess::AssembleSharedTransportOperator()
+{
+    const CRFProcess* m_pcs = shared_operator_pcs;
+    (*eqs_new->A) = *m_pcs->shared_lhs;
+    eqs_new->SetKeptOperator(m_pcs->shared_lhs, m_pcs->kept_operators);
+
+    const long n_nodes = m_msh->GetNodesNumber(false);
+    const int idx0 = GetNodeValueIndex(pcs_primary_function_name[0]);
+    std::vector<double> u0(n_nodes);
+    std::vector<double> f(n_nodes);
+    for (long i = 0; i < n_nodes; i++)
+        u0[i] = GetNodeValue(m_msh->Eqs2Global_NodeIndex[i], idx0);
+    m_pcs->shared_rhs->multiVec(&u0[0], &f[0]);
+    for (long i = 0; i < n_nodes; i++)
+        eqs_new->b[i] += f[i];
+}
+
+//--------------------------------------------------------------------
+/*! \brief Check whether the global matrices of the terms of the equation
+     can be kept ($GLOBAL_OPERATOR_CACHE in the NUM file).
+
+     This is the case for groundwater flow and for heat and mass transport
+     with a saturated flow, for linear equations with material properties
+     that are constant in time, solved by Picard iterations. Coupled
+     deformation, domain decomposition, FCT, Neumann time control and
+     nonlinear sorption or decay are excluded. For groundwater flow only
+     constant or element-wise permeabilities and constant storage are
+     accepted; the other models (Kozeny-Carman, clogging, curves of the
+     stress) change the coefficients during the simulation. For heat
+     transport the density, heat capacity and heat conductivity of the
+     fluids and solids and the porosity must be constant or element-wise,
+     since the fingerprint does not cover the temperature itself.
+ */
+bool CRFProcess::hasCachableOperator() const
+{
+    if (!m_num || m_num->global_operator_cache < 1 || !dom_vector.empty() ||
+        femFCTmode || dof != 1 || continuum_vector.size() != 1 ||
+        NumDeactivated_SubDomains > 0 || Write_Matrix ||
+        m_num->nls_method > 0 || shared_lhs || shared_operator_pcs ||
+        !fem || fem->isDeformationCoupling() != 0 ||
+        (Tim && Tim->time_control_type == TimeControlType::NEUMANN))
+        return false;
+    if (pcs_type_name_vector.size() &&
+        pcs_type_name_vector[0].find("DYNAMIC") == 0)
+        return false;
+
+    switch (getProcessType())
+    {
+        case FiniteElement::GROUNDWATER_FLOW:
+            for (std::size_t i = 0; i < mmp_vector.size(); i++)
+                if (mmp_vector[i]->unconfined_flow_group > 0 ||
+                    mmp_vector[i]->flowlinearity_model > 1 ||
+                    mmp_vector[i]->permeability_model > 2 ||
+                    mmp_vector[i]->storage_model > 1)
+                    return false;
+            return true;
+        case FiniteElement::HEAT_TRANSPORT:
+            // Liquid or groundwater flow, i.e. full saturation
+            if (flow_pcs_type != 0 && flow_pcs_type != 1)
+                return false;
+            // Pressure and evaporation terms of the RHS
+            for (std::size_t i = 0; i < mmp_vector.size(); i++)
+                if (mmp_vector[i]->evaporation == 647 ||
+                    mmp_vector[i]->heat_diffusion_model == 1 ||
+                    (mmp_vector[i]->porosity_model != 1 &&
+                     mmp_vector[i]->porosity_model != 11))
+                    return false;
+            for (std::size_t i = 0; i < mfp_vector.size(); i++)
+                if (mfp_vector[i]->density_model != 1 ||
+                    mfp_vector[i]->heat_capacity_model != 1 ||
+                    mfp_vector[i]->heat_conductivity_model != 1)
+                    return false;
+            for (std::size_t i = 0; i < msp_vector.size(); i++)
+                if (msp_vector[i]->Density_mode != 1 ||
+                    msp_vector[i]->GetCapacityModel() != 1 ||
+                    msp_vector[i]->GetConductModel() != 1)
+                    return false;
+            return true;
+        case FiniteElement::MASS_TRANSPORT:
+#ifdef GEM_REACT
+            return false;
+#else
+            if (flow_pcs_type != 0 && flow_pcs_type != 1)
+                return false;
+            return cp_vec[pcs_component_number]->HasLinearTransportOperator();
+#endif
+        default:
+            return false;
+    }
+}
+
+//--------------------------------------------------------------------
+/*! \brief Fingerprint of the data that the coefficients of the kept
+     global matrices depend on.
+
+     These are the node coordinates and the active elements, and for
+     transport processes the velocities at the Gauss points and the
+     primary and element values of the other processes, e.g. pressure,
+     temperature or porosity. If the fingerprint changes, the matrices are
+     assembled anew. The coordinates are hashed again only after a node
+     was moved.
+ */
+unsigned long long CRFProcess::GlobalOperatorFingerprint()
+{
+    if (node_coordinates_changes != MeshLib::CNode::getCoordinateChanges())
+    {
+        node_coordinates_hash = Math_Group::HASH_OFFSET_BASIS;
+        for (std::size_t i = 0; i < m_msh->nod_vector.size(); i++)
+            node_coordinates_hash =
+                Math_Group::hashValues(m_msh->nod_vector[i]->getData(), 3,
+                                       node_coordinates_hash);
+        node_coordinates_changes = MeshLib::CNode::getCoordinateChanges();
+    }
+    const double n_nodes = static_cast<double>(m_msh->nod_vector.size());
+    unsigned long long hash =
+        Math_Group::hashValues(&n_nodes, 1, node_coordinates_hash);
+    const std::size_t n_elements = m_msh->ele_vector.size();
+    std::vector<double> active(n_elements);
+    for (std::size_t i = 0; i < n_elements; i++)
+    {
+        CElem* elem = m_msh->ele_vector[i];
+        active[i] =
+            (elem->GetMark() && elem->GetExcavState() == -1) ? 1. : 0.;
+    }
+    if (n_elements > 0)
+        hash = Math_Group::hashValues(&active[0], n_elements, hash);
+    if (getProcessType() == FiniteElement::GROUNDWATER_FLOW)
+        return hash;
+
+    for (std::size_t i = 0; i < ele_gp_value.size(); i++)
+    {
+        const Math_Group::Matrix& v = ele_gp_value[i]->Velocity;
+        hash = Math_Group::hashValues(v.getEntryArray(), v.Size(), hash);
+    }
+    for (std::size_t k = 0; k < pcs_vector.size(); k++)
+    {
+        CRFProcess* a_pcs = pcs_vector[k];
+        if (a_pcs == this ||
+            a_pcs->getProcessType() == FiniteElement::MASS_TRANSPORT)
+            continue;
+        const std::size_t n_nodes = a_pcs->m_msh->GetNodesNumber(false);
+        for (int j = 0; j < a_pcs->pcs_number_of_primary_nvals; j++)
+        {
+            const int idx =
+                a_pcs->GetNodeValueIndex(a_pcs->pcs_primary_function_name[j]);
+            if (idx >= 0)
+                hash = Math_Group::hashValues(
+                    a_pcs->nod_val_vector[idx + 1], n_nodes, hash);
+        }
+        const std::size_t n_ele_values = a_pcs->ele_val_name_vector.size();
+        if (n_ele_values == 0)
+            continue;
+        for (std::size_t i = 0; i < a_pcs->ele_val_vector.size(); i++)
+            hash = Math_Group::hashValues(a_pcs->ele_val_vector[i],
+                                          n_ele_values, hash);
+    }
+    return hash;
+}
+
+//--------------------------------------------------------------------
+/*! \brief Check whether the element loop is replaced by the kept global
+     matrices of the terms of the equation.
+
+     The matrices are allocated with the first call. They are used if they
+     were assembled with the current fingerprint of the coefficients.
+     Otherwise they are set up to be assembled by the following element
+     loop. If they are assembled anew three times without being used, the
+     coefficients change in every time step, and the matrices are
+     released.
+ */
+bool CRFProcess::isGlobalOperatorCached()
+{
+    if (!global_operator_cache)
+    {
+        if (!hasCachableOperator())
+            return false;
+        global_operator_cache = new Math_Group::GlobalOperatorCache(
+            *m_msh->GetSparseTable(),
+            getProcessType() == FiniteElement::MASS_TRANSPORT);
+        ScreenMessage("-> Global operator of %s is kept: %g MB\n",
+                      pcs_primary_function_name[0],
+                      global_operator_cache->getMemory() / 1048576.);
+    }
+    if (global_operator_cache->isReleased())
+        return false;
+
+    const unsigned long long fingerprint = GlobalOperatorFingerprint();
+    if (global_operator_cache->isValid(fingerprint))
+        return true;
+    if (global_operator_cache->getNumberOfAssemblies() >= 3)
+    {
+        ScreenMessage(
+            "-> Coefficients of %s change in every time step. The global "
+            "operator is released\n",
+            pcs_primary_function_name[0]);
+        global_operator_cache->release();
+        return false;
+    }
+    global_operator_cache->reset(fingerprint);
+    return false;
+}
+
+//--------------------------------------------------------------------
+/*! \brief Assembly of the element loop with the kept global matrices.
+
+     The factors of the terms are those of
+     CFiniteElementStd::AssembleParabolicEquation() for groundwater flow and
+     of CFiniteElementStd::AssembleMixedHyperbolicParabolicEquation() for
+     transport. The RHS is the operator of the previous time level applied
+     to the primary variable of the previous time level.
+ */
+void CRFProcess::AssembleGlobalOperator()
+{
+    using Math_Group::GlobalOperatorCache;
+    const double dt_inverse = 1.0 / Tim->time_step_length;
+    double lhs_fac[GlobalOperatorCache::NUMBER_OF_TERMS];
+    double rhs_fac[GlobalOperatorCache::NUMBER_OF_TERMS];
+    lhs_fac[GlobalOperatorCache::MASS] = dt_inverse;
+    rhs_fac[GlobalOperatorCache::MASS] = dt_inverse;
+    lhs_fac[GlobalOperatorCache::CONTENT] = 0.;
+    if (getProcessType() == FiniteElement::GROUNDWATER_FLOW)
+    {
+        double relax0 = m_num->nls_relaxation;
+        if (relax0 < DBL_MIN)
+            relax0 = 1.0;
+        lhs_fac[GlobalOperatorCache::LAPLACE] = relax0;
+        rhs_fac[GlobalOperatorCache::LAPLACE] = -(1.0 - relax0);
+        lhs_fac[GlobalOperatorCache::ADVECTION] = 0.;
+        rhs_fac[GlobalOperatorCache::ADVECTION] = 0.;
+        rhs_fac[GlobalOperatorCache::CONTENT] = 0.;
+    }
+    else
+    {
+        const double theta = m_num->ls_theta;
+        lhs_fac[GlobalOperatorCache::LAPLACE] = theta;
+        rhs_fac[GlobalOperatorCache::LAPLACE] = -(1.0 - theta);
+        lhs_fac[GlobalOperatorCache::ADVECTION] = theta;
+        rhs_fac[GlobalOperatorCache::ADVECTION] = -(1.0 - theta);
+        rhs_fac[GlobalOperatorCache::CONTENT] = -(1.0 - theta) * dt_inverse;
+    }
+
+    const long n_nodes = m_msh->GetNodesNumber(false);
+    const int idx0 = GetNodeValueIndex(pcs_primary_function_name[0]);
+    std::vector<double> u0(n_nodes);
+    for (long i = 0; i < n_nodes; i++)
+        u0[i] = GetNodeValue(m_msh->Eqs2Global_NodeIndex[i], idx0);
+    global_operator_cache->apply(lhs_fac, rhs_fac, &u0[0], *eqs_new->A,
+                                 eqs_new->b);
+}
+#endif
+
+/*************************************************************************
+   GeoSys-Function:
+   Task: Integration
+   Programming:
+   05/2009 WW Implementation
+ **************************************************************************/
+void CRFProcess::Integration(vector<double>& node_velue)
+{
+    //----------------------------------------------------------------------
+    size_t k;
+    long i;
+    CElem* elem = NULL;
+    bool Check2D3D;
+    Check2D3D = false;
+    double n_val[8];
+
+    if (type == 66)  // Overland flow
+        Check2D3D = true;
+
+    vector<double> buffer((long)node_velue.size());
+    for (i = 0; i < (long)buffer.size(); i++)
+        buffer[i] = 0.;
+
+    const std::vector<long>& elements = getActiveElements();
+    for (i = 0; i < (long)elements.size(); i++)
+    {
+        elem = m_msh->ele_vector[elements[i]];
+        for (k = 0; k < elem->GetNodesNumber(false); k++)
+            n_val[k] = node_velue[elem->GetNodeIndex(k)];
+
+        elem->SetOrder(false);
+        fem->ConfigElement(elem, Check2D3D);
+        fem->FaceIntegration(n_val);
+
+        for (k = 0; k < elem->GetNodesNumber(false); k++)
+            buffer[elem->GetNodeIndex(k)] += n_val[k];
+    }
+    //----------------------------------------------------------------------
+}
+
+/*************************************************************************
+   GeoSys-Function:
+   Task: Calculate integration point velocity
+   Programming:
+   08/2005 WW Implementation
+   last modified:
+ **************************************************************************/
+void CRFProcess::CalIntegrationPointValue()
+{
+    CElem* elem = NULL;
+    continuum = 0;  // 15.02.2007/
+    //  cal_integration_point_value = true;
+    // Currently, extropolation only valid for liquid and Richards flow.
+    //	if (_pcs_type_name.find("LIQUID") != string::npos ||
+    //_pcs_type_name.find( 			"RICHARD") != string::npos ||
+    //_pcs_type_name.find( 			"MULTI_PHASE_FLOW") != string::npos ||
+    //_pcs_type_name.find( 			"GROUNDWATER_FLOW") != string::npos ||
+    //_pcs_type_name.find( 			"TWO_PHASE_FLOW") != string::npos
+    //			|| _pcs_type_name.find("AIR_FLOW") != string::npos
+    //			|| _pcs_type_name.find("PS_GLOBAL") != string::npos) //WW/CB
+
+    switch (getProcessType())
+    {
+        case FiniteElement::LIQUID_FLOW:
+        case FiniteElement::RICHARDS_FLOW:
+        case FiniteElement::MULTI_PHASE_FLOW:
+        case FiniteElement::GROUNDWATER_FLOW:
+        case FiniteElement::TWO_PHASE_FLOW:
+        case FiniteElement::DEFORMATION_H2:  // 07.2011. WW
+        case FiniteElement::AIR_FLOW:
+        case FiniteElement::PS_GLOBAL:
+        case FiniteElement::MULTI_COMPONENTIAL_FLOW:  // AKS/NB
+        case FiniteElement::DEFORMATION_FLOW:         // NW
+        case FiniteElement::TNEQ:                     // HS, TN
+        case FiniteElement::TES:                      // HS, TN
+        case FiniteElement::HEAT_TRANSPORT:           // JOD 2014-11-10
+        case FiniteElement::MASS_TRANSPORT:           // JOD 2014-11-10
+            cal_integration_point_value = true;
+            break;
+        default:
+            cal_integration_point_value = false;
+            return;
+    }
+
+    ScreenMessage("->Calculate velocity\n");
+
+    // check linear flow or not
+    bool isLinearFlow = true;
+    for (size_t i = 0; i < mmp_vector.size(); i++)
+    {
+        if (mmp_vector[i]->flowlinearity_model > 1)
+        {
+            isLinearFlow = false;
+            break;
+        }
+    }
+    const std::vector<long>& elements = getActiveElements();
+    if (isLinearFlow)
+    {
+        for (size_t i = 0; i < elements.size(); i++)
+        {
+            elem = m_msh->ele_vector[elements[i]];
+            if ((getProcessType() == FiniteElement::HEAT_TRANSPORT ||
+                 getProcessType() == FiniteElement::MASS_TRANSPORT) &&
+                !elem->selected)
+                continue;  // not selected for TOTAL_FLUX calculation JOD
+                           // 2014-11-10
+            fem->ConfigElement(elem);
+            fem->Config();  // OK4709
+            // fem->m_dom = NULL; // To be used for parallization
+            if (getProcessType() == FiniteElement::MULTI_COMPONENTIAL_FLOW)
+                fem->Cal_VelocityMCF();
+            else
+                fem->Cal_Velocity();
+
+            // moved here from additional lower loop
+            if (getProcessType() == FiniteElement::TNEQ ||
+                getProcessType() == FiniteElement::TES)
+            {
+                fem->CalcSolidDensityRate();  // HS, thermal storage
+                                              // reactions
             }
         }
     }
     else
     {  // NW
-        const size_t mesh_ele_vector_size(m_msh->ele_vector.size());
         const size_t v_itr_max(this->m_num->local_picard1_max_iterations);
         double pre_v[3] = {};
         double new_v[3] = {};
@@ -6007,25 +6687,22 @@ void CRFProcess::CalIntegrationPointValue()
             // std::cout << "  non-linear iteration: " << i_itr << "/" <<
             // v_itr_max << std::endl;
             vel_error = .0;
-            for (size_t i = 0; i < mesh_ele_vector_size; i++)
+            for (size_t i = 0; i < elements.size(); i++)
             {
-                elem = m_msh->ele_vector[i];
-                if (elem->GetMark())  // Marked for use
-                {
-                    ElementValue* gp_ele = ele_gp_value[i];
-                    gp_ele->GetEleVelocity(pre_v);
+                elem = m_msh->ele_vector[elements[i]];
+                ElementValue* gp_ele = ele_gp_value[elements[i]];
+                gp_ele->GetEleVelocity(pre_v);
 
-                    fem->ConfigElement(elem);
-                    fem->Config();  // OK4709
-                    // fem->m_dom = NULL; // To be used for parallization
+                fem->ConfigElement(elem);
+                fem->Config();  // OK4709
+                // fem->m_dom = NULL; // To be used for parallization
 
-                    fem->Cal_Velocity();
+                fem->Cal_Velocity();
 
-                    gp_ele->GetEleVelocity(new_v);
-                    vel_error = max(vel_error, fabs(new_v[0] - pre_v[0]));
-                    vel_error = max(vel_error, fabs(new_v[1] - pre_v[1]));
-                    vel_error = max(vel_error, fabs(new_v[2] - pre_v[2]));
-                }
+                gp_ele->GetEleVelocity(new_v);
+                vel_error = max(vel_error, fabs(new_v[0] - pre_v[0]));
+                vel_error = max(vel_error, fabs(new_v[1] - pre_v[1]));
+                vel_error = max(vel_error, fabs(new_v[2] - pre_v[2]));
             }
             // std::cout << "  error (max. norm): " << vel_error << std::endl;
             bool isConverged =
@@ -8502,7 +9179,8 @@ void CRFProcess::IncorporateSourceTerms(const int rank)
                 st_eqs_value.push_back(Water_ST_vec[i].water_st_value);
 
 #else
-                eqs_rhs[gem_node_index] += Water_ST_vec[i].water_st_value;
+                eqs_rhs[m_msh->nod_vector[gem_node_index]->GetEquationIndex()] +=
+                    Water_ST_vec[i].water_st_value;
 #endif
             }
         }
@@ -8695,6 +9373,8 @@ void CRFProcess::PCSMoveNOD(void)
     {
         case 1:
             MSHMoveNODUcFlow(this);
+            // The cached element geometry is out of date
+            fem->cacheElementGeometry(m_msh->ele_vector);
             break;
         default:
             DisplayMsgLn("PCSMoveNOD: no valid process");
@@ -9170,341 +9850,64 @@ NLS, go to enum system last modification:
 double CRFProcess::CalcIterationNODError(FiniteElement::ErrorMethod method,
                                          bool nls_error, bool cpl_error)
 {
-    static long i, k, g_nnodes;
-    static double error, error_g, val1, val2, value;
-    int nidx1, ii;
-    double* eqs_x = NULL;  // 11.2007. WW
+    static double error, error_g;
+    int ii;
     int num_dof_errors = pcs_number_of_primary_nvals;
     double unknowns_norm = 0.0;
+    double values_norm = 0.0;
     double absolute_error[DOF_NUMBER_MAX];
 #if defined(USE_PETSC)  // || defined(other parallel libs)//02.2014. WW
-    g_nnodes = m_msh->getNumNodesLocal();
-    eqs_x = eqs_new->GetGlobalSolution();
+    const long g_nnodes = m_msh->getNumNodesLocal();
+    double* eqs_x = eqs_new->GetGlobalSolution();
 #else
-        g_nnodes = m_msh->GetNodesNumber(false);
-
+    const long g_nnodes = m_msh->GetNodesNumber(false);
 #ifdef NEW_EQS
-        eqs_x = eqs_new->x;
+    double* eqs_x = eqs_new->x;  // 11.2007. WW
 #else
-        eqs_x = eqs->x;
+    double* eqs_x = eqs->x;
 #endif
-
 #endif  // if defined(USE_PETSC)
 
     switch (method)
     {
-        //
-        // --> ENORM:	|x1-x0|
-        //     Norm of the solution vector delta (absolute error).
-        //     Norm taken over entire solution vector (all primary variables)
-        //     and checked against a single tolerance.
-        //
         case FiniteElement::ENORM:
-            if (m_num->nls_method > 0)
-            {  // NEWTON-RAPHSON
-                for (ii = 0; ii < pcs_number_of_primary_nvals; ii++)
+        case FiniteElement::ERNORM:
+        case FiniteElement::EVNORM:
+        case FiniteElement::BNORM:
+        case FiniteElement::LMAX:
+            break;
+        default:
+            ScreenMessage(
+                "ERROR: Invalid error method for Iteration or Coupling Node "
+                "error.\n");
+            return 0.0;
+            //
+            /*
+            -----------------------------------------------------------------------------------------------
+            ALTERNATIVE METHODS NOT YET IMPLEMENTED. MODIFY THEM AND ADD THEIR
+            ENUM VALUES IF YOU WANT THEM.
+            -----------------------------------------------------------------------------------------------
+            // METHOD 4
+            case 4:
+                for(ii=0;ii<pcs_number_of_primary_nvals;ii++)
                 {
-                    for (i = 0; i < g_nnodes; i++)
-                    {
-#if defined(USE_PETSC)  // || defined(other parallel libs)//08.2014. WW
-                        val1 = eqs_x[pcs_number_of_primary_nvals *
-                                         m_msh->Eqs2Global_NodeIndex[i] +
-                                     ii];
-#else
-                            val1 = eqs_x[i + ii * g_nnodes];
-#endif
-                        unknowns_norm += val1 * val1;
+                    error = max_c = 0.0;
+                    nidx1 = GetNodeValueIndex(pcs_primary_function_name[ii]) +
+            1;
+                    //
+                    for (i = 0l; i < g_nnodes; i++){
+                       k = m_msh->Eqs2Global_NodeIndex[i];
+                       error = MMax(error, fabs(eqs_x[i+ii*g_nnodes] -
+            GetNodeValue(k, nidx1))); max_c = MMax(MMax(max_c,
+            fabs(fabs(eqs_x[i+ii*g_nnodes]))),fabs(GetNodeValue(k, nidx1)));
                     }
+                    pcs_absolute_error[ii] = error / (max_c + MKleinsteZahl);
                 }
-            }
-            else
-            {  // PICARD
-                for (ii = 0; ii < pcs_number_of_primary_nvals; ii++)
-                {
-                    nidx1 =
-                        GetNodeValueIndex(pcs_primary_function_name[ii]) + 1;
-                    //
-                    for (i = 0; i < g_nnodes; i++)
-                    {
-#if defined(USE_PETSC)  // || defined(other parallel libs)//08.2014. WW
-                        val1 = GetNodeValue(i, nidx1) -
-                               eqs_x[pcs_number_of_primary_nvals *
-                                         m_msh->Eqs2Global_NodeIndex[i] +
-                                     ii];
-#else
-                            k = m_msh->Eqs2Global_NodeIndex[i];
-                            val1 = GetNodeValue(k, nidx1) -
-                                   eqs_x[i + ii * g_nnodes];
-#endif
-                        unknowns_norm += val1 * val1;
-                    }
-                }
-            }
-            num_dof_errors = 1;
-            unknowns_norm = sqrt(unknowns_norm);
-            absolute_error[0] = unknowns_norm;
-            break;
-        //
-        // --> ERNORM:	|(x1-x0)/x0)|
-        //     Norm of the solution vector delta divided by the solution vector
-        //     (relative error). A single tolerance applied to all primary
-        //     variables.
-        //
-        case FiniteElement::ERNORM:
-            value = 0.0;
-            if (m_num->nls_method > 0)
-            {  // NEWTON-RAPHSON
-                for (ii = 0; ii < pcs_number_of_primary_nvals; ii++)
-                {
-                    nidx1 =
-                        GetNodeValueIndex(pcs_primary_function_name[ii]) + 1;
-                    //
-                    for (i = 0; i < g_nnodes; i++)
-                    {
-#if defined(USE_PETSC)  // || defined(other parallel libs)//02.2018. WW
-                        val1 = eqs_x[pcs_number_of_primary_nvals *
-                                         m_msh->Eqs2Global_NodeIndex[i] +
-                                     ii];
-                        val2 = GetNodeValue(i, nidx1);
-#else
-                            k = m_msh->Eqs2Global_NodeIndex[i];
-                            val1 = eqs_x[i + ii * g_nnodes];
-                            val2 = GetNodeValue(k, nidx1);
-#endif
-                        //
-                        unknowns_norm += val1 * val1;
-                        value += val2 * val2;
-                    }
-                }
-            }
-            else
-            {  // PICARD
-                for (ii = 0; ii < pcs_number_of_primary_nvals; ii++)
-                {
-                    nidx1 =
-                        GetNodeValueIndex(pcs_primary_function_name[ii]) + 1;
-                    //
-                    error = 0.0;
-                    for (i = 0; i < g_nnodes; i++)
-                    {
-#if defined(USE_PETSC)  // || defined(other parallel libs)//08.2014. WW
-                        val1 = GetNodeValue(i, nidx1);
-                        val2 = val1 - eqs_x[pcs_number_of_primary_nvals *
-                                                m_msh->Eqs2Global_NodeIndex[i] +
-                                            ii];
-#else
-                            k = m_msh->Eqs2Global_NodeIndex[i];
-                            val1 = GetNodeValue(k, nidx1);
-                            val2 = val1 - eqs_x[i + ii * g_nnodes];
-#endif
-                        //
-                        unknowns_norm += val2 * val2;
-                        value += val1 * val1;
-                    }
-                }
-            }
-            num_dof_errors = 1;
-            unknowns_norm = sqrt(unknowns_norm);
-            absolute_error[0] = unknowns_norm / (sqrt(value) + DBL_EPSILON);
-            break;
-        //
-        // --> EVNORM:	|x1-x0|
-        //     Norm of the solution vector delta (absolute error).
-        //     Norm taken over solution vector of each primary variable, checked
-        //     againes a tolerence specific to each variable.
-        //
-        case FiniteElement::EVNORM:
-            if (m_num->nls_method > 0)
-            {  // NEWTON-RAPHSON
-                for (ii = 0; ii < pcs_number_of_primary_nvals; ii++)
-                {
-                    error = 0.0;
-                    for (i = 0; i < g_nnodes; i++)
-                    {
-#if defined(USE_PETSC)  // || defined(other parallel libs)//08.2014. WW
-                        val1 = eqs_x[pcs_number_of_primary_nvals *
-                                         m_msh->Eqs2Global_NodeIndex[i] +
-                                     ii];
-#else
-                            val1 = eqs_x[i + ii * g_nnodes];
-#endif
-                        error += val1 * val1;
-                    }
-                    unknowns_norm += error;
-                    absolute_error[ii] = sqrt(error);
-                }
-            }
-            else
-            {  // PICARD
-                for (ii = 0; ii < pcs_number_of_primary_nvals; ii++)
-                {
-                    nidx1 =
-                        GetNodeValueIndex(pcs_primary_function_name[ii]) + 1;
-                    //
-                    error = 0.0;
-                    for (i = 0; i < g_nnodes; i++)
-                    {
-#if defined(USE_PETSC)  // || defined(other parallel libs)//08.2014. WW
-                        val1 = GetNodeValue(i, nidx1) -
-                               eqs_x[pcs_number_of_primary_nvals *
-                                         m_msh->Eqs2Global_NodeIndex[i] +
-                                     ii];
-#else
-                            k = m_msh->Eqs2Global_NodeIndex[i];
-                            val1 = GetNodeValue(k, nidx1) -
-                                   eqs_x[i + ii * g_nnodes];
-#endif
-                        error += val1 * val1;
-                    }
-                    unknowns_norm += error;
-                    absolute_error[ii] = sqrt(error);
-                }
-            }
-            unknowns_norm = sqrt(unknowns_norm);
-            break;
-        //
-        // --> BNORM: Get norm of solution vector, same as ENORM. RHS norm will
-        // be calculated later.
-        //     Norm of the solution vector delta (absolute error).
-        //     Norm taken over entire solution vector (all primary variables)
-        //     and checked against a single tolerance.
-        //
-        case FiniteElement::BNORM:
-            if (m_num->nls_method > 0)
-            {  // NEWTON-RAPHSON
-                for (ii = 0; ii < pcs_number_of_primary_nvals; ii++)
-                {
-                    for (i = 0; i < g_nnodes; i++)
-                    {
-#if defined(USE_PETSC)  // || defined(other parallel libs)//08.2014. WW
-                        val1 = eqs_x[pcs_number_of_primary_nvals *
-                                         m_msh->Eqs2Global_NodeIndex[i] +
-                                     ii];
-#else
-                            val1 = eqs_x[i + ii * g_nnodes];
-#endif
-                        unknowns_norm += val1 * val1;
-                    }
-                }
-            }
-            else
-            {  // PICARD
-                for (ii = 0; ii < pcs_number_of_primary_nvals; ii++)
-                {
-                    nidx1 =
-                        GetNodeValueIndex(pcs_primary_function_name[ii]) + 1;
-                    //
-                    for (i = 0; i < g_nnodes; i++)
-                    {
-#if defined(USE_PETSC)  // || defined(other parallel libs)//08.2014. WW
-                        val1 = GetNodeValue(i, nidx1) -
-                               eqs_x[pcs_number_of_primary_nvals *
-                                         m_msh->Eqs2Global_NodeIndex[i] +
-                                     ii];
-#else
-                            k = m_msh->Eqs2Global_NodeIndex[i];
-                            val1 = GetNodeValue(k, nidx1) -
-                                   eqs_x[i + ii * g_nnodes];
-#endif
-                        unknowns_norm += val1 * val1;
-                    }
-                }
-            }
-            num_dof_errors = 1;
-            unknowns_norm = sqrt(unknowns_norm);
-            absolute_error[0] = unknowns_norm;
-            break;
-        //
-        // --> LMAX:	max(x1-x0)
-        //     Local max error (across all elements) of solution vector delta
-        //     (absolute error). Tolerance required for each primary variable.
-        //
-        case FiniteElement::LMAX:
-            if (m_num->nls_method > 0)
-            {  // NEWTON-RAPHSON
-                for (ii = 0; ii < pcs_number_of_primary_nvals; ii++)
-                {
-                    error = 0.0;
-                    for (i = 0; i < g_nnodes; i++)
-                    {
-#if defined(USE_PETSC)  // || defined(other parallel libs)//08.3014. WW
-                        val1 = eqs_x[pcs_number_of_primary_nvals *
-                                         m_msh->Eqs2Global_NodeIndex[i] +
-                                     ii];
-#else
-                            val1 = eqs_x[i + ii * g_nnodes];
-#endif
-                        unknowns_norm += val1 * val1;
-                        val1 = fabs(val1);
-                        if (val1 > error)
-                            error = val1;
-                    }
-                    absolute_error[ii] = error;
-                }
-            }
-            else
-            {  // PICARD
-                for (ii = 0; ii < pcs_number_of_primary_nvals; ii++)
-                {
-                    error = 0.0;
-                    nidx1 =
-                        GetNodeValueIndex(pcs_primary_function_name[ii]) + 1;
-                    //
-                    for (i = 0; i < g_nnodes; i++)
-                    {
-#if defined(USE_PETSC)  // || defined(other parallel libs)//08.3014. WW
-                        val1 = GetNodeValue(i, nidx1) -
-                               eqs_x[pcs_number_of_primary_nvals *
-                                         m_msh->Eqs2Global_NodeIndex[i] +
-                                     ii];
-#else
-                            k = m_msh->Eqs2Global_NodeIndex[i];
-                            val1 = GetNodeValue(k, nidx1) -
-                                   eqs_x[i + ii * g_nnodes];
-#endif
-                        unknowns_norm += val1 * val1;
-                        val1 = fabs(val1);
-                        if (val1 > error)
-                            error = val1;
-                    }
-                    absolute_error[ii] = error;
-                }
-            }
-            unknowns_norm = sqrt(unknowns_norm);
-            break;
-        //
-        default:
-            ScreenMessage(
-                "ERROR: Invalid error method for Iteration or Coupling Node "
-                "error.\n");
-            return 0.0;
-            //
-            /*
-            -----------------------------------------------------------------------------------------------
-            ALTERNATIVE METHODS NOT YET IMPLEMENTED. MODIFY THEM AND ADD THEIR
-            ENUM VALUES IF YOU WANT THEM.
-            -----------------------------------------------------------------------------------------------
-            // METHOD 4
-            case 4:
-                for(ii=0;ii<pcs_number_of_primary_nvals;ii++)
-                {
-                    error = max_c = 0.0;
-                    nidx1 = GetNodeValueIndex(pcs_primary_function_name[ii]) +
-            1;
-                    //
-                    for (i = 0l; i < g_nnodes; i++){
-                       k = m_msh->Eqs2Global_NodeIndex[i];
-                       error = MMax(error, fabs(eqs_x[i+ii*g_nnodes] -
-            GetNodeValue(k, nidx1))); max_c = MMax(MMax(max_c,
-            fabs(fabs(eqs_x[i+ii*g_nnodes]))),fabs(GetNodeValue(k, nidx1)));
-                    }
-                    pcs_absolute_error[ii] = error / (max_c + MKleinsteZahl);
-                }
-                break;
-            //
-            // METHOD 5
-            case 5:
-                for(ii=0;ii<pcs_number_of_primary_nvals;ii++)
+                break;
+            //
+            // METHOD 5
+            case 5:
+                for(ii=0;ii<pcs_number_of_primary_nvals;ii++)
                 {
                     error = max_c = 0.0;
                     min_c = 1.e99;
@@ -9563,6 +9966,90 @@ double CRFProcess::CalcIterationNODError(FiniteElement::ErrorMethod method,
             */
     }
 
+    // NEWTON-RAPHSON: the solution is the increment. PICARD: the increment
+    // is the difference of the node values to the solution. All norms of a
+    // primary variable are computed in one pass over its nodes.
+    const bool x_is_increment = m_num->nls_method > 0;
+    const bool with_values =
+        !x_is_increment || method == FiniteElement::ERNORM;
+    for (ii = 0; ii < pcs_number_of_primary_nvals; ii++)
+    {
+        const double* nod_values = NULL;
+        if (with_values)
+            nod_values = getNodeValue_per_Variable(
+                GetNodeValueIndex(pcs_primary_function_name[ii]) + 1);
+#if defined(USE_PETSC)  // || defined(other parallel libs)//08.2014. WW
+        // The solution vector is interleaved, and the node values are
+        // those of the local nodes.
+        Math_Group::IncrementNorms norms;
+        norms.increment_sq = norms.value_sq = norms.increment_max = 0.0;
+        for (long i = 0; i < g_nnodes; i++)
+        {
+            const double x_i = eqs_x[pcs_number_of_primary_nvals *
+                                         m_msh->Eqs2Global_NodeIndex[i] +
+                                     ii];
+            const double u_i = nod_values ? nod_values[i] : 0.0;
+            const double d = x_is_increment ? x_i : u_i - x_i;
+            norms.increment_sq += d * d;
+            norms.value_sq += u_i * u_i;
+            norms.increment_max = MMax(norms.increment_max, fabs(d));
+        }
+#else
+        const Math_Group::IncrementNorms norms =
+            Math_Group::CalcIncrementNorms(
+                nod_values, &m_msh->Eqs2Global_NodeIndex[0],
+                eqs_x + ii * g_nnodes, g_nnodes, x_is_increment);
+#endif
+        unknowns_norm += norms.increment_sq;
+        values_norm += norms.value_sq;
+        if (method == FiniteElement::EVNORM)
+            absolute_error[ii] = sqrt(norms.increment_sq);
+        else if (method == FiniteElement::LMAX)
+            absolute_error[ii] = norms.increment_max;
+    }
+    unknowns_norm = sqrt(unknowns_norm);
+
+    switch (method)
+    {
+        //
+        // --> ENORM:	|x1-x0|
+        //     Norm of the solution vector delta (absolute error).
+        //     Norm taken over entire solution vector (all primary variables)
+        //     and checked against a single tolerance.
+        //
+        // --> BNORM: Get norm of solution vector, same as ENORM. RHS norm will
+        // be calculated later.
+        //
+        case FiniteElement::ENORM:
+        case FiniteElement::BNORM:
+            num_dof_errors = 1;
+            absolute_error[0] = unknowns_norm;
+            break;
+        //
+        // --> ERNORM:	|(x1-x0)/x0)|
+        //     Norm of the solution vector delta divided by the solution vector
+        //     (relative error). A single tolerance applied to all primary
+        //     variables.
+        //
+        case FiniteElement::ERNORM:
+            num_dof_errors = 1;
+            absolute_error[0] =
+                unknowns_norm / (sqrt(values_norm) + DBL_EPSILON);
+            break;
+        //
+        // --> EVNORM:	|x1-x0|
+        //     Norm of the solution vector delta (absolute error).
+        //     Norm taken over solution vector of each primary variable, checked
+        //     againes a tolerence specific to each variable.
+        //
+        // --> LMAX:	max(x1-x0)
+        //     Local max error (across all elements) of solution vector delta
+        //     (absolute error). Tolerance required for each primary variable.
+        //
+        default:
+            break;
+    }
+
 #if defined(USE_PETSC)  // || defined(other parallel libs)//08.2014. WW
     for (ii = 0; ii < pcs_number_of_primary_nvals; ii++)
     {
@@ -9659,7 +10146,6 @@ double CRFProcess::ExecuteNonLinear(int loop_process_number, bool print_pcs)
 #endif
 #if !defined(USE_PETSC)  // && !defined(other parallel libs)//03.3012. WW
     double* eqs_b = NULL;
-    int k;
 #ifdef NEW_EQS
     eqs_x = eqs_new->x;
     eqs_b = eqs_new->b;
@@ -9732,6 +10218,9 @@ double CRFProcess::ExecuteNonLinear(int loop_process_number, bool print_pcs)
     converged = false;
     accepted = true;
     last_error = 1.0;
+    if (nls_acceleration)
+        nls_acceleration->reset();
+    ResetJacobianLagging();
     for (iter_nlin = 0; iter_nlin < m_num->nls_max_iterations; iter_nlin++)
     {
         ScreenMessage("    PCS non-linear iteration: %d/%d\n",
@@ -9753,6 +10242,12 @@ double CRFProcess::ExecuteNonLinear(int loop_process_number, bool print_pcs)
             // ---------------------------------------------------
             //
             damping = nl_theta;
+            // Modified Newton: the increment of an iteration with a kept
+            // Jacobian that does not decrease is discarded, and the
+            // iteration is repeated with a new Jacobian.
+            if (iter_nlin + 1 < m_num->nls_max_iterations &&
+                !UpdateJacobianLagging(nonlinear_iteration_error))
+                continue;
             switch (m_num->getNonLinearErrorMethod())
             {
                 // For most error methods (also works for Newton)
@@ -9776,8 +10271,11 @@ double CRFProcess::ExecuteNonLinear(int loop_process_number, bool print_pcs)
                         else
                             num_fail = 0;
                         //
-                        if (num_fail > 1)
-                            diverged = true;  // require 2 consecutive failures
+                        // require 2 consecutive failures, 4 with Anderson
+                        // acceleration: its residuals are not monotonic, and
+                        // a rejected iterate is a failure by itself.
+                        if (num_fail > (m_num->nls_anderson_depth > 0 ? 3 : 1))
+                            diverged = true;
                         last_error = nonlinear_iteration_error;
                     }
                     break;
@@ -9925,14 +10423,10 @@ double CRFProcess::ExecuteNonLinear(int loop_process_number, bool print_pcs)
                                             ii]);
                 }
 #else
-                const long ish = ii * g_nnodes;
-                for (j = 0; j < g_nnodes; j++)
-                {
-                    k = m_msh->Eqs2Global_NodeIndex[j];
-                    double val =
-                        GetNodeValue(k, nidx1) + damping * eqs_x[j + ish];
-                    SetNodeValue(k, nidx1, val);
-                }
+                Math_Group::UpdateNodeValues(
+                    getNodeValue_per_Variable(nidx1),
+                    &m_msh->Eqs2Global_NodeIndex[0], eqs_x + ii * g_nnodes,
+                    g_nnodes, damping, true);
 #endif
             }
         }
@@ -9964,6 +10458,14 @@ double CRFProcess::ExecuteNonLinear(int loop_process_number, bool print_pcs)
         }
     }
     iter_nlin_max = std::max(iter_nlin_max, iter_nlin);
+    ResetJacobianLagging();
+    if (nls_acceleration && m_num->nls_anderson_depth > 0)
+        ScreenMessage(
+            "      -->Anderson acceleration: %d of %d updates accelerated, "
+            "%d restarts\n",
+            nls_acceleration->getNumberOfAcceleratedIterations(),
+            nls_acceleration->getNumberOfIterations(),
+            nls_acceleration->getNumberOfRestarts());
     // ------------------------------------------------------------
     // NON-LINEAR ITERATIONS COMPLETE
     // ------------------------------------------------------------
@@ -10012,6 +10514,319 @@ double CRFProcess::ExecuteNonLinear(int loop_process_number, bool print_pcs)
     return nonlinear_iteration_error;
 }
 
+#if !defined(USE_PETSC)
+/**************************************************************************
+   FEMLib-Method:
+   Task: Picard update of the primary variables with Anderson acceleration
+         ($NON_LINEAR_ACCELERATION). The solution of the linear system is
+         G(x) of the present values x of the nodes. As with the plain
+         update, eqs_x gets the values before the update for the time step
+         control.
+**************************************************************************/
+void CRFProcess::AccelerateNonLinearIteration(const double damping)
+{
+    const long g_nnodes = m_msh->GetNodesNumber(false);
+    const std::size_t size =
+        static_cast<std::size_t>(g_nnodes) * pcs_number_of_primary_nvals;
+    if (!nls_acceleration)
+        nls_acceleration =
+            new Math_Group::AndersonAcceleration(m_num->nls_anderson_depth);
+
+    std::vector<double> x(size);
+    for (int ii = 0; ii < pcs_number_of_primary_nvals; ii++)
+    {
+        const int nidx1 = GetNodeValueIndex(pcs_primary_function_name[ii]) + 1;
+        const long nshift = ii * g_nnodes;
+        for (long j = 0; j < g_nnodes; j++)
+            x[j + nshift] =
+                GetNodeValue(m_msh->Eqs2Global_NodeIndex[j], nidx1);
+    }
+
+    nls_acceleration->update(&x[0], eqs_x, size, damping);
+
+    for (int ii = 0; ii < pcs_number_of_primary_nvals; ii++)
+    {
+        const int nidx1 = GetNodeValueIndex(pcs_primary_function_name[ii]) + 1;
+        const long nshift = ii * g_nnodes;
+        for (long j = 0; j < g_nnodes; j++)
+        {
+            const long k = m_msh->Eqs2Global_NodeIndex[j];
+            const double val_n = GetNodeValue(k, nidx1);
+            SetNodeValue(k, nidx1, x[j + nshift]);
+            eqs_x[j + nshift] = val_n;  // Used for time stepping
+        }
+    }
+}
+#endif
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Modified Newton method ($NEWTON_JACOBIAN_LAGGING). The Jacobian
+         of an iteration is kept for at most newton_jacobian_reuse further
+         iterations, as long as the iterations contract fast enough. In
+         these iterations, only the residual is assembled, and the
+         preconditioner or the factorization of the kept matrix is reused
+         by the linear solver. The first iterations of a Newton loop
+         assemble the Jacobian.
+**************************************************************************/
+void CRFProcess::ResetJacobianLagging()
+{
+    lagged_jacobian_uses = 0;
+    jacobian_lagged = false;
+    jacobian_lagging_error = -1.;
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Decide whether the next Newton iteration reuses the kept Jacobian
+         from the error of the increment of the current iteration. The
+         Jacobian is kept if the error decreases at least by the factor
+         newton_jacobian_contraction. Returns false if the increment of an
+         iteration with the kept Jacobian does not decrease the error: it
+         is to be discarded, and the next iteration assembles the Jacobian.
+**************************************************************************/
+bool CRFProcess::UpdateJacobianLagging(const double error)
+{
+    const bool lagged = jacobian_lagged;
+    jacobian_lagged = false;
+#ifdef NEW_EQS
+    if (m_num->newton_jacobian_reuse < 1 || m_num->nls_method != 1 ||
+        !dom_vector.empty())
+        return true;
+    if (jacobian_lagging_error < 0.)
+    {
+        // First iteration: its contraction is not known
+        jacobian_lagging_error = error;
+        return true;
+    }
+    const double contraction = error / jacobian_lagging_error;
+    if (lagged && !(contraction < 1.))
+    {
+        ScreenMessage(
+            "      Increment with the kept Jacobian rejected, contraction "
+            "%g\n",
+            contraction);
+        return false;
+    }
+    jacobian_lagging_error = error;
+    jacobian_lagged = contraction <= m_num->newton_jacobian_contraction &&
+                      lagged_jacobian_uses > 0 &&
+                      lagged_jacobian_uses <= m_num->newton_jacobian_reuse;
+#else
+    (void)error;
+    (void)lagged;
+#endif
+    return true;
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Called after the element loop of the assembly, before the source
+         terms and the boundary conditions are incorporated. Keeps the
+         element part of the assembled Jacobian, or replaces the matrix of
+         a lagged iteration with the kept one. The Jacobian of the first
+         iteration of the modified Newton method is not kept, since it is
+         never reused (see UpdateJacobianLagging()); the quasi-Newton method
+         reuses every assembled tangent.
+**************************************************************************/
+void CRFProcess::KeepOrRestoreJacobian()
+{
+#ifdef NEW_EQS
+    const bool quasi_newton = m_num->quasi_newton_method > 0 &&
+                              isDeformationProcess(getProcessType());
+    if ((m_num->newton_jacobian_reuse < 1 && !quasi_newton) ||
+        m_num->nls_method != 1 || !dom_vector.empty())
+        return;
+    Math_Group::CSparseMatrix* A = eqs_new->A;
+    const std::size_t n_entries =
+        static_cast<std::size_t>(A->NumberOfEntries());
+    if (jacobian_lagged && lagged_jacobian_uses > 0 &&
+        lagged_jacobian.size() == n_entries)
+    {
+        A->SetEntries(&lagged_jacobian[0]);
+        eqs_new->SetKeptOperator(&lagged_jacobian, kept_operators);
+        lagged_jacobian_uses++;
+        if (m_num->newton_jacobian_reuse > 0)
+            ScreenMessage(
+                "      Jacobian of a previous iteration reused (%d/%d)\n",
+                lagged_jacobian_uses - 1, m_num->newton_jacobian_reuse);
+        return;
+    }
+    lagged_jacobian_uses = 0;
+    if (!quasi_newton && jacobian_lagging_error < 0.)
+        return;
+    const double* entries = A->Entries();
+    lagged_jacobian.assign(entries, entries + n_entries);
+    eqs_new->SetKeptOperator(&lagged_jacobian, ++kept_operators);
+    lagged_jacobian_uses = 1;
+#endif
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Solution predictor ($SOLUTION_PREDICTOR). Called before the first
+         iteration of a time step, when both time levels hold the solution
+         of the last accepted time step. The initial guess of the primary
+         variables is extrapolated in time by the Lagrange polynomial
+         through the solutions of the last two (LINEAR) or three
+         (QUADRATIC) accepted time steps, e.g. for LINEAR
+            u = u_n + dt_{n+1} / dt_n (u_n - u_{n-1}).
+         The solution of a repeated time step is stored only once.
+**************************************************************************/
+void CRFProcess::PredictSolution()
+{
+    predictor_check = false;
+    if (m_num->solution_predictor < 1 || Tim == NULL ||
+        isDeformationProcess(getProcessType()))
+        return;
+    const double dt = Tim->time_step_length;
+    if (!(dt > 0.))
+        return;
+    const double t_new = Tim->last_active_time;
+    const double t_old = t_new - dt;
+    const std::size_t n_nodes = m_msh->GetNodesNumber(false);
+    const std::size_t n = n_nodes * pcs_number_of_primary_nvals;
+
+    // Keep the previous solution. Solutions of the same or a later time,
+    // i.e. of a rejected time step, are dropped.
+    while (!predictor_times.empty() &&
+           predictor_times.back() > t_old - 1.e-10 * dt)
+    {
+        predictor_times.pop_back();
+        predictor_solutions.pop_back();
+    }
+    if (!predictor_solutions.empty() && predictor_solutions[0].size() != n)
+    {
+        predictor_times.clear();
+        predictor_solutions.clear();
+    }
+    const std::size_t max_points =
+        static_cast<std::size_t>(m_num->solution_predictor) + 1;
+    if (predictor_solutions.size() == max_points)
+    {
+        std::rotate(predictor_solutions.begin(),
+                    predictor_solutions.begin() + 1,
+                    predictor_solutions.end());
+        predictor_times.erase(predictor_times.begin());
+    }
+    else
+        predictor_solutions.push_back(std::vector<double>());
+    predictor_times.push_back(t_old);
+    std::vector<double>& u_n = predictor_solutions.back();
+    u_n.resize(n);
+    for (int j = 0; j < pcs_number_of_primary_nvals; j++)
+    {
+        const int nidx0 = GetNodeValueIndex(pcs_primary_function_name[j]);
+        double* u_j = &u_n[j * n_nodes];
+        for (std::size_t l = 0; l < n_nodes; l++)
+            u_j[l] = GetNodeValue(l, nidx0);
+    }
+
+    const std::size_t n_points = predictor_times.size();
+    if (n_points < 2)
+        return;
+    double weights[3];
+    for (std::size_t i = 0; i < n_points; i++)
+    {
+        weights[i] = 1.0;
+        for (std::size_t k = 0; k < n_points; k++)
+            if (k != i)
+                weights[i] *= (t_new - predictor_times[k]) /
+                              (predictor_times[i] - predictor_times[k]);
+    }
+    for (int j = 0; j < pcs_number_of_primary_nvals; j++)
+    {
+        const int nidx1 = GetNodeValueIndex(pcs_primary_function_name[j]) + 1;
+        const std::size_t shift = j * n_nodes;
+        for (std::size_t l = 0; l < n_nodes; l++)
+        {
+            double u = 0.0;
+            for (std::size_t i = 0; i < n_points; i++)
+                u += weights[i] * predictor_solutions[i][shift + l];
+            SetNodeValue(l, nidx1, u);
+        }
+    }
+    predictor_check = true;
+    ScreenMessage("      Initial guess extrapolated from %d time steps\n",
+                  static_cast<int>(n_points));
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Called after the assembly of the first iteration of a time step
+         with a predicted initial guess. The residual of the assembled
+         system, b - A x for Picard and linear problems and b for the
+         increment of Newton, is compared with that of the previous
+         solution. If the prediction has the larger residual, the previous
+         solution is restored as initial guess, and true is returned: the
+         system is to be assembled again.
+**************************************************************************/
+bool CRFProcess::RejectPredictedSolution()
+{
+    if (!predictor_check)
+        return false;
+    predictor_check = false;
+#if defined(NEW_EQS) && !defined(USE_MPI)
+    if (m_num->nls_method > 1 || !dom_vector.empty())
+        return false;
+    const long g_nnodes = m_msh->GetNodesNumber(false);
+    const long n = g_nnodes * pcs_number_of_primary_nvals;
+    std::vector<double> d(n), Ad(n), r(n);
+    for (int ii = 0; ii < pcs_number_of_primary_nvals; ii++)
+    {
+        const int nidx0 = GetNodeValueIndex(pcs_primary_function_name[ii]);
+        for (long j = 0; j < g_nnodes; j++)
+        {
+            const long k = m_msh->Eqs2Global_NodeIndex[j];
+            // Previous solution minus the predicted one
+            d[j + ii * g_nnodes] =
+                GetNodeValue(k, nidx0) - GetNodeValue(k, nidx0 + 1);
+            r[j + ii * g_nnodes] = GetNodeValue(k, nidx0 + 1);
+        }
+    }
+    const double* b = eqs_new->b;
+    if (m_num->nls_method < 1)
+    {
+        eqs_new->A->multiVec(&r[0], &Ad[0]);
+        for (long i = 0; i < n; i++)
+            r[i] = b[i] - Ad[i];
+    }
+    else
+        r.assign(b, b + n);
+    eqs_new->A->multiVec(&d[0], &Ad[0]);
+    double norm_predicted = 0.0, norm_previous = 0.0;
+    for (long i = 0; i < n; i++)
+    {
+        norm_predicted += r[i] * r[i];
+        norm_previous += (r[i] - Ad[i]) * (r[i] - Ad[i]);
+    }
+    norm_predicted = std::sqrt(norm_predicted);
+    norm_previous = std::sqrt(norm_previous);
+    if (!(norm_previous < norm_predicted))
+        return false;
+
+    ScreenMessage(
+        "      Predicted initial guess rejected, residual %g > %g of the "
+        "previous solution\n",
+        norm_predicted, norm_previous);
+    CopyTimestepNODValues(false);
+    if (m_num->nls_method < 1)
+    {
+        for (int ii = 0; ii < pcs_number_of_primary_nvals; ii++)
+        {
+            const int nidx1 =
+                GetNodeValueIndex(pcs_primary_function_name[ii]) + 1;
+            for (long j = 0; j < g_nnodes; j++)
+                eqs_x[j + ii * g_nnodes] =
+                    GetNodeValue(m_msh->Eqs2Global_NodeIndex[j], nidx1);
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
 /**************************************************************************
    FEMLib-Method:
    Task:
@@ -10104,14 +10919,12 @@ void CRFProcess::Extropolation_GaussValue()
                 SetNodeValue(i, idx[k], 0.0);
     }
     //
-    for (i = 0; i < (long)m_msh->ele_vector.size(); i++)
+    const std::vector<long>& elements = getActiveElements();
+    for (i = 0; i < (long)elements.size(); i++)
     {
-        elem = m_msh->ele_vector[i];
-        if (elem->GetMark())  // Marked for use
-        {
-            for (k = 0; k < NS; k++)
-                fem->ExtropolateGauss(*elem, this, k);
-        }
+        elem = m_msh->ele_vector[elements[i]];
+        for (k = 0; k < NS; k++)
+            fem->ExtropolateGauss(*elem, this, k);
     }
 }
 
@@ -11654,6 +12467,7 @@ void CRFProcess::CalcELEFluxes(const GEOLIB::Polyline* const ply,
 
     result[0] = result[1] = 0;
     FiniteElement::ProcessType pcs_type(getProcessType());
+    m_msh->ConstructEdges();
 
     CRFProcess* m_pcs_flow = NULL;
     //	if (_pcs_type_name.find("FLOW") != string::npos) {
@@ -11971,6 +12785,7 @@ void CRFProcess::CalcELEMassFluxes(const GEOLIB::Polyline* const ply,
                 numberPolyline = i;
     }
 
+    m_msh->ConstructEdges();
     m_msh->GetELEOnPLY(ply, ele_vector_at_geo, true);
     // BG: 04/2011 nodes are needed to provide the correct edge
     m_msh->GetNODOnPLY(ply, nod_vector_at_geo);
@@ -12595,6 +13410,7 @@ void CRFProcess::AssembleParabolicEquationRHSVector(CNode* m_nod)
     for (size_t i = 0; i < m_nod->getConnectedElementIDs().size(); i++)
         eqs->b[m_nod->getConnectedElementIDs()[i]] = 0.0;
     //----------------------------------------------------------------------
+    m_msh->ConstructEdges();
     CElem* m_ele = NULL;
     CEdge* m_edg = NULL;
     double edg_normal_vector[3];
@@ -13503,7 +14319,8 @@ void CRFProcess::DumpEqs(string file_name)
     for (long i = 0; i < eqs->dim; i++)
     {
         CNode const* const node(m_msh->nod_vector[i % nnode]);
-        std::vector<size_t> const& connected_nodes(node->getConnectedNodes());
+        MeshLib::NodeAdjacency const& connected_nodes(
+            node->getConnectedNodes());
         const size_t n_connected_nodes(connected_nodes.size());
         for (int ii = 0; ii < eqs->unknown_vector_dimension; ii++)
             for (size_t j = 0; j < n_connected_nodes; j++)
@@ -13979,8 +14796,9 @@ void CRFProcess::IncorporateSourceTerms_GEMS(void)
 // Adding the rate of concentration change to the right hand side of the
 // equation.
 #ifdef NEW_EQS  // 15.12.2008. WW
-            eqs_new->b[it] -= m_vec_GEM->m_xDC_Chem_delta[it * nDC + i] /
-                              Tim->time_step_length;
+            eqs_new->b[m_msh->nod_vector[it]->GetEquationIndex()] -=
+                m_vec_GEM->m_xDC_Chem_delta[it * nDC + i] /
+                Tim->time_step_length;
 #elif defined(USE_PETSC)
 // eqs_new->b[it] -= m_vec_GEM->m_xDC_Chem_delta[it * nDC + i] /
 // Tim->time_step_length;
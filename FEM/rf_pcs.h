@@ -31,7 +31,9 @@
 #include "rf_num_new.h"
 #include "rf_tim_new.h"
 #include "conversion_rate.h"  // HS, 10.2011
+#include "SparseMatrixCSR.h"
 #include "SparseMatrixDOK.h"
+#include "ThreadPrivate.h"
 
 #include "Eigen/Eigen"
 
@@ -52,6 +54,7 @@ namespace FiniteElement
 {
 class CFiniteElementStd;
 class CFiniteElementVec;
+class ElementBatch;
 class ElementMatrix;
 class ElementValue;
 }  // namespace FiniteElement
@@ -61,10 +64,17 @@ namespace MeshLib
 class CFEMesh;
 }
 
+namespace Math_Group
+{
+class AndersonAcceleration;
+}
+
 #ifdef NEW_EQS  // WW
 namespace Math_Group
 {
 class Linear_EQS;
+class CSparseMatrix;
+class GlobalOperatorCache;
 }
 using Math_Group::Linear_EQS;
 #endif
@@ -247,6 +257,40 @@ protected:  // WW
     long size_unknowns;
     // Assembler
     CFiniteElementStd* fem;
+    /// Assemblers of the threads of the parallel assembly, the first one is
+    /// fem
+    std::vector<CFiniteElementStd*> thread_fem;
+    /// Element batches of the assembly, one per element type
+    std::vector<FiniteElement::ElementBatch*> element_batches;
+    /// Indices of the active (marked) elements grouped by element type.
+    /// The elements of type t start at active_element_ptr[t - 1].
+    std::vector<long> active_elements;
+    std::vector<long> active_element_ptr;
+    /// Active elements of each color of the mesh (CFEMesh::ColorElements),
+    /// given by their position in active_elements. The elements of color c
+    /// are active_color_elements[active_color_ptr[c]] up to before
+    /// active_color_ptr[c + 1]. Empty if the mesh is not colored.
+    std::vector<long> active_color_elements;
+    std::vector<long> active_color_ptr;
+    /// CElem::getMarkChanges() and the number of elements of the mesh when
+    /// the active elements were collected, -1 if not yet
+    unsigned long active_elements_mark_changes;
+    long active_elements_mesh_size;
+    /// Anderson acceleration of the Picard iterations
+    /// ($NON_LINEAR_ACCELERATION), or NULL
+    Math_Group::AndersonAcceleration* nls_acceleration;
+    /// Modified Newton ($NEWTON_JACOBIAN_LAGGING): number of iterations that
+    /// used the kept Jacobian, whether the current iteration uses it, and
+    /// the error of the previous iteration
+    int lagged_jacobian_uses;
+    bool jacobian_lagged;
+    double jacobian_lagging_error;
+    /// Solution predictor ($SOLUTION_PREDICTOR): primary variables of the
+    /// last accepted time steps and their times
+    std::vector<std::vector<double> > predictor_solutions;
+    std::vector<double> predictor_times;
+    /// Whether the residual of the predicted initial guess is to be checked
+    bool predictor_check;
     // Time step control
     bool accepted;     // 25.08.1008. WW
     int accept_steps;  // 27.08.1008. WW
@@ -260,7 +304,7 @@ protected:  // WW
     Math_Group::Vec* Gl_Vec;                 // NW
     Math_Group::Vec* Gl_Vec1;                // NW
     Math_Group::Vec* Gl_ML;                  // NW
-    Math_Group::SparseMatrixDOK* FCT_AFlux;  // NW
+    Math_Group::SparseMatrixCSR* FCT_AFlux;  // NW
 #ifdef USE_PETSC
     Math_Group::SparseMatrixDOK* FCT_K;
     Math_Group::SparseMatrixDOK* FCT_d;
@@ -296,6 +340,30 @@ public:
     Linear_EQS* eqs_new;
 #endif  // LIS endif for Fluid Momentum	// PCH
     bool configured_in_nonlinearloop;
+    /// Mass transport: element part of the matrix and operator of the right
+    /// hand side, kept for the components that use the operator of this one
+    /// (see Problem::SetSharedTransportOperators())
+    Math_Group::CSparseMatrix* shared_lhs;
+    Math_Group::CSparseMatrix* shared_rhs;
+    /// Time step and time step size of the kept operator
+    long shared_operator_step;
+    double shared_operator_dt;
+    /// Component whose operator is used by this one, or NULL
+    CRFProcess* shared_operator_pcs;
+    /// Linear processes: global matrices of the terms of the equation,
+    /// assembled once ($GLOBAL_OPERATOR_CACHE), or NULL
+    Math_Group::GlobalOperatorCache* global_operator_cache;
+    /// Hash of the node coordinates for the fingerprint of the kept global
+    /// matrices, and MeshLib::CNode::getCoordinateChanges() when it was
+    /// computed
+    unsigned long long node_coordinates_hash;
+    unsigned long node_coordinates_changes;
+    /// Modified Newton: element part of the kept Jacobian
+    std::vector<double> lagged_jacobian;
+    /// Number of operators kept by the process (shared operator, Jacobian).
+    /// It identifies their versions for the reuse of the preconditioner,
+    /// see Linear_EQS::SetKeptOperator().
+    unsigned long kept_operators;
 #else
     LINEAR_SOLVER* eqs;
 #endif
@@ -675,16 +743,65 @@ public:
     // nod_fct_name);
     void CheckMarkedElement();   // WW
     void CheckExcavedElement();  // WX
+    /// Collect the active elements anew
+    void UpdateActiveElements();
+    /// Indices of the active elements, collected anew if the marks of the
+    /// elements have changed. Not to be called in a parallel region.
+    const std::vector<long>& getActiveElements()
+    {
+        if (active_elements_mesh_size !=
+                static_cast<long>(m_msh->ele_vector.size()) ||
+            active_elements_mark_changes != MeshLib::CElem::getMarkChanges())
+            UpdateActiveElements();
+        return active_elements;
+    }
     // Configuration 3 - ELE matrices
     void CreateELEMatricesPointer(void);
     // Equation system
     //---WW
-    CFiniteElementStd* GetAssember() { return fem; }
+    /// Assembler of the calling thread
+    CFiniteElementStd* GetAssember()
+    {
+        if (thread_fem.empty())
+            return fem;
+        return thread_fem[ThreadPrivateIndex()];
+    }
     void AllocateLocalMatrixMemory();
     virtual void
     GlobalAssembly();  // Make as a virtual function. //10.09.201l. WW
     /// For all PDEs excluding that for deformation. 24.11.2010l. WW
     void GlobalAssembly_std(const bool is_mixed_order, bool Check2D3D = false);
+    /// Whether the element loop of the assembly runs in parallel
+    bool isParallelAssembly() const;
+    /// Element loop of the assembly over the colors of the elements with
+    /// OpenMP
+    void GlobalAssembly_omp(const bool is_mixed_order, const bool Check2D3D,
+                            const bool mesh_order);
+    /// Whether the element loop of the assembly uses element batches
+    bool isBatchAssembly() const;
+    /// Element loop of the assembly over batches of elements of the same
+    /// type, whose local matrices are computed together
+    void GlobalAssembly_batch(const bool Check2D3D);
+#ifdef NEW_EQS
+    /// Whether the operator of another transport component is used in this
+    /// time step
+    bool isSharedTransportOperator() const;
+    /// Matrix and RHS of the element loop from the operator of another
+    /// transport component
+    void AssembleSharedTransportOperator();
+    /// Whether the equation system of this process is linear with constant
+    /// coefficients, so that its global matrices can be kept
+    bool hasCachableOperator() const;
+    /// Fingerprint of the data that the coefficients of the kept global
+    /// matrices depend on
+    unsigned long long GlobalOperatorFingerprint();
+    /// Whether the element loop is replaced by the kept global matrices.
+    /// Otherwise, the kept matrices are set up for the next element loop
+    /// if the process has them.
+    bool isGlobalOperatorCached();
+    /// Matrix and RHS of the element loop from the kept global matrices
+    void AssembleGlobalOperator();
+#endif
     /// Assemble EQS for deformation process.
     virtual void GlobalAssembly_DM(){};
 #if defined(NEW_EQS) && defined(JFNK_H2M)
@@ -709,6 +826,28 @@ public:
     double Execute();
     double ExecuteNonLinear(int loop_process_number, bool print_pcs = true);
     void PrintStandardIterationInformation(bool write_std_errors = true);
+#if !defined(USE_PETSC)
+    void AccelerateNonLinearIteration(const double damping);
+#endif
+    /// Whether the current Newton iteration reuses the Jacobian of a
+    /// previous one, so that only the residual is assembled
+    bool isJacobianLagged() const { return jacobian_lagged; }
+    /// Assemble the Jacobian in the next Newton iteration
+    void ResetJacobianLagging();
+    /// Decide whether the next Newton iteration reuses the Jacobian from
+    /// the error of the current one. False if the increment of the
+    /// current iteration is to be discarded.
+    bool UpdateJacobianLagging(const double error);
+    /// Keep the element part of the Jacobian, or replace it with the kept
+    /// one if the iteration is lagged
+    void KeepOrRestoreJacobian();
+    /// Extrapolate the initial guess of the time step from the last
+    /// accepted time steps ($SOLUTION_PREDICTOR)
+    void PredictSolution();
+    /// Replace the predicted initial guess with the previous solution if
+    /// its residual of the assembled system is larger. Returns true if it
+    /// is replaced.
+    bool RejectPredictedSolution();
 
     virtual void CalculateElementMatrices(void);
 #if !defined(USE_PETSC)  // && !defined(other parallel libs)//03.3012. WW
@@ -5998,7 +5998,7 @@ void RandomWalk::buildFDMIndex(void)
 {
     double xmax, ymax, zmax;
     double xmin, ymin, zmin;
-    long i, j, k, iel, ic, jc, kc, nels;
+    long i, j, k, iel, ic, jc, kc;
     // WW long ne, nels;
     int index;
     neFDM = -1;
@@ -6078,7 +6078,9 @@ void RandomWalk::buildFDMIndex(void)
     ny = (int)floor(yrw_range / dy) + 1;
     nz = (int)floor(zrw_range / dz) + 1;
     // WW ne = nx*ny*nz;
-    nels = m_msh->ele_vector.size();
+    const MeshLib::MeshElementGrid& element_grid(m_msh->getElementGrid());
+    std::vector<long> candidates;
+    double box_min[3], box_max[3];
 
     for (k = 0; k < nz; k++)  // loop over the dummy element set
     {
@@ -6092,10 +6094,21 @@ void RandomWalk::buildFDMIndex(void)
                 one.k = k;
                 one.eleIndex =
                     -5;  // eleIndex -5 is dummy index different from -10
-                for (iel = 0; iel < nels;
-                     iel++)  // loop over mesh elements, assign them to dummy
-                             // elements
+                // Elements near the dummy element, widened by half a dummy
+                // element against round-off. They are ascending, so that the
+                // first one with its center in the dummy element is taken.
+                box_min[0] = pnt_x_min + (i - 0.5) * dx;
+                box_min[1] = pnt_y_min + (j - 0.5) * dy;
+                box_min[2] = pnt_z_min + (k - 0.5) * dz;
+                box_max[0] = pnt_x_min + (i + 1.5) * dx;
+                box_max[1] = pnt_y_min + (j + 1.5) * dy;
+                box_max[2] = pnt_z_min + (k + 1.5) * dz;
+                element_grid.getElementsInBox(box_min, box_max, candidates);
+                for (size_t l = 0; l < candidates.size();
+                     l++)  // loop over mesh elements, assign them to dummy
+                           // elements
                 {
+                    iel = candidates[l];
                     double const* center =
                         m_msh->ele_vector[iel]->GetGravityCenter();
                     ic = (int)floor((center[0] - pnt_x_min) / dx);
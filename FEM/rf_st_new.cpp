@@ -1542,6 +1542,7 @@ void CSourceTerm::EdgeIntegration(CFEMesh* msh,
     //}
 
     // Unmakr edges.
+    msh->ConstructEdges();
     for (i = 0; i < (long)msh->edge_vector.size(); i++)
         msh->edge_vector[i]->SetMark(false);
     for (i = 0; i < nSize; i++)
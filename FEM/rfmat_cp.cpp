@@ -1784,6 +1784,76 @@ double CompProperties::CalcElementDecayRateNew(long index, CRFProcess* m_pcs)
     return lambda;
 }
 
+/**************************************************************************
+   Task: Whether the retardation factor and the decay rate are independent
+      of the concentration, i.e. the transport equation of the component
+      is linear.
+**************************************************************************/
+bool CompProperties::HasLinearTransportOperator() const
+{
+    switch (isotherm_model)
+    {
+        case -1:  // no sorption
+        case 1:   // linear isotherm
+        case 4:   // face retardation
+            break;
+        case 2:  // Freundlich isotherm with exponent one
+            if (fabs(isotherm_model_values[1] - 1.0) < MKleinsteZahl)
+                break;
+            return false;
+        default:
+            return false;
+    }
+    switch (decay_model)
+    {
+        case -1:  // no decay
+            return true;
+        case 1:  // first order decay
+            return fabs(decay_model_values[1] - 1.0) < MKleinsteZahl;
+        default:
+            return false;
+    }
+}
+
+/**************************************************************************
+   Task: Whether the other component has the same linear transport
+      equation, so that both can be solved with one operator.
+**************************************************************************/
+bool CompProperties::HasSameTransportOperator(
+    const CompProperties& other) const
+{
+    if (!HasLinearTransportOperator() || !other.HasLinearTransportOperator())
+        return false;
+    if (mobil != other.mobil || transport_phase != other.transport_phase)
+        return false;
+
+    if (diffusion_model != other.diffusion_model ||
+        count_of_diffusion_model_values !=
+            other.count_of_diffusion_model_values)
+        return false;
+    if (diffusion_model == 0 &&
+        diffusion_function_name != other.diffusion_function_name)
+        return false;
+    for (int i = 0; i < count_of_diffusion_model_values; i++)
+        if (diffusion_model_values[i] != other.diffusion_model_values[i])
+            return false;
+
+    if (isotherm_model != other.isotherm_model ||
+        count_of_isotherm_model_values != other.count_of_isotherm_model_values)
+        return false;
+    for (int i = 0; i < count_of_isotherm_model_values; i++)
+        if (isotherm_model_values[i] != other.isotherm_model_values[i])
+            return false;
+
+    if (decay_model != other.decay_model ||
+        count_of_decay_model_values != other.count_of_decay_model_values)
+        return false;
+    for (int i = 0; i < count_of_decay_model_values; i++)
+        if (decay_model_values[i] != other.decay_model_values[i])
+            return false;
+    return true;
+}
+
 // SB:todo Wie kann ich die gut ersetzen (wird nur in loop_pcs gebraucht, um zu
 // schauen ob der process mobil ist ??
 int CPGetMobil(long comp)
@@ -150,6 +150,11 @@ public:
     double CalcElementMeanConcNew(long index, CRFProcess* m_pcs);
     double CalcElementDecayRate(long index);
     double CalcElementDecayRateNew(long index, CRFProcess* m_pcs);
+    /// Sorption and decay do not depend on the concentration
+    bool HasLinearTransportOperator() const;
+    /// Diffusion, sorption and decay give the same transport equation as
+    /// those of the other component
+    bool HasSameTransportOperator(const CompProperties& other) const;
     // IO
     std::string file_base_name;
 };
@@ -0,0 +1,633 @@
+/*
+ * OGSMeshIOBinary.cpp
+ *
+ * Binary OGS mesh files, which are mapped into memory and read without
+ * parsing.
+ *
+ *  Created on: Oct 18, 2026
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ */
+
+#include "MeshIO/OGSMeshIOBinary.h"
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "msh_edge.h"
+#include "msh_elem.h"
+#include "msh_mesh.h"
+#include "msh_node.h"
+
+namespace FileIO
+{
+static const char MESH_FILE_MAGIC[8] = {'O', 'G', 'S', 'M', 'S', 'H', 'B', 0};
+static const uint32_t MESH_FILE_BYTE_ORDER = 0x01020304;
+static const std::size_t FILE_HEADER_SIZE = 24;
+
+struct OGSMeshIOBinary::MeshHeader
+{
+    int64_t n_nodes;
+    int64_t n_elements;
+    /// Sum of the numbers of the nodes of the elements
+    int64_t n_element_nodes;
+    int64_t has_topology;
+    int64_t n_edges;
+    /// Sums of the numbers of the faces and of the edges of the elements
+    int64_t n_element_faces;
+    int64_t n_element_edges;
+    /// Sums of the numbers of the elements and of the nodes connected to
+    /// the nodes
+    int64_t n_connected_elements;
+    int64_t n_connected_nodes;
+    int64_t axisymmetry;
+    int64_t cross_section;
+    int64_t n_msh_layer;
+    int64_t pcs_name_length;
+    int64_t geo_name_length;
+    int64_t geo_type_name_length;
+};
+
+/// Size of a string or array in the file, padded to 8 bytes
+static std::size_t getPaddedSize(const std::size_t n)
+{
+    return (n + 7) / 8 * 8;
+}
+
+/// Whether a count of the header is not negative and not larger than n_max,
+/// so that the sizes computed from the counts cannot overflow
+static bool isCountValid(const int64_t n, const std::size_t n_max)
+{
+    return n >= 0 && static_cast<uint64_t>(n) <= n_max;
+}
+
+/// Whether all entries of an array are in [lower, upper)
+static bool isInRange(const int64_t* array, const int64_t n,
+                      const int64_t lower, const int64_t upper)
+{
+    for (int64_t i = 0; i < n; i++)
+        if (array[i] < lower || array[i] >= upper)
+            return false;
+    return true;
+}
+
+/// Whether an array of n + 1 entries starts the rows of n compressed rows
+/// with the given number of entries
+static bool isRowPointer(const int64_t* ptr, const int64_t n,
+                         const int64_t n_entries)
+{
+    if (ptr[0] != 0 || ptr[n] != n_entries)
+        return false;
+    for (int64_t i = 0; i < n; i++)
+        if (ptr[i + 1] < ptr[i])
+            return false;
+    return true;
+}
+
+/**
+ * A file mapped into memory, or read into a buffer where files cannot be
+ * mapped. The data stay valid for the life time of the object.
+ */
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& file_name)
+        : _data(NULL), _size(0)
+    {
+#ifdef _WIN32
+        std::ifstream is(file_name.c_str(), std::ios::binary);
+        if (!is)
+            return;
+        _buffer.assign(std::istreambuf_iterator<char>(is),
+                       std::istreambuf_iterator<char>());
+        _size = _buffer.size();
+        if (_size > 0)
+            _data = &_buffer[0];
+#else
+        const int fd = open(file_name.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0)
+        {
+            void* const data = mmap(NULL, file_stat.st_size, PROT_READ,
+                                    MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                _data = static_cast<const char*>(data);
+                _size = file_stat.st_size;
+            }
+        }
+        close(fd);
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifndef _WIN32
+        if (_data)
+            munmap(const_cast<char*>(_data), _size);
+#endif
+    }
+
+    const char* data() const { return _data; }
+    std::size_t size() const { return _size; }
+
+private:
+    const char* _data;
+    std::size_t _size;
+#ifdef _WIN32
+    std::vector<char> _buffer;
+#endif
+};
+
+/// Sequential access to the arrays of a mesh in the mapped file
+class ArrayReader
+{
+public:
+    explicit ArrayReader(const char* data) : _data(data), _position(0) {}
+
+    template <typename T>
+    const T* next(const std::size_t n)
+    {
+        const T* array = reinterpret_cast<const T*>(_data + _position);
+        _position += getPaddedSize(n * sizeof(T));
+        return array;
+    }
+
+    std::string nextString(const std::size_t n)
+    {
+        const char* s = next<char>(n);
+        return std::string(s, n);
+    }
+
+private:
+    const char* _data;
+    std::size_t _position;
+};
+
+/// Writes an array and pads it to 8 bytes
+template <typename T>
+static void writeArray(std::ostream& os, const T* array, const std::size_t n)
+{
+    if (n > 0)
+        os.write(reinterpret_cast<const char*>(array), n * sizeof(T));
+    static const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    os.write(padding, getPaddedSize(n * sizeof(T)) - n * sizeof(T));
+}
+
+template <typename T>
+static void writeArray(std::ostream& os, const std::vector<T>& array)
+{
+    writeArray(os, array.empty() ? NULL : &array[0], array.size());
+}
+
+std::string OGSMeshIOBinary::getFileName(const std::string& file_base_name)
+{
+    return file_base_name + ".msb";
+}
+
+bool OGSMeshIOBinary::isUpToDate(const std::string& binary_file_name,
+                                 const std::string& ascii_file_name)
+{
+    struct stat binary_stat, ascii_stat;
+    if (stat(binary_file_name.c_str(), &binary_stat) != 0)
+        return false;
+    if (stat(ascii_file_name.c_str(), &ascii_stat) != 0)
+        return true;
+    return binary_stat.st_mtime >= ascii_stat.st_mtime;
+}
+
+std::size_t OGSMeshIOBinary::getMeshSize(const MeshHeader& header)
+{
+    const std::size_t l = sizeof(int64_t);
+    const std::size_t d = sizeof(double);
+    std::size_t size = sizeof(MeshHeader);
+    size += getPaddedSize(header.pcs_name_length);
+    size += getPaddedSize(header.geo_name_length);
+    size += getPaddedSize(header.geo_type_name_length);
+    size += header.n_nodes * (l + 3 * d + d);
+    size += 3 * header.n_elements * l + (header.n_elements + 1) * l;
+    size += header.n_element_nodes * l;
+    if (header.has_topology)
+    {
+        size += 2 * header.n_edges * l;
+        size += header.n_element_faces * l + 2 * header.n_element_edges * l;
+        size += 2 * (header.n_nodes + 1) * l;
+        size += (header.n_connected_elements + header.n_connected_nodes) * l;
+    }
+    return size;
+}
+
+bool OGSMeshIOBinary::read(const std::string& file_name,
+                           std::vector<MeshLib::CFEMesh*>& mesh_vec,
+                           GEOLIB::GEOObjects* geo_obj,
+                           std::string* unique_name)
+{
+    const MappedFile file(file_name);
+    const char* data = file.data();
+    if (!data || file.size() < FILE_HEADER_SIZE ||
+        std::memcmp(data, MESH_FILE_MAGIC, sizeof(MESH_FILE_MAGIC)) != 0)
+        return false;
+    uint32_t version, byte_order;
+    std::memcpy(&version, data + 8, sizeof(version));
+    std::memcpy(&byte_order, data + 12, sizeof(byte_order));
+    if (version != VERSION || byte_order != MESH_FILE_BYTE_ORDER)
+        return false;
+    const int64_t n_meshes = *reinterpret_cast<const int64_t*>(data + 16);
+    // Each mesh has at least its header
+    if (n_meshes < 0 ||
+        static_cast<uint64_t>(n_meshes) >
+            (file.size() - FILE_HEADER_SIZE) / sizeof(MeshHeader))
+        return false;
+
+    std::vector<MeshLib::CFEMesh*> meshes;
+    std::size_t position = FILE_HEADER_SIZE;
+    for (int64_t m = 0; m < n_meshes; m++)
+    {
+        MeshLib::CFEMesh* mesh = NULL;
+        if (position < file.size())
+            mesh = readMesh(data + position, file.size() - position, geo_obj,
+                            unique_name);
+        if (!mesh)
+        {
+            for (std::size_t i = 0; i < meshes.size(); i++)
+                delete meshes[i];
+            return false;
+        }
+        position += getMeshSize(
+            *reinterpret_cast<const MeshHeader*>(data + position));
+        meshes.push_back(mesh);
+    }
+    mesh_vec.insert(mesh_vec.end(), meshes.begin(), meshes.end());
+    return true;
+}
+
+MeshLib::CFEMesh* OGSMeshIOBinary::readMesh(const char* data,
+                                            const std::size_t size,
+                                            GEOLIB::GEOObjects* geo_obj,
+                                            std::string* unique_name)
+{
+    using MeshLib::CElem;
+    using MeshLib::CNode;
+
+    if (size < sizeof(MeshHeader))
+        return NULL;
+    const MeshHeader& header = *reinterpret_cast<const MeshHeader*>(data);
+    // Each counted item takes at least 8 bytes, each character 1 byte
+    const std::size_t n_max = size / sizeof(int64_t);
+    if (!isCountValid(header.n_nodes, n_max) ||
+        !isCountValid(header.n_elements, n_max) ||
+        !isCountValid(header.n_element_nodes, n_max) ||
+        !isCountValid(header.n_edges, n_max) ||
+        !isCountValid(header.n_element_faces, n_max) ||
+        !isCountValid(header.n_element_edges, n_max) ||
+        !isCountValid(header.n_connected_elements, n_max) ||
+        !isCountValid(header.n_connected_nodes, n_max) ||
+        !isCountValid(header.pcs_name_length, size) ||
+        !isCountValid(header.geo_name_length, size) ||
+        !isCountValid(header.geo_type_name_length, size) ||
+        getMeshSize(header) > size)
+        return NULL;
+
+    ArrayReader reader(data + sizeof(MeshHeader));
+    const std::size_t n_nodes = header.n_nodes;
+    const std::size_t n_elements = header.n_elements;
+
+    MeshLib::CFEMesh* mesh = new MeshLib::CFEMesh(geo_obj, unique_name);
+    mesh->pcs_name = reader.nextString(header.pcs_name_length);
+    mesh->geo_name = reader.nextString(header.geo_name_length);
+    mesh->geo_type_name = reader.nextString(header.geo_type_name_length);
+    mesh->_axisymmetry = header.axisymmetry != 0;
+    mesh->_cross_section = header.cross_section != 0;
+    mesh->_n_msh_layer = header.n_msh_layer;
+
+    // Nodes
+    const int64_t* node_ids = reader.next<int64_t>(n_nodes);
+    const double* node_xyz = reader.next<double>(3 * n_nodes);
+    const double* node_area = reader.next<double>(n_nodes);
+    mesh->nod_vector.reserve(n_nodes);
+    for (std::size_t i = 0; i < n_nodes; i++)
+    {
+        CNode* node = new CNode(node_ids[i], &node_xyz[3 * i]);
+        node->patch_area = node_area[i];
+        mesh->nod_vector.push_back(node);
+    }
+
+    // Elements
+    const int64_t* element_ids = reader.next<int64_t>(n_elements);
+    const int64_t* element_types = reader.next<int64_t>(n_elements);
+    const int64_t* element_patches = reader.next<int64_t>(n_elements);
+    const int64_t* element_node_ptr = reader.next<int64_t>(n_elements + 1);
+    const int64_t* element_nodes =
+        reader.next<int64_t>(header.n_element_nodes);
+    bool valid =
+        isRowPointer(element_node_ptr, n_elements, header.n_element_nodes) &&
+        isInRange(element_nodes, header.n_element_nodes, 0, header.n_nodes);
+    int64_t n_element_faces = 0, n_element_edges = 0;
+    mesh->ele_vector.reserve(n_elements);
+    for (std::size_t i = 0; i < n_elements && valid; i++)
+    {
+        CElem* elem = new CElem(i);
+        mesh->ele_vector.push_back(elem);
+        elem->SetIndex(element_ids[i]);
+        elem->setPatchIndex(element_patches[i]);
+        if (element_types[i] != MshElemType::INVALID &&
+            (element_types[i] < MshElemType::LINE ||
+             element_types[i] > MshElemType::QUAD8))
+        {
+            valid = false;
+            break;
+        }
+        const MshElemType::type type =
+            static_cast<MshElemType::type>(element_types[i]);
+        elem->SetElementType(type);
+        if (type == MshElemType::INVALID)
+            continue;
+        elem->Config(type);
+        const int64_t n_elem_nodes =
+            element_node_ptr[i + 1] - element_node_ptr[i];
+        if (n_elem_nodes != elem->GetVertexNumber())
+        {
+            valid = false;
+            break;
+        }
+        for (int64_t k = 0; k < n_elem_nodes; k++)
+            elem->SetNodeIndex(k, element_nodes[element_node_ptr[i] + k]);
+        elem->InitializeMembers();
+        n_element_faces += elem->GetFacesNumber();
+        n_element_edges += elem->GetEdgesNumber();
+
+        mesh->setElementType(type);
+        if (elem->GetPatchIndex() > mesh->max_mmp_groups)
+            mesh->max_mmp_groups = elem->GetPatchIndex();
+        if (elem->GetDimension() > mesh->max_ele_dim)
+            mesh->max_ele_dim = elem->GetDimension();
+    }
+    if (!valid || (header.has_topology &&
+                   (n_element_faces != header.n_element_faces ||
+                    n_element_edges != header.n_element_edges)))
+    {
+        delete mesh;
+        return NULL;
+    }
+    if (!header.has_topology)
+        return mesh;
+
+    // Topology of CFEMesh::ConstructGrid(): edges, neighbors and edges of
+    // the elements, elements and nodes connected to the nodes
+    const int64_t* edge_nodes = reader.next<int64_t>(2 * header.n_edges);
+    const int64_t* element_neighbors =
+        reader.next<int64_t>(header.n_element_faces);
+    const int64_t* element_edges = reader.next<int64_t>(header.n_element_edges);
+    const int64_t* element_edge_orientation =
+        reader.next<int64_t>(header.n_element_edges);
+    const int64_t* node_element_ptr = reader.next<int64_t>(n_nodes + 1);
+    const int64_t* node_elements =
+        reader.next<int64_t>(header.n_connected_elements);
+    const int64_t* node_node_ptr = reader.next<int64_t>(n_nodes + 1);
+    const int64_t* node_nodes = reader.next<int64_t>(header.n_connected_nodes);
+    if (!isInRange(edge_nodes, 2 * header.n_edges, 0, header.n_nodes) ||
+        !isInRange(element_neighbors, header.n_element_faces, -1,
+                   header.n_elements) ||
+        !isInRange(element_edges, header.n_element_edges, 0,
+                   header.n_edges) ||
+        !isRowPointer(node_element_ptr, header.n_nodes,
+                      header.n_connected_elements) ||
+        !isInRange(node_elements, header.n_connected_elements, 0,
+                   header.n_elements) ||
+        !isRowPointer(node_node_ptr, header.n_nodes,
+                      header.n_connected_nodes) ||
+        !isInRange(node_nodes, header.n_connected_nodes, 0, header.n_nodes))
+    {
+        delete mesh;
+        return NULL;
+    }
+
+    Math_Group::vec<CNode*> edge_node_vec(3);
+    edge_node_vec[2] = NULL;
+    mesh->edge_vector.reserve(header.n_edges);
+    for (int64_t i = 0; i < header.n_edges; i++)
+    {
+        MeshLib::CEdge* edge = new MeshLib::CEdge(i);
+        edge->SetOrder(false);
+        edge_node_vec[0] = mesh->nod_vector[edge_nodes[2 * i]];
+        edge_node_vec[1] = mesh->nod_vector[edge_nodes[2 * i + 1]];
+        edge->SetNodes(edge_node_vec);
+        mesh->edge_vector.push_back(edge);
+    }
+
+    Math_Group::vec<CElem*> neighbors(15);
+    Math_Group::vec<MeshLib::CEdge*> edges(15);
+    Math_Group::vec<int> orientation(15);
+    std::size_t face_position = 0, edge_position = 0;
+    for (std::size_t i = 0; i < n_elements; i++)
+    {
+        CElem* elem = mesh->ele_vector[i];
+        if (elem->GetElementType() == MshElemType::INVALID)
+            continue;
+        const std::size_t n_faces = elem->GetFacesNumber();
+        for (std::size_t k = 0; k < n_faces; k++)
+        {
+            const int64_t e = element_neighbors[face_position++];
+            neighbors[k] = (e < 0) ? NULL : mesh->ele_vector[e];
+        }
+        elem->SetNeighbors(neighbors);
+        const std::size_t n_edges = elem->GetEdgesNumber();
+        for (std::size_t k = 0; k < n_edges; k++)
+        {
+            edges[k] = mesh->edge_vector[element_edges[edge_position]];
+            orientation[k] =
+                static_cast<int>(element_edge_orientation[edge_position]);
+            edge_position++;
+        }
+        elem->SetEdgesOrientation(orientation);
+        elem->SetEdges(edges);
+    }
+
+    mesh->_node_elements_ptr.assign(node_element_ptr,
+                                    node_element_ptr + n_nodes + 1);
+    mesh->_node_elements.assign(node_elements,
+                                node_elements + header.n_connected_elements);
+    mesh->_node_nodes_ptr.assign(node_node_ptr, node_node_ptr + n_nodes + 1);
+    mesh->_node_nodes.assign(node_nodes,
+                             node_nodes + header.n_connected_nodes);
+    mesh->UpdateNodeAdjacencyViews();
+    mesh->_has_file_topology = true;
+    return mesh;
+}
+
+bool OGSMeshIOBinary::write(const std::string& file_name,
+                            const std::vector<MeshLib::CFEMesh*>& mesh_vec,
+                            const bool with_topology)
+{
+    std::ofstream os(file_name.c_str(), std::ios::binary | std::ios::trunc);
+    if (!os.good())
+        return false;
+
+    os.write(MESH_FILE_MAGIC, sizeof(MESH_FILE_MAGIC));
+    const uint32_t version = VERSION;
+    os.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    os.write(reinterpret_cast<const char*>(&MESH_FILE_BYTE_ORDER),
+             sizeof(MESH_FILE_BYTE_ORDER));
+    const int64_t n_meshes = mesh_vec.size();
+    os.write(reinterpret_cast<const char*>(&n_meshes), sizeof(n_meshes));
+
+    for (std::size_t m = 0; m < mesh_vec.size(); m++)
+    {
+        // Deferred edges are part of the topology
+        if (with_topology)
+            mesh_vec[m]->ConstructEdges();
+        if (!writeMesh(os, *mesh_vec[m], with_topology))
+            return false;
+    }
+    return os.good();
+}
+
+bool OGSMeshIOBinary::writeMesh(std::ostream& os,
+                                const MeshLib::CFEMesh& mesh,
+                                const bool with_topology)
+{
+    using MeshLib::CElem;
+    using MeshLib::CNode;
+
+    const std::size_t n_nodes = mesh.nod_vector.size();
+    const std::size_t n_elements = mesh.ele_vector.size();
+
+    MeshHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.n_nodes = n_nodes;
+    header.n_elements = n_elements;
+    header.axisymmetry = mesh._axisymmetry;
+    header.cross_section = mesh._cross_section;
+    header.n_msh_layer = mesh._n_msh_layer;
+    header.pcs_name_length = mesh.pcs_name.size();
+    header.geo_name_length = mesh.geo_name.size();
+    header.geo_type_name_length = mesh.geo_type_name.size();
+
+    std::vector<int64_t> node_ids(n_nodes);
+    std::vector<double> node_xyz(3 * n_nodes), node_area(n_nodes);
+    for (std::size_t i = 0; i < n_nodes; i++)
+    {
+        const CNode* node = mesh.nod_vector[i];
+        node_ids[i] = node->GetIndex();
+        for (int d = 0; d < 3; d++)
+            node_xyz[3 * i + d] = node->getData()[d];
+        node_area[i] = node->patch_area;
+    }
+
+    std::vector<int64_t> element_ids(n_elements), element_types(n_elements),
+        element_patches(n_elements), element_node_ptr(n_elements + 1, 0),
+        element_nodes;
+    for (std::size_t i = 0; i < n_elements; i++)
+    {
+        const CElem* elem = mesh.ele_vector[i];
+        element_ids[i] = elem->GetIndex();
+        element_types[i] = elem->GetElementType();
+        element_patches[i] = elem->GetPatchIndex();
+        if (elem->GetElementType() != MshElemType::INVALID)
+            for (int k = 0; k < elem->GetVertexNumber(); k++)
+                element_nodes.push_back(elem->GetNodeIndex(k));
+        element_node_ptr[i + 1] = element_nodes.size();
+    }
+    header.n_element_nodes = element_nodes.size();
+
+    // Topology, with the element neighbors before ConstructGrid() replaced
+    // the missing ones by the faces on the surface
+    std::vector<int64_t> edge_nodes, element_neighbors, element_edges,
+        element_edge_orientation, node_element_ptr, node_elements,
+        node_node_ptr, node_nodes;
+    if (with_topology && !mesh.edge_vector.empty())
+    {
+        header.has_topology = 1;
+        header.n_edges = mesh.edge_vector.size();
+        std::map<const CElem*, int64_t> element_positions;
+        for (std::size_t i = 0; i < n_elements; i++)
+            element_positions[mesh.ele_vector[i]] = i;
+        for (std::size_t i = 0; i < mesh.edge_vector.size(); i++)
+        {
+            MeshLib::CEdge* edge = mesh.edge_vector[i];
+            if (edge->GetIndex() != i || edge->GetNode(2))
+                return false;
+            edge_nodes.push_back(edge->GetNode(0)->GetIndex());
+            edge_nodes.push_back(edge->GetNode(1)->GetIndex());
+        }
+        for (std::size_t i = 0; i < n_elements; i++)
+        {
+            CElem* elem = mesh.ele_vector[i];
+            if (elem->GetElementType() == MshElemType::INVALID)
+                continue;
+            for (std::size_t k = 0; k < elem->GetFacesNumber(); k++)
+            {
+                std::map<const CElem*, int64_t>::const_iterator it =
+                    element_positions.find(elem->GetNeighbor(k));
+                element_neighbors.push_back(
+                    it == element_positions.end() ? -1 : it->second);
+            }
+            for (std::size_t k = 0; k < elem->GetEdgesNumber(); k++)
+            {
+                element_edges.push_back(elem->GetEdge(k)->GetIndex());
+                element_edge_orientation.push_back(
+                    elem->GetEdgeOrientation(k));
+            }
+        }
+        node_element_ptr.push_back(0);
+        node_node_ptr.push_back(0);
+        for (std::size_t i = 0; i < n_nodes; i++)
+        {
+            const CNode* node = mesh.nod_vector[i];
+            node_elements.insert(node_elements.end(),
+                                 node->getConnectedElementIDs().begin(),
+                                 node->getConnectedElementIDs().end());
+            node_nodes.insert(node_nodes.end(),
+                              node->getConnectedNodes().begin(),
+                              node->getConnectedNodes().end());
+            node_element_ptr.push_back(node_elements.size());
+            node_node_ptr.push_back(node_nodes.size());
+        }
+        header.n_element_faces = element_neighbors.size();
+        header.n_element_edges = element_edges.size();
+        header.n_connected_elements = node_elements.size();
+        header.n_connected_nodes = node_nodes.size();
+    }
+
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeArray(os, mesh.pcs_name.data(), mesh.pcs_name.size());
+    writeArray(os, mesh.geo_name.data(), mesh.geo_name.size());
+    writeArray(os, mesh.geo_type_name.data(), mesh.geo_type_name.size());
+    writeArray(os, node_ids);
+    writeArray(os, node_xyz);
+    writeArray(os, node_area);
+    writeArray(os, element_ids);
+    writeArray(os, element_types);
+    writeArray(os, element_patches);
+    writeArray(os, element_node_ptr);
+    writeArray(os, element_nodes);
+    if (header.has_topology)
+    {
+        writeArray(os, edge_nodes);
+        writeArray(os, element_neighbors);
+        writeArray(os, element_edges);
+        writeArray(os, element_edge_orientation);
+        writeArray(os, node_element_ptr);
+        writeArray(os, node_elements);
+        writeArray(os, node_node_ptr);
+        writeArray(os, node_nodes);
+    }
+    return os.good();
+}
+}  // namespace FileIO
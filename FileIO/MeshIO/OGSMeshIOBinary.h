@@ -0,0 +1,103 @@
+/*
+ * OGSMeshIOBinary.h
+ *
+ * Binary OGS mesh files, which are mapped into memory and read without
+ * parsing.
+ *
+ *  Created on: Oct 18, 2026
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ */
+
+#ifndef OGS_MESHIO_BINARY_H
+#define OGS_MESHIO_BINARY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace GEOLIB
+{
+class GEOObjects;
+}
+
+namespace MeshLib
+{
+class CFEMesh;
+}
+
+namespace FileIO
+{
+/*!
+   \brief Reader and writer of binary mesh files (*.msb).
+
+   A file holds the meshes of an ASCII *.msh file: the nodes, the elements
+   with their material groups and, optionally, the topology that
+   CFEMesh::ConstructGrid() derives from them, i.e. the neighbors and the
+   edges of the elements and the elements and nodes connected to the
+   nodes. A mesh read with the topology skips its search in
+   ConstructGrid().
+
+   All numbers are 64 bit integers or doubles in the byte order of the
+   machine that wrote the file, each array aligned to 8 bytes. A file
+   starts with
+
+      char[8] "OGSMSHB", uint32 version, uint32 byte order mark,
+      int64 number of meshes
+
+   followed by the meshes. A mesh starts with the header of
+   OGSMeshIOBinary::MeshHeader, followed by the arrays in the order of its
+   counts. Files of another version or byte order are rejected, and the
+   caller falls back to the ASCII file.
+ */
+class OGSMeshIOBinary
+{
+public:
+    /// Version of the layout, to be increased with each change of it
+    static const unsigned VERSION = 1;
+
+    /// Name of the binary mesh file of a project
+    static std::string getFileName(const std::string& file_base_name);
+
+    /// Whether the binary file exists and is not older than the ASCII file
+    static bool isUpToDate(const std::string& binary_file_name,
+                           const std::string& ascii_file_name);
+
+    /**
+     * Reads all meshes of a binary file.
+     * @return false if the file cannot be read or is not a valid binary
+     * mesh file of this version. No mesh is added to mesh_vec then.
+     */
+    bool read(const std::string& file_name,
+              std::vector<MeshLib::CFEMesh*>& mesh_vec,
+              GEOLIB::GEOObjects* geo_obj = NULL,
+              std::string* unique_name = NULL);
+
+    /**
+     * Writes the meshes to a binary file. The topology can only be
+     * written for meshes after CFEMesh::ConstructGrid() and before the
+     * generation of the quadratic nodes. Deferred edges are built before
+     * the topology is written.
+     */
+    bool write(const std::string& file_name,
+               const std::vector<MeshLib::CFEMesh*>& mesh_vec,
+               bool with_topology);
+
+private:
+    struct MeshHeader;
+
+    /// Size of a mesh in the file, with the header
+    static std::size_t getMeshSize(const MeshHeader& header);
+    /// Mesh from the data of a file, NULL if it is not valid
+    static MeshLib::CFEMesh* readMesh(const char* data, std::size_t size,
+                                      GEOLIB::GEOObjects* geo_obj,
+                                      std::string* unique_name);
+    static bool writeMesh(std::ostream& os, const MeshLib::CFEMesh& mesh,
+                          bool with_topology);
+};
+}  // namespace FileIO
+
+#endif
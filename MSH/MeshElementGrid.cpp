@@ -0,0 +1,386 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file MeshElementGrid.cpp
+ * Uniform grid of buckets over the elements of a mesh for the search of
+ * elements by points, boxes and segments.
+ */
+
+#include "MeshElementGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "msh_elem.h"
+#include "msh_node.h"
+
+namespace MeshLib
+{
+/// Widening of the bounding boxes relative to their diagonal. The test of
+/// line elements accepts points with a distance of about 3e-5 of the
+/// length to the line.
+static const double ELEMENT_BOX_MARGIN = 1.0e-4;
+
+/// Whether the segment from a to b intersects the box [lo, hi] (slabs)
+static bool segmentIntersectsBox(const double* a, const double* b,
+                                 const double* lo, const double* hi)
+{
+    double t_min = 0.0, t_max = 1.0;
+    for (int d = 0; d < 3; d++)
+    {
+        const double dir = b[d] - a[d];
+        if (dir == 0.0)
+        {
+            if (a[d] < lo[d] || a[d] > hi[d])
+                return false;
+            continue;
+        }
+        double t1 = (lo[d] - a[d]) / dir;
+        double t2 = (hi[d] - a[d]) / dir;
+        if (t1 > t2)
+            std::swap(t1, t2);
+        t_min = std::max(t_min, t1);
+        t_max = std::min(t_max, t2);
+        if (t_min > t_max)
+            return false;
+    }
+    return true;
+}
+
+MeshElementGrid::MeshElementGrid(const std::vector<CElem*>& elements)
+    : n_elements(elements.size()), min_cell_size(0.0)
+{
+    boxes.resize(6 * n_elements);
+    centers.resize(3 * n_elements);
+    for (int d = 0; d < 3; d++)
+    {
+        origin[d] = upper[d] = 0.0;
+        cell_size[d] = 1.0;
+        n_cells[d] = 1;
+    }
+
+    // Bounds of the nodes, which tell the directions without an extent
+    double node_lo[3] = {0.0, 0.0, 0.0}, node_hi[3] = {0.0, 0.0, 0.0};
+    for (std::size_t e = 0; e < n_elements; e++)
+    {
+        CElem* elem = elements[e];
+        double* lo = &boxes[6 * e];
+        double* hi = lo + 3;
+        for (std::size_t i = 0; i < elem->GetNodesNumber(false); i++)
+        {
+            double const* x = elem->GetNode(i)->getData();
+            for (int d = 0; d < 3; d++)
+            {
+                if (i == 0 || x[d] < lo[d])
+                    lo[d] = x[d];
+                if (i == 0 || x[d] > hi[d])
+                    hi[d] = x[d];
+            }
+        }
+        double diagonal = 0.0;
+        for (int d = 0; d < 3; d++)
+            diagonal += (hi[d] - lo[d]) * (hi[d] - lo[d]);
+        const double margin = ELEMENT_BOX_MARGIN * std::sqrt(diagonal);
+        double const* center = elem->GetGravityCenter();
+        for (int d = 0; d < 3; d++)
+        {
+            if (e == 0 || lo[d] < node_lo[d])
+                node_lo[d] = lo[d];
+            if (e == 0 || hi[d] > node_hi[d])
+                node_hi[d] = hi[d];
+            lo[d] -= margin;
+            hi[d] += margin;
+            centers[3 * e + d] = center[d];
+            if (e == 0 || lo[d] < origin[d])
+                origin[d] = lo[d];
+            if (e == 0 || hi[d] > upper[d])
+                upper[d] = hi[d];
+        }
+    }
+
+    // About one element per cell. Directions whose extent is smaller than
+    // the cell size, e.g. z of a 2D mesh, have one cell.
+    bool has_extent[3] = {true, true, true};
+    double h = 0.0;
+    for (int dim = 3; dim > 0 && n_elements > 0;)
+    {
+        double volume = 1.0;
+        for (int d = 0; d < 3; d++)
+            if (has_extent[d])
+                volume *= node_hi[d] - node_lo[d];
+        h = std::pow(volume / n_elements, 1.0 / dim);
+        const int old_dim = dim;
+        for (int d = 0; d < 3; d++)
+            if (has_extent[d] && !(node_hi[d] - node_lo[d] > h))
+            {
+                has_extent[d] = false;
+                dim--;
+            }
+        if (dim == old_dim)
+            break;
+        if (dim == 0)
+            h = 0.0;
+    }
+    for (int d = 0; d < 3; d++)
+    {
+        if (!(h > 0.0) || !has_extent[d])
+            continue;
+        const double extent = upper[d] - origin[d];
+        n_cells[d] = std::max(
+            1L, std::min(static_cast<long>(std::ceil(extent / h)),
+                         static_cast<long>(n_elements)));
+        cell_size[d] = extent / n_cells[d];
+        if (n_cells[d] > 1 &&
+            (min_cell_size == 0.0 || cell_size[d] < min_cell_size))
+            min_cell_size = cell_size[d];
+    }
+
+    // Buckets in compressed rows: count, then fill in the order of the
+    // elements
+    const long n_all_cells = n_cells[0] * n_cells[1] * n_cells[2];
+    box_ptr.assign(n_all_cells + 1, 0);
+    center_ptr.assign(n_all_cells + 1, 0);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        std::vector<long> box_pos, center_pos;
+        if (pass == 1)
+        {
+            for (long c = 0; c < n_all_cells; c++)
+            {
+                box_ptr[c + 1] += box_ptr[c];
+                center_ptr[c + 1] += center_ptr[c];
+            }
+            box_elements.resize(box_ptr[n_all_cells]);
+            center_elements.resize(center_ptr[n_all_cells]);
+            box_pos.assign(box_ptr.begin(), box_ptr.end() - 1);
+            center_pos.assign(center_ptr.begin(), center_ptr.end() - 1);
+        }
+        for (std::size_t e = 0; e < n_elements; e++)
+        {
+            long ijk_lo[3], ijk_hi[3], ijk[3];
+            getCellIndices(&boxes[6 * e], ijk_lo);
+            getCellIndices(&boxes[6 * e + 3], ijk_hi);
+            for (ijk[2] = ijk_lo[2]; ijk[2] <= ijk_hi[2]; ijk[2]++)
+                for (ijk[1] = ijk_lo[1]; ijk[1] <= ijk_hi[1]; ijk[1]++)
+                    for (ijk[0] = ijk_lo[0]; ijk[0] <= ijk_hi[0]; ijk[0]++)
+                    {
+                        const long c = getCell(ijk);
+                        if (pass == 0)
+                            box_ptr[c + 1]++;
+                        else
+                            box_elements[box_pos[c]++] = e;
+                    }
+            getCellIndices(&centers[3 * e], ijk);
+            const long c = getCell(ijk);
+            if (pass == 0)
+                center_ptr[c + 1]++;
+            else
+                center_elements[center_pos[c]++] = e;
+        }
+    }
+}
+
+void MeshElementGrid::getCellIndices(const double* xyz, long* ijk) const
+{
+    for (int d = 0; d < 3; d++)
+    {
+        const long i =
+            static_cast<long>(std::floor((xyz[d] - origin[d]) / cell_size[d]));
+        ijk[d] = std::max(0L, std::min(i, n_cells[d] - 1));
+    }
+}
+
+bool MeshElementGrid::isInGrid(const double* xyz) const
+{
+    for (int d = 0; d < 3; d++)
+        if (xyz[d] < origin[d] || xyz[d] > upper[d])
+            return false;
+    return n_elements > 0;
+}
+
+void MeshElementGrid::getElementsAtPoint(const double* xyz,
+                                         std::vector<long>& elements) const
+{
+    elements.clear();
+    if (!isInGrid(xyz))
+        return;
+    long ijk[3];
+    getCellIndices(xyz, ijk);
+    const long c = getCell(ijk);
+    for (long k = box_ptr[c]; k < box_ptr[c + 1]; k++)
+    {
+        const long e = box_elements[k];
+        double const* lo = &boxes[6 * e];
+        double const* hi = lo + 3;
+        if (xyz[0] >= lo[0] && xyz[0] <= hi[0] && xyz[1] >= lo[1] &&
+            xyz[1] <= hi[1] && xyz[2] >= lo[2] && xyz[2] <= hi[2])
+            elements.push_back(e);
+    }
+}
+
+void MeshElementGrid::searchShell(
+    const double* xyz, const long* ijk, const long r, const std::size_t k,
+    std::vector<std::pair<double, long> >& nearest) const
+{
+    long c_ijk[3];
+    for (c_ijk[2] = std::max(0L, ijk[2] - r);
+         c_ijk[2] <= std::min(n_cells[2] - 1, ijk[2] + r); c_ijk[2]++)
+        for (c_ijk[1] = std::max(0L, ijk[1] - r);
+             c_ijk[1] <= std::min(n_cells[1] - 1, ijk[1] + r); c_ijk[1]++)
+        {
+            const bool inner = std::abs(c_ijk[2] - ijk[2]) < r &&
+                               std::abs(c_ijk[1] - ijk[1]) < r;
+            // Inside the shell, only the first and the last cell of a row
+            const long step = (inner && r > 0) ? 2 * r : 1;
+            for (c_ijk[0] = ijk[0] - r; c_ijk[0] <= ijk[0] + r;
+                 c_ijk[0] += step)
+            {
+                if (c_ijk[0] < 0 || c_ijk[0] >= n_cells[0])
+                    continue;
+                const long c = getCell(c_ijk);
+                for (long l = center_ptr[c]; l < center_ptr[c + 1]; l++)
+                {
+                    const long e = center_elements[l];
+                    double const* x = &centers[3 * e];
+                    const std::pair<double, long> candidate(
+                        (x[0] - xyz[0]) * (x[0] - xyz[0]) +
+                            (x[1] - xyz[1]) * (x[1] - xyz[1]) +
+                            (x[2] - xyz[2]) * (x[2] - xyz[2]),
+                        e);
+                    if (nearest.size() == k && !(candidate < nearest.back()))
+                        continue;
+                    nearest.insert(std::lower_bound(nearest.begin(),
+                                                    nearest.end(), candidate),
+                                   candidate);
+                    if (nearest.size() > k)
+                        nearest.pop_back();
+                }
+            }
+        }
+}
+
+void MeshElementGrid::getNearestElements(const double* xyz,
+                                         const std::size_t k,
+                                         std::vector<long>& elements) const
+{
+    elements.clear();
+    if (n_elements == 0 || k == 0)
+        return;
+
+    std::vector<std::pair<double, long> > nearest;
+    long ijk[3];
+    getCellIndices(xyz, ijk);
+    const long r_max = std::max(n_cells[0], std::max(n_cells[1], n_cells[2]));
+    for (long r = 0; r < r_max; r++)
+    {
+        searchShell(xyz, ijk, r, k, nearest);
+        // The cells beyond the shell r are at least r cells away
+        const double bound = r * min_cell_size;
+        if (nearest.size() == k && nearest.back().first < bound * bound)
+            break;
+    }
+    for (std::size_t i = 0; i < nearest.size(); i++)
+        elements.push_back(nearest[i].second);
+}
+
+long MeshElementGrid::getNearestElement(const double* xyz) const
+{
+    std::vector<long> elements;
+    getNearestElements(xyz, 1, elements);
+    if (elements.empty())
+        return -1;
+    return elements[0];
+}
+
+void MeshElementGrid::getElementsInBox(const double* x_min,
+                                       const double* x_max,
+                                       std::vector<long>& elements) const
+{
+    elements.clear();
+    for (int d = 0; d < 3; d++)
+        if (x_max[d] < origin[d] || x_min[d] > upper[d])
+            return;
+    if (n_elements == 0)
+        return;
+
+    long ijk_lo[3], ijk_hi[3], ijk[3];
+    getCellIndices(x_min, ijk_lo);
+    getCellIndices(x_max, ijk_hi);
+    for (ijk[2] = ijk_lo[2]; ijk[2] <= ijk_hi[2]; ijk[2]++)
+        for (ijk[1] = ijk_lo[1]; ijk[1] <= ijk_hi[1]; ijk[1]++)
+            for (ijk[0] = ijk_lo[0]; ijk[0] <= ijk_hi[0]; ijk[0]++)
+            {
+                const long c = getCell(ijk);
+                for (long k = box_ptr[c]; k < box_ptr[c + 1]; k++)
+                {
+                    const long e = box_elements[k];
+                    double const* lo = &boxes[6 * e];
+                    double const* hi = lo + 3;
+                    if (lo[0] <= x_max[0] && hi[0] >= x_min[0] &&
+                        lo[1] <= x_max[1] && hi[1] >= x_min[1] &&
+                        lo[2] <= x_max[2] && hi[2] >= x_min[2])
+                        elements.push_back(e);
+                }
+            }
+    std::sort(elements.begin(), elements.end());
+    elements.erase(std::unique(elements.begin(), elements.end()),
+                   elements.end());
+}
+
+void MeshElementGrid::getElementsOnSegment(const double* a, const double* b,
+                                           std::vector<long>& elements) const
+{
+    elements.clear();
+    double x_min[3], x_max[3];
+    for (int d = 0; d < 3; d++)
+    {
+        x_min[d] = std::min(a[d], b[d]);
+        x_max[d] = std::max(a[d], b[d]);
+        if (x_max[d] < origin[d] || x_min[d] > upper[d])
+            return;
+    }
+    if (n_elements == 0)
+        return;
+
+    long ijk_lo[3], ijk_hi[3], ijk[3];
+    getCellIndices(x_min, ijk_lo);
+    getCellIndices(x_max, ijk_hi);
+    for (ijk[2] = ijk_lo[2]; ijk[2] <= ijk_hi[2]; ijk[2]++)
+        for (ijk[1] = ijk_lo[1]; ijk[1] <= ijk_hi[1]; ijk[1]++)
+            for (ijk[0] = ijk_lo[0]; ijk[0] <= ijk_hi[0]; ijk[0]++)
+            {
+                // Skip the cells of the box of the segment that the segment
+                // does not pass. The outer cells reach to the grid bounds.
+                double cell_lo[3], cell_hi[3];
+                for (int d = 0; d < 3; d++)
+                {
+                    cell_lo[d] = (ijk[d] == 0) ? origin[d]
+                                               : origin[d] + ijk[d] * cell_size[d];
+                    cell_hi[d] = (ijk[d] == n_cells[d] - 1)
+                                     ? upper[d]
+                                     : origin[d] + (ijk[d] + 1) * cell_size[d];
+                }
+                if (!segmentIntersectsBox(a, b, cell_lo, cell_hi))
+                    continue;
+                const long c = getCell(ijk);
+                for (long k = box_ptr[c]; k < box_ptr[c + 1]; k++)
+                {
+                    const long e = box_elements[k];
+                    if (segmentIntersectsBox(a, b, &boxes[6 * e],
+                                             &boxes[6 * e + 3]))
+                        elements.push_back(e);
+                }
+            }
+    std::sort(elements.begin(), elements.end());
+    elements.erase(std::unique(elements.begin(), elements.end()),
+                   elements.end());
+}
+}  // namespace MeshLib
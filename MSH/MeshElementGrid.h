@@ -0,0 +1,108 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file MeshElementGrid.h
+ * Uniform grid of buckets over the elements of a mesh for the search of
+ * elements by points, boxes and segments.
+ */
+
+#ifndef OGS_MESHELEMENTGRID_H
+#define OGS_MESHELEMENTGRID_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace MeshLib
+{
+class CElem;
+
+/*!
+   \brief Buckets of the elements in the cells of a uniform grid over the
+   bounding box of a mesh.
+
+   The cells have about one element each. An element is kept in all cells
+   that its bounding box overlaps (box buckets), and in the cell of its
+   gravity center (center buckets). Both are stored in compressed rows,
+   with ascending element indices in each cell.
+
+   The bounding boxes are widened a little, so that the box buckets
+   contain all elements that the tolerant point-in-element tests of
+   CFEMesh accept. The element lists of the queries are ascending, so that
+   the first element of a list that passes a test is the one that a
+   search over all elements would find.
+
+   The coordinates are copied when the grid is built. If the nodes move,
+   the grid has to be built again (CFEMesh::InvalidateElementGrid()).
+ */
+class MeshElementGrid
+{
+public:
+    explicit MeshElementGrid(const std::vector<CElem*>& elements);
+
+    std::size_t getNumberOfElements() const { return n_elements; }
+
+    /// Elements whose bounding box contains the point
+    void getElementsAtPoint(const double* xyz,
+                            std::vector<long>& elements) const;
+
+    /// Element with the nearest gravity center, the one with the smallest
+    /// index if several are equally near, -1 for an empty mesh
+    long getNearestElement(const double* xyz) const;
+
+    /// The k elements with the nearest gravity centers, sorted by the
+    /// distance
+    void getNearestElements(const double* xyz, const std::size_t k,
+                            std::vector<long>& elements) const;
+
+    /// Elements whose bounding box intersects the box [x_min, x_max]
+    void getElementsInBox(const double* x_min, const double* x_max,
+                          std::vector<long>& elements) const;
+
+    /// Elements whose bounding box intersects the segment from a to b,
+    /// e.g. the path of a particle within a time step
+    void getElementsOnSegment(const double* a, const double* b,
+                              std::vector<long>& elements) const;
+
+private:
+    std::size_t n_elements;
+    /// Lower and upper corner of the grid
+    double origin[3];
+    double upper[3];
+    double cell_size[3];
+    long n_cells[3];
+    /// Smallest cell size of the directions with more than one cell
+    double min_cell_size;
+
+    /// [6 * e]: lower and upper corner of the widened bounding box
+    std::vector<double> boxes;
+    /// [3 * e]: gravity center
+    std::vector<double> centers;
+
+    std::vector<long> box_ptr;
+    std::vector<long> box_elements;
+    std::vector<long> center_ptr;
+    std::vector<long> center_elements;
+
+    long getCell(const long* ijk) const
+    {
+        return (ijk[2] * n_cells[1] + ijk[1]) * n_cells[0] + ijk[0];
+    }
+    /// Cell indices of a point, clamped to the grid
+    void getCellIndices(const double* xyz, long* ijk) const;
+    bool isInGrid(const double* xyz) const;
+    /// Center buckets of the cells with the Chebyshev distance r to the
+    /// cell ijk, added to the sorted list of the k nearest elements
+    void searchShell(const double* xyz, const long* ijk, const long r,
+                     const std::size_t k,
+                     std::vector<std::pair<double, long> >& nearest) const;
+};
+}  // namespace MeshLib
+#endif
@@ -55,7 +55,9 @@ public:
     void SetBoundaryType(char type) { boundary_type = type; }
     char GetBoundaryType() const { return boundary_type; }  // 18.02.2009. WW
     void SetOrder(bool order) { quadratic = order; }
-    void SetMark(bool state) { mark = state; }
+    /// Virtual, so that CElem counts the changes of its mark also if it is
+    /// set through a pointer to CCore
+    virtual void SetMark(bool state) { mark = state; }
     void SetIndex(size_t lvalue) { index = lvalue; }  // OK
     // Output
     virtual void Write(std::ostream& os = std::cout) const { os << "\n"; }
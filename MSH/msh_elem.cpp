@@ -25,6 +25,8 @@
 
 namespace MeshLib
 {
+unsigned long CElem::mark_changes = 0;
+
 /**************************************************************************
    MSHLib-Method:
    Task:
@@ -97,9 +99,8 @@ CElem::CElem() : CCore(0), normal_vector(NULL)
 CElem::CElem(size_t Index, CElem* onwer, int Face)
     : CCore(Index), normal_vector(NULL), owner(onwer)
 {
-    int i, j, k, n, ne;
+    int i, n;
     int faceIndex_loc[10];
-    int edgeIndex_loc[10] = {};
     no_faces_on_surface = 0;
     n = owner->GetElementFaceNodes(Face, faceIndex_loc);
     face_index = Face;
@@ -156,31 +157,9 @@ CElem::CElem(size_t Index, CElem* onwer, int Face)
             (nodes[i]->GetBoundaryType() != '1'))
             nodes[i]->SetBoundaryType('B');
     }
-    // Face edges
-    ne = owner->GetEdgesNumber();
-    edges.resize(nnodes);
-    edges_orientation.resize(nnodes);
-    edges_orientation = 1;
-    for (i = 0; i < nnodes; i++)
-    {
-        k = (i + 1) % nnodes;
-        for (j = 0; j < ne; j++)
-        {
-            owner->GetLocalIndicesOfEdgeNodes(j, edgeIndex_loc);
-            if ((faceIndex_loc[i] == edgeIndex_loc[0] &&
-                 faceIndex_loc[k] == edgeIndex_loc[1]) ||
-                (faceIndex_loc[i] == edgeIndex_loc[1] &&
-                 faceIndex_loc[k] == edgeIndex_loc[0]))
-            {
-                edges[i] = owner->edges[j];
-                if (faceIndex_loc[i] == edgeIndex_loc[1] &&
-                    faceIndex_loc[k] == edgeIndex_loc[0])
-                    edges_orientation[i] = -1;
-                edges[i]->boundary_type = 'B';
-                break;
-            }
-        }
-    }
+    // Face edges, later if the edges of the owner are deferred
+    if (owner->HasEdges())
+        SetFaceEdges();
 
 #if defined(USE_PETSC)  // || defined(using other parallel scheme). WW
     g_index = NULL;
@@ -815,12 +794,20 @@ void CElem::Read(std::istream& is, int fileType)
     }
 }
 
-void CElem::InitializeMembers()
+void CElem::InitializeMembers(bool with_edges)
 {
     // Initialize topological properties
     neighbors.resize(nfaces);
     for (size_t i = 0; i < nfaces; i++)
         neighbors[i] = NULL;
+    if (with_edges)
+        InitializeEdges();
+    else
+        FreeEdgeMemory();
+}
+
+void CElem::InitializeEdges()
+{
     edges.resize(nedges);
     edges_orientation.resize(nedges);
     for (size_t i = 0; i < nedges; i++)
@@ -830,6 +817,42 @@ void CElem::InitializeMembers()
     }
 }
 
+/**************************************************************************
+   MSHLib-Method:
+   Task: Edges of a face element, i.e. the edges of the owner between
+   the vertices of the face, which are marked as boundary edges
+**************************************************************************/
+void CElem::SetFaceEdges()
+{
+    int faceIndex_loc[10];
+    int edgeIndex_loc[10] = {};
+    owner->GetElementFaceNodes(face_index, faceIndex_loc);
+    const int ne = owner->GetEdgesNumber();
+    edges.resize(nnodes);
+    edges_orientation.resize(nnodes);
+    edges_orientation = 1;
+    for (int i = 0; i < nnodes; i++)
+    {
+        const int k = (i + 1) % nnodes;
+        for (int j = 0; j < ne; j++)
+        {
+            owner->GetLocalIndicesOfEdgeNodes(j, edgeIndex_loc);
+            if ((faceIndex_loc[i] == edgeIndex_loc[0] &&
+                 faceIndex_loc[k] == edgeIndex_loc[1]) ||
+                (faceIndex_loc[i] == edgeIndex_loc[1] &&
+                 faceIndex_loc[k] == edgeIndex_loc[0]))
+            {
+                edges[i] = owner->edges[j];
+                if (faceIndex_loc[i] == edgeIndex_loc[1] &&
+                    faceIndex_loc[k] == edgeIndex_loc[0])
+                    edges_orientation[i] = -1;
+                edges[i]->boundary_type = 'B';
+                break;
+            }
+        }
+    }
+}
+
 /**************************************************************************
    MSHLib-Method:
    Task:
@@ -920,6 +943,13 @@ void CElem::WriteNeighbors(std::ostream& os) const
 **************************************************************************/
 void CElem::MarkingAll(bool makop)
 {
+    if (makop != mark)
+    {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        mark_changes++;
+    }
     this->mark = makop;
     int SizeV = nnodes;
     if (quadratic)
@@ -137,6 +137,23 @@ public:
     MshElemType::type GetElementType() const { return geo_type; }
     void SetElementType(MshElemType::type type) { geo_type = type; }
     void MarkingAll(bool makop);
+    /// Mark the element only, e.g. as active, but not its nodes and edges
+    virtual void SetMark(bool state)
+    {
+        if (state != mark)
+        {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+            mark_changes++;
+        }
+        mark = state;
+    }
+    /// Number of changes of the marks of all elements. The lists of the
+    /// active elements of the processes are rebuilt if it changes. Marks
+    /// may be set in a parallel loop, but the counter must be read outside
+    /// of parallel regions, i.e. after all marks of a loop are set.
+    static unsigned long getMarkChanges() { return mark_changes; }
     std::string GetName() const;
     //------------------------------------------------------------------
     // Nodes
@@ -190,8 +207,8 @@ public:
     int GetVertexNumber() const { return nnodes; }
     void SetNodesNumber(int ivalue) { nnodes = ivalue; }  // OK
     CElem* GetOwner() const { return owner; }             // YD
-    // Initialize topological properties
-    void InitializeMembers();
+    // Initialize topological properties, the edges only if with_edges
+    void InitializeMembers(bool with_edges = true);
     //------------------------------------------------------------------
     // Edges
     void GetEdges(Math_Group::vec<CEdge*>& ele_edges)
@@ -212,11 +229,21 @@ public:
         for (size_t i = 0; i < nedges; i++)
             edges_orientation[i] = ori_edg[i];
     }
+    int GetEdgeOrientation(int index) const
+    {
+        return edges_orientation[index];
+    }
     void FreeEdgeMemory()  // 09.2012. WW
     {
         edges.resize(0);
         edges_orientation.resize(0);
     }
+    /// Whether the edges are allocated, see CFEMesh::ConstructEdges()
+    bool HasEdges() const { return edges.Size() > 0; }
+    /// Allocate the deferred edges, before they are set
+    void InitializeEdges();
+    /// Edges of a face element from the edges of its owner
+    void SetFaceEdges();
     void GetLocalIndicesOfEdgeNodes(const int Edge, int* EdgeNodes);
     size_t GetEdgesNumber() const { return nedges; }
     //------------------------------------------------------------------
@@ -357,6 +384,7 @@ private:
     // WW double MatT[9];
 
     int excavated;  // WX:01.2011 excavation state
+    static unsigned long mark_changes;
 
     // -- Methods
     int GetElementFaces1D(int* FaceNode);
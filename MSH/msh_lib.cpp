@@ -72,11 +72,28 @@ void FEMDeleteAll()
    09/2011 TF changed signature of function in order to read more than one mesh
 **************************************************************************/
 void FEMRead(const std::string& file_base_name, std::vector<CFEMesh*>& mesh_vec,
-             GEOLIB::GEOObjects* geo_obj, std::string* unique_name)
+             GEOLIB::GEOObjects* geo_obj, std::string* unique_name,
+             bool use_binary)
 {
     CFEMesh* mesh(NULL);
     std::string msh_file_name(file_base_name + FEM_FILE_EXTENSION);
 
+    const std::string bin_file_name(
+        FileIO::OGSMeshIOBinary::getFileName(file_base_name));
+    if (use_binary &&
+        FileIO::OGSMeshIOBinary::isUpToDate(bin_file_name, msh_file_name))
+    {
+        FileIO::OGSMeshIOBinary meshIO;
+        if (meshIO.read(bin_file_name, mesh_vec, geo_obj, unique_name))
+        {
+            Display::ScreenMessage("MSHRead:  binary file\n");
+            return;
+        }
+        Display::ScreenMessage(
+            "MSHRead:  %s is not a valid binary mesh file of version %u\n",
+            bin_file_name.c_str(), FileIO::OGSMeshIOBinary::VERSION);
+    }
+
     std::ifstream msh_file_ascii(msh_file_name.data(), std::ios::in);
     if (!msh_file_ascii.is_open())
         std::cout << "CFEMesh::FEMRead() - Could not open file...\n";
@@ -789,6 +806,9 @@ void MSHMoveNODUcFlow(CRFProcess* m_pcs)
             strang = (long*)Free(strang);
         } /*endif index ==1 */
           /* end for Schleife �ber alle Knoten */
+
+    // The elements have moved
+    m_pcs->m_msh->InvalidateElementGrid();
 }
 
 /**************************************************************************
@@ -33,11 +33,14 @@ extern MeshLib::CFEMesh* FEMGet(const std::string& msh_name);
  * @param mesh_vec a vector, the new mesh will be put in this vector
  * @param geo_obj object, that manages the geometric entities
  * @param unique_name the name of geometric data
+ * @param use_binary read the binary mesh file (*.msb) instead of the ASCII
+ * file if it is up to date
  */
 void FEMRead(const std::string& mesh_fname,
              std::vector<MeshLib::CFEMesh*>& mesh_vec,
              GEOLIB::GEOObjects* geo_obj = NULL,
-             std::string* unique_name = NULL);
+             std::string* unique_name = NULL,
+             bool use_binary = true);
 #if defined(USE_PETSC)  // || defined(using other parallel scheme)
 void FEMRead_ASCII(const int msize, const int mrank,
                    const std::string& file_base_name,
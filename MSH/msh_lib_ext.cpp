@@ -42,7 +42,8 @@ using namespace MeshLib;
 void BuildNodeStruc(MeshNodes* anode, MPI_Datatype* MPI_Node_ptr);
 
 void FEMRead(const string& file_base_name, vector<MeshLib::CFEMesh*>& mesh_vec,
-             GEOLIB::GEOObjects* geo_obj, string* unique_name)
+             GEOLIB::GEOObjects* geo_obj, string* unique_name,
+             bool /*use_binary*/)
 {
     int msize;
     int mrank;
@@ -717,6 +718,8 @@ void CFEMesh::ConfigHighOrderElements()
 
     int* middle_node = NULL;
 
+    ConstructEdges();
+
     // TEST
     // int myrank;
     // MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
@@ -788,24 +791,8 @@ void CFEMesh::ConfigHighOrderElements()
     }
     */
 
-    CNode* node = NULL;
-    for (size_t e = 0; e < e_size; e++)
-    {
-        elem = ele_vector[e];
-        for (int i = elem->nnodes; i < elem->nnodesHQ; i++)
-        {
-            bool done = false;
-            node = elem->GetNode(i);
-            for (int k = 0; k < (int)node->getConnectedElementIDs().size(); k++)
-                if (e == node->getConnectedElementIDs()[k])
-                {
-                    done = true;
-                    break;
-                }
-            if (!done)
-                node->getConnectedElementIDs().push_back(e);
-        }
-    }
+    // Elements connected to the new nodes
+    ConnectedElements2Node(true, true);
 
     // For sparse matrix
     ConnectedNodes(true);
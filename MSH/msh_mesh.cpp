@@ -17,6 +17,7 @@
 #include <cfloat>
 #include <cmath>
 #include <climits>
+#include <algorithm>
 #include <fstream>
 #include <iomanip>  //WW
 #include <iostream>
@@ -119,6 +120,8 @@ size_t max_dim = 0;  // OK411
 //========================================================================
 namespace MeshLib
 {
+bool CFEMesh::_defer_edges = false;
+
 /**************************************************************************
    FEMLib-Method:
    Task:
@@ -146,7 +149,10 @@ CFEMesh::CFEMesh(GEOLIB::GEOObjects* geo_obj, std::string* geo_name)
       NodesNumber_Quadratic(0),
       useQuadratic(false),
       _axisymmetry(false),
-      _mesh_grid(NULL)
+      _mesh_grid(NULL),
+      _element_grid(NULL),
+      _has_deferred_edges(false),
+      _has_file_topology(false)
 {
     coordinate_system = 1;
 
@@ -169,7 +175,12 @@ CFEMesh::CFEMesh(GEOLIB::GEOObjects* geo_obj, std::string* geo_name)
 // Copy-Constructor for CFEMeshes.
 // Programming: 2010/11/10 KR
 CFEMesh::CFEMesh(CFEMesh const& old_mesh)
-    : PT(NULL), _search_length(old_mesh._search_length), _mesh_grid(NULL)
+    : PT(NULL),
+      _search_length(old_mesh._search_length),
+      _mesh_grid(NULL),
+      _element_grid(NULL),
+      _has_deferred_edges(false),
+      _has_file_topology(false)
 {
     std::cout << "Copying mesh object ... ";
 
@@ -266,6 +277,7 @@ CFEMesh::~CFEMesh(void)
         delete _mesh_grid;
         _mesh_grid = NULL;
     }
+    delete _element_grid;
 }
 
 void CFEMesh::setElementType(MshElemType::type type)
@@ -341,6 +353,30 @@ void CFEMesh::computeMinEdgeLength()
                 _min_edge_length = kth_edge_length;
         }
     }
+    else if (_has_deferred_edges)
+    {
+        // The element edges have the lengths of the edges to be built
+        bool first = true;
+        for (size_t e = 0; e < ele_vector.size(); e++)
+        {
+            CElem* elem(ele_vector[e]);
+            for (size_t i = 0; i < elem->GetEdgesNumber(); i++)
+            {
+                int edgeIndex_loc[2];
+                elem->GetLocalIndicesOfEdgeNodes(i, edgeIndex_loc);
+                double const* const pnt0(
+                    elem->GetNode(edgeIndex_loc[0])->getData());
+                double const* const pnt1(
+                    elem->GetNode(edgeIndex_loc[1])->getData());
+                double const dx(pnt1[0] - pnt0[0]), dy(pnt1[1] - pnt0[1]),
+                    dz(pnt1[2] - pnt0[2]);
+                const double length(sqrt(dx * dx + dy * dy + dz * dz));
+                if (first || length < _min_edge_length)
+                    _min_edge_length = length;
+                first = false;
+            }
+        }
+    }
 }
 
 void CFEMesh::setSearchLength(double len)
@@ -355,6 +391,7 @@ double CFEMesh::getSearchLength() const
 
 void CFEMesh::computeSearchLength(double c)
 {
+    ConstructEdges();
     const size_t n(edge_vector.size());
 
     if (n == 0)
@@ -503,24 +540,307 @@ bool CFEMesh::Read(std::ifstream* fem_file)
    04/2007 WW Cut from Construct grid
    03/2011 KR cleaned up code
 **************************************************************************/
-void CFEMesh::ConnectedElements2Node(bool quadratic)
+void CFEMesh::ConnectedElements2Node(bool quadratic, bool all_elements)
 {
-    size_t nNodes(nod_vector.size());
-    for (size_t e = 0; e < nNodes; e++)
-        nod_vector[e]->getConnectedElementIDs().clear();
+    // Count the elements of each node, then fill the rows in the order of the
+    // elements
+    const size_t nNodes(nod_vector.size());
+    const size_t nElems(ele_vector.size());
+    _node_elements_ptr.assign(nNodes + 1, 0);
+    for (size_t e = 0; e < nElems; e++)
+    {
+        CElem* elem = ele_vector[e];
+        if (!all_elements && !elem->GetMark())
+            continue;
 
-    size_t nElems(ele_vector.size());
+        size_t nElemNodes(static_cast<size_t>(elem->GetNodesNumber(quadratic)));
+        for (size_t i = 0; i < nElemNodes; i++)
+            _node_elements_ptr[elem->GetNodeIndex(i) + 1]++;
+    }
+    for (size_t i = 0; i < nNodes; i++)
+        _node_elements_ptr[i + 1] += _node_elements_ptr[i];
+
+    _node_elements.resize(_node_elements_ptr[nNodes]);
+    std::vector<size_t> pos(_node_elements_ptr.begin(),
+                            _node_elements_ptr.end() - 1);
     for (size_t e = 0; e < nElems; e++)
     {
         CElem* elem = ele_vector[e];
-        if (!elem->GetMark())
+        if (!all_elements && !elem->GetMark())
             continue;
 
         size_t nElemNodes(static_cast<size_t>(elem->GetNodesNumber(quadratic)));
         for (size_t i = 0; i < nElemNodes; i++)
+            _node_elements[pos[elem->GetNodeIndex(i)]++] = e;
+    }
+    UpdateNodeAdjacencyViews();
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Set elements connected to the nodes from an adjacency in compressed
+   row storage
+**************************************************************************/
+void CFEMesh::setConnectedElements(std::vector<size_t> const& node_ptr,
+                                   std::vector<size_t> const& element_ids)
+{
+    _node_elements_ptr = node_ptr;
+    _node_elements = element_ids;
+    UpdateNodeAdjacencyViews();
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Point the nodes to their rows of the adjacencies. Nodes without a
+   row, e.g. created after the adjacency, get empty ones.
+**************************************************************************/
+void CFEMesh::UpdateNodeAdjacencyViews() const
+{
+    const size_t n_nodes(nod_vector.size());
+    const size_t n_element_rows(
+        _node_elements_ptr.empty() ? 0 : _node_elements_ptr.size() - 1);
+    const size_t n_node_rows(
+        _node_nodes_ptr.empty() ? 0 : _node_nodes_ptr.size() - 1);
+    size_t const* const elements(
+        _node_elements.empty() ? NULL : &_node_elements[0]);
+    size_t const* const nodes(_node_nodes.empty() ? NULL : &_node_nodes[0]);
+    for (size_t i = 0; i < n_nodes; i++)
+    {
+        CNode* node = nod_vector[i];
+        if (i < n_element_rows)
+            node->setConnectedElementIDs(NodeAdjacency(
+                elements + _node_elements_ptr[i],
+                _node_elements_ptr[i + 1] - _node_elements_ptr[i]));
+        else
+            node->setConnectedElementIDs(NodeAdjacency());
+        if (i < n_node_rows)
+            node->setConnectedNodes(
+                NodeAdjacency(nodes + _node_nodes_ptr[i],
+                              _node_nodes_ptr[i + 1] - _node_nodes_ptr[i]));
+        else
+            node->setConnectedNodes(NodeAdjacency());
+    }
+}
+
+/**************************************************************************
+   FEMLib-Method: ColorElements
+   Task: Distribute the elements into groups (colors) of elements that do not
+   share a node. The contributions of the elements of one color to the global
+   system can be added concurrently.
+   The coloring is greedy in the order of the elements, i.e. it only depends
+   on the mesh. Since two elements sharing a high order node also share the
+   corner nodes of the edge or face, the linear nodes are sufficient.
+**************************************************************************/
+void CFEMesh::ColorElements()
+{
+    const long n_elements = static_cast<long>(ele_vector.size());
+    const long n_nodes = static_cast<long>(nod_vector.size());
+
+    // Elements connected to the nodes, including the inactive elements
+    std::vector<long> node_ele_ptr(n_nodes + 1, 0);
+    for (long e = 0; e < n_elements; e++)
+    {
+        const CElem* elem = ele_vector[e];
+        const int nn = static_cast<int>(elem->GetNodesNumber(false));
+        for (int i = 0; i < nn; i++)
+            node_ele_ptr[elem->GetNodeIndex(i) + 1]++;
+    }
+    for (long i = 0; i < n_nodes; i++)
+        node_ele_ptr[i + 1] += node_ele_ptr[i];
+    std::vector<long> node_ele(node_ele_ptr[n_nodes]);
+    std::vector<long> fill(node_ele_ptr.begin(), node_ele_ptr.end() - 1);
+    for (long e = 0; e < n_elements; e++)
+    {
+        const CElem* elem = ele_vector[e];
+        const int nn = static_cast<int>(elem->GetNodesNumber(false));
+        for (int i = 0; i < nn; i++)
+            node_ele[fill[elem->GetNodeIndex(i)]++] = e;
+    }
+
+    // Smallest color not used by an already colored neighbor
+    std::vector<int> color(n_elements, -1);
+    // Last element that found the color at one of its neighbors
+    std::vector<long> color_mark;
+    for (long e = 0; e < n_elements; e++)
+    {
+        const CElem* elem = ele_vector[e];
+        const int nn = static_cast<int>(elem->GetNodesNumber(false));
+        for (int i = 0; i < nn; i++)
+        {
+            const long n = elem->GetNodeIndex(i);
+            for (long k = node_ele_ptr[n]; k < node_ele_ptr[n + 1]; k++)
+            {
+                const int c = color[node_ele[k]];
+                if (c >= 0)
+                    color_mark[c] = e;
+            }
+        }
+        int c = 0;
+        while (c < static_cast<int>(color_mark.size()) && color_mark[c] == e)
+            c++;
+        if (c == static_cast<int>(color_mark.size()))
+            color_mark.push_back(-1);
+        color[e] = c;
+    }
+
+    const int n_colors = static_cast<int>(color_mark.size());
+    ele_color_ptr.assign(n_colors + 1, 0);
+    for (long e = 0; e < n_elements; e++)
+        ele_color_ptr[color[e] + 1]++;
+    for (int c = 0; c < n_colors; c++)
+        ele_color_ptr[c + 1] += ele_color_ptr[c];
+    ele_color_elements.resize(n_elements);
+    std::vector<long> pos(ele_color_ptr.begin(), ele_color_ptr.end() - 1);
+    for (long e = 0; e < n_elements; e++)
+        ele_color_elements[pos[color[e]]++] = e;
+
+    Display::ScreenMessage(
+        "-> Element coloring: %d colors for %ld elements\n", n_colors,
+        n_elements);
+}
+
+/// Bits of the local side index in the packed (element, side) numbers
+static const int ELEMENT_SIDE_BITS = 4;
+static const long ELEMENT_SIDE_MASK = (1L << ELEMENT_SIDE_BITS) - 1;
+
+/// Face or edge of an element with its linear nodes in ascending order
+struct ElementSideKey
+{
+    long nodes[4];  // -1 for the unused ones
+    long side;      // packed (element << ELEMENT_SIDE_BITS) + local side
+
+    bool operator<(const ElementSideKey& other) const
+    {
+        for (int k = 0; k < 4; k++)
+            if (nodes[k] != other.nodes[k])
+                return nodes[k] < other.nodes[k];
+        return side < other.side;
+    }
+    bool hasSameNodes(const ElementSideKey& other) const
+    {
+        for (int k = 0; k < 4; k++)
+            if (nodes[k] != other.nodes[k])
+                return false;
+        return true;
+    }
+};
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Linear nodes of a face or an edge of an element in ascending
+   order. Faces of linear elements have at most four nodes.
+**************************************************************************/
+static void GetElementSideNodes(CElem* elem, bool edges, int side, long* nodes)
+{
+    int local[10];
+    int n = 2;
+    if (edges)
+        elem->GetLocalIndicesOfEdgeNodes(side, local);
+    else
+        n = elem->GetElementFaceNodes(side, local);
+    for (int k = 0; k < 4; k++)
+        nodes[k] = (k < n) ? elem->GetNodeIndex(local[k]) : -1;
+    for (int k = 1; k < n && k < 4; k++)
+        for (int l = k; l > 0 && nodes[l] < nodes[l - 1]; l--)
+            std::swap(nodes[l], nodes[l - 1]);
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Group the faces or the edges of the elements by their nodes.
+   side_ptr[e] + i numbers the side i of element e. sorted_sides holds the
+   sides packed as (e << ELEMENT_SIDE_BITS) + i, sorted by their nodes and,
+   for the same nodes, by the element and the side. side_group is the
+   position in sorted_sides of the first side with the same nodes.
+   The sides are bucketed by their smallest node and sorted within the
+   buckets, both in parallel over the elements and buckets if OpenMP is
+   enabled, so the result does not depend on the number of threads.
+**************************************************************************/
+static void SortElementSides(const std::vector<CElem*>& elements,
+                             size_t n_nodes, bool edges,
+                             std::vector<long>& side_ptr,
+                             std::vector<long>& sorted_sides,
+                             std::vector<long>& side_group)
+{
+    const long n_elements = static_cast<long>(elements.size());
+    side_ptr.assign(n_elements + 1, 0);
+    for (long e = 0; e < n_elements; e++)
+    {
+        CElem* elem(elements[e]);
+        int n_sides = 0;
+        if (elem->GetElementType() != MshElemType::INVALID)
+            n_sides = static_cast<int>(edges ? elem->GetEdgesNumber()
+                                             : elem->GetFacesNumber());
+        side_ptr[e + 1] = side_ptr[e] + n_sides;
+    }
+    const long n_sides = side_ptr[n_elements];
+
+    // Smallest node of each side, kept in side_group until the grouping
+    side_group.resize(n_sides);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long e = 0; e < n_elements; e++)
+    {
+        long nodes[4];
+        for (long s = side_ptr[e]; s < side_ptr[e + 1]; s++)
         {
-            MeshLib::CNode* node(nod_vector[elem->GetNodeIndex(i)]);
-            node->getConnectedElementIDs().push_back(e);
+            GetElementSideNodes(elements[e], edges,
+                                static_cast<int>(s - side_ptr[e]), nodes);
+            side_group[s] = nodes[0];
+        }
+    }
+
+    // Buckets of the smallest nodes, each ascending in the element index
+    std::vector<long> bucket_ptr(n_nodes + 1, 0);
+    for (long s = 0; s < n_sides; s++)
+        bucket_ptr[side_group[s] + 1]++;
+    for (size_t i = 0; i < n_nodes; i++)
+        bucket_ptr[i + 1] += bucket_ptr[i];
+    sorted_sides.resize(n_sides);
+    {
+        std::vector<long> pos(bucket_ptr.begin(), bucket_ptr.end() - 1);
+        for (long e = 0; e < n_elements; e++)
+            for (long s = side_ptr[e]; s < side_ptr[e + 1]; s++)
+                sorted_sides[pos[side_group[s]]++] =
+                    (e << ELEMENT_SIDE_BITS) + (s - side_ptr[e]);
+    }
+
+    // Sort each bucket by the other nodes
+    const long n_buckets = static_cast<long>(n_nodes);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        std::vector<ElementSideKey> keys;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1024)
+#endif
+        for (long b = 0; b < n_buckets; b++)
+        {
+            const long begin = bucket_ptr[b];
+            const long end = bucket_ptr[b + 1];
+            keys.resize(end - begin);
+            for (long p = begin; p < end; p++)
+            {
+                ElementSideKey& key = keys[p - begin];
+                key.side = sorted_sides[p];
+                GetElementSideNodes(
+                    elements[key.side >> ELEMENT_SIDE_BITS], edges,
+                    static_cast<int>(key.side & ELEMENT_SIDE_MASK), key.nodes);
+            }
+            if (keys.size() > 1)
+                std::sort(keys.begin(), keys.end());
+            long group = begin;
+            for (long p = begin; p < end; p++)
+            {
+                const ElementSideKey& key = keys[p - begin];
+                if (p > begin && !key.hasSameNodes(keys[p - begin - 1]))
+                    group = p;
+                sorted_sides[p] = key.side;
+                side_group[side_ptr[key.side >> ELEMENT_SIDE_BITS] +
+                           (key.side & ELEMENT_SIDE_MASK)] = group;
+            }
         }
     }
 }
@@ -538,37 +858,49 @@ void CFEMesh::ConstructGrid()
 {
     Display::ScreenMessage("Executing ConstructGrid() ... \n");
 
-    bool done;
-
     Math_Group::vec<CNode*> e_nodes0(20);
-    Math_Group::vec<int> Edge_Orientation(15);
-    Math_Group::vec<CEdge*> Edges(15);
-    Math_Group::vec<CEdge*> Edges0(15);
     Math_Group::vec<CElem*> Neighbors(15);
     Math_Group::vec<CElem*> Neighbors0(15);
 
-    Math_Group::vec<CNode*> e_edgeNodes0(3);
-    Math_Group::vec<CNode*> e_edgeNodes(3);
-
 #if !defined( \
     USE_PETSC)  // &&! defined(USE_OTHER Parallel solver lib) //WW 06.2013
     NodesNumber_Linear = nod_vector.size();
 #endif
 
-    Edge_Orientation = 1;
-
-    // Set neighbors of node
-    ConnectedElements2Node();
-
     // Compute neighbors and edges
     size_t e_size(ele_vector.size());
 
-    // 2011-11-21 TF
-    // initializing attributes of objects - why is this not done in the
-    // constructor?
-    for (size_t e = 0; e < e_size; e++)
+    // The topology of a binary mesh file was searched with all elements
+    // marked. Otherwise it is searched again.
+    for (size_t e = 0; e < e_size && _has_file_topology; e++)
+        if (!ele_vector[e]->GetMark())
+        {
+            for (size_t i = 0; i < edge_vector.size(); i++)
+                delete edge_vector[i];
+            edge_vector.clear();
+            _has_file_topology = false;
+        }
+
+    std::vector<long> face_ptr, sorted_faces, face_group;
+    std::vector<long> edge_ptr, sorted_edges, edge_group;
+    if (!_has_file_topology)
     {
-        ele_vector[e]->InitializeMembers();
+        // Set neighbors of node
+        ConnectedElements2Node();
+
+        // Faces and edges of the elements grouped by their nodes
+        SortElementSides(ele_vector, nod_vector.size(), false, face_ptr,
+                         sorted_faces, face_group);
+        SortElementSides(ele_vector, nod_vector.size(), true, edge_ptr,
+                         sorted_edges, edge_group);
+
+        // 2011-11-21 TF
+        // initializing attributes of objects - why is this not done in the
+        // constructor?
+        for (size_t e = 0; e < e_size; e++)
+        {
+            ele_vector[e]->InitializeMembers(!_defer_edges);
+        }
     }
 
     for (size_t e = 0; e < e_size; e++)
@@ -581,70 +913,36 @@ void CFEMesh::ConstructGrid()
         for (size_t i = 0; i < nnodes0; i++)  // Nodes
             e_nodes0[i] = nod_vector[node_index[i]];
 
-        size_t nFaces = static_cast<size_t>(elem->GetFacesNumber());
-        // neighbors
+        if (_has_file_topology)
+        {
+            // Neighbors and edges from the binary mesh file
+            elem->SetOrder(false);
+            elem->SetNodes(e_nodes0, true);
+            continue;
+        }
+
+        // neighbors: the element with the smallest index that has a face with
+        // the same nodes
+        size_t nFaces = static_cast<size_t>(face_ptr[e + 1] - face_ptr[e]);
         for (size_t i = 0; i < nFaces; i++)  // Faces
         {
             if (Neighbors0[i])
                 continue;
 
-            done = false;
-            int faceIndex_loc0[10];
-            size_t nFaceNodes = static_cast<size_t>(
-                elem->GetElementFaceNodes(i, faceIndex_loc0));
-            for (size_t k = 0; k < nFaceNodes; k++)  // face nodes
+            const long group = face_group[face_ptr[e] + i];
+            for (size_t p = group; p < sorted_faces.size(); p++)
             {
-                size_t nConnElems(e_nodes0[faceIndex_loc0[k]]
-                                      ->getConnectedElementIDs()
-                                      .size());
-                for (size_t ei = 0; ei < nConnElems;
-                     ei++)  // elements connected to face node
-                {
-                    size_t ee(static_cast<size_t>(
-                        e_nodes0[faceIndex_loc0[k]]
-                            ->getConnectedElementIDs()[ei]));
-                    if (ee == e)
-                        continue;
-                    CElem* connElem(ele_vector[ee]);
-                    const Math_Group::vec<long>& node_index_glb(
-                        connElem->GetNodeIndeces());
-                    connElem->GetNeighbors(Neighbors);
-                    size_t nFacesConnElem =
-                        static_cast<size_t>(connElem->GetFacesNumber());
-
-                    int faceIndex_loc[10];
-                    for (size_t ii = 0; ii < nFacesConnElem;
-                         ii++)  // faces of elements connected to face node
-                    {
-                        size_t nFaceNodesConnElem(static_cast<size_t>(
-                            connElem->GetElementFaceNodes(ii, faceIndex_loc)));
-                        if (nFaceNodes != nFaceNodesConnElem)
-                            continue;
-                        size_t counter(0);
-                        for (size_t j = 0; j < nFaceNodes; j++)
-                        {
-                            for (size_t jj = 0; jj < nFaceNodesConnElem; jj++)
-                                if (node_index[faceIndex_loc0[j]] ==
-                                    node_index_glb[faceIndex_loc[jj]])
-                                {
-                                    counter++;
-                                    break;
-                                }
-                        }
-                        if (counter == nFaceNodesConnElem)
-                        {
-                            Neighbors0[i] = connElem;
-                            Neighbors[ii] = elem;
-                            connElem->SetNeighbor(ii, elem);
-                            done = true;
-                            break;
-                        }
-                    }
-                    if (done)
-                        break;
-                }
-                if (done)
+                const long ee = sorted_faces[p] >> ELEMENT_SIDE_BITS;
+                const int ii =
+                    static_cast<int>(sorted_faces[p] & ELEMENT_SIDE_MASK);
+                if (face_group[face_ptr[ee] + ii] != group)
                     break;
+                if (ee == static_cast<long>(e) || !ele_vector[ee]->GetMark())
+                    continue;
+                CElem* connElem(ele_vector[ee]);
+                Neighbors0[i] = connElem;
+                connElem->SetNeighbor(ii, elem);
+                break;
             }
         }
         elem->SetNeighbors(Neighbors0);
@@ -682,91 +980,36 @@ void CFEMesh::ConstructGrid()
         }
         // --------------------------------
 
-        // Edges
-        size_t nedges0(elem->GetEdgesNumber());
-        elem->GetEdges(Edges0);
-        for (size_t i = 0; i < nedges0; i++)  // edges
-        {
-            int edgeIndex_loc0[2];
-            elem->GetLocalIndicesOfEdgeNodes(i, edgeIndex_loc0);
-            // Check neighbors
-            done = false;
-            for (size_t k = 0; k < 2; k++)  // beginning and end of edge
-            {
-                size_t nConnElem(e_nodes0[edgeIndex_loc0[k]]
-                                     ->getConnectedElementIDs()
-                                     .size());
-                for (size_t ei = 0; ei < nConnElem;
-                     ei++)  // elements connected to edge node
-                {
-                    size_t ee(e_nodes0[edgeIndex_loc0[k]]
-                                  ->getConnectedElementIDs()[ei]);
-                    if (ee == e)
-                        continue;
-                    CElem* connElem(ele_vector[ee]);
-                    const Math_Group::vec<long>& node_index_glb(
-                        connElem->GetNodeIndeces());
-                    size_t nedges(connElem->GetEdgesNumber());
-                    connElem->GetEdges(Edges);
-                    // Edges of neighbors
-                    int edgeIndex_loc[2];
-                    for (size_t ii = 0; ii < nedges;
-                         ii++)  // edges of element connected to edge node
-                    {
-                        connElem->GetLocalIndicesOfEdgeNodes(ii, edgeIndex_loc);
-
-                        if ((node_index[edgeIndex_loc0[0]] ==
-                                 node_index_glb[edgeIndex_loc[0]] &&
-                             node_index[edgeIndex_loc0[1]] ==
-                                 node_index_glb[edgeIndex_loc[1]]) ||
-                            (node_index[edgeIndex_loc0[0]] ==
-                                 node_index_glb[edgeIndex_loc[1]] &&
-                             node_index[edgeIndex_loc0[1]] ==
-                                 node_index_glb
-                                     [edgeIndex_loc[0]]))  // check if elements
-                                                           // share edge
-
-                            if (Edges[ii])
-                            {
-                                Edges0[i] = Edges[ii];
-                                Edges[ii]->GetNodes(e_edgeNodes);
-                                if ((size_t)node_index[edgeIndex_loc0[0]] ==
-                                        e_edgeNodes[1]->GetIndex() &&
-                                    (size_t)node_index[edgeIndex_loc0[1]] ==
-                                        e_edgeNodes[0]
-                                            ->GetIndex())  // check direction of
-                                                           // edge
-                                    Edge_Orientation[i] = -1;
-                                done = true;
-                                break;
-                            }
-                    }  //  for(ii=0; ii<nedges; ii++)
-                    if (done)
-                        break;
-                }  // for(ei=0; ei<e_size_l; ei++)
-                if (done)
-                    break;
-            }           // for(k=0;k<2;k++)
-            if (!done)  // new edges and new node
-            {
-                Edges0[i] = new CEdge((long)edge_vector.size());
-                Edges0[i]->SetOrder(false);
-                e_edgeNodes0[0] = e_nodes0[edgeIndex_loc0[0]];
-                e_edgeNodes0[1] = e_nodes0[edgeIndex_loc0[1]];
-                e_edgeNodes0[2] = NULL;
-                Edges0[i]->SetNodes(e_edgeNodes0);
-                edge_vector.push_back(Edges0[i]);
-            }  // new edges
-        }      //  for(i=0; i<nedges0; i++)
-        //
-        // Set edges and nodes
         elem->SetOrder(false);
-        elem->SetEdgesOrientation(Edge_Orientation);
-        elem->SetEdges(Edges0);
         // Resize is true
         elem->SetNodes(e_nodes0, true);
     }  // Over elements
 
+    // Edges, left to ConstructEdges() if they are deferred
+    _has_deferred_edges = false;
+    size_t n_edges = edge_vector.size();
+    if (!_has_file_topology)
+    {
+        if (_defer_edges)
+        {
+            _has_deferred_edges = true;
+            n_edges = 0;
+            for (size_t p = 0; p < sorted_edges.size(); p++)
+            {
+                const long ee = sorted_edges[p] >> ELEMENT_SIDE_BITS;
+                if (edge_group[edge_ptr[ee] +
+                               (sorted_edges[p] & ELEMENT_SIDE_MASK)] ==
+                    static_cast<long>(p))
+                    n_edges++;
+            }
+        }
+        else
+        {
+            BuildEdges(edge_ptr, sorted_edges, edge_group, false);
+            n_edges = edge_vector.size();
+        }
+    }
+
     // Set faces on surfaces and others
     _msh_n_lines = 0;  // Should be members of mesh
     _msh_n_quads = 0;
@@ -928,23 +1171,133 @@ void CFEMesh::ConstructGrid()
 
     // TEST WW
     // For sparse matrix
-    ConnectedNodes(false);
+    if (!_has_file_topology)
+        ConnectedNodes(false);
+    // A later construction has to search the topology
+    _has_file_topology = false;
     //
     e_nodes0.resize(0);
     //	node_index_glb.resize(0);
     //	node_index_glb0.resize(0);
-    Edge_Orientation.resize(0);
-    Edges.resize(0);
-    Edges0.resize(0);
     Neighbors.resize(0);
     Neighbors0.resize(0);
-    e_edgeNodes0.resize(0);
-    e_edgeNodes.resize(0);
 
     // computeSearchLength();
     computeMinEdgeLength();
     setSearchLength(0.375 * _min_edge_length / 2);
     constructMeshGrid();
+
+    if (_has_deferred_edges)
+        Display::ScreenMessage("-> %ld edges are built on demand\n",
+                               (long)n_edges);
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Create the edges of the elements. An edge is shared with the
+   element with the smallest index before this one that has an edge with
+   the same nodes, of the marked elements only unless all_elements is set.
+**************************************************************************/
+void CFEMesh::BuildEdges(const std::vector<long>& edge_ptr,
+                         const std::vector<long>& sorted_edges,
+                         const std::vector<long>& edge_group,
+                         bool all_elements)
+{
+    bool done;
+    Math_Group::vec<CNode*> e_nodes0(20);
+    Math_Group::vec<int> Edge_Orientation(15);
+    Math_Group::vec<CEdge*> Edges0(15);
+    Math_Group::vec<CNode*> e_edgeNodes0(3);
+    Math_Group::vec<CNode*> e_edgeNodes(3);
+
+    Edge_Orientation = 1;
+
+    size_t e_size(ele_vector.size());
+    for (size_t e = 0; e < e_size; e++)
+    {
+        CElem* elem(ele_vector[e]);
+        const Math_Group::vec<long>& node_index(elem->GetNodeIndeces());
+        for (int i = 0; i < elem->GetVertexNumber(); i++)
+            e_nodes0[i] = elem->GetNode(i);
+
+        // Edges
+        size_t nedges0(elem->GetEdgesNumber());
+        elem->GetEdges(Edges0);
+        for (size_t i = 0; i < nedges0; i++)  // edges
+        {
+            int edgeIndex_loc0[2];
+            elem->GetLocalIndicesOfEdgeNodes(i, edgeIndex_loc0);
+            // The edge of the element with the smallest index before this one
+            // that has an edge with the same nodes
+            done = false;
+            const long group = edge_group[edge_ptr[e] + i];
+            for (size_t p = group; p < sorted_edges.size(); p++)
+            {
+                const long ee = sorted_edges[p] >> ELEMENT_SIDE_BITS;
+                const int ii =
+                    static_cast<int>(sorted_edges[p] & ELEMENT_SIDE_MASK);
+                if (edge_group[edge_ptr[ee] + ii] != group ||
+                    ee >= static_cast<long>(e))
+                    break;
+                CEdge* connEdge(ele_vector[ee]->GetEdge(ii));
+                if ((!all_elements && !ele_vector[ee]->GetMark()) ||
+                    !connEdge)
+                    continue;
+                Edges0[i] = connEdge;
+                connEdge->GetNodes(e_edgeNodes);
+                if ((size_t)node_index[edgeIndex_loc0[0]] ==
+                        e_edgeNodes[1]->GetIndex() &&
+                    (size_t)node_index[edgeIndex_loc0[1]] ==
+                        e_edgeNodes[0]->GetIndex())  // check direction of edge
+                    Edge_Orientation[i] = -1;
+                done = true;
+                break;
+            }
+            if (!done)  // new edges and new node
+            {
+                Edges0[i] = new CEdge((long)edge_vector.size());
+                Edges0[i]->SetOrder(false);
+                e_edgeNodes0[0] = e_nodes0[edgeIndex_loc0[0]];
+                e_edgeNodes0[1] = e_nodes0[edgeIndex_loc0[1]];
+                e_edgeNodes0[2] = NULL;
+                Edges0[i]->SetNodes(e_edgeNodes0);
+                edge_vector.push_back(Edges0[i]);
+            }  // new edges
+        }      //  for(i=0; i<nedges0; i++)
+        elem->SetEdgesOrientation(Edge_Orientation);
+        elem->SetEdges(Edges0);
+    }  // Over elements
+}
+
+/**************************************************************************
+   FEMLib-Method:
+   Task: Deferred edges, which ConstructGrid() has left out. They
+   are searched over all elements, as in ConstructGrid() of a new mesh, and
+   get the marks of their elements like CElem::MarkingAll().
+**************************************************************************/
+void CFEMesh::ConstructEdges()
+{
+    if (!_has_deferred_edges)
+        return;
+    _has_deferred_edges = false;
+    Display::ScreenMessage("Executing ConstructEdges() ... \n");
+
+    std::vector<long> edge_ptr, sorted_edges, edge_group;
+    SortElementSides(ele_vector, nod_vector.size(), true, edge_ptr,
+                     sorted_edges, edge_group);
+    for (size_t e = 0; e < ele_vector.size(); e++)
+        ele_vector[e]->InitializeEdges();
+    BuildEdges(edge_ptr, sorted_edges, edge_group, true);
+
+    for (size_t e = 0; e < ele_vector.size(); e++)
+    {
+        CElem* elem(ele_vector[e]);
+        for (size_t i = 0; i < elem->GetEdgesNumber(); i++)
+            elem->GetEdge(i)->SetMark(elem->GetMark());
+    }
+    for (size_t i = 0; i < face_vector.size(); i++)
+        face_vector[i]->SetFaceEdges();
+    Display::ScreenMessage("-> %ld edges\n", (long)edge_vector.size());
 }
 
 void CFEMesh::constructMeshGrid()
@@ -971,38 +1324,17 @@ void CFEMesh::constructMeshGrid()
 **************************************************************************/
 void CFEMesh::GenerateHighOrderNodes()
 {
-    int j, k, ii;
+    int j, k;
     int nnodes0, nedges0, nedges;
     long e, ei, ee, e_size_l;
     int edgeIndex_loc0[2];
     bool done;
     double x0 = 0.0, y0 = 0.0, z0 = 0.0;  // OK411
 
+    ConstructEdges();
     // Set neighbors of node. All elements, even in deactivated subdomains, are
     // taken into account here.
-    for (e = 0; e < (long)nod_vector.size(); e++)
-        nod_vector[e]->getConnectedElementIDs().clear();
-    done = false;
-    size_t ele_vector_size(ele_vector.size());
-    for (size_t e = 0; e < ele_vector_size; e++)
-    {
-        CElem* thisElem0 = ele_vector[e];
-        for (size_t i = 0; i < thisElem0->GetNodesNumber(false); i++)
-        {
-            done = false;
-            long ni = thisElem0->GetNodeIndex(i);
-            size_t n_connected_elements(
-                nod_vector[ni]->getConnectedElementIDs().size());
-            for (size_t j = 0; j < n_connected_elements; j++)
-                if (e == nod_vector[ni]->getConnectedElementIDs()[j])
-                {
-                    done = true;
-                    break;
-                }
-            if (!done)
-                nod_vector[ni]->getConnectedElementIDs().push_back(e);
-        }
-    }
+    ConnectedElements2Node(false, true);
     //
     CNode* aNode = NULL;
     Math_Group::vec<CNode*> e_nodes0(20);
@@ -1011,6 +1343,12 @@ void CFEMesh::GenerateHighOrderNodes()
     CElem* thisElem = NULL;
     CEdge* thisEdge0 = NULL;
     CEdge* thisEdge = NULL;
+    // Edges of the elements grouped by their nodes, with the middle point of
+    // each group
+    std::vector<long> edge_ptr, sorted_edges, edge_group;
+    SortElementSides(ele_vector, nod_vector.size(), true, edge_ptr,
+                     sorted_edges, edge_group);
+    std::vector<CNode*> edge_middle_nodes(sorted_edges.size(), NULL);
     //----------------------------------------------------------------------
     // Loop over elements (except for line elements)
     size_t e_size(ele_vector.size());
@@ -1031,49 +1369,15 @@ void CFEMesh::GenerateHighOrderNodes()
         for (int i = 0; i < nedges0; i++)
         {
             thisEdge0 = thisElem0->GetEdge(i);
-            thisElem0->GetLocalIndicesOfEdgeNodes(i, edgeIndex_loc0);
-            // Check neighbors
-            done = false;
-            for (k = 0; k < 2; k++)
+            // Middle point of the edge created for another element
+            CNode*& edge_middle(
+                edge_middle_nodes[edge_group[edge_ptr[e] + i]]);
+            if (edge_middle)
             {
-                e_size_l = (long)e_nodes0[edgeIndex_loc0[k]]
-                               ->getConnectedElementIDs()
-                               .size();
-                for (ei = 0; ei < e_size_l; ei++)
-                {
-                    size_t ee(e_nodes0[edgeIndex_loc0[k]]
-                                  ->getConnectedElementIDs()[ei]);
-                    if (ee == e)
-                        continue;
-                    thisElem = ele_vector[ee];
-
-                    if (thisElem->GetElementType() == MshElemType::LINE)
-                        continue;
-
-                    nedges = thisElem->GetEdgesNumber();
-                    // Edges of neighbors
-                    for (ii = 0; ii < nedges; ii++)
-                    {
-                        thisEdge = thisElem->GetEdge(ii);
-                        if (*thisEdge0 == *thisEdge)
-                        {
-                            aNode = thisEdge->GetNode(2);
-                            if (aNode)  // The middle point exist
-                            {
-                                e_nodes0[nnodes0] = aNode;
-                                nnodes0++;
-                                done = true;
-                                break;
-                            }
-                        }
-                    }  //  for(ii=0; ii<nedges; ii++)
-                    if (done)
-                        break;
-                }  // for(ei=0; ei<e_size_l; ei++)
-                if (done)
-                    break;
-            }  // for(k=0;k<2;k++)
-            if (!done)
+                e_nodes0[nnodes0] = edge_middle;
+                nnodes0++;
+            }
+            else
             {
                 double const* const pnt0(thisEdge0->GetNode(0)->getData());
                 double const* const pnt1(thisEdge0->GetNode(1)->getData());
@@ -1087,6 +1391,7 @@ void CFEMesh::GenerateHighOrderNodes()
                 thisEdge0->SetNode(2, aNode);
                 nnodes0++;
                 nod_vector.push_back(aNode);
+                edge_middle = aNode;
             }
         }  //  for(i=0; i<nedges0; i++)
 
@@ -1218,23 +1523,8 @@ void CFEMesh::GenerateHighOrderNodes()
 #endif
         Eqs2Global_NodeIndex.push_back(nod_vector[e]->GetIndex());
     }
-    for (size_t e = 0; e < e_size; e++)
-    {
-        thisElem0 = ele_vector[e];
-        for (int i = thisElem0->nnodes; i < thisElem0->nnodesHQ; i++)
-        {
-            done = false;
-            aNode = thisElem0->GetNode(i);
-            for (k = 0; k < (int)aNode->getConnectedElementIDs().size(); k++)
-                if (e == aNode->getConnectedElementIDs()[k])
-                {
-                    done = true;
-                    break;
-                }
-            if (!done)
-                aNode->getConnectedElementIDs().push_back(e);
-        }
-    }
+    // Elements connected to the new nodes
+    ConnectedElements2Node(true, true);
 
     // For sparse matrix
     ConnectedNodes(true);
@@ -1522,22 +1812,7 @@ long CFEMesh::GetNODOnPNT(const GEOLIB::Point* const pnt) const
 **************************************************************************/
 long CFEMesh::GetNearestELEOnPNT(const GEOLIB::Point* const pnt) const
 {
-    long nextele(-1);
-    double dist(std::numeric_limits<double>::max()), dist1;
-
-    for (size_t i = 0; i < ele_vector.size(); i++)
-    {
-        double const* center(ele_vector[i]->GetGravityCenter());
-        dist1 = 0.0;
-        for (size_t k(0); k < 3; k++)
-            dist1 += (center[k] - (*pnt)[k]) * (center[k] - (*pnt)[k]);
-        if (dist1 < dist)
-        {
-            dist = dist1;
-            nextele = i;
-        }
-    }
-    return nextele;
+    return getElementGrid().getNearestElement(pnt->getData());
 }
 
 // WW. (x1-x0).(x2-x0)
@@ -2931,52 +3206,35 @@ std::ios::pos_type CFEMesh::GMSReadTIN(std::ifstream* tin_file)
 void CFEMesh::ConnectedNodes(bool quadratic) const
 {
 #define noTestConnectedNodes
-    bool exist = false;
-
-    for (size_t i = 0; i < nod_vector.size(); i++)
+    // The nodes of the connected elements are added to the connected nodes
+    // found so far, sorted and made unique node by node
+    const size_t n_nodes(nod_vector.size());
+    std::vector<size_t> node_ptr(n_nodes + 1, 0);
+    std::vector<size_t> node_nodes;
+    node_nodes.reserve(_node_nodes.size());
+    std::vector<size_t> row;
+    for (size_t i = 0; i < n_nodes; i++)
     {
         CNode* nod = nod_vector[i];
-        size_t n_connected_elements(nod->getConnectedElementIDs().size());
-        for (size_t j = 0; j < n_connected_elements; j++)
+        NodeAdjacency const& connected_nodes(nod->getConnectedNodes());
+        row.assign(connected_nodes.begin(), connected_nodes.end());
+        NodeAdjacency const& connected_elements(nod->getConnectedElementIDs());
+        for (size_t j = 0; j < connected_elements.size(); j++)
         {
-            CElem* ele = ele_vector[nod->getConnectedElementIDs()[j]];
+            CElem* ele = ele_vector[connected_elements[j]];
             size_t n_quadratic_node(
                 static_cast<size_t>(ele->GetNodesNumber(quadratic)));
             for (size_t l = 0; l < n_quadratic_node; l++)
-            {
-                exist = false;
-                size_t n_connected_nodes(nod->getConnectedNodes().size());
-                // WW
-                for (size_t k = 0; k < n_connected_nodes; k++)
-                    if (nod->getConnectedNodes()[k] ==
-                        static_cast<size_t>(ele->nodes_index[l]))
-                    {
-                        exist = true;
-                        break;
-                    }
-                if (!exist)  // WW
-                    nod->getConnectedNodes().push_back(ele->nodes_index[l]);
-            }
-        }
-    }
-
-    // Sorting. WW
-    // WW
-    for (size_t i = 0; i < nod_vector.size(); i++)
-    {
-        CNode* nod = nod_vector[i];
-        size_t n_connected_nodes = nod->getConnectedNodes().size();
-        for (size_t k = 0; k < n_connected_nodes; k++)
-        {
-            for (size_t l = k; l < n_connected_nodes; l++)
-                if (nod->getConnectedNodes()[l] < nod->getConnectedNodes()[k])
-                {
-                    const size_t n(nod->getConnectedNodes()[k]);
-                    nod->getConnectedNodes()[k] = nod->getConnectedNodes()[l];
-                    nod->getConnectedNodes()[l] = n;
-                }
+                row.push_back(static_cast<size_t>(ele->nodes_index[l]));
         }
+        std::sort(row.begin(), row.end());
+        node_nodes.insert(node_nodes.end(), row.begin(),
+                          std::unique(row.begin(), row.end()));
+        node_ptr[i + 1] = node_nodes.size();
     }
+    _node_nodes_ptr.swap(node_ptr);
+    _node_nodes.swap(node_nodes);
+    UpdateNodeAdjacencyViews();
 //----------------------------------------------------------------------
 #ifdef TestConnectedNodes
     for (i = 0; i < (long)nod_vector.size(); i++)
@@ -3180,11 +3438,277 @@ void CFEMesh::SetNetworkIntersectionNodes()
 }
 
 #ifdef NEW_EQS  // 1.11.2007 WW
+/// Bandwidth and profile of the graph ptr/adj with the node numbers number.
+static void GraphBandwidthAndProfile(const std::vector<long>& ptr,
+                                     const std::vector<long>& adj,
+                                     const std::vector<long>& number,
+                                     long& bandwidth, double& profile)
+{
+    bandwidth = 0;
+    profile = 0.;
+    const long n = static_cast<long>(ptr.size()) - 1;
+    for (long i = 0; i < n; i++)
+    {
+        long first = number[i];
+        for (long k = ptr[i]; k < ptr[i + 1]; k++)
+        {
+            const long d = number[i] - number[adj[k]];
+            bandwidth = std::max(bandwidth, std::abs(d));
+            first = std::min(first, number[adj[k]]);
+        }
+        profile += static_cast<double>(number[i] - first);
+    }
+}
+
+/*!
+   Reverse Cuthill-McKee order of the graph ptr/adj. Each connected part
+   starts at a pseudo-peripheral node found from the node of the smallest
+   degree by repeated breadth-first searches (George and Liu).
+ */
+static void ReverseCuthillMcKee(const std::vector<long>& ptr,
+                                const std::vector<long>& adj,
+                                std::vector<long>& order)
+{
+    const long n = static_cast<long>(ptr.size()) - 1;
+    std::vector<std::pair<long, long> > by_degree(n);
+    for (long i = 0; i < n; i++)
+        by_degree[i] = std::make_pair(ptr[i + 1] - ptr[i], i);
+    std::sort(by_degree.begin(), by_degree.end());
+
+    std::vector<long> level(n, -1);
+    std::vector<char> numbered(n, 0);
+    std::vector<long> bfs;
+    std::vector<std::pair<long, long> > neighbors;
+    order.clear();
+    order.reserve(n);
+    for (long c = 0; c < n; c++)
+    {
+        long start = by_degree[c].second;
+        if (numbered[start])
+            continue;
+
+        // Pseudo-peripheral node
+        long eccentricity = -1;
+        for (;;)
+        {
+            bfs.assign(1, start);
+            level[start] = 0;
+            for (std::size_t k = 0; k < bfs.size(); k++)
+            {
+                const long i = bfs[k];
+                for (long m = ptr[i]; m < ptr[i + 1]; m++)
+                    if (level[adj[m]] < 0)
+                    {
+                        level[adj[m]] = level[i] + 1;
+                        bfs.push_back(adj[m]);
+                    }
+            }
+            const long depth = level[bfs.back()];
+            long candidate = bfs.back();
+            for (std::size_t k = bfs.size(); k-- > 0 && level[bfs[k]] == depth;)
+                if (ptr[bfs[k] + 1] - ptr[bfs[k]] <
+                    ptr[candidate + 1] - ptr[candidate])
+                    candidate = bfs[k];
+            for (std::size_t k = 0; k < bfs.size(); k++)
+                level[bfs[k]] = -1;
+            if (depth <= eccentricity)
+                break;
+            eccentricity = depth;
+            start = candidate;
+        }
+
+        // Cuthill-McKee: neighbors by ascending degree
+        order.push_back(start);
+        numbered[start] = 1;
+        for (std::size_t k = order.size() - 1; k < order.size(); k++)
+        {
+            const long i = order[k];
+            neighbors.clear();
+            for (long m = ptr[i]; m < ptr[i + 1]; m++)
+            {
+                const long j = adj[m];
+                if (numbered[j])
+                    continue;
+                numbered[j] = 1;
+                neighbors.push_back(std::make_pair(ptr[j + 1] - ptr[j], j));
+            }
+            std::sort(neighbors.begin(), neighbors.end());
+            for (std::size_t m = 0; m < neighbors.size(); m++)
+                order.push_back(neighbors[m].second);
+        }
+    }
+    std::reverse(order.begin(), order.end());
+}
+
+/*!
+   Index of a point on the Hilbert curve of n_dim dimensions, with n_bits
+   bits for each coordinate x[i] (J. Skilling, Programming the Hilbert
+   curve, AIP Conf. Proc. 707, 2004). x is overwritten.
+ */
+static unsigned long long HilbertIndex(unsigned long* x, const int n_dim,
+                                       const int n_bits)
+{
+    const unsigned long M = 1UL << (n_bits - 1);
+    // Inverse undo
+    for (unsigned long Q = M; Q > 1; Q >>= 1)
+    {
+        const unsigned long P = Q - 1;
+        for (int i = 0; i < n_dim; i++)
+        {
+            if (x[i] & Q)
+                x[0] ^= P;
+            else
+            {
+                const unsigned long t = (x[0] ^ x[i]) & P;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+    // Gray encode
+    for (int i = 1; i < n_dim; i++)
+        x[i] ^= x[i - 1];
+    unsigned long t = 0;
+    for (unsigned long Q = M; Q > 1; Q >>= 1)
+        if (x[n_dim - 1] & Q)
+            t ^= Q - 1;
+    for (int i = 0; i < n_dim; i++)
+        x[i] ^= t;
+    // Interleave the bits of the transposed index
+    unsigned long long index = 0;
+    for (int b = n_bits - 1; b >= 0; b--)
+        for (int i = 0; i < n_dim; i++)
+            index = (index << 1) | ((x[i] >> b) & 1UL);
+    return index;
+}
+
+/**************************************************************************
+   MSHLib-Method:
+   Task: New equation indices of the nodes for the sparse table, in order
+      to reduce the bandwidth of the matrix or to improve the locality of
+      its entries. Only the equation numbering changes. The node indices,
+      and thus input and output, are not affected. The vertex nodes keep
+      the first equation indices.
+      method 1: Reverse Cuthill-McKee of the graph of the vertex nodes. The
+                other nodes follow in the order of their first vertex.
+      method 2: Hilbert curve of the node coordinates
+**************************************************************************/
+void CFEMesh::RenumberEquations(const int method)
+{
+    const long n_nodes = static_cast<long>(Eqs2Global_NodeIndex.size());
+    const long n_linear = static_cast<long>(NodesNumber_Linear);
+
+    // Graph of the vertex nodes
+    std::vector<long> ptr(n_linear + 1, 0);
+    std::vector<long> adj;
+    for (long i = 0; i < n_linear; i++)
+    {
+        NodeAdjacency const& connected =
+            nod_vector[i]->getConnectedNodes();
+        for (std::size_t k = 0; k < connected.size(); k++)
+        {
+            const long j = static_cast<long>(connected[k]);
+            if (j < n_linear && j != i)
+                adj.push_back(j);
+        }
+        ptr[i + 1] = static_cast<long>(adj.size());
+    }
+    std::vector<long> number(n_nodes);
+    for (long i = 0; i < n_nodes; i++)
+        number[i] = nod_vector[i]->GetEquationIndex();
+    long bandwidth0 = 0;
+    double profile0 = 0.;
+    GraphBandwidthAndProfile(ptr, adj, number, bandwidth0, profile0);
+
+    // Nodes in the new order
+    std::vector<long> order;
+    std::vector<std::pair<unsigned long long, long> > keys;
+    if (method == 1)
+    {
+        ReverseCuthillMcKee(ptr, adj, order);
+        for (long k = 0; k < n_linear; k++)
+            number[order[k]] = k;
+        for (long i = n_linear; i < n_nodes; i++)
+        {
+            NodeAdjacency const& connected =
+                nod_vector[i]->getConnectedNodes();
+            unsigned long long first = n_linear;
+            for (std::size_t k = 0; k < connected.size(); k++)
+                if (static_cast<long>(connected[k]) < n_linear)
+                    first = std::min(
+                        first,
+                        static_cast<unsigned long long>(number[connected[k]]));
+            keys.push_back(std::make_pair(first, i));
+        }
+    }
+    else
+    {
+        double x_min[3] = {DBL_MAX, DBL_MAX, DBL_MAX};
+        double x_max[3] = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+        for (long i = 0; i < n_nodes; i++)
+        {
+            const double* x = nod_vector[i]->getData();
+            for (int d = 0; d < 3; d++)
+            {
+                x_min[d] = std::min(x_min[d], x[d]);
+                x_max[d] = std::max(x_max[d], x[d]);
+            }
+        }
+        double max_range = 0.;
+        for (int d = 0; d < 3; d++)
+            max_range = std::max(max_range, x_max[d] - x_min[d]);
+        // Coordinates of the curve, the directions in which the mesh extends
+        int dims[3];
+        int n_dim = 0;
+        for (int d = 0; d < 3; d++)
+            if (x_max[d] - x_min[d] > 1.e-10 * max_range)
+                dims[n_dim++] = d;
+        const int n_bits = (n_dim > 0) ? 63 / n_dim : 1;
+        const double scale = static_cast<double>((1ULL << n_bits) - 1);
+        for (long i = 0; i < n_nodes; i++)
+        {
+            const double* x = nod_vector[i]->getData();
+            unsigned long xi[3] = {0, 0, 0};
+            for (int d = 0; d < n_dim; d++)
+                xi[d] = static_cast<unsigned long>(
+                    scale * (x[dims[d]] - x_min[dims[d]]) /
+                    (x_max[dims[d]] - x_min[dims[d]]));
+            const unsigned long long index =
+                (n_dim > 1) ? HilbertIndex(xi, n_dim, n_bits) : xi[0];
+            keys.push_back(std::make_pair(index, i));
+        }
+        // Vertex nodes first
+        std::sort(keys.begin(), keys.begin() + n_linear);
+        for (long k = 0; k < n_linear; k++)
+            order.push_back(keys[k].second);
+        keys.erase(keys.begin(), keys.begin() + n_linear);
+    }
+    std::sort(keys.begin(), keys.end());
+    for (std::size_t k = 0; k < keys.size(); k++)
+        order.push_back(keys[k].second);
+
+    for (long k = 0; k < n_nodes; k++)
+    {
+        number[order[k]] = k;
+        nod_vector[order[k]]->SetEquationIndex(k);
+        Eqs2Global_NodeIndex[k] = nod_vector[order[k]]->GetIndex();
+    }
+    long bandwidth = 0;
+    double profile = 0.;
+    GraphBandwidthAndProfile(ptr, adj, number, bandwidth, profile);
+    Display::ScreenMessage(
+        "-> Equation renumbering (%s): bandwidth %ld -> %ld, profile %g -> "
+        "%g\n",
+        (method == 1) ? "reverse Cuthill-McKee" : "Hilbert curve", bandwidth0,
+        bandwidth, profile0, profile);
+}
+
 /**************************************************************************
    MSHLib-Method:
    Programing:
    11/2007 WW Implementation
    04/2011 WW CRS storage
+   Storage (ls_storage_method): 100 CRS, 101 BCSR, otherwise JDS
 **************************************************************************/
 void CFEMesh::CreateSparseTable()
 {
@@ -3196,6 +3720,24 @@ void CFEMesh::CreateSparseTable()
             stype = Math_Group::CRS;
             break;
         }
+        else if (num_vector[i]->ls_storage_method == 101)
+        {
+            stype = Math_Group::BCSR;
+            break;
+        }
+    // Memory limit of the element-to-matrix map, the smallest one given
+    double map_memory_MB = -1.;
+    for (int i = 0; i < (int)num_vector.size(); i++)
+        if (map_memory_MB < 0. ||
+            num_vector[i]->ls_assembly_map_memory < map_memory_MB)
+            map_memory_MB = num_vector[i]->ls_assembly_map_memory;
+
+    // Equation numbering of the nodes, the first one given
+    int renumbering = 0;
+    for (int i = 0; i < (int)num_vector.size() && renumbering == 0; i++)
+        renumbering = num_vector[i]->ls_node_renumbering;
+    if (renumbering > 0)
+        RenumberEquations(renumbering);
 
     // Symmetry case is skipped.
     // 1. Sparse_graph_H for high order interpolation. Up to now, deformation
@@ -3211,6 +3753,11 @@ void CFEMesh::CreateSparseTable()
     else
         sparse_graph = new SparseTable(this, false, false, stype);
 
+    if (sparse_graph_H)
+        sparse_graph_H->BuildElementEntryMap(this, true, map_memory_MB);
+    if (sparse_graph)
+        sparse_graph->BuildElementEntryMap(this, false, map_memory_MB);
+
     //  sparse_graph->Write();
     //  sparse_graph_H->Write();
     //
@@ -3227,227 +3774,259 @@ GEOLIB::Grid<MeshLib::CNode> const* CFEMesh::getGrid() const
 #endif
 
 /*!
-   brief Find the element by a point
+   brief Check whether a point is in an element by the sum of the volumes
+   of the sub-elements spanned by the point and the element faces
    YS/WW 05/2012
 */
-size_t CFEMesh::FindElementByPoint(const double* xyz)
+bool CFEMesh::isPointInElement(CElem const* n_ele, const double* xyz) const
 {
     double x1[3], x2[3], x3[3], x4[3], x5[3], x6[3], x7[3], x8[3];
-    double a, a_sub[12];
-    CNode* a_node;
-    CElem* n_ele;
-    double tol = 1e-9;
+    double a_sub[12];
+    CNode const* a_node;
+    const double tol = 1e-9;
+    const double a = n_ele->GetVolume();
+
+    a_node = n_ele->GetNode(0);
+    x1[0] = a_node->X();
+    x1[1] = a_node->Y();
+    x1[2] = a_node->Z();
+    a_node = n_ele->GetNode(1);
+    x2[0] = a_node->X();
+    x2[1] = a_node->Y();
+    x2[2] = a_node->Z();
+
+    if (n_ele->GetElementType() != MshElemType::LINE)
+    {
+        a_node = n_ele->GetNode(2);
+        x3[0] = a_node->X();
+        x3[1] = a_node->Y();
+        x3[2] = a_node->Z();
+    }
 
-    const size_t ne = ele_vector.size();
-    for (size_t i = 0; i < ne; i++)
+    if (n_ele->GetElementType() == MshElemType::QUAD ||
+        n_ele->GetElementType() == MshElemType::TETRAHEDRON)
     {
-        n_ele = ele_vector[i];
-        a = n_ele->GetVolume();
-
-        a_node = n_ele->GetNode(0);
-        x1[0] = a_node->X();
-        x1[1] = a_node->Y();
-        x1[2] = a_node->Z();
-        a_node = n_ele->GetNode(1);
-        x2[0] = a_node->X();
-        x2[1] = a_node->Y();
-        x2[2] = a_node->Z();
-
-        if (n_ele->GetElementType() != MshElemType::LINE)
-        {
-            a_node = n_ele->GetNode(2);
-            x3[0] = a_node->X();
-            x3[1] = a_node->Y();
-            x3[2] = a_node->Z();
-        }
-
-        if (n_ele->GetElementType() == MshElemType::QUAD ||
-            n_ele->GetElementType() == MshElemType::TETRAHEDRON)
-        {
-            a_node = n_ele->GetNode(3);
-            x4[0] = a_node->X();
-            x4[1] = a_node->Y();
-            x4[2] = a_node->Z();
-        }
-
-        if (n_ele->GetElementType() == MshElemType::PYRAMID)
-        {
-            a_node = n_ele->GetNode(3);
-            x4[0] = a_node->X();
-            x4[1] = a_node->Y();
-            x4[2] = a_node->Z();
-            a_node = n_ele->GetNode(4);
-            x5[0] = a_node->X();
-            x5[1] = a_node->Y();
-            x5[2] = a_node->Z();
-        }
-
-        if (n_ele->GetElementType() == MshElemType::PRISM)
-        {
-            a_node = n_ele->GetNode(3);
-            x4[0] = a_node->X();
-            x4[1] = a_node->Y();
-            x4[2] = a_node->Z();
-            a_node = n_ele->GetNode(4);
-            x5[0] = a_node->X();
-            x5[1] = a_node->Y();
-            x5[2] = a_node->Z();
-            a_node = n_ele->GetNode(5);
-            x6[0] = a_node->X();
-            x6[1] = a_node->Y();
-            x6[2] = a_node->Z();
-        }
-
-        if (n_ele->GetElementType() == MshElemType::HEXAHEDRON)
-        {
-            a_node = n_ele->GetNode(3);
-            x4[0] = a_node->X();
-            x4[1] = a_node->Y();
-            x4[2] = a_node->Z();
-            a_node = n_ele->GetNode(4);
-            x5[0] = a_node->X();
-            x5[1] = a_node->Y();
-            x5[2] = a_node->Z();
-            a_node = n_ele->GetNode(5);
-            x6[0] = a_node->X();
-            x6[1] = a_node->Y();
-            x6[2] = a_node->Z();
-            a_node = n_ele->GetNode(6);
-            x7[0] = a_node->X();
-            x7[1] = a_node->Y();
-            x7[2] = a_node->Z();
-            a_node = n_ele->GetNode(7);
-            x8[0] = a_node->X();
-            x8[1] = a_node->Y();
-            x8[2] = a_node->Z();
-        }
-
-        switch (n_ele->GetElementType())
-        {
-            case MshElemType::LINE:
-                double d1, d2, d3;
-                d1 = 0.;
-                d2 = 0.;
-                d3 = 0.;
-                for (int kk = 0; kk < 3; kk++)
-                {
-                    d1 += (x1[kk] - xyz[kk]) * (x1[kk] - xyz[kk]);
-                    d2 += (x2[kk] - xyz[kk]) * (x2[kk] - xyz[kk]);
-                    d3 += (x1[kk] - x2[kk]) * (x1[kk] - x2[kk]);
-                }
-                d1 = sqrt(d1);
-                d2 = sqrt(d2);
-                d3 = sqrt(d3);
+        a_node = n_ele->GetNode(3);
+        x4[0] = a_node->X();
+        x4[1] = a_node->Y();
+        x4[2] = a_node->Z();
+    }
 
-                if (fabs((d1 + d2 - d3) / d3) < tol)
-                {
-                    return i;
-                }
-                break;
+    if (n_ele->GetElementType() == MshElemType::PYRAMID)
+    {
+        a_node = n_ele->GetNode(3);
+        x4[0] = a_node->X();
+        x4[1] = a_node->Y();
+        x4[2] = a_node->Z();
+        a_node = n_ele->GetNode(4);
+        x5[0] = a_node->X();
+        x5[1] = a_node->Y();
+        x5[2] = a_node->Z();
+    }
 
-            case MshElemType::TRIANGLE:
-                a_sub[0] = ComputeDetTri(x1, x2, xyz);
-                a_sub[1] = ComputeDetTri(x2, x3, xyz);
-                a_sub[2] = ComputeDetTri(x3, x1, xyz);
+    if (n_ele->GetElementType() == MshElemType::PRISM)
+    {
+        a_node = n_ele->GetNode(3);
+        x4[0] = a_node->X();
+        x4[1] = a_node->Y();
+        x4[2] = a_node->Z();
+        a_node = n_ele->GetNode(4);
+        x5[0] = a_node->X();
+        x5[1] = a_node->Y();
+        x5[2] = a_node->Z();
+        a_node = n_ele->GetNode(5);
+        x6[0] = a_node->X();
+        x6[1] = a_node->Y();
+        x6[2] = a_node->Z();
+    }
 
-                if (fabs((a_sub[0] + a_sub[1] + a_sub[2] - a) / a) < tol)
-                {
-                    return i;
-                }
-                break;
+    if (n_ele->GetElementType() == MshElemType::HEXAHEDRON)
+    {
+        a_node = n_ele->GetNode(3);
+        x4[0] = a_node->X();
+        x4[1] = a_node->Y();
+        x4[2] = a_node->Z();
+        a_node = n_ele->GetNode(4);
+        x5[0] = a_node->X();
+        x5[1] = a_node->Y();
+        x5[2] = a_node->Z();
+        a_node = n_ele->GetNode(5);
+        x6[0] = a_node->X();
+        x6[1] = a_node->Y();
+        x6[2] = a_node->Z();
+        a_node = n_ele->GetNode(6);
+        x7[0] = a_node->X();
+        x7[1] = a_node->Y();
+        x7[2] = a_node->Z();
+        a_node = n_ele->GetNode(7);
+        x8[0] = a_node->X();
+        x8[1] = a_node->Y();
+        x8[2] = a_node->Z();
+    }
 
-            case MshElemType::QUAD:
-                a_sub[0] = ComputeDetTri(x1, x2, xyz);
-                a_sub[1] = ComputeDetTri(x2, x3, xyz);
-                a_sub[2] = ComputeDetTri(x3, x4, xyz);
-                a_sub[3] = ComputeDetTri(x4, x1, xyz);
+    switch (n_ele->GetElementType())
+    {
+        case MshElemType::LINE:
+            double d1, d2, d3;
+            d1 = 0.;
+            d2 = 0.;
+            d3 = 0.;
+            for (int kk = 0; kk < 3; kk++)
+            {
+                d1 += (x1[kk] - xyz[kk]) * (x1[kk] - xyz[kk]);
+                d2 += (x2[kk] - xyz[kk]) * (x2[kk] - xyz[kk]);
+                d3 += (x1[kk] - x2[kk]) * (x1[kk] - x2[kk]);
+            }
+            d1 = sqrt(d1);
+            d2 = sqrt(d2);
+            d3 = sqrt(d3);
 
-                if (fabs((a_sub[0] + a_sub[1] + a_sub[2] + a_sub[3] - a) / a) <
-                    tol)
-                {
-                    return i;
-                }
-                break;
+            if (fabs((d1 + d2 - d3) / d3) < tol)
+            {
+                return true;
+            }
+            break;
 
-            case MshElemType::TETRAHEDRON:
-                a_sub[0] = ComputeDetTex(x2, x4, x3, xyz);
-                a_sub[1] = ComputeDetTex(x1, x3, x4, xyz);
-                a_sub[2] = ComputeDetTex(x2, x1, x4, xyz);
-                a_sub[3] = ComputeDetTex(x2, x3, x1, xyz);
+        case MshElemType::TRIANGLE:
+            a_sub[0] = ComputeDetTri(x1, x2, xyz);
+            a_sub[1] = ComputeDetTri(x2, x3, xyz);
+            a_sub[2] = ComputeDetTri(x3, x1, xyz);
 
-                if (fabs((a_sub[0] + a_sub[1] + a_sub[2] + a_sub[3] - a) / a) <
-                    tol)
-                {
-                    return i;
-                }
-                break;
+            if (fabs((a_sub[0] + a_sub[1] + a_sub[2] - a) / a) < tol)
+            {
+                return true;
+            }
+            break;
 
-            case MshElemType::PYRAMID:
-                a_sub[0] = ComputeDetTex(x1, x2, x4, xyz);
-                a_sub[1] = ComputeDetTex(x2, x3, x4, xyz);
-                a_sub[2] = ComputeDetTex(x1, x5, x2, xyz);
-                a_sub[3] = ComputeDetTex(x2, x5, x4, xyz);
-                a_sub[4] = ComputeDetTex(x3, x5, x4, xyz);
-                a_sub[5] = ComputeDetTex(x4, x5, x1, xyz);
-
-                if (fabs((a_sub[0] + a_sub[1] + a_sub[2] + a_sub[3] + a_sub[4] +
-                          a_sub[5] - a) /
-                         a) < tol)
-                {
-                    return i;
-                }
-                break;
+        case MshElemType::QUAD:
+            a_sub[0] = ComputeDetTri(x1, x2, xyz);
+            a_sub[1] = ComputeDetTri(x2, x3, xyz);
+            a_sub[2] = ComputeDetTri(x3, x4, xyz);
+            a_sub[3] = ComputeDetTri(x4, x1, xyz);
 
-            case MshElemType::PRISM:
-                a_sub[0] = ComputeDetTex(x1, x2, x3, xyz);
-                a_sub[1] = ComputeDetTex(x4, x6, x5, xyz);
-                a_sub[2] = ComputeDetTex(x1, x4, x2, xyz);
-                a_sub[3] = ComputeDetTex(x2, x4, x5, xyz);
-                a_sub[4] = ComputeDetTex(x2, x5, x3, xyz);
-                a_sub[5] = ComputeDetTex(x3, x5, x6, xyz);
-                a_sub[6] = ComputeDetTex(x3, x6, x1, xyz);
-                a_sub[7] = ComputeDetTex(x1, x6, x4, xyz);
-
-                if (fabs((a_sub[0] + a_sub[1] + a_sub[2] + a_sub[3] + a_sub[4] +
-                          a_sub[5] + a_sub[6] + a_sub[7] - a) /
-                         a) < tol)
-                {
-                    return i;
-                }
-                break;
+            if (fabs((a_sub[0] + a_sub[1] + a_sub[2] + a_sub[3] - a) / a) <
+                tol)
+            {
+                return true;
+            }
+            break;
 
-            case MshElemType::HEXAHEDRON:
-                a_sub[0] = ComputeDetTex(x1, x2, x4, xyz);
-                a_sub[1] = ComputeDetTex(x4, x2, x3, xyz);
-                a_sub[2] = ComputeDetTex(x2, x6, x3, xyz);
-                a_sub[3] = ComputeDetTex(x3, x6, x7, xyz);
-                a_sub[4] = ComputeDetTex(x3, x7, x4, xyz);
-                a_sub[5] = ComputeDetTex(x4, x7, x8, xyz);
-                a_sub[6] = ComputeDetTex(x4, x8, x1, xyz);
-                a_sub[7] = ComputeDetTex(x1, x8, x5, xyz);
-                a_sub[8] = ComputeDetTex(x1, x5, x2, xyz);
-                a_sub[9] = ComputeDetTex(x2, x5, x6, xyz);
-                a_sub[10] = ComputeDetTex(x5, x8, x6, xyz);
-                a_sub[11] = ComputeDetTex(x6, x8, x7, xyz);
-
-                if (fabs((a_sub[0] + a_sub[1] + a_sub[2] + a_sub[3] + a_sub[4] +
-                          a_sub[5] + a_sub[6] + a_sub[7] + a_sub[8] + a_sub[9] +
-                          a_sub[10] + a_sub[11] - a) /
-                         a) < tol)
-                {
-                    return i;
-                }
-                break;
+        case MshElemType::TETRAHEDRON:
+            a_sub[0] = ComputeDetTex(x2, x4, x3, xyz);
+            a_sub[1] = ComputeDetTex(x1, x3, x4, xyz);
+            a_sub[2] = ComputeDetTex(x2, x1, x4, xyz);
+            a_sub[3] = ComputeDetTex(x2, x3, x1, xyz);
 
-            default:
-                // do nothing with other elements
-                break;
-        }
+            if (fabs((a_sub[0] + a_sub[1] + a_sub[2] + a_sub[3] - a) / a) <
+                tol)
+            {
+                return true;
+            }
+            break;
+
+        case MshElemType::PYRAMID:
+            a_sub[0] = ComputeDetTex(x1, x2, x4, xyz);
+            a_sub[1] = ComputeDetTex(x2, x3, x4, xyz);
+            a_sub[2] = ComputeDetTex(x1, x5, x2, xyz);
+            a_sub[3] = ComputeDetTex(x2, x5, x4, xyz);
+            a_sub[4] = ComputeDetTex(x3, x5, x4, xyz);
+            a_sub[5] = ComputeDetTex(x4, x5, x1, xyz);
+
+            if (fabs((a_sub[0] + a_sub[1] + a_sub[2] + a_sub[3] + a_sub[4] +
+                      a_sub[5] - a) /
+                     a) < tol)
+            {
+                return true;
+            }
+            break;
+
+        case MshElemType::PRISM:
+            a_sub[0] = ComputeDetTex(x1, x2, x3, xyz);
+            a_sub[1] = ComputeDetTex(x4, x6, x5, xyz);
+            a_sub[2] = ComputeDetTex(x1, x4, x2, xyz);
+            a_sub[3] = ComputeDetTex(x2, x4, x5, xyz);
+            a_sub[4] = ComputeDetTex(x2, x5, x3, xyz);
+            a_sub[5] = ComputeDetTex(x3, x5, x6, xyz);
+            a_sub[6] = ComputeDetTex(x3, x6, x1, xyz);
+            a_sub[7] = ComputeDetTex(x1, x6, x4, xyz);
+
+            if (fabs((a_sub[0] + a_sub[1] + a_sub[2] + a_sub[3] + a_sub[4] +
+                      a_sub[5] + a_sub[6] + a_sub[7] - a) /
+                     a) < tol)
+            {
+                return true;
+            }
+            break;
+
+        case MshElemType::HEXAHEDRON:
+            a_sub[0] = ComputeDetTex(x1, x2, x4, xyz);
+            a_sub[1] = ComputeDetTex(x4, x2, x3, xyz);
+            a_sub[2] = ComputeDetTex(x2, x6, x3, xyz);
+            a_sub[3] = ComputeDetTex(x3, x6, x7, xyz);
+            a_sub[4] = ComputeDetTex(x3, x7, x4, xyz);
+            a_sub[5] = ComputeDetTex(x4, x7, x8, xyz);
+            a_sub[6] = ComputeDetTex(x4, x8, x1, xyz);
+            a_sub[7] = ComputeDetTex(x1, x8, x5, xyz);
+            a_sub[8] = ComputeDetTex(x1, x5, x2, xyz);
+            a_sub[9] = ComputeDetTex(x2, x5, x6, xyz);
+            a_sub[10] = ComputeDetTex(x5, x8, x6, xyz);
+            a_sub[11] = ComputeDetTex(x6, x8, x7, xyz);
+
+            if (fabs((a_sub[0] + a_sub[1] + a_sub[2] + a_sub[3] + a_sub[4] +
+                      a_sub[5] + a_sub[6] + a_sub[7] + a_sub[8] + a_sub[9] +
+                      a_sub[10] + a_sub[11] - a) /
+                     a) < tol)
+            {
+                return true;
+            }
+            break;
+
+        default:
+            // do nothing with other elements
+            break;
     }
+    return false;
+}
+
+/*!
+   brief Find the element by a point
+   YS/WW 05/2012
+*/
+size_t CFEMesh::FindElementByPoint(const double* xyz)
+{
+    // Only the elements whose bounding box contains the point are tested.
+    // They are ascending, so that the found element is the first one in
+    // ele_vector.
+    std::vector<long> candidates;
+    getElementGrid().getElementsAtPoint(xyz, candidates);
+    for (std::size_t i = 0; i < candidates.size(); i++)
+        if (isPointInElement(ele_vector[candidates[i]], xyz))
+            return candidates[i];
     // Not find
     return -1;
 }
 
+/*!
+   The grid of the elements, built if it does not exist or if the number of
+   elements has changed
+*/
+const MeshElementGrid& CFEMesh::getElementGrid() const
+{
+    if (_element_grid &&
+        _element_grid->getNumberOfElements() != ele_vector.size())
+        InvalidateElementGrid();
+    if (!_element_grid)
+        _element_grid = new MeshElementGrid(ele_vector);
+    return *_element_grid;
+}
+
+/// Remove the grid of the elements, e.g. after the nodes have moved
+void CFEMesh::InvalidateElementGrid() const
+{
+    delete _element_grid;
+    _element_grid = NULL;
+}
+
 // 09. 2012 WW
 /// Free the memory occupied by edges
 void CFEMesh::FreeEdgeMemory()
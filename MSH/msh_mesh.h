@@ -39,10 +39,12 @@
 
 // MSHLib
 #include "MSHEnums.h"  // KR 2010/11/15
+#include "MeshElementGrid.h"
 #include "MeshNodesAlongPolyline.h"
 
 // FileIO
 #include "MeshIO/OGSMeshIO.h"
+#include "MeshIO/OGSMeshIOBinary.h"
 
 #include "msh_elem.h"
 
@@ -194,11 +196,26 @@ public:
     bool Read(std::ifstream* fem_file);
 
     friend class FileIO::OGSMeshIO;
+    friend class FileIO::OGSMeshIOBinary;
     std::ios::pos_type GMSReadTIN(std::ifstream*);
     //
     void ConstructGrid();
+    /**
+     * Builds the edges of a mesh with deferred edges, which
+     * ConstructGrid() skips. Features that need the edges call it before
+     * they use them, it does nothing if the edges exist.
+     */
+    void ConstructEdges();
     void GenerateHighOrderNodes();
 
+    /**
+     * Deferred edges of the meshes constructed afterwards, chosen with the
+     * option --deferred-edges of ogs: the edges of the elements are built on
+     * demand only (ConstructEdges()).
+     */
+    static void setDeferredEdges(bool defer) { _defer_edges = defer; }
+    static bool hasDeferredEdges() { return _defer_edges; }
+
     void markTopSurfaceFaceElements3D();
 
 /// For parallel computing. 03.2012. WW
@@ -283,6 +300,17 @@ public:
     */
     size_t FindElementByPoint(const double* xyz);
 
+    /// Point-in-element test of FindElementByPoint
+    bool isPointInElement(CElem const* elem, const double* xyz) const;
+
+    /**
+     * Grid of the elements for the search of elements by points, boxes and
+     * segments. It is built at the first call.
+     */
+    const MeshElementGrid& getElementGrid() const;
+    /// Has to be called if the nodes move
+    void InvalidateElementGrid() const;
+
     /**
      * \brief depreciated method - uses old surface class
      */
@@ -445,7 +473,18 @@ public:
 
     void ConnectedNodes(bool quadratic) const;
     // WW
-    void ConnectedElements2Node(bool quadratic = false);
+    void ConnectedElements2Node(bool quadratic = false,
+                                bool all_elements = false);
+    /// Sets the elements connected to the nodes, the ones of node i given by
+    /// element_ids[node_ptr[i]] to element_ids[node_ptr[i+1]-1]
+    void setConnectedElements(std::vector<size_t> const& node_ptr,
+                              std::vector<size_t> const& element_ids);
+    /// Greedy coloring of all elements for the parallel assembly.
+    void ColorElements();
+    /// Elements ele_color_elements[ele_color_ptr[c], ele_color_ptr[c+1]) have
+    /// the color c. Elements of the same color do not share nodes.
+    std::vector<long> ele_color_ptr;
+    std::vector<long> ele_color_elements;
     // OK
     std::vector<std::string> mat_names_vector;
     void DefineMobileNodes(CRFProcess*);  // OK
@@ -459,6 +498,9 @@ public:
 #ifdef NEW_EQS  // 1.11.2007 WW
     // Compute the graph of the sparse matrix related to this mesh. 1.11.2007 WW
     void CreateSparseTable();
+    /// Equation numbering of the nodes for the sparse table, 1: reverse
+    /// Cuthill-McKee, 2: Hilbert curve
+    void RenumberEquations(const int method);
     // Get the sparse graph   1.11.2007 WW
     SparseTable* GetSparseTable(bool quad = false) const
     {
@@ -586,6 +628,28 @@ public:
 
 private:
     GEOLIB::Grid<MeshLib::CNode>* _mesh_grid;
+    mutable MeshElementGrid* _element_grid;
+    static bool _defer_edges;
+    /// ConstructGrid() left the edges to ConstructEdges()
+    bool _has_deferred_edges;
+    /// Creates the edges of the elements from their grouping by nodes, see
+    /// ConstructGrid()
+    void BuildEdges(const std::vector<long>& edge_ptr,
+                    const std::vector<long>& sorted_edges,
+                    const std::vector<long>& edge_group, bool all_elements);
+    /// The neighbors and edges of the elements and the connectivity of the
+    /// nodes were read from a binary mesh file, and ConstructGrid() does not
+    /// search them
+    bool _has_file_topology;
+    /// Elements and nodes connected to the nodes in compressed row storage,
+    /// the ones of node i from index ptr[i] to ptr[i+1]-1. The nodes hold
+    /// views of their rows.
+    std::vector<size_t> _node_elements_ptr;
+    std::vector<size_t> _node_elements;
+    mutable std::vector<size_t> _node_nodes_ptr;
+    mutable std::vector<size_t> _node_nodes;
+    /// Points the nodes to their rows of the adjacencies
+    void UpdateNodeAdjacencyViews() const;
 };
 
 }  // namespace MeshLib
@@ -24,6 +24,8 @@
 //========================================================================
 namespace MeshLib
 {
+unsigned long CNode::coordinate_changes = 0;
+
 /**************************************************************************
    MSHLib-Method:
    Task:
@@ -129,6 +131,7 @@ void CNode::operator=(const CNode& n)
     coordinate[0] = n.coordinate[0];
     coordinate[1] = n.coordinate[1];
     coordinate[2] = n.coordinate[2];
+    CountMove();
 }
 /**************************************************************************
    MSHLib-Method:
@@ -172,6 +175,7 @@ void CNode::SetCoordinates(const double* argCoord)
     coordinate[0] = argCoord[0];
     coordinate[1] = argCoord[1];
     coordinate[2] = argCoord[2];
+    CountMove();
 }
 
 std::ostream& operator<<(std::ostream& os, MeshLib::CNode const& node)
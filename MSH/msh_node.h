@@ -28,6 +28,32 @@
 
 namespace MeshLib
 {
+/**
+ * \brief Read-only view of the row of a node in an adjacency of the mesh,
+ * e.g. the connected nodes or elements, which the mesh keeps in compressed
+ * row storage (see CFEMesh::ConnectedNodes()).
+ */
+class NodeAdjacency
+{
+public:
+    NodeAdjacency() : _ids(NULL), _size(0) {}
+    NodeAdjacency(size_t const* ids, size_t size) : _ids(ids), _size(size) {}
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    size_t operator[](size_t i) const
+    {
+        assert(i < _size);
+        return _ids[i];
+    }
+    size_t const* begin() const { return _ids; }
+    size_t const* end() const { return _ids + _size; }
+
+private:
+    size_t const* _ids;
+    size_t _size;
+};
+
 // Class definition
 class CNode : public CCore
 {
@@ -102,29 +128,47 @@ public:
      */
     inline double const* getData() const { return coordinate; }
     // Set functions
-    void SetX(double argX) { coordinate[0] = argX; }
-    void SetY(double argY) { coordinate[1] = argY; }
-    void SetZ(double argZ) { coordinate[2] = argZ; }
+    void SetX(double argX)
+    {
+        coordinate[0] = argX;
+        CountMove();
+    }
+    void SetY(double argY)
+    {
+        coordinate[1] = argY;
+        CountMove();
+    }
+    void SetZ(double argZ)
+    {
+        coordinate[2] = argZ;
+        CountMove();
+    }
     void SetCoordinates(const double* argCoord);
+    /// Number of changes of the coordinates of all nodes by the set
+    /// functions, e.g. to detect a moved mesh
+    static unsigned long getCoordinateChanges() { return coordinate_changes; }
 
     int GetEquationIndex() const { return eqs_index; }
     void SetEquationIndex(long eqIndex) { eqs_index = eqIndex; }
     // Output
     void Write(std::ostream& os = std::cout) const;
 
-    std::vector<size_t> const& getConnectedElementIDs() const
+    /// Elements connected to the node, see CFEMesh::ConnectedElements2Node()
+    NodeAdjacency const& getConnectedElementIDs() const
     {
         return _connected_elements;
     }
-    std::vector<size_t>& getConnectedElementIDs()
+    void setConnectedElementIDs(NodeAdjacency const& elements)
     {
-        return _connected_elements;
+        _connected_elements = elements;
     }
-    std::vector<size_t> const& getConnectedNodes() const
+    /// Nodes connected to the node in ascending order, the node itself
+    /// included, see CFEMesh::ConnectedNodes()
+    NodeAdjacency const& getConnectedNodes() const { return _connected_nodes; }
+    void setConnectedNodes(NodeAdjacency const& nodes)
     {
-        return _connected_nodes;
+        _connected_nodes = nodes;
     }
-    std::vector<size_t>& getConnectedNodes() { return _connected_nodes; }
     size_t getNumConnectedNodes() const { return _connected_nodes.size(); }
     /*!
      * \brief Check whether the node is non-ghost
@@ -142,9 +186,17 @@ public:
 
 private:
     double coordinate[3];
+    static unsigned long coordinate_changes;
+    static void CountMove()
+    {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+        coordinate_changes++;
+    }
     long eqs_index;                        // renumber
-    std::vector<size_t> _connected_nodes;  // OK
-    std::vector<size_t> _connected_elements;
+    NodeAdjacency _connected_nodes;  // OK
+    NodeAdjacency _connected_elements;
 };
 
 std::ostream& operator<<(std::ostream& os, MeshLib::CNode const& node);
@@ -342,7 +342,7 @@ void ExtractMeshNodes::writeMesh2DNodeIDAndArea(std::ostream& os,
     for (size_t k(0); k < n_nodes; k++)
     {
         // get all associated mesh elements
-        std::vector<size_t> const& mesh_elem_ids(
+        MeshLib::NodeAdjacency const& mesh_elem_ids(
             msh_nodes[node_ids[k]]->getConnectedElementIDs());
         size_t n_mesh_elem_ids(mesh_elem_ids.size());
         // get areas for mesh elements
@@ -425,7 +425,7 @@ void ExtractMeshNodes::writeMesh2DNodeIDAndArea(
     for (size_t k(0); k < n_nodes; k++)
     {
         // get all associated mesh elements
-        std::vector<size_t> const& mesh_elem_ids(
+        MeshLib::NodeAdjacency const& mesh_elem_ids(
             msh_nodes[node_ids[k]]->getConnectedElementIDs());
         size_t n_mesh_elem_ids(mesh_elem_ids.size());
         // get areas for mesh elements
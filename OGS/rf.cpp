@@ -59,6 +59,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #endif
+#include "msh_mesh.h"
 #include "problem.h"
 
 /* Deklarationen */
@@ -214,6 +215,8 @@ int main(int argc, char* argv[])
                 << "  -h [--help]               print this message and exit\n"
                 << "  -b [--build-info]         print build info and exit\n"
                 << "  --output-directory DIR    put output files into DIR\n"
+                << "  --deferred-edges          build the mesh edges on demand "
+                   "only\n"
                 << "  --version                 print ogs version and exit"
                 << "\n";
             exit(0);
@@ -233,6 +236,11 @@ int main(int argc, char* argv[])
             std::cout << BuildInfo::OGS_VERSION << "\n";
             exit(0);
         }
+        if (anArg == "--deferred-edges")
+        {
+            MeshLib::CFEMesh::setDeferredEdges(true);
+            continue;
+        }
         if (anArg == "--output-directory")
         {
             if (i + 1 >= arg_strings.size())
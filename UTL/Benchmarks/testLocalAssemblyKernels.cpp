@@ -0,0 +1,209 @@
+/*
+ * testLocalAssemblyKernels.cpp
+ *
+ * Micro-benchmark of the integration point kernels of the local matrices of
+ * CFiniteElementStd: the loops over the run time numbers of nodes and
+ * dimensions as in CalcMass, CalcLaplace and CalcAdvection before, against
+ * the kernels of LocalAssemblyKernels.h. The old loops access the matrix
+ * entries by a virtual operator() like that of Math_Group::Matrix.
+ *
+ * Usage: testLocalAssemblyKernels [number of elements]
+ *
+ *  Created on: Oct 18, 2026
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// FEM
+#include "LocalAssemblyKernels.h"
+
+/// Row-major matrix with the element access of Math_Group::Matrix
+class LocalMatrix
+{
+public:
+    LocalMatrix(const std::size_t rows, const std::size_t cols)
+        : ncols(cols), data(rows * cols, 0.0)
+    {
+    }
+    virtual ~LocalMatrix() {}
+    virtual double& operator()(const std::size_t i, const std::size_t j);
+    void operator=(const double a) { std::fill(data.begin(), data.end(), a); }
+    std::size_t Size() const { return data.size(); }
+    double* getEntryArray() { return &data[0]; }
+    double operator[](const std::size_t i) const { return data[i]; }
+
+private:
+    std::size_t ncols;
+    std::vector<double> data;
+};
+
+double& LocalMatrix::operator()(const std::size_t i, const std::size_t j)
+{
+    return data[i * ncols + j];
+}
+
+struct ElementCase
+{
+    const char* name;
+    int nnodes;
+    int dim;
+    int n_gauss_points;
+};
+
+struct IntegrationPointData
+{
+    std::vector<double> N;
+    std::vector<double> dN;
+    std::vector<double> K;
+    std::vector<double> v;
+};
+
+void oldMass(const double fac, const double* N, const int nnodes,
+             LocalMatrix& M)
+{
+    for (int i = 0; i < nnodes; i++)
+        for (int j = 0; j < nnodes; j++)
+            M(i, j) += fac * N[i] * N[j];
+}
+
+void oldLaplace(const double fac, const double* dN, const double* K,
+                const int nnodes, const std::size_t dim,
+                LocalMatrix& M)
+{
+    for (int i = 0; i < nnodes; i++)
+        for (int j = 0; j < nnodes; j++)
+            for (std::size_t k = 0; k < dim; k++)
+            {
+                const int ksh = k * nnodes + i;
+                const int km = dim * k;
+                for (std::size_t l = 0; l < dim; l++)
+                    M(i, j) += fac * dN[ksh] * K[km + l] * dN[l * nnodes + j];
+            }
+}
+
+void oldAdvection(const double fac, const double* N, const double* v,
+                  const double* dN, const int nnodes, const std::size_t dim,
+                  LocalMatrix& M)
+{
+    for (int i = 0; i < nnodes; i++)
+        for (int j = 0; j < nnodes; j++)
+            for (std::size_t k = 0; k < dim; k++)
+                M(i, j) += fac * N[i] * v[k] * dN[k * nnodes + j];
+}
+
+double maxDifference(const LocalMatrix& A, const LocalMatrix& B)
+{
+    double diff = 0.0;
+    for (std::size_t i = 0; i < A.Size(); i++)
+        diff = std::max(diff, std::fabs(A[i] - B[i]) /
+                                  std::max(1.0, std::fabs(A[i])));
+    return diff;
+}
+
+int main(int argc, char* argv[])
+{
+    const long n_elements = (argc > 1) ? std::atol(argv[1]) : 20000;
+    const ElementCase cases[] = {
+        {"line", 2, 1, 3},         {"tri", 3, 2, 3},
+        {"tri in 3D", 3, 3, 3},    {"quad", 4, 2, 9},
+        {"tet", 4, 3, 5},          {"prism", 6, 3, 9},
+        {"hex", 8, 3, 27},         {"quadratic tri", 6, 2, 3},
+        {"quadratic quad", 9, 2, 9}, {"quadratic tet", 10, 3, 15},
+        {"quadratic prism", 15, 3, 9}, {"quadratic hex", 20, 3, 27}};
+    const std::size_t n_cases = sizeof(cases) / sizeof(cases[0]);
+
+    std::srand(1);
+    std::cout << std::setw(16) << "element" << std::setw(10) << "kernel"
+              << std::setw(12) << "old [s]" << std::setw(12) << "new [s]"
+              << std::setw(10) << "speedup" << std::setw(12) << "rel. diff"
+              << std::endl;
+    for (std::size_t c = 0; c < n_cases; c++)
+    {
+        const ElementCase& ec = cases[c];
+        const int n = ec.nnodes;
+        const int dim = ec.dim;
+        std::vector<IntegrationPointData> ips(ec.n_gauss_points);
+        for (int gp = 0; gp < ec.n_gauss_points; gp++)
+        {
+            IntegrationPointData& ip = ips[gp];
+            ip.N.resize(n);
+            ip.dN.resize(n * dim);
+            ip.K.resize(dim * dim);
+            ip.v.resize(3);
+            for (int i = 0; i < n; i++)
+                ip.N[i] = std::rand() / (double)RAND_MAX;
+            for (int i = 0; i < n * dim; i++)
+                ip.dN[i] = std::rand() / (double)RAND_MAX - 0.5;
+            for (int i = 0; i < dim * dim; i++)
+                ip.K[i] = std::rand() / (double)RAND_MAX;
+            for (int i = 0; i < 3; i++)
+                ip.v[i] = std::rand() / (double)RAND_MAX - 0.5;
+        }
+        const FiniteElement::LocalAssemblyKernels& kernels =
+            FiniteElement::getLocalAssemblyKernels(n, dim);
+
+        for (int kernel = 0; kernel < 3; kernel++)
+        {
+            LocalMatrix M_old(n, n), M_new(n, n);
+            clock_t start = clock();
+            for (long e = 0; e < n_elements; e++)
+            {
+                M_old = 0.0;
+                // Varies with the element, so that nothing is hoisted
+                const double fac = 0.5 + 1.e-9 * e;
+                for (int gp = 0; gp < ec.n_gauss_points; gp++)
+                {
+                    const IntegrationPointData& ip = ips[gp];
+                    if (kernel == 0)
+                        oldMass(fac, &ip.N[0], n, M_old);
+                    else if (kernel == 1)
+                        oldLaplace(fac, &ip.dN[0], &ip.K[0], n, dim, M_old);
+                    else
+                        oldAdvection(fac, &ip.N[0], &ip.v[0], &ip.dN[0], n,
+                                     dim, M_old);
+                }
+            }
+            const double t_old = (clock() - start) / (double)CLOCKS_PER_SEC;
+
+            start = clock();
+            for (long e = 0; e < n_elements; e++)
+            {
+                M_new = 0.0;
+                double* M = M_new.getEntryArray();
+                const double fac = 0.5 + 1.e-9 * e;
+                for (int gp = 0; gp < ec.n_gauss_points; gp++)
+                {
+                    const IntegrationPointData& ip = ips[gp];
+                    if (kernel == 0)
+                        kernels.shape_product(fac, &ip.N[0], n, M, n, false);
+                    else if (kernel == 1)
+                        kernels.grad_shape_product(fac, &ip.dN[0], &ip.K[0],
+                                                   n, dim, M, n);
+                    else
+                        kernels.shape_grad_product(fac, &ip.N[0], &ip.v[0],
+                                                   &ip.dN[0], n, dim, M, n);
+                }
+            }
+            const double t_new = (clock() - start) / (double)CLOCKS_PER_SEC;
+
+            const char* kernel_names[] = {"mass", "laplace", "advection"};
+            std::cout << std::setw(16) << ec.name << std::setw(10)
+                      << kernel_names[kernel] << std::setw(12) << t_old
+                      << std::setw(12) << t_new << std::setw(10)
+                      << ((t_new > 0.) ? t_old / t_new : 0.) << std::setw(12)
+                      << maxDifference(M_old, M_new) << std::endl;
+        }
+    }
+    return 0;
+}
@@ -184,7 +184,7 @@ void ModifyMeshProperties::substituteMaterialID(GEOLIB::Polygon const& polygon,
 
     for (size_t k(0); k < n_mesh_node_ids; k++)
     {
-        std::vector<size_t> const& connected_element_ids(
+        MeshLib::NodeAdjacency const& connected_element_ids(
             mesh_nodes[mesh_node_ids[k]]->getConnectedElementIDs());
         for (size_t j(0); j < connected_element_ids.size(); j++)
         {
@@ -0,0 +1,88 @@
+/*
+ * mainConvertMeshToBinary.cpp
+ *
+ * Converts an ASCII OGS mesh file (*.msh) to a binary mesh file (*.msb),
+ * which FEMRead() reads instead of the ASCII file.
+ *
+ *  Created on: Oct 18, 2026
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// FEM
+#include "problem.h"
+
+// MSH
+#include "msh_lib.h"  // for FEMRead
+#include "msh_mesh.h"
+
+// FileIO
+#include "MeshIO/OGSMeshIOBinary.h"
+
+Problem* aproblem = NULL;
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3 || std::string(argv[1]).find("--mesh") == std::string::npos)
+    {
+        std::cout << "program " << argv[0]
+                  << " converts an ogs mesh file to a binary mesh file, by "
+                     "default with the topology of the elements and nodes"
+                  << std::endl;
+        std::cout << "Usage: " << std::endl
+                  << argv[0] << "\n\t--mesh ogs_meshfile\n\t[--no-topology]"
+                  << std::endl;
+        return -1;
+    }
+
+    std::string file_base_name(argv[2]);
+    if (file_base_name.find(".msh") != std::string::npos)
+        file_base_name = file_base_name.substr(0, file_base_name.size() - 4);
+    const bool with_topology =
+        !(argc > 3 && std::string(argv[3]).find("--no-topology") !=
+                          std::string::npos);
+
+    // *** read the ASCII mesh file
+    std::vector<MeshLib::CFEMesh*> mesh_vec;
+    FEMRead(file_base_name, mesh_vec, NULL, NULL, false);
+    if (mesh_vec.empty())
+    {
+        std::cerr << "could not read mesh from file " << file_base_name
+                  << ".msh" << std::endl;
+        return -1;
+    }
+    if (with_topology)
+        for (std::size_t i = 0; i < mesh_vec.size(); i++)
+            mesh_vec[i]->ConstructGrid();
+
+    // *** write the binary mesh file
+    const std::string bin_file_name(
+        FileIO::OGSMeshIOBinary::getFileName(file_base_name));
+    FileIO::OGSMeshIOBinary meshIO;
+    const bool written =
+        meshIO.write(bin_file_name, mesh_vec, with_topology);
+    if (written)
+    {
+        std::cout << "wrote " << mesh_vec.size() << " mesh(es) to "
+                  << bin_file_name << std::endl;
+        for (std::size_t i = 0; i < mesh_vec.size(); i++)
+            std::cout << "\tmesh " << i << ": "
+                      << mesh_vec[i]->nod_vector.size() << " nodes, "
+                      << mesh_vec[i]->ele_vector.size() << " elements, "
+                      << mesh_vec[i]->edge_vector.size() << " edges"
+                      << std::endl;
+    }
+    else
+        std::cerr << "could not write " << bin_file_name << std::endl;
+
+    for (std::size_t i = 0; i < mesh_vec.size(); i++)
+        delete mesh_vec[i];
+    return written ? 0 : -1;
+}
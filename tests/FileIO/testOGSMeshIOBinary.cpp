@@ -0,0 +1,262 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ * File:   testOGSMeshIOBinary.cpp
+ *
+ * Created on October 18, 2026
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "MeshIO/OGSMeshIOBinary.h"
+#include "msh_edge.h"
+#include "msh_elem.h"
+#include "msh_mesh.h"
+#include "msh_node.h"
+
+#include "../TestMeshes.h"
+
+using FileIO::OGSMeshIOBinary;
+using MeshLib::CElem;
+using MeshLib::CFEMesh;
+using MeshLib::CNode;
+
+namespace
+{
+std::string getTestFileName()
+{
+    return std::string(::testing::UnitTest::GetInstance()
+                           ->current_test_info()
+                           ->name()) +
+           ".msb";
+}
+
+std::vector<char> readBytes(const std::string& file_name)
+{
+    std::ifstream is(file_name.c_str(), std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(is),
+                             std::istreambuf_iterator<char>());
+}
+
+void writeBytes(const std::string& file_name, const std::vector<char>& bytes)
+{
+    std::ofstream os(file_name.c_str(), std::ios::binary | std::ios::trunc);
+    os.write(&bytes[0], bytes.size());
+}
+
+void deleteMeshes(std::vector<CFEMesh*>& meshes)
+{
+    for (std::size_t m = 0; m < meshes.size(); m++)
+        delete meshes[m];
+    meshes.clear();
+}
+
+/// Compares two meshes after ConstructGrid(), including the topology
+void compareMeshes(CFEMesh& expected, CFEMesh& mesh)
+{
+    ASSERT_EQ(expected.nod_vector.size(), mesh.nod_vector.size());
+    ASSERT_EQ(expected.ele_vector.size(), mesh.ele_vector.size());
+    ASSERT_EQ(expected.edge_vector.size(), mesh.edge_vector.size());
+    for (std::size_t i = 0; i < mesh.nod_vector.size(); i++)
+    {
+        const CNode& a = *expected.nod_vector[i];
+        const CNode& b = *mesh.nod_vector[i];
+        for (int d = 0; d < 3; d++)
+            EXPECT_EQ(a.getData()[d], b.getData()[d]) << "node " << i;
+        ASSERT_EQ(a.getConnectedElementIDs().size(),
+                  b.getConnectedElementIDs().size())
+            << "node " << i;
+        for (std::size_t k = 0; k < a.getConnectedElementIDs().size(); k++)
+            EXPECT_EQ(a.getConnectedElementIDs()[k],
+                      b.getConnectedElementIDs()[k])
+                << "node " << i;
+        ASSERT_EQ(a.getConnectedNodes().size(), b.getConnectedNodes().size())
+            << "node " << i;
+        for (std::size_t k = 0; k < a.getConnectedNodes().size(); k++)
+            EXPECT_EQ(a.getConnectedNodes()[k], b.getConnectedNodes()[k])
+                << "node " << i;
+    }
+    for (std::size_t e = 0; e < mesh.ele_vector.size(); e++)
+    {
+        CElem& a = *expected.ele_vector[e];
+        CElem& b = *mesh.ele_vector[e];
+        EXPECT_EQ(a.GetElementType(), b.GetElementType()) << "element " << e;
+        EXPECT_EQ(a.GetPatchIndex(), b.GetPatchIndex()) << "element " << e;
+        ASSERT_EQ(a.GetNodesNumber(false), b.GetNodesNumber(false));
+        for (std::size_t k = 0; k < a.GetNodesNumber(false); k++)
+            EXPECT_EQ(a.GetNodeIndex(k), b.GetNodeIndex(k))
+                << "element " << e;
+        ASSERT_EQ(a.GetFacesNumber(), b.GetFacesNumber());
+        for (std::size_t k = 0; k < a.GetFacesNumber(); k++)
+            EXPECT_EQ(a.GetNeighbor(k)->GetIndex(),
+                      b.GetNeighbor(k)->GetIndex())
+                << "element " << e << ", face " << k;
+        ASSERT_EQ(a.GetEdgesNumber(), b.GetEdgesNumber());
+        for (std::size_t k = 0; k < a.GetEdgesNumber(); k++)
+        {
+            EXPECT_EQ(a.GetEdge(k)->GetIndex(), b.GetEdge(k)->GetIndex())
+                << "element " << e << ", edge " << k;
+            for (int l = 0; l < 2; l++)
+                EXPECT_EQ(a.GetEdge(k)->GetNode(l)->GetIndex(),
+                          b.GetEdge(k)->GetNode(l)->GetIndex())
+                    << "element " << e << ", edge " << k;
+        }
+    }
+}
+}  // namespace
+
+TEST(FileIO, OGSMeshIOBinaryRoundTrip)
+{
+    std::vector<CFEMesh*> meshes;
+    meshes.push_back(
+        TestMeshes::readMesh(TestMeshes::createRectangle(5, 4, true)));
+    meshes.push_back(
+        TestMeshes::readMesh(TestMeshes::createBox(3, 3, 2, true)));
+    for (std::size_t m = 0; m < meshes.size(); m++)
+        meshes[m]->ConstructGrid();
+
+    const std::string file_name = getTestFileName();
+    OGSMeshIOBinary io;
+    for (int with_topology = 0; with_topology < 2; with_topology++)
+    {
+        ASSERT_TRUE(io.write(file_name, meshes, with_topology != 0));
+        std::vector<CFEMesh*> read_meshes;
+        ASSERT_TRUE(io.read(file_name, read_meshes));
+        ASSERT_EQ(meshes.size(), read_meshes.size());
+        for (std::size_t m = 0; m < meshes.size(); m++)
+        {
+            read_meshes[m]->ConstructGrid();
+            compareMeshes(*meshes[m], *read_meshes[m]);
+        }
+        deleteMeshes(read_meshes);
+    }
+    std::remove(file_name.c_str());
+    deleteMeshes(meshes);
+}
+
+TEST(FileIO, OGSMeshIOBinaryRejectsCorruptFiles)
+{
+    std::vector<CFEMesh*> meshes;
+    meshes.push_back(
+        TestMeshes::readMesh(TestMeshes::createRectangle(3, 2, true)));
+    meshes[0]->ConstructGrid();
+    const std::string file_name = getTestFileName();
+    OGSMeshIOBinary io;
+    ASSERT_TRUE(io.write(file_name, meshes, true));
+    deleteMeshes(meshes);
+    const std::vector<char> valid = readBytes(file_name);
+
+    // File header: magic (8 bytes), version, byte order mark, number of
+    // meshes. The header of the first mesh starts with the numbers of nodes,
+    // of elements and of element nodes.
+    const std::size_t version_position = 8;
+    const std::size_t n_meshes_position = 16;
+    const std::size_t n_nodes_position = 24;
+    const std::size_t n_elements_position = 32;
+    const std::size_t n_element_nodes_position = 40;
+    const int64_t huge = static_cast<int64_t>(1) << 61;
+    struct Corruption
+    {
+        const char* name;
+        std::size_t position;
+        int64_t value;
+        std::size_t size;
+    };
+    const Corruption corruptions[] = {
+        {"magic", 0, 0, 1},
+        {"version", version_position, 99, 4},
+        {"negative mesh count", n_meshes_position, -1, 8},
+        {"overflowing mesh count", n_meshes_position, huge, 8},
+        {"more meshes than stored", n_meshes_position, 2, 8},
+        {"negative node count", n_nodes_position, -1, 8},
+        {"overflowing node count", n_nodes_position, huge, 8},
+        {"more nodes than stored", n_nodes_position, 1000, 8},
+        {"overflowing element count", n_elements_position, huge, 8},
+        {"overflowing element node count", n_element_nodes_position, huge,
+         8}};
+    const std::size_t n_corruptions = sizeof(corruptions) / sizeof(Corruption);
+    for (std::size_t c = 0; c < n_corruptions; c++)
+    {
+        std::vector<char> bytes(valid);
+        std::memcpy(&bytes[corruptions[c].position], &corruptions[c].value,
+                    corruptions[c].size);
+        writeBytes(file_name, bytes);
+        std::vector<CFEMesh*> read_meshes;
+        EXPECT_FALSE(io.read(file_name, read_meshes)) << corruptions[c].name;
+        EXPECT_TRUE(read_meshes.empty()) << corruptions[c].name;
+        deleteMeshes(read_meshes);
+    }
+
+    // Arrays of the first mesh: after its header (15 numbers) the names,
+    // the node IDs, coordinates and areas, and the element IDs, types,
+    // material groups, node row pointers and nodes
+    int64_t header[15];
+    std::memcpy(header, &valid[n_nodes_position], sizeof(header));
+    const int64_t n_nodes = header[0];
+    const int64_t n_elements = header[1];
+    std::size_t position = n_nodes_position + sizeof(header);
+    for (int k = 12; k < 15; k++)
+        position += (header[k] + 7) / 8 * 8;
+    position += 5 * n_nodes * sizeof(int64_t);
+    const std::size_t element_types_position =
+        position + n_elements * sizeof(int64_t);
+    const std::size_t element_nodes_position =
+        position + (4 * n_elements + 1) * sizeof(int64_t);
+    // The first element is the square of the nodes 0, 1, 5 and 4
+    int64_t first_nodes[4];
+    std::memcpy(first_nodes, &valid[element_nodes_position],
+                sizeof(first_nodes));
+    ASSERT_EQ(0, first_nodes[0]);
+    ASSERT_EQ(5, first_nodes[2]);
+    const Corruption array_corruptions[] = {
+        {"invalid element type", element_types_position, 1000, 8},
+        {"node index out of range", element_nodes_position, n_nodes, 8},
+        {"negative node index", element_nodes_position, -1, 8}};
+    for (std::size_t c = 0; c < 3; c++)
+    {
+        std::vector<char> bytes(valid);
+        std::memcpy(&bytes[array_corruptions[c].position],
+                    &array_corruptions[c].value, array_corruptions[c].size);
+        writeBytes(file_name, bytes);
+        std::vector<CFEMesh*> read_meshes;
+        EXPECT_FALSE(io.read(file_name, read_meshes))
+            << array_corruptions[c].name;
+        deleteMeshes(read_meshes);
+    }
+
+    // Truncated files
+    const std::size_t lengths[] = {0, 20, 100, valid.size() - 8};
+    for (std::size_t l = 0; l < sizeof(lengths) / sizeof(std::size_t); l++)
+    {
+        std::vector<char> bytes(valid.begin(), valid.begin() + lengths[l]);
+        if (bytes.empty())
+            std::ofstream(file_name.c_str(), std::ios::trunc);
+        else
+            writeBytes(file_name, bytes);
+        std::vector<CFEMesh*> read_meshes;
+        EXPECT_FALSE(io.read(file_name, read_meshes))
+            << "length " << lengths[l];
+        deleteMeshes(read_meshes);
+    }
+
+    // The valid file is still read
+    writeBytes(file_name, valid);
+    std::vector<CFEMesh*> read_meshes;
+    EXPECT_TRUE(io.read(file_name, read_meshes));
+    EXPECT_EQ(1u, read_meshes.size());
+    deleteMeshes(read_meshes);
+    std::remove(file_name.c_str());
+}
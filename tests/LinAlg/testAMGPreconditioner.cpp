@@ -0,0 +1,129 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ * File:   testAMGPreconditioner.cpp
+ *
+ * Created on October 18, 2026
+ *
+ */
+#include <gtest/gtest.h>
+
+#ifdef NEW_EQS
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "AMGPreconditioner.h"
+#include "matrix_class.h"
+
+#include "../TestMatrices.h"
+#include "../TestMeshes.h"
+
+using Math_Group::AMGParameters;
+using Math_Group::CSparseMatrix;
+using Math_Group::SparseTable;
+
+namespace
+{
+double norm(const std::vector<double>& v)
+{
+    double s = 0.0;
+    for (std::size_t i = 0; i < v.size(); i++)
+        s += v[i] * v[i];
+    return std::sqrt(s);
+}
+
+/// Stationary iteration x += M^{-1} (b - A x) with one AMG cycle as M^{-1}.
+/// Returns the number of cycles that reduce the residual by 1e-8, or
+/// max_cycles + 1, and the largest reduction factor of a cycle.
+int countCycles(CSparseMatrix& A, const int max_cycles,
+                double& max_reduction)
+{
+    const std::size_t dim = static_cast<std::size_t>(A.Dim());
+    std::vector<double> b(dim), x(dim, 0.0), r(dim), c(dim);
+    for (std::size_t i = 0; i < dim; i++)
+        b[i] = std::sin(static_cast<double>(i));
+    r = b;
+    const double r0 = norm(b);
+    double r_previous = r0;
+    max_reduction = 0.0;
+    for (int k = 1; k <= max_cycles; k++)
+    {
+        A.Precond_AMG(&r[0], &c[0]);
+        for (std::size_t i = 0; i < dim; i++)
+            x[i] += c[i];
+        A.multiVec(&x[0], &r[0]);
+        for (std::size_t i = 0; i < dim; i++)
+            r[i] = b[i] - r[i];
+        const double r_norm = norm(r);
+        max_reduction = std::max(max_reduction, r_norm / r_previous);
+        r_previous = r_norm;
+        if (r_norm < 1e-8 * r0)
+            return k;
+    }
+    return max_cycles + 1;
+}
+}  // namespace
+
+TEST(LinAlg, AMGVCycleConvergesOnLaplacian1D)
+{
+    MeshLib::CFEMesh* mesh =
+        TestMeshes::readMesh(TestMeshes::createLine(400));
+    mesh->ConstructGrid();
+    SparseTable table(mesh, false, false, Math_Group::CRS);
+    CSparseMatrix A(table, 1);
+    TestMatrices::setLaplacian(*mesh, A, 1e-4, 0.0, 0.0);
+
+    AMGParameters parameters;
+    parameters.coarse_size = 20;
+    A.ComputeAMG(parameters, NULL);
+    EXPECT_GT(A.GetAMG()->NumberOfLevels(), 2);
+
+    double max_reduction;
+    EXPECT_LE(countCycles(A, 40, max_reduction), 30);
+    EXPECT_LT(max_reduction, 0.6);
+    delete mesh;
+}
+
+TEST(LinAlg, AMGVCycleConvergesOnLaplacian2D)
+{
+    MeshLib::CFEMesh* mesh =
+        TestMeshes::readMesh(TestMeshes::createRectangle(40, 40, false));
+    mesh->ConstructGrid();
+    for (int dof = 1; dof <= 2; dof++)
+        for (int smoother = 0; smoother < 2; smoother++)
+        {
+            SparseTable table(mesh, false, false, Math_Group::CRS);
+            CSparseMatrix A(table, dof);
+            TestMatrices::setLaplacian(*mesh, A, 1e-4, 0.0, 0.0);
+
+            AMGParameters parameters;
+            parameters.smoother = smoother;
+            parameters.coarse_size = 50;
+            EXPECT_TRUE(A.ComputeAMG(parameters, NULL));
+            EXPECT_GT(A.GetAMG()->NumberOfLevels(), 2);
+            EXPECT_LT(A.GetAMG()->OperatorComplexity(), 2.0);
+
+            double max_reduction;
+            EXPECT_LE(countCycles(A, 40, max_reduction), 30)
+                << "DOF " << dof << ", smoother " << smoother;
+            EXPECT_LT(max_reduction, 0.6)
+                << "DOF " << dof << ", smoother " << smoother;
+
+            // New values on the same pattern keep the aggregates.
+            A *= 2.0;
+            EXPECT_FALSE(A.ComputeAMG(parameters, NULL));
+            EXPECT_LE(countCycles(A, 40, max_reduction), 30)
+                << "DOF " << dof << ", smoother " << smoother
+                << ", updated";
+        }
+    delete mesh;
+}
+
+#endif  // NEW_EQS
@@ -0,0 +1,109 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ * File:   testAndersonAcceleration.cpp
+ *
+ * Created on October 18, 2026
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "AndersonAcceleration.h"
+
+using Math_Group::AndersonAcceleration;
+
+namespace
+{
+const std::size_t n = 20;
+
+/// Fixed point map of a discretized nonlinear reaction-diffusion equation,
+/// a contraction with the rate of about 0.92
+void evaluateG(const std::vector<double>& x, std::vector<double>& g)
+{
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const double left = (i > 0) ? x[i - 1] : 0.0;
+        const double right = (i + 1 < n) ? x[i + 1] : 0.0;
+        g[i] = 0.45 * (left + right) + 0.03 * std::sin(x[i]) + 1.0;
+    }
+}
+
+double residualNorm(const std::vector<double>& x, const std::vector<double>& g)
+{
+    double s = 0.0;
+    for (std::size_t i = 0; i < n; i++)
+        s += (g[i] - x[i]) * (g[i] - x[i]);
+    return std::sqrt(s);
+}
+
+/// Iterations until |G(x) - x| < 1e-10, or max_iterations + 1
+int iterate(AndersonAcceleration& anderson, const double beta,
+            const int max_iterations, std::vector<double>& x)
+{
+    x.assign(n, 0.0);
+    std::vector<double> g(n);
+    for (int k = 0; k <= max_iterations; k++)
+    {
+        evaluateG(x, g);
+        if (residualNorm(x, g) < 1e-10)
+            return k;
+        anderson.update(&x[0], &g[0], n, beta);
+    }
+    return max_iterations + 1;
+}
+}  // namespace
+
+TEST(LinAlg, AndersonAccelerationFirstStepIsFixedPointStep)
+{
+    AndersonAcceleration anderson(5);
+    std::vector<double> x(n, 0.5), g(n);
+    evaluateG(x, g);
+    EXPECT_FALSE(anderson.update(&x[0], &g[0], n, 0.7));
+    for (std::size_t i = 0; i < n; i++)
+        EXPECT_DOUBLE_EQ(0.5 + 0.7 * (g[i] - 0.5), x[i]);
+}
+
+TEST(LinAlg, AndersonAccelerationConvergesFasterThanPicard)
+{
+    AndersonAcceleration anderson(10);
+    std::vector<double> x_anderson;
+    const int anderson_iterations = iterate(anderson, 1.0, 500, x_anderson);
+    EXPECT_LE(anderson_iterations, 25);
+    EXPECT_GT(anderson.getNumberOfAcceleratedIterations(), 0);
+
+    // Plain fixed point iteration
+    std::vector<double> x_picard(n, 0.0), g(n);
+    int picard_iterations = 0;
+    for (evaluateG(x_picard, g); residualNorm(x_picard, g) >= 1e-10;
+         evaluateG(x_picard, g))
+    {
+        x_picard = g;
+        picard_iterations++;
+    }
+    EXPECT_GT(picard_iterations, 4 * anderson_iterations);
+    for (std::size_t i = 0; i < n; i++)
+        EXPECT_NEAR(x_picard[i], x_anderson[i], 1e-9);
+
+    // After reset(), the same iterations are done again.
+    anderson.reset();
+    EXPECT_EQ(0, anderson.getNumberOfIterations());
+    std::vector<double> x_again;
+    EXPECT_EQ(anderson_iterations, iterate(anderson, 1.0, 500, x_again));
+    for (std::size_t i = 0; i < n; i++)
+        EXPECT_DOUBLE_EQ(x_anderson[i], x_again[i]);
+}
+
+TEST(LinAlg, AndersonAccelerationWithDamping)
+{
+    AndersonAcceleration anderson(10);
+    std::vector<double> x;
+    EXPECT_LE(iterate(anderson, 0.5, 500, x), 40);
+}
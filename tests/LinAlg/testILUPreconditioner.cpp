@@ -0,0 +1,148 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ * File:   testILUPreconditioner.cpp
+ *
+ * Created on October 18, 2026
+ *
+ */
+#include <gtest/gtest.h>
+
+#ifdef NEW_EQS
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "matrix_class.h"
+#include "LinAlg/GaussAlgorithm.h"
+
+#include "../TestMatrices.h"
+#include "../TestMeshes.h"
+
+using Math_Group::CSparseMatrix;
+using Math_Group::Matrix;
+using Math_Group::SparseTable;
+
+namespace
+{
+/// Solves A x = b with the ILU factors of A and with dense LU, and
+/// returns the largest difference of the solutions.
+double compareWithDenseLU(CSparseMatrix& A)
+{
+    const std::size_t dim = static_cast<std::size_t>(A.Dim());
+    std::vector<double> b(dim);
+    for (std::size_t i = 0; i < dim; i++)
+        b[i] = 1.0 + 0.1 * static_cast<double>(i % 7);
+    std::vector<double> x(dim);
+    A.Precond_ILU(&b[0], &x[0]);
+
+    Matrix dense(TestMatrices::toDense(A));
+    MathLib::GaussAlgorithm<Matrix> lu(dense, dim);
+    lu.execute(&b[0]);
+
+    double max_difference = 0.0;
+    for (std::size_t i = 0; i < dim; i++)
+        max_difference = std::max(max_difference, std::fabs(x[i] - b[i]));
+    return max_difference;
+}
+}  // namespace
+
+TEST(LinAlg, ILU0ExactOnTridiagonalMatrix)
+{
+    // ILU(0) of a tridiagonal matrix has no fill-in, i.e. it is exact.
+    MeshLib::CFEMesh* mesh =
+        TestMeshes::readMesh(TestMeshes::createLine(30));
+    mesh->ConstructGrid();
+    SparseTable table(mesh, false, false, Math_Group::CRS);
+    CSparseMatrix A(table, 1);
+    TestMatrices::setLaplacian(*mesh, A, 0.5, 0.2, 0.0);
+
+    A.ComputeILU(0.0, -1, false);
+    EXPECT_LT(compareWithDenseLU(A), 1e-12);
+    delete mesh;
+}
+
+TEST(LinAlg, ILUTWithoutDroppingIsExact)
+{
+    MeshLib::CFEMesh* mesh =
+        TestMeshes::readMesh(TestMeshes::createRectangle(5, 4, true));
+    mesh->ConstructGrid();
+    const Math_Group::StorageType storage[2] = {Math_Group::CRS,
+                                                Math_Group::JDS};
+    for (int s = 0; s < 2; s++)
+        for (int dof = 1; dof <= 2; dof++)
+        {
+            SparseTable table(mesh, false, false, storage[s]);
+            CSparseMatrix A(table, dof);
+            TestMatrices::setLaplacian(*mesh, A, 0.5, 0.2, 0.3);
+            const int max_fill = static_cast<int>(A.Dim());
+
+            A.ComputeILU(0.0, max_fill, false);
+            EXPECT_LT(compareWithDenseLU(A), 1e-12)
+                << "storage " << s << ", DOF " << dof;
+            A.ComputeILU(0.0, max_fill, true);
+            EXPECT_LT(compareWithDenseLU(A), 1e-12)
+                << "storage " << s << ", DOF " << dof
+                << ", level scheduling";
+        }
+    delete mesh;
+}
+
+TEST(LinAlg, ILU0MatchesMatrixOnPattern)
+{
+    // The product LU of the ILU(0) factors equals A on the pattern of A.
+    // Its columns are computed from the ones of (LU)^{-1} by dense LU.
+    MeshLib::CFEMesh* mesh =
+        TestMeshes::readMesh(TestMeshes::createRectangle(4, 3, true));
+    mesh->ConstructGrid();
+    for (int dof = 1; dof <= 2; dof++)
+    {
+        SparseTable table(mesh, false, false, Math_Group::CRS);
+        CSparseMatrix A(table, dof);
+        TestMatrices::setLaplacian(*mesh, A, 0.5, 0.2, 0.3);
+        const std::size_t dim = static_cast<std::size_t>(A.Dim());
+
+        for (int level_scheduling = 0; level_scheduling < 2;
+             level_scheduling++)
+        {
+            A.ComputeILU(0.0, -1, level_scheduling != 0);
+            Matrix inverse(dim, dim);
+            std::vector<double> e(dim), column(dim);
+            for (std::size_t j = 0; j < dim; j++)
+            {
+                std::fill(e.begin(), e.end(), 0.0);
+                e[j] = 1.0;
+                A.Precond_ILU(&e[0], &column[0]);
+                for (std::size_t i = 0; i < dim; i++)
+                    inverse(i, j) = column[i];
+            }
+            MathLib::GaussAlgorithm<Matrix> lu(inverse, dim);
+            for (std::size_t j = 0; j < dim; j++)
+            {
+                std::fill(column.begin(), column.end(), 0.0);
+                column[j] = 1.0;
+                if (j == 0)
+                    lu.execute(&column[0]);
+                else
+                    lu.executeWithExistedElimination(&column[0]);
+                for (std::size_t i = 0; i < dim; i++)
+                {
+                    if (A(i, j) == 0.0)
+                        continue;
+                    EXPECT_NEAR(A(i, j), column[i], 1e-10)
+                        << "DOF " << dof << ", entry (" << i << ", " << j
+                        << ")";
+                }
+            }
+        }
+    }
+    delete mesh;
+}
+
+#endif  // NEW_EQS
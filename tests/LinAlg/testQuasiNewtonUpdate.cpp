@@ -0,0 +1,145 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ * File:   testQuasiNewtonUpdate.cpp
+ *
+ * Created on October 18, 2026
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "matrix_class.h"
+#include "LinAlg/GaussAlgorithm.h"
+#include "QuasiNewtonUpdate.h"
+
+using Math_Group::Matrix;
+using Math_Group::QuasiNewtonUpdate;
+
+namespace
+{
+const std::size_t n = 10;
+
+/// K u + u^3 = f with the tridiagonal K of the 1D Laplacian, shifted, plus
+/// skew times a non-symmetric part
+class CubicProblem
+{
+public:
+    explicit CubicProblem(const double skew_) : skew(skew_) {}
+
+    double entry(const std::size_t i, const std::size_t j) const
+    {
+        if (i == j)
+            return 2.5;
+        if (j + 1 == i)
+            return -1.0 - skew;
+        if (i + 1 == j)
+            return -1.0 + skew;
+        return 0.0;
+    }
+
+    /// b = -F(u), the right hand side of the Newton system
+    void computeRHS(const std::vector<double>& u, std::vector<double>& b) const
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            b[i] = 0.07 * (1.0 + 0.5 * i) - u[i] * u[i] * u[i];
+            for (std::size_t j = 0; j < n; j++)
+                b[i] -= entry(i, j) * u[j];
+        }
+    }
+
+private:
+    const double skew;
+};
+
+double norm(const std::vector<double>& v)
+{
+    double s = 0.0;
+    for (std::size_t i = 0; i < n; i++)
+        s += v[i] * v[i];
+    return std::sqrt(s);
+}
+
+/// Newton iterations with the tangent K at u = 0 kept, with quasi-Newton
+/// updates if quasi_newton is given. Returns the number of iterations until
+/// |F(u)| < 1e-10, or max_iterations + 1.
+int solve(const CubicProblem& problem, QuasiNewtonUpdate* quasi_newton,
+          const int max_iterations, std::vector<double>& u)
+{
+    Matrix K(n, n);
+    for (std::size_t i = 0; i < n; i++)
+        for (std::size_t j = 0; j < n; j++)
+            K(i, j) = problem.entry(i, j);
+    MathLib::GaussAlgorithm<Matrix> kept_tangent(K, n);
+
+    u.assign(n, 0.0);
+    std::vector<double> b(n), x(n);
+    for (int k = 0; k <= max_iterations; k++)
+    {
+        problem.computeRHS(u, b);
+        if (norm(b) < 1e-10)
+            return k;
+        if (quasi_newton)
+            quasi_newton->prepareRHS(&b[0], n);
+        x = b;
+        if (k == 0)
+            kept_tangent.execute(&x[0]);
+        else
+            kept_tangent.executeWithExistedElimination(&x[0]);
+        if (quasi_newton)
+            EXPECT_TRUE(quasi_newton->correctSolution(&x[0], &b[0]));
+        for (std::size_t i = 0; i < n; i++)
+            u[i] += x[i];
+        if (quasi_newton)
+            quasi_newton->setStep(&x[0], 1.0);
+    }
+    return max_iterations + 1;
+}
+}  // namespace
+
+TEST(LinAlg, QuasiNewtonUpdateBFGS)
+{
+    const CubicProblem problem(0.0);
+    std::vector<double> u_kept, u_bfgs;
+    const int kept_iterations = solve(problem, NULL, 500, u_kept);
+    ASSERT_LE(kept_iterations, 500);
+
+    QuasiNewtonUpdate bfgs(QuasiNewtonUpdate::BFGS, 50);
+    const int bfgs_iterations = solve(problem, &bfgs, 500, u_bfgs);
+    EXPECT_LT(3 * bfgs_iterations, kept_iterations);
+    EXPECT_GT(bfgs.getNumberOfUpdates(), 0);
+    for (std::size_t i = 0; i < n; i++)
+        EXPECT_NEAR(u_kept[i], u_bfgs[i], 1e-9);
+}
+
+TEST(LinAlg, QuasiNewtonUpdateBroyden)
+{
+    const CubicProblem problem(0.4);
+    std::vector<double> u_kept, u_broyden;
+    const int kept_iterations = solve(problem, NULL, 500, u_kept);
+    ASSERT_LE(kept_iterations, 500);
+
+    QuasiNewtonUpdate broyden(QuasiNewtonUpdate::BROYDEN, 50);
+    const int broyden_iterations = solve(problem, &broyden, 500, u_broyden);
+    EXPECT_LT(2 * broyden_iterations, kept_iterations);
+    EXPECT_GT(broyden.getNumberOfUpdates(), 0);
+    for (std::size_t i = 0; i < n; i++)
+        EXPECT_NEAR(u_kept[i], u_broyden[i], 1e-9);
+
+    // Without a step, reset() gives the kept tangent back.
+    broyden.reset();
+    EXPECT_EQ(0, broyden.getNumberOfUpdates());
+    std::vector<double> b(n, 1.0), x(n, 2.0);
+    broyden.prepareRHS(&b[0], n);
+    EXPECT_TRUE(broyden.correctSolution(&x[0], &b[0]));
+    for (std::size_t i = 0; i < n; i++)
+        EXPECT_DOUBLE_EQ(2.0, x[i]);
+}
@@ -0,0 +1,115 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ * File:   testSparseDirectSolver.cpp
+ *
+ * Created on October 18, 2026
+ *
+ */
+#include <gtest/gtest.h>
+
+#ifdef NEW_EQS
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "SparseDirectSolver.h"
+#include "matrix_class.h"
+
+#include "../TestMatrices.h"
+#include "../TestMeshes.h"
+
+using Math_Group::CSparseMatrix;
+using Math_Group::SparseDirectSolver;
+using Math_Group::SparseTable;
+
+namespace
+{
+/// Relative residual |b - A x| / |b| of the solution of the direct solver
+double solveAndGetResidual(CSparseMatrix& A, SparseDirectSolver& solver,
+                           std::vector<double>& b)
+{
+    const std::size_t dim = b.size();
+    std::vector<double> x(dim), r(dim);
+    solver.Solve(&b[0], &x[0]);
+    A.multiVec(&x[0], &r[0]);
+    double r_norm = 0.0, b_norm = 0.0;
+    for (std::size_t i = 0; i < dim; i++)
+    {
+        r_norm += (b[i] - r[i]) * (b[i] - r[i]);
+        b_norm += b[i] * b[i];
+    }
+    return std::sqrt(r_norm / b_norm);
+}
+}  // namespace
+
+TEST(LinAlg, SparseDirectSolverLU)
+{
+    MeshLib::CFEMesh* mesh =
+        TestMeshes::readMesh(TestMeshes::createBox(4, 3, 3, true));
+    mesh->ConstructGrid();
+    const Math_Group::StorageType storage[2] = {Math_Group::CRS,
+                                                Math_Group::JDS};
+    for (int s = 0; s < 2; s++)
+        for (int dof = 1; dof <= 2; dof++)
+        {
+            SparseTable table(mesh, false, false, storage[s]);
+            CSparseMatrix A(table, dof);
+            TestMatrices::setLaplacian(*mesh, A, 0.1, 0.3, 0.2);
+            std::vector<double> b(A.Dim());
+            for (std::size_t i = 0; i < b.size(); i++)
+                b[i] = std::cos(static_cast<double>(i));
+
+            SparseDirectSolver* solver = A.GetDirectSolver(false);
+            EXPECT_EQ(SparseDirectSolver::ANALYZED_AND_FACTORIZED,
+                      solver->Factorize(A));
+            EXPECT_LT(solveAndGetResidual(A, *solver, b), 1e-12)
+                << "storage " << s << ", DOF " << dof;
+
+            // The same values are not factorized again, new ones are.
+            EXPECT_EQ(SparseDirectSolver::REUSED, solver->Factorize(A));
+            A(0, 0) += 1.0;
+            EXPECT_EQ(SparseDirectSolver::FACTORIZED, solver->Factorize(A));
+            EXPECT_LT(solveAndGetResidual(A, *solver, b), 1e-12)
+                << "storage " << s << ", DOF " << dof << ", new values";
+        }
+    delete mesh;
+}
+
+TEST(LinAlg, SparseDirectSolverLDLTWithDirichletRows)
+{
+    MeshLib::CFEMesh* mesh =
+        TestMeshes::readMesh(TestMeshes::createRectangle(8, 6, true));
+    mesh->ConstructGrid();
+    for (int dof = 1; dof <= 2; dof++)
+    {
+        SparseTable table(mesh, false, false, Math_Group::CRS);
+        CSparseMatrix A(table, dof);
+        TestMatrices::setLaplacian(*mesh, A, 0.1, 0.0, 0.2);
+        std::vector<double> b(A.Dim());
+        for (std::size_t i = 0; i < b.size(); i++)
+            b[i] = std::cos(static_cast<double>(i));
+
+        SparseDirectSolver* solver = A.GetDirectSolver(true);
+        ASSERT_EQ(SparseDirectSolver::LDLT, solver->GetMethod());
+        EXPECT_EQ(SparseDirectSolver::ANALYZED_AND_FACTORIZED,
+                  solver->Factorize(A));
+        EXPECT_LT(solveAndGetResidual(A, *solver, b), 1e-12)
+            << "DOF " << dof;
+
+        // Dirichlet conditions clear the rows of the known unknowns only.
+        for (long i = 0; i < A.Dim(); i += 5)
+            A.Diagonize(i, 1.0 + 0.01 * i, &b[0]);
+        EXPECT_EQ(SparseDirectSolver::FACTORIZED, solver->Factorize(A));
+        EXPECT_LT(solveAndGetResidual(A, *solver, b), 1e-12)
+            << "DOF " << dof << ", Dirichlet rows";
+    }
+    delete mesh;
+}
+
+#endif  // NEW_EQS
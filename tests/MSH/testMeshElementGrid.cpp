@@ -0,0 +1,244 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ * File:   testMeshElementGrid.cpp
+ *
+ * Created on October 18, 2026
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "MeshElementGrid.h"
+#include "msh_elem.h"
+#include "msh_mesh.h"
+#include "msh_node.h"
+
+#include "../TestMeshes.h"
+
+using MeshLib::CElem;
+using MeshLib::CFEMesh;
+using MeshLib::MeshElementGrid;
+
+namespace
+{
+/// Pseudo random numbers in [0, 1), the same on all platforms
+class Random
+{
+public:
+    Random() : state(12345u) {}
+    double next()
+    {
+        state = state * 1103515245u + 12345u;
+        return static_cast<double>((state >> 8) & 0xffffu) / 65536.0;
+    }
+
+private:
+    unsigned state;
+};
+
+/// Bounding box of the element, widened by margin times its diagonal
+void getBox(const CElem& elem, const double margin, double* lo, double* hi)
+{
+    for (std::size_t i = 0; i < elem.GetNodesNumber(false); i++)
+    {
+        double const* x = elem.GetNode(i)->getData();
+        for (int d = 0; d < 3; d++)
+        {
+            lo[d] = (i == 0) ? x[d] : std::min(lo[d], x[d]);
+            hi[d] = (i == 0) ? x[d] : std::max(hi[d], x[d]);
+        }
+    }
+    double diagonal = 0.0;
+    for (int d = 0; d < 3; d++)
+        diagonal += (hi[d] - lo[d]) * (hi[d] - lo[d]);
+    for (int d = 0; d < 3; d++)
+    {
+        lo[d] -= margin * std::sqrt(diagonal);
+        hi[d] += margin * std::sqrt(diagonal);
+    }
+}
+
+bool boxesIntersect(const CElem& elem, const double margin, const double* lo,
+                    const double* hi)
+{
+    double e_lo[3], e_hi[3];
+    getBox(elem, margin, e_lo, e_hi);
+    for (int d = 0; d < 3; d++)
+        if (e_hi[d] < lo[d] || e_lo[d] > hi[d])
+            return false;
+    return true;
+}
+
+double squaredDistance(const double* a, const double* b)
+{
+    double s = 0.0;
+    for (int d = 0; d < 3; d++)
+        s += (a[d] - b[d]) * (a[d] - b[d]);
+    return s;
+}
+
+/*!
+   Compares a query result with brute force: it contains all elements that
+   the query with exact bounding boxes finds (exact(e) is true), only
+   elements that the query with boxes widened by 1e-3 of their diagonal
+   finds (widened(e) is true), and it is ascending.
+ */
+template <typename ExactTest, typename WidenedTest>
+void checkQuery(const CFEMesh& mesh, const std::vector<long>& result,
+                ExactTest exact, WidenedTest widened)
+{
+    for (std::size_t k = 1; k < result.size(); k++)
+        EXPECT_LT(result[k - 1], result[k]);
+    for (std::size_t e = 0; e < mesh.ele_vector.size(); e++)
+    {
+        const bool found = std::binary_search(result.begin(), result.end(),
+                                              static_cast<long>(e));
+        if (exact(*mesh.ele_vector[e]))
+            EXPECT_TRUE(found) << "element " << e << " is missing";
+        if (found)
+            EXPECT_TRUE(widened(*mesh.ele_vector[e]))
+                << "element " << e << " is not at the query";
+    }
+}
+
+struct BoxTest
+{
+    BoxTest(const double margin_, const double* lo_, const double* hi_)
+        : margin(margin_), lo(lo_), hi(hi_)
+    {
+    }
+    bool operator()(const CElem& elem) const
+    {
+        return boxesIntersect(elem, margin, lo, hi);
+    }
+    double margin;
+    const double* lo;
+    const double* hi;
+};
+
+/// Intersection of the element box with the segment, tested at 201 points
+/// of the segment for the exact test, or with the bounding box of the
+/// segment for the widened test
+struct SegmentTest
+{
+    SegmentTest(const double margin_, const double* a_, const double* b_)
+        : margin(margin_), a(a_), b(b_)
+    {
+    }
+    bool operator()(const CElem& elem) const
+    {
+        if (margin > 0.0)
+        {
+            double lo[3], hi[3];
+            for (int d = 0; d < 3; d++)
+            {
+                lo[d] = std::min(a[d], b[d]);
+                hi[d] = std::max(a[d], b[d]);
+            }
+            return boxesIntersect(elem, margin, lo, hi);
+        }
+        for (int k = 0; k <= 200; k++)
+        {
+            double x[3];
+            for (int d = 0; d < 3; d++)
+                x[d] = a[d] + 5e-3 * k * (b[d] - a[d]);
+            if (boxesIntersect(elem, 0.0, x, x))
+                return true;
+        }
+        return false;
+    }
+    double margin;
+    const double* a;
+    const double* b;
+};
+
+void checkGrid(const CFEMesh& mesh, const double* size)
+{
+    const MeshElementGrid& grid = mesh.getElementGrid();
+    ASSERT_EQ(mesh.ele_vector.size(), grid.getNumberOfElements());
+    Random random;
+    std::vector<long> result;
+    for (int q = 0; q < 100; q++)
+    {
+        // Points in and around the mesh
+        double x[3], y[3];
+        for (int d = 0; d < 3; d++)
+        {
+            x[d] = (1.4 * random.next() - 0.2) * size[d];
+            y[d] = (1.4 * random.next() - 0.2) * size[d];
+        }
+
+        grid.getElementsAtPoint(x, result);
+        checkQuery(mesh, result, BoxTest(0.0, x, x), BoxTest(1e-3, x, x));
+
+        double lo[3], hi[3];
+        for (int d = 0; d < 3; d++)
+        {
+            lo[d] = std::min(x[d], y[d]);
+            hi[d] = std::max(x[d], y[d]);
+        }
+        grid.getElementsInBox(lo, hi, result);
+        checkQuery(mesh, result, BoxTest(0.0, lo, hi), BoxTest(1e-3, lo, hi));
+
+        grid.getElementsOnSegment(x, y, result);
+        checkQuery(mesh, result, SegmentTest(0.0, x, y),
+                   SegmentTest(1e-3, x, y));
+
+        // Nearest gravity centers
+        std::vector<std::pair<double, long> > distances;
+        for (std::size_t e = 0; e < mesh.ele_vector.size(); e++)
+            distances.push_back(std::make_pair(
+                squaredDistance(x, mesh.ele_vector[e]->GetGravityCenter()),
+                static_cast<long>(e)));
+        std::sort(distances.begin(), distances.end());
+        EXPECT_EQ(distances[0].second, grid.getNearestElement(x));
+
+        grid.getNearestElements(x, 7, result);
+        ASSERT_EQ(7u, result.size());
+        for (std::size_t k = 0; k < result.size(); k++)
+            EXPECT_DOUBLE_EQ(
+                distances[k].first,
+                squaredDistance(x,
+                                mesh.ele_vector[result[k]]->GetGravityCenter()));
+    }
+}
+}  // namespace
+
+TEST(MSH, MeshElementGrid2D)
+{
+    CFEMesh* mesh =
+        TestMeshes::readMesh(TestMeshes::createRectangle(12, 7, true));
+    mesh->ConstructGrid();
+    const double size[3] = {12.0, 7.0, 0.0};
+    checkGrid(*mesh, size);
+    delete mesh;
+}
+
+TEST(MSH, MeshElementGrid3D)
+{
+    CFEMesh* mesh =
+        TestMeshes::readMesh(TestMeshes::createBox(6, 5, 4, true));
+    mesh->ConstructGrid();
+    const double size[3] = {6.0, 5.0, 4.0};
+    checkGrid(*mesh, size);
+    delete mesh;
+}
+
+TEST(MSH, MeshElementGridOfLine)
+{
+    CFEMesh* mesh = TestMeshes::readMesh(TestMeshes::createLine(50));
+    mesh->ConstructGrid();
+    const double size[3] = {50.0, 0.0, 0.0};
+    checkGrid(*mesh, size);
+    delete mesh;
+}
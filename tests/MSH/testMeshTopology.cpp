@@ -0,0 +1,163 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ * File:   testMeshTopology.cpp
+ *
+ * Created on October 18, 2026
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "msh_edge.h"
+#include "msh_elem.h"
+#include "msh_mesh.h"
+#include "msh_node.h"
+
+#include "../TestMeshes.h"
+
+using MeshLib::CEdge;
+using MeshLib::CElem;
+using MeshLib::CFEMesh;
+
+namespace
+{
+/// Sorted global node indices of face i of an element
+std::vector<long> getFaceNodes(CElem& elem, const int i)
+{
+    int local[10];
+    const int n = elem.GetElementFaceNodes(i, local);
+    std::vector<long> nodes;
+    for (int k = 0; k < n; k++)
+        nodes.push_back(elem.GetNodeIndex(local[k]));
+    std::sort(nodes.begin(), nodes.end());
+    return nodes;
+}
+
+/// Sorted global node indices of edge i of an element
+std::pair<long, long> getEdgeNodes(CElem& elem, const int i)
+{
+    int local[3];
+    elem.GetLocalIndicesOfEdgeNodes(i, local);
+    const long a = elem.GetNodeIndex(local[0]);
+    const long b = elem.GetNodeIndex(local[1]);
+    return std::make_pair(std::min(a, b), std::max(a, b));
+}
+
+bool isMeshElement(const CFEMesh& mesh, const CElem* elem)
+{
+    return std::find(mesh.ele_vector.begin(), mesh.ele_vector.end(), elem) !=
+           mesh.ele_vector.end();
+}
+
+/// Neighbors: the other element with a face of the same nodes, or on the
+/// boundary a face element owned by the element
+void checkNeighbors(const CFEMesh& mesh)
+{
+    const std::size_t n_elements = mesh.ele_vector.size();
+    std::size_t n_boundary_faces = 0;
+    for (std::size_t e = 0; e < n_elements; e++)
+    {
+        CElem& elem = *mesh.ele_vector[e];
+        for (std::size_t i = 0; i < elem.GetFacesNumber(); i++)
+        {
+            const std::vector<long> face = getFaceNodes(elem, i);
+            long expected = -1;
+            for (std::size_t ee = 0; ee < n_elements && expected < 0; ee++)
+            {
+                if (ee == e)
+                    continue;
+                CElem& other = *mesh.ele_vector[ee];
+                for (std::size_t k = 0; k < other.GetFacesNumber(); k++)
+                    if (getFaceNodes(other, k) == face)
+                        expected = static_cast<long>(ee);
+            }
+            CElem* neighbor = elem.GetNeighbor(i);
+            if (expected >= 0)
+            {
+                EXPECT_EQ(mesh.ele_vector[expected], neighbor)
+                    << "element " << e << ", face " << i;
+                continue;
+            }
+            n_boundary_faces++;
+            ASSERT_TRUE(neighbor != NULL) << "element " << e << ", face " << i;
+            EXPECT_FALSE(isMeshElement(mesh, neighbor))
+                << "element " << e << ", face " << i;
+            EXPECT_EQ(&elem, neighbor->GetOwner())
+                << "element " << e << ", face " << i;
+        }
+    }
+    EXPECT_EQ(n_boundary_faces, mesh.face_vector.size());
+}
+
+/// Edges: one per pair of element nodes that an element has as an edge,
+/// shared by all elements with that edge
+void checkEdges(const CFEMesh& mesh)
+{
+    std::map<std::pair<long, long>, CEdge*> edges;
+    for (std::size_t e = 0; e < mesh.ele_vector.size(); e++)
+    {
+        CElem& elem = *mesh.ele_vector[e];
+        for (std::size_t i = 0; i < elem.GetEdgesNumber(); i++)
+        {
+            const std::pair<long, long> nodes = getEdgeNodes(elem, i);
+            CEdge* edge = elem.GetEdge(i);
+            ASSERT_TRUE(edge != NULL) << "element " << e << ", edge " << i;
+            const long a = edge->GetNode(0)->GetIndex();
+            const long b = edge->GetNode(1)->GetIndex();
+            EXPECT_EQ(nodes, std::make_pair(std::min(a, b), std::max(a, b)))
+                << "element " << e << ", edge " << i;
+            if (edges.count(nodes))
+                EXPECT_EQ(edges[nodes], edge)
+                    << "element " << e << ", edge " << i;
+            else
+                edges[nodes] = edge;
+        }
+    }
+    EXPECT_EQ(edges.size(), mesh.edge_vector.size());
+    for (std::size_t i = 0; i < mesh.edge_vector.size(); i++)
+        EXPECT_EQ(static_cast<long>(i), mesh.edge_vector[i]->GetIndex());
+}
+
+void checkTopology(const std::string& mesh_text)
+{
+    CFEMesh* mesh = TestMeshes::readMesh(mesh_text);
+    mesh->ConstructGrid();
+    checkNeighbors(*mesh);
+    checkEdges(*mesh);
+    const std::size_t n_edges = mesh->edge_vector.size();
+    delete mesh;
+
+    // Deferred edges are built on demand, with the same result
+    CFEMesh::setDeferredEdges(true);
+    mesh = TestMeshes::readMesh(mesh_text);
+    mesh->ConstructGrid();
+    CFEMesh::setDeferredEdges(false);
+    EXPECT_TRUE(mesh->edge_vector.empty());
+    checkNeighbors(*mesh);
+    mesh->ConstructEdges();
+    EXPECT_EQ(n_edges, mesh->edge_vector.size());
+    checkEdges(*mesh);
+    delete mesh;
+}
+}  // namespace
+
+TEST(MSH, ConstructGridOfMixedMesh2D)
+{
+    checkTopology(TestMeshes::createRectangle(6, 5, true));
+}
+
+TEST(MSH, ConstructGridOfMixedMesh3D)
+{
+    checkTopology(TestMeshes::createBox(4, 3, 3, true));
+}
@@ -0,0 +1,138 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ * File:   testNodeAdjacency.cpp
+ *
+ * Created on October 18, 2026
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "msh_elem.h"
+#include "msh_mesh.h"
+#include "msh_node.h"
+
+#include "../TestMeshes.h"
+
+using MeshLib::CElem;
+using MeshLib::CFEMesh;
+using MeshLib::CNode;
+using MeshLib::NodeAdjacency;
+
+namespace
+{
+void expectEqual(const std::vector<std::size_t>& expected,
+                 const NodeAdjacency& adjacency, const char* what,
+                 const std::size_t node)
+{
+    ASSERT_EQ(expected.size(), adjacency.size()) << what << ", node " << node;
+    for (std::size_t k = 0; k < expected.size(); k++)
+        EXPECT_EQ(expected[k], adjacency[k]) << what << ", node " << node;
+}
+
+/*!
+   Compares the adjacency of the nodes with brute force: the elements of a
+   node, ascending, are the marked (or all) elements with the node, and its
+   connected nodes, sorted, are the nodes of these elements.
+ */
+void checkAdjacency(const CFEMesh& mesh, const bool quadratic,
+                    const bool all_elements, const bool check_nodes)
+{
+    for (std::size_t i = 0; i < mesh.nod_vector.size(); i++)
+    {
+        std::vector<std::size_t> elements, nodes;
+        for (std::size_t e = 0; e < mesh.ele_vector.size(); e++)
+        {
+            CElem& elem = *mesh.ele_vector[e];
+            if (!all_elements && !elem.GetMark())
+                continue;
+            const std::size_t n_nodes = elem.GetNodesNumber(quadratic);
+            bool has_node = false;
+            for (std::size_t k = 0; k < n_nodes; k++)
+                has_node |= elem.GetNodeIndex(k) == static_cast<long>(i);
+            if (!has_node)
+                continue;
+            elements.push_back(e);
+            for (std::size_t k = 0; k < n_nodes; k++)
+                nodes.push_back(elem.GetNodeIndex(k));
+        }
+        std::sort(nodes.begin(), nodes.end());
+        nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+        const CNode& node = *mesh.nod_vector[i];
+        expectEqual(elements, node.getConnectedElementIDs(), "elements", i);
+        if (check_nodes)
+            expectEqual(nodes, node.getConnectedNodes(), "nodes", i);
+    }
+}
+
+void checkMesh(const std::string& mesh_text)
+{
+    CFEMesh* mesh = TestMeshes::readMesh(mesh_text);
+    mesh->ConstructGrid();
+    checkAdjacency(*mesh, false, true, true);
+
+    // Elements of deactivated domains are left out, unless all elements
+    // are asked for.
+    for (std::size_t e = 0; e < mesh->ele_vector.size(); e += 3)
+        mesh->ele_vector[e]->SetMark(false);
+    mesh->ConnectedElements2Node();
+    checkAdjacency(*mesh, false, false, false);
+    mesh->ConnectedElements2Node(false, true);
+    checkAdjacency(*mesh, false, true, false);
+    for (std::size_t e = 0; e < mesh->ele_vector.size(); e++)
+        mesh->ele_vector[e]->SetMark(true);
+
+    // Quadratic nodes
+    const std::size_t n_linear_nodes = mesh->nod_vector.size();
+    mesh->GenerateHighOrderNodes();
+    EXPECT_GT(mesh->nod_vector.size(), n_linear_nodes);
+    checkAdjacency(*mesh, true, true, true);
+    delete mesh;
+}
+}  // namespace
+
+TEST(MSH, NodeAdjacencyOfMixedMesh2D)
+{
+    checkMesh(TestMeshes::createRectangle(6, 5, true));
+}
+
+TEST(MSH, NodeAdjacencyOfMixedMesh3D)
+{
+    checkMesh(TestMeshes::createBox(4, 3, 3, true));
+}
+
+TEST(MSH, NodeAdjacencyFromCompressedRows)
+{
+    CFEMesh* mesh =
+        TestMeshes::readMesh(TestMeshes::createRectangle(3, 2, false));
+    mesh->ConstructGrid();
+    // Node i is connected to the elements 0 to i - 1
+    const std::size_t n_nodes = mesh->nod_vector.size();
+    std::vector<std::size_t> node_ptr(1, 0), element_ids;
+    for (std::size_t i = 0; i < n_nodes; i++)
+    {
+        for (std::size_t e = 0; e < i; e++)
+            element_ids.push_back(e);
+        node_ptr.push_back(element_ids.size());
+    }
+    mesh->setConnectedElements(node_ptr, element_ids);
+    for (std::size_t i = 0; i < n_nodes; i++)
+    {
+        const NodeAdjacency& elements =
+            mesh->nod_vector[i]->getConnectedElementIDs();
+        ASSERT_EQ(i, elements.size());
+        for (std::size_t e = 0; e < i; e++)
+            EXPECT_EQ(e, elements[e]);
+    }
+    delete mesh;
+}
@@ -0,0 +1,97 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ * File:   testBCSRMatrix.cpp
+ *
+ * Created on October 18, 2026
+ *
+ */
+#include <gtest/gtest.h>
+
+#ifdef NEW_EQS
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "matrix_class.h"
+
+#include "../TestMeshes.h"
+
+using Math_Group::CSparseMatrix;
+using Math_Group::SparseTable;
+
+namespace
+{
+/// Sets the same non-symmetric values on the pattern of the mesh in A and B
+void setValues(const MeshLib::CFEMesh& mesh, CSparseMatrix& A,
+               CSparseMatrix& B)
+{
+    const long n = static_cast<long>(mesh.nod_vector.size());
+    const int dof = A.Dof();
+    for (long i = 0; i < n; i++)
+    {
+        const MeshLib::CNode& node = *mesh.nod_vector[i];
+        for (std::size_t k = 0; k < node.getConnectedNodes().size(); k++)
+        {
+            const long j = static_cast<long>(node.getConnectedNodes()[k]);
+            for (int d = 0; d < dof; d++)
+                for (int e = 0; e < dof; e++)
+                {
+                    const long row = d * n + i;
+                    const long column = e * n + j;
+                    const double value =
+                        std::sin(0.37 * row + 1.3 * column + 0.1);
+                    A(row, column) = value;
+                    B(row, column) = value;
+                }
+        }
+    }
+}
+}  // namespace
+
+TEST(Matrix, BCSRProductsEqualCRSProducts)
+{
+    // DOF 2 to 4 use the BlockRowProduct<N> kernels, DOF 1 and 5 the
+    // generic products of the block storage.
+    MeshLib::CFEMesh* mesh =
+        TestMeshes::readMesh(TestMeshes::createBox(4, 3, 2, true));
+    mesh->ConstructGrid();
+    SparseTable crs_table(mesh, false, false, Math_Group::CRS);
+    SparseTable bcsr_table(mesh, false, false, Math_Group::BCSR);
+    for (int dof = 1; dof <= 5; dof++)
+    {
+        CSparseMatrix crs(crs_table, dof);
+        CSparseMatrix bcsr(bcsr_table, dof);
+        ASSERT_EQ(crs.Dim(), bcsr.Dim());
+        ASSERT_EQ(crs.NumberOfEntries(), bcsr.NumberOfEntries());
+        crs = 0.0;
+        bcsr = 0.0;
+        setValues(*mesh, crs, bcsr);
+
+        const std::size_t dim = static_cast<std::size_t>(crs.Dim());
+        std::vector<double> x(dim);
+        for (std::size_t i = 0; i < dim; i++)
+            x[i] = std::cos(0.5 * static_cast<double>(i));
+        std::vector<double> crs_result(dim), bcsr_result(dim);
+
+        crs.multiVec(&x[0], &crs_result[0]);
+        bcsr.multiVec(&x[0], &bcsr_result[0]);
+        for (std::size_t i = 0; i < dim; i++)
+            EXPECT_NEAR(crs_result[i], bcsr_result[i], 1e-12)
+                << "A x, DOF " << dof << ", row " << i;
+
+        crs.Trans_MultiVec(&x[0], &crs_result[0]);
+        bcsr.Trans_MultiVec(&x[0], &bcsr_result[0]);
+        for (std::size_t i = 0; i < dim; i++)
+            EXPECT_NEAR(crs_result[i], bcsr_result[i], 1e-12)
+                << "A^T x, DOF " << dof << ", row " << i;
+    }
+    delete mesh;
+}
+
+#endif  // NEW_EQS
@@ -0,0 +1,91 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file TestMatrices.h
+ * Sparse matrices of the built-in linear solvers (NEW_EQS) on the
+ * connectivity of a mesh, and their dense copies, for the tests.
+ */
+
+#ifndef OGS_TESTMATRICES_H
+#define OGS_TESTMATRICES_H
+
+#ifdef NEW_EQS
+
+#include <cstddef>
+#include <vector>
+
+#include "matrix_class.h"
+#include "msh_mesh.h"
+
+namespace TestMatrices
+{
+/*!
+   Sets the graph Laplacian of the mesh nodes plus shift on the diagonal in
+   each DOF block of A. skew is added to the entries above and subtracted
+   from the ones below the diagonal, coupling couples the DOFs of a node.
+   With shift > 0 and small skew and coupling, A is diagonally dominant.
+ */
+inline void setLaplacian(const MeshLib::CFEMesh& mesh,
+                         Math_Group::CSparseMatrix& A, const double shift,
+                         const double skew, const double coupling)
+{
+    const long n = static_cast<long>(mesh.nod_vector.size());
+    const int dof = A.Dof();
+    A = 0.0;
+    for (long i = 0; i < n; i++)
+    {
+        const MeshLib::CNode& node = *mesh.nod_vector[i];
+        const std::size_t n_connected = node.getConnectedNodes().size();
+        long degree = 0;
+        for (std::size_t k = 0; k < n_connected; k++)
+        {
+            const long j = static_cast<long>(node.getConnectedNodes()[k]);
+            if (j == i)
+                continue;
+            degree++;
+            for (int d = 0; d < dof; d++)
+                A(d * n + i, d * n + j) = -1.0 + (j > i ? skew : -skew);
+        }
+        for (int d = 0; d < dof; d++)
+        {
+            A(d * n + i, d * n + i) = degree + shift;
+            for (int e = 0; e < dof; e++)
+                if (e != d)
+                    A(d * n + i, e * n + i) = coupling;
+        }
+    }
+}
+
+/// Dense copy of A
+inline Math_Group::Matrix toDense(const Math_Group::CSparseMatrix& A)
+{
+    const long dim = A.Dim();
+    Math_Group::Matrix dense(dim, dim);
+    for (long i = 0; i < dim; i++)
+        for (long j = 0; j < dim; j++)
+            dense(i, j) = A(i, j);
+    return dense;
+}
+
+/// b = A x
+inline std::vector<double> multiply(const Math_Group::Matrix& A,
+                                    const std::vector<double>& x)
+{
+    std::vector<double> b(x.size(), 0.0);
+    for (std::size_t i = 0; i < x.size(); i++)
+        for (std::size_t j = 0; j < x.size(); j++)
+            b[i] += A(i, j) * x[j];
+    return b;
+}
+}  // namespace TestMatrices
+
+#endif  // NEW_EQS
+
+#endif
@@ -0,0 +1,147 @@
+/**
+ * \copyright
+ * Copyright (c) 2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/project/license
+ *
+ */
+
+/**
+ * \file TestMeshes.h
+ * Small structured meshes for the tests, given as the text of an OGS mesh
+ * file (*.msh) and read by CFEMesh::Read().
+ */
+
+#ifndef OGS_TESTMESHES_H
+#define OGS_TESTMESHES_H
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "msh_mesh.h"
+
+namespace TestMeshes
+{
+/// Mesh from the text of a mesh file. The text is written to a file named
+/// after the running test, since CFEMesh::Read() needs a file stream.
+inline MeshLib::CFEMesh* readMesh(const std::string& text)
+{
+    const std::string file_name =
+        std::string(::testing::UnitTest::GetInstance()
+                        ->current_test_info()
+                        ->name()) +
+        ".msh";
+    {
+        std::ofstream os(file_name.c_str());
+        os << text;
+    }
+    std::ifstream is(file_name.c_str());
+    std::string line;
+    std::getline(is, line);  // #FEM_MSH
+    MeshLib::CFEMesh* mesh = new MeshLib::CFEMesh();
+    mesh->Read(&is);
+    is.close();
+    std::remove(file_name.c_str());
+    return mesh;
+}
+
+/// n line elements of unit length along the x axis
+inline std::string createLine(const int n)
+{
+    std::ostringstream os;
+    os << "#FEM_MSH\n $NODES\n  " << n + 1 << "\n";
+    for (int i = 0; i <= n; i++)
+        os << i << " " << i << " 0 0\n";
+    os << " $ELEMENTS\n  " << n << "\n";
+    for (int i = 0; i < n; i++)
+        os << i << " 0 line " << i << " " << i + 1 << "\n";
+    os << "#STOP\n";
+    return os.str();
+}
+
+/// nx x ny unit squares. If mixed, every second square is split into two
+/// triangles, and the material group is the row of the square.
+inline std::string createRectangle(const int nx, const int ny,
+                                   const bool mixed)
+{
+    std::ostringstream os;
+    os << "#FEM_MSH\n $NODES\n  " << (nx + 1) * (ny + 1) << "\n";
+    for (int j = 0; j <= ny; j++)
+        for (int i = 0; i <= nx; i++)
+            os << j * (nx + 1) + i << " " << i << " " << j << " 0\n";
+    std::ostringstream elements;
+    int n_elements = 0;
+    for (int j = 0; j < ny; j++)
+        for (int i = 0; i < nx; i++)
+        {
+            const int n0 = j * (nx + 1) + i;
+            const int n1 = n0 + 1;
+            const int n2 = n1 + nx + 1;
+            const int n3 = n0 + nx + 1;
+            const int group = mixed ? j : 0;
+            if (mixed && (i + j) % 2 == 1)
+            {
+                elements << n_elements++ << " " << group << " tri " << n0
+                         << " " << n1 << " " << n2 << "\n";
+                elements << n_elements++ << " " << group << " tri " << n0
+                         << " " << n2 << " " << n3 << "\n";
+            }
+            else
+                elements << n_elements++ << " " << group << " quad " << n0
+                         << " " << n1 << " " << n2 << " " << n3 << "\n";
+        }
+    os << " $ELEMENTS\n  " << n_elements << "\n"
+       << elements.str() << "#STOP\n";
+    return os.str();
+}
+
+/// nx x ny x nz unit cubes. If mixed, the cubes of every second column are
+/// split into two prisms, so that the faces of the elements match.
+inline std::string createBox(const int nx, const int ny, const int nz,
+                             const bool mixed)
+{
+    std::ostringstream os;
+    os << "#FEM_MSH\n $NODES\n  " << (nx + 1) * (ny + 1) * (nz + 1) << "\n";
+    for (int k = 0; k <= nz; k++)
+        for (int j = 0; j <= ny; j++)
+            for (int i = 0; i <= nx; i++)
+                os << (k * (ny + 1) + j) * (nx + 1) + i << " " << i << " "
+                   << j << " " << k << "\n";
+    std::ostringstream elements;
+    int n_elements = 0;
+    const int layer = (nx + 1) * (ny + 1);
+    for (int k = 0; k < nz; k++)
+        for (int j = 0; j < ny; j++)
+            for (int i = 0; i < nx; i++)
+            {
+                const int n0 = (k * (ny + 1) + j) * (nx + 1) + i;
+                const int n1 = n0 + 1;
+                const int n2 = n1 + nx + 1;
+                const int n3 = n0 + nx + 1;
+                if (mixed && (i + j) % 2 == 1)
+                {
+                    elements << n_elements++ << " 0 pris " << n0 << " " << n1
+                             << " " << n2 << " " << n0 + layer << " "
+                             << n1 + layer << " " << n2 + layer << "\n";
+                    elements << n_elements++ << " 0 pris " << n0 << " " << n2
+                             << " " << n3 << " " << n0 + layer << " "
+                             << n2 + layer << " " << n3 + layer << "\n";
+                }
+                else
+                    elements << n_elements++ << " 0 hex " << n0 << " " << n1
+                             << " " << n2 << " " << n3 << " " << n0 + layer
+                             << " " << n1 + layer << " " << n2 + layer << " "
+                             << n3 + layer << "\n";
+            }
+    os << " $ELEMENTS\n  " << n_elements << "\n"
+       << elements.str() << "#STOP\n";
+    return os.str();
+}
+}  // namespace TestMeshes
+
+#endif